@@ -240,6 +240,23 @@ function(wl_test NAME)
   add_dependencies(wl_tests ${NAME})
 endfunction()
 
+# Benchmarks are not run by ctest and not installed. Build them with the target
+# 'wl_benchmarks' and run them by hand.
+function(wl_benchmark NAME)
+
+  if (NOT OPTION_BUILD_BENCHMARKS)
+    return()
+  endif()
+
+  _parse_common_args("${ARGN}")
+
+  add_executable(${NAME} ${ARG_SRCS})
+
+  _common_compile_tasks()
+
+  add_dependencies(wl_benchmarks ${NAME})
+endfunction()
+
 # Checks a single 'SRC' file using Codecheck and writes a file named
 # codecheck_<shasum of input> if the codecheck did not yield anything. The
 # target for the codecheck will be added as a dependency to 'NAME' for debug
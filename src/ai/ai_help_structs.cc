@@ -1010,13 +1010,147 @@ bool SchedulerTask::operator<(const SchedulerTask& other) const {
 	return priority > other.priority;
 }
 
+TaskScheduler::CostTimer::CostTimer(TaskScheduler& scheduler, SchedulerTaskId id)
+   : scheduler_(scheduler), id_(id), start_(std::chrono::steady_clock::now()) {
+}
+
+TaskScheduler::CostTimer::~CostTimer() {
+	scheduler_.add_cost(id_, std::chrono::duration_cast<std::chrono::microseconds>(
+	                            std::chrono::steady_clock::now() - start_)
+	                            .count());
+}
+
+TaskScheduler::TaskScheduler()
+   : positions_(static_cast<size_t>(SchedulerTaskId::kUnset), std::numeric_limits<size_t>::max()),
+     costs_(static_cast<size_t>(SchedulerTaskId::kUnset)) {
+}
+
+void TaskScheduler::add(const SchedulerTask& task) {
+	const size_t id = static_cast<size_t>(task.id);
+	assert(id < positions_.size());
+	if (positions_[id] < heap_.size()) {
+		throw wexception("AI internal error: task '%s' is scheduled twice", task.descr.c_str());
+	}
+	heap_.push_back(task);
+	positions_[id] = heap_.size() - 1;
+	sift_up(heap_.size() - 1);
+}
+
+const SchedulerTask& TaskScheduler::top() const {
+	assert(!heap_.empty());
+	return heap_.front();
+}
+
+std::vector<SchedulerTask> TaskScheduler::due_tasks(const Time& gametime,
+                                                    size_t max_count) const {
+	std::vector<SchedulerTask> result;
+	// Heap positions whose parents were taken already. The earliest of them is the next task.
+	std::vector<size_t> candidates;
+	if (!heap_.empty()) {
+		candidates.push_back(0);
+	}
+	while (result.size() < max_count && !candidates.empty()) {
+		auto next = candidates.begin();
+		for (auto it = candidates.begin() + 1; it != candidates.end(); ++it) {
+			if (before(*it, *next)) {
+				next = it;
+			}
+		}
+		const size_t position = *next;
+		if (heap_[position].due_time > gametime) {
+			break;
+		}
+		result.push_back(heap_[position]);
+		candidates.erase(next);
+		for (size_t child = 2 * position + 1; child <= 2 * position + 2; ++child) {
+			if (child < heap_.size()) {
+				candidates.push_back(child);
+			}
+		}
+	}
+	return result;
+}
+
+void TaskScheduler::set_due_time(SchedulerTaskId id, const Time& due_time) {
+	const size_t position = positions_.at(static_cast<size_t>(id));
+	if (position >= heap_.size()) {
+		throw wexception("AI internal error: nonexistent task.");
+	}
+	heap_[position].due_time = due_time;
+	sift_up(position);
+	sift_down(positions_[static_cast<size_t>(id)]);
+}
+
+const Time& TaskScheduler::get_due_time(SchedulerTaskId id) const {
+	const size_t position = positions_.at(static_cast<size_t>(id));
+	if (position >= heap_.size()) {
+		throw wexception("AI internal error: nonexistent task.");
+	}
+	return heap_[position].due_time;
+}
+
+void TaskScheduler::add_cost(SchedulerTaskId id, uint32_t microseconds) {
+	TaskCost& cost = costs_.at(static_cast<size_t>(id));
+	++cost.runs;
+	cost.total_us += microseconds;
+	cost.max_us = std::max(cost.max_us, microseconds);
+}
+
+const TaskScheduler::TaskCost& TaskScheduler::get_cost(SchedulerTaskId id) const {
+	return costs_.at(static_cast<size_t>(id));
+}
+
+bool TaskScheduler::before(size_t a, size_t b) const {
+	const SchedulerTask& task_a = heap_[a];
+	const SchedulerTask& task_b = heap_[b];
+	if (task_a.due_time != task_b.due_time) {
+		return task_a.due_time < task_b.due_time;
+	}
+	// Same order as the tasks are run in when several are due
+	if (task_a.priority != task_b.priority) {
+		return task_a < task_b;
+	}
+	return task_a.id < task_b.id;
+}
+
+void TaskScheduler::swap_positions(size_t a, size_t b) {
+	std::swap(heap_[a], heap_[b]);
+	positions_[static_cast<size_t>(heap_[a].id)] = a;
+	positions_[static_cast<size_t>(heap_[b].id)] = b;
+}
+
+void TaskScheduler::sift_up(size_t position) {
+	while (position > 0) {
+		const size_t parent = (position - 1) / 2;
+		if (!before(position, parent)) {
+			return;
+		}
+		swap_positions(position, parent);
+		position = parent;
+	}
+}
+
+void TaskScheduler::sift_down(size_t position) {
+	for (;;) {
+		size_t earliest = position;
+		for (size_t child = 2 * position + 1; child <= 2 * position + 2; ++child) {
+			if (child < heap_.size() && before(child, earliest)) {
+				earliest = child;
+			}
+		}
+		if (earliest == position) {
+			return;
+		}
+		swap_positions(position, earliest);
+		position = earliest;
+	}
+}
+
 // List of blocked fields with block time, with some accompanying functions
 void BlockedFields::add(Widelands::Coords coords, const Time& till) {
-	const uint32_t hash = coords.hash();
-	if (blocked_fields_.count(hash) == 0) {
-		blocked_fields_.insert(std::make_pair(hash, till));
-	} else if (blocked_fields_[hash] < till) {
-		blocked_fields_[hash] = till;
+	auto inserted = blocked_fields_.insert(std::make_pair(coords.hash(), till));
+	if (!inserted.second && inserted.first->second < till) {
+		inserted.first->second = till;
 	}
 	// The third possibility is that a field has been already blocked for longer time than 'till'
 }
@@ -1026,22 +1160,236 @@ uint32_t BlockedFields::count() {
 }
 
 void BlockedFields::remove_expired(const Time& gametime) {
-	std::vector<uint32_t> fields_to_remove;
-	for (auto field : blocked_fields_) {
-		if (field.second < gametime) {
-			fields_to_remove.push_back(field.first);
+	for (auto it = blocked_fields_.begin(); it != blocked_fields_.end();) {
+		if (it->second < gametime) {
+			it = blocked_fields_.erase(it);
+		} else {
+			++it;
 		}
 	}
-	while (!fields_to_remove.empty()) {
-		blocked_fields_.erase(fields_to_remove.back());
-		fields_to_remove.pop_back();
-	}
 }
 
 bool BlockedFields::is_blocked(Widelands::Coords coords) {
 	return (blocked_fields_.count(coords.hash()) != 0);
 }
 
+namespace {
+// Sum of 'length' values of a row starting at x, wrapping around the map edge, maybe even several
+// times. 'prefix' are the width + 1 prefix sums of the row. They may overflow, the differences are
+// still right as long as the sum itself fits.
+uint32_t sum_in_row(const uint16_t* prefix, int16_t width, int16_t x, int32_t length) {
+	const int32_t remaining = length % width;
+	uint32_t result = (length / width) * prefix[width];
+	if (x + remaining <= width) {
+		result += static_cast<uint16_t>(prefix[x + remaining] - prefix[x]);
+	} else {
+		result += static_cast<uint16_t>(prefix[width] - prefix[x] + prefix[x + remaining - width]);
+	}
+	return result;
+}
+
+// Adds up 'sum_row(y, x, length)' for the part of every row within the area, the area having the
+// same shape as when walking it with Map::get_tln() etc.
+template <typename SumRow>
+uint32_t sum_area(int16_t width,
+                  int16_t height,
+                  const Widelands::Coords& center,
+                  uint16_t radius,
+                  const SumRow& sum_row) {
+	// In doubled coordinates odd rows are shifted by half a node to the right
+	const int32_t doubled_center_x = 2 * center.x + (center.y & 1);
+	uint32_t result = 0;
+	for (int32_t dy = -radius; dy <= radius; ++dy) {
+		const int32_t offset = std::abs(dy);
+		const int16_t y = ((center.y + dy) % height + height) % height;
+		// Floor division, the dividend is even unless the map has an odd height
+		const int32_t doubled_left = doubled_center_x - 2 * radius + offset - (y & 1);
+		const int32_t left = doubled_left >= 0 ? doubled_left / 2 : (doubled_left - 1) / 2;
+		result += sum_row(y, (left % width + width) % width, 2 * radius + 1 - offset);
+	}
+	return result;
+}
+}  // namespace
+
+FieldClassCounts::FieldClassCounts() : width_(0), height_(0), nr_classes_(0) {
+}
+
+void FieldClassCounts::init(int16_t width, int16_t height, uint8_t nr_classes) {
+	assert(width > 0 && height > 0);
+	assert(0 < nr_classes && nr_classes <= 8);
+	width_ = width;
+	height_ = height;
+	nr_classes_ = nr_classes;
+	classes_.assign(width * height, 0);
+	prefix_counts_.assign(nr_classes * height * (width + 1), 0);
+	dirty_rows_.assign(height, false);
+	invalidated_.clear();
+}
+
+void FieldClassCounts::set(const Widelands::Coords& coords, uint8_t classes) {
+	assert(0 <= coords.x && coords.x < width_ && 0 <= coords.y && coords.y < height_);
+	uint8_t& current = classes_[coords.y * width_ + coords.x];
+	if (current != classes) {
+		current = classes;
+		dirty_rows_[coords.y] = true;
+	}
+}
+
+bool FieldClassCounts::has(const Widelands::Coords& coords, uint8_t c) const {
+	assert(0 <= coords.x && coords.x < width_ && 0 <= coords.y && coords.y < height_);
+	return classes_[coords.y * width_ + coords.x] & (1 << c);
+}
+
+void FieldClassCounts::update_row(int16_t y) {
+	const uint8_t* row_classes = &classes_[y * width_];
+	for (uint8_t c = 0; c < nr_classes_; ++c) {
+		uint16_t* prefix = &prefix_counts_[(c * height_ + y) * (width_ + 1)];
+		for (int16_t x = 0; x < width_; ++x) {
+			prefix[x + 1] = prefix[x] + ((row_classes[x] >> c) & 1);
+		}
+	}
+	dirty_rows_[y] = false;
+}
+
+uint32_t FieldClassCounts::count(const Widelands::Coords& center, uint16_t radius, uint8_t c) {
+	assert(is_initialized());
+	assert(c < nr_classes_);
+	return sum_area(
+	   width_, height_, center, radius, [this, c](int16_t y, int16_t x, int32_t length) {
+		   if (dirty_rows_[y]) {
+			   update_row(y);
+		   }
+		   return sum_in_row(&prefix_counts_[(c * height_ + y) * (width_ + 1)], width_, x, length);
+	   });
+}
+
+void FieldClassCounts::update_dirty_rows() {
+	for (int16_t y = 0; y < height_; ++y) {
+		if (dirty_rows_[y]) {
+			update_row(y);
+		}
+	}
+}
+
+void FieldClassCounts::invalidate(const Widelands::Coords& coords) {
+	if (is_initialized()) {
+		invalidated_.push_back(coords);
+	}
+}
+
+std::vector<Widelands::Coords> FieldClassCounts::take_invalidated() {
+	std::vector<Widelands::Coords> result;
+	result.swap(invalidated_);
+	return result;
+}
+
+MilitaryInfluence::MilitaryInfluence() : width_(0), height_(0) {
+}
+
+void MilitaryInfluence::init(int16_t width, int16_t height) {
+	assert(width > 0 && height > 0);
+	width_ = width;
+	height_ = height;
+	buildings_.clear();
+	values_.assign(kNumLayers * width * height, 0);
+	prefix_sums_.assign(kNumLayers * height * (width + 1), 0);
+	dirty_rows_.assign(height, false);
+}
+
+void MilitaryInfluence::set_building(const Widelands::Coords& coords,
+                                     Widelands::PlayerNumber owner,
+                                     BuildingType type,
+                                     uint16_t soldiers) {
+	assert(is_initialized());
+	assert(0 <= coords.x && coords.x < width_ && 0 <= coords.y && coords.y < height_);
+	auto it = buildings_.find(coords.hash());
+	if (it == buildings_.end()) {
+		it = buildings_.emplace(coords.hash(), Building()).first;
+	} else {
+		apply(it->second, -1);
+	}
+	it->second.coords = coords;
+	it->second.owner = owner;
+	it->second.type = type;
+	it->second.soldiers = soldiers;
+	apply(it->second, 1);
+}
+
+void MilitaryInfluence::remove_building(const Widelands::Coords& coords) {
+	auto it = buildings_.find(coords.hash());
+	if (it != buildings_.end()) {
+		apply(it->second, -1);
+		buildings_.erase(it);
+	}
+}
+
+void MilitaryInfluence::set_hostile(Widelands::PlayerNumber pn, bool hostile) {
+	if (is_hostile(pn) == hostile) {
+		return;
+	}
+	for (const auto& hash_and_building : buildings_) {
+		if (hash_and_building.second.owner == pn) {
+			apply(hash_and_building.second, -1);
+		}
+	}
+	if (hostile_.size() <= pn) {
+		hostile_.resize(pn + 1, false);
+	}
+	hostile_[pn] = hostile;
+	for (const auto& hash_and_building : buildings_) {
+		if (hash_and_building.second.owner == pn) {
+			apply(hash_and_building.second, 1);
+		}
+	}
+}
+
+void MilitaryInfluence::apply(const Building& building, int8_t sign) {
+	uint16_t* node = &values_[(building.coords.y * width_ + building.coords.x) * kNumLayers];
+	if (is_hostile(building.owner)) {
+		node[kEnemyBuildings] += sign;
+		switch (building.type) {
+		case BuildingType::kMilitarySite:
+			node[kEnemyMilitarySites] += sign;
+			node[kEnemySoldiers] += sign * building.soldiers;
+			break;
+		case BuildingType::kMilitaryConstructionSite:
+			node[kEnemyMilitaryConstructionSites] += sign;
+			break;
+		case BuildingType::kWarehouse:
+			node[kEnemyWarehouses] += sign;
+			node[kEnemySoldiers] += sign * building.soldiers;
+			break;
+		case BuildingType::kOther:
+			break;
+		}
+	} else if (building.type == BuildingType::kMilitarySite) {
+		node[kAllySoldiers] += sign * building.soldiers;
+	}
+	dirty_rows_[building.coords.y] = true;
+}
+
+void MilitaryInfluence::update_row(int16_t y) {
+	const uint16_t* row_values = &values_[y * width_ * kNumLayers];
+	for (uint8_t layer = 0; layer < kNumLayers; ++layer) {
+		uint16_t* prefix = &prefix_sums_[(layer * height_ + y) * (width_ + 1)];
+		for (int16_t x = 0; x < width_; ++x) {
+			prefix[x + 1] = prefix[x] + row_values[x * kNumLayers + layer];
+		}
+	}
+	dirty_rows_[y] = false;
+}
+
+uint32_t MilitaryInfluence::sum(const Widelands::Coords& center, uint16_t radius, Layer layer) {
+	assert(is_initialized());
+	return sum_area(
+	   width_, height_, center, radius, [this, layer](int16_t y, int16_t x, int32_t length) {
+		   if (dirty_rows_[y]) {
+			   update_row(y);
+		   }
+		   return sum_in_row(&prefix_sums_[(layer * height_ + y) * (width_ + 1)], width_, x, length);
+	   });
+}
+
 PlayersStrengths::PlayersStrengths() : update_time(0) {
 }
 
@@ -1479,6 +1827,81 @@ bool FlagWarehouseDistances::remove_old_flag(const Time& gametime) {
 	return false;
 }
 
+const FlagConnections::RoadDistances* FlagConnections::get_road_distances(uint32_t origin,
+                                                                          uint16_t radius) const {
+	auto it = origins_.find(origin);
+	if (it == origins_.end() || it->second.radius != radius) {
+		return nullptr;
+	}
+	return &it->second.road_distances;
+}
+
+const FlagConnections::RoadDistances& FlagConnections::set_road_distances(
+   Widelands::Coords origin, uint16_t radius, RoadDistances distances) {
+	Origin& entry = origins_[origin.hash()];
+	if (entry.radius != radius) {
+		// The possible roads were looked for in another area
+		entry.road_lengths.clear();
+	}
+	entry.coords = origin;
+	entry.radius = radius;
+	entry.road_distances = std::move(distances);
+	return entry.road_distances;
+}
+
+bool FlagConnections::get_road_length(uint32_t origin,
+                                      uint32_t target,
+                                      int32_t fields_necessity,
+                                      const Time& gametime,
+                                      int32_t* length) const {
+	auto origin_it = origins_.find(origin);
+	if (origin_it == origins_.end()) {
+		return false;
+	}
+	auto it = origin_it->second.road_lengths.find(target);
+	if (it == origin_it->second.road_lengths.end() ||
+	    it->second.fields_necessity != fields_necessity || it->second.expiry_time <= gametime) {
+		return false;
+	}
+	*length = it->second.length;
+	return true;
+}
+
+void FlagConnections::set_road_length(uint32_t origin,
+                                      uint32_t target,
+                                      int32_t fields_necessity,
+                                      int32_t length,
+                                      const Time& gametime) {
+	auto origin_it = origins_.find(origin);
+	if (origin_it == origins_.end()) {
+		return;
+	}
+	RoadLength& entry = origin_it->second.road_lengths[target];
+	entry.fields_necessity = fields_necessity;
+	entry.length = length;
+	entry.expiry_time = gametime + kRoadLengthExpirationPeriod;
+}
+
+void FlagConnections::invalidate(const Widelands::Map& map,
+                                 const Widelands::BaseImmovable::PositionList& positions) {
+	for (auto it = origins_.begin(); it != origins_.end();) {
+		// Flags up to 2 fields beyond the radius are walked to over roads, see collect_nearflags()
+		const uint32_t reach = it->second.radius + 2;
+		bool affected = false;
+		for (const Widelands::Coords& coords : positions) {
+			if (map.calc_distance(it->second.coords, coords) <= reach) {
+				affected = true;
+				break;
+			}
+		}
+		if (affected) {
+			it = origins_.erase(it);
+		} else {
+			++it;
+		}
+	}
+}
+
 // Returns pointer to winning road, provided that the treshold is exceeded
 FlagCandidates::Candidate* FlagCandidates::get_winner(const int16_t threshold) {
 	if (flags_.empty()) {
@@ -21,6 +21,8 @@
 #define WL_AI_AI_HELP_STRUCTS_H
 
 #include <bitset>
+#include <chrono>
+#include <unordered_map>
 
 #include "ai/ai_hints.h"
 #include "economy/flag.h"
@@ -128,6 +130,9 @@ constexpr Duration kFlagDistanceExpirationPeriod = Duration(120 * 1000);
 // If the distance of flag-warehouse was not updated for this time, we presume that the flag
 // does not exist anymore and remove it
 constexpr Duration kOldFlagRemoveTime = Duration(5 * 60 * 1000);
+// Trees, buildings and borders can block a possible road without any road being changed, so the
+// length of a possible road is trusted only for this time
+constexpr Duration kRoadLengthExpirationPeriod = Duration(60 * 1000);
 
 constexpr uint32_t kNoField = std::numeric_limits<uint32_t>::max();
 
@@ -424,6 +429,79 @@ struct MineableField {
 	int32_t same_mine_fields_nearby;
 };
 
+// Field observers (BuildableField, MineableField) that are checked in turns. They are stored by
+// value in one vector, so walking over them does not chase pointers and adding one allocates only
+// when the vector grows. Whose turn it is is kept as an index that wraps around; removing a field
+// moves the last field into its slot.
+// References to the fields are invalidated by add() and remove_next().
+template <typename T> class FieldRotation {
+public:
+	using iterator = typename std::vector<T>::iterator;
+	using const_iterator = typename std::vector<T>::const_iterator;
+
+	FieldRotation() : next_(0) {
+	}
+
+	bool empty() const {
+		return fields_.empty();
+	}
+	size_t size() const {
+		return fields_.size();
+	}
+
+	// The field whose turn it is
+	T& next() {
+		assert(!fields_.empty());
+		return fields_[next_];
+	}
+	// Passes the turn on to the following field
+	void advance() {
+		assert(!fields_.empty());
+		if (++next_ == fields_.size()) {
+			next_ = 0;
+		}
+	}
+	// Removes next(), the turn goes to the field that took its slot
+	void remove_next() {
+		assert(!fields_.empty());
+		if (next_ + 1 != fields_.size()) {
+			fields_[next_] = std::move(fields_.back());
+		}
+		fields_.pop_back();
+		if (next_ == fields_.size()) {
+			next_ = 0;
+		}
+	}
+	// The field that gets its turn 'offset' turns after next()
+	T& in_turns(size_t offset) {
+		assert(!fields_.empty());
+		return fields_[(next_ + offset) % fields_.size()];
+	}
+
+	// Adds a field, it gets its turn before the index wraps around the next time
+	T& add(const Widelands::FCoords& fc) {
+		fields_.emplace_back(fc);
+		return fields_.back();
+	}
+
+	iterator begin() {
+		return fields_.begin();
+	}
+	iterator end() {
+		return fields_.end();
+	}
+	const_iterator begin() const {
+		return fields_.begin();
+	}
+	const_iterator end() const {
+		return fields_.end();
+	}
+
+private:
+	std::vector<T> fields_;
+	size_t next_;
+};
+
 struct EconomyObserver {
 	explicit EconomyObserver(Widelands::Economy& e);
 
@@ -778,6 +856,69 @@ struct SchedulerTask {
 	std::string descr;
 };
 
+// The AI's tasks in a binary heap ordered by due time. Every task id is scheduled at most once
+// and its position in the heap is indexed, so rescheduling a task needs no search and no sorting.
+// In addition the time the tasks took to run is accounted per task.
+struct TaskScheduler {
+	struct TaskCost {
+		uint32_t average_us() const {
+			return runs > 0 ? total_us / runs : 0;
+		}
+
+		uint32_t runs = 0;
+		uint64_t total_us = 0;
+		uint32_t max_us = 0;
+	};
+
+	// Adds the real time between its construction and its destruction to the cost of a task
+	class CostTimer {
+	public:
+		CostTimer(TaskScheduler& scheduler, SchedulerTaskId id);
+		~CostTimer();
+
+	private:
+		TaskScheduler& scheduler_;
+		const SchedulerTaskId id_;
+		const std::chrono::steady_clock::time_point start_;
+	};
+
+	TaskScheduler();
+
+	void add(const SchedulerTask&);
+	bool empty() const {
+		return heap_.empty();
+	}
+	size_t size() const {
+		return heap_.size();
+	}
+	// The task that is due first
+	const SchedulerTask& top() const;
+	// Up to 'max_count' tasks that are due at 'gametime', the earliest first
+	std::vector<SchedulerTask> due_tasks(const Time& gametime, size_t max_count) const;
+
+	void set_due_time(SchedulerTaskId, const Time&);
+	const Time& get_due_time(SchedulerTaskId) const;
+
+	// All tasks in heap order
+	const std::vector<SchedulerTask>& tasks() const {
+		return heap_;
+	}
+	void add_cost(SchedulerTaskId, uint32_t microseconds);
+	const TaskCost& get_cost(SchedulerTaskId) const;
+
+private:
+	// Whether the task at heap position a is due before the one at position b
+	bool before(size_t a, size_t b) const;
+	void swap_positions(size_t a, size_t b);
+	void sift_up(size_t position);
+	void sift_down(size_t position);
+
+	std::vector<SchedulerTask> heap_;
+	// Heap position by task id, for tasks that were not added it is past the end of the heap
+	std::vector<size_t> positions_;
+	std::vector<TaskCost> costs_;
+};
+
 // List of blocked fields with block time, with some accompanying functions
 struct BlockedFields {
 	void add(Widelands::Coords coords, const Time& till);
@@ -787,7 +928,136 @@ struct BlockedFields {
 
 private:
 	// <hash of field coordinates, time till blocked>
-	std::map<uint32_t, Time> blocked_fields_;
+	std::unordered_map<uint32_t, Time> blocked_fields_;
+};
+
+// Every node of the map is assigned a set of classes (unowned and walkable, enemy owned, ...) and
+// this struct answers "how many nodes of a class are within a radius" without visiting the
+// area. Counts are kept as prefix sums per map row, so a query costs one lookup per row of the
+// area. Rows are rebuilt lazily when a node in them changed its classes.
+// Nodes whose classes might have changed are collected by invalidate(), the owner of this struct
+// is responsible for classifying them again.
+// The classes of Class are those a computer player tracks for itself. Other users can pass their
+// own number of classes to init() and use their own class numbers.
+struct FieldClassCounts {
+	enum Class : uint8_t {
+		kUnownedWalkable = 0,
+		kEnemyWalkable,
+		kAllyWalkable,
+		kUnownedBuildable,
+		kUnownedMineable,
+		kUnownedPortVicinity,
+		kNumClasses
+	};
+
+	FieldClassCounts();
+
+	void init(int16_t width, int16_t height, uint8_t nr_classes = kNumClasses);
+	bool is_initialized() const {
+		return width_ > 0;
+	}
+	int16_t height() const {
+		return height_;
+	}
+
+	// Sets all classes of the node at once, 'classes' is a bitmask of (1 << Class)
+	void set(const Widelands::Coords& coords, uint8_t classes);
+	bool has(const Widelands::Coords& coords, uint8_t c) const;
+
+	// Number of nodes of the class within the area, counted exactly like Map::find_fields does
+	uint32_t count(const Widelands::Coords& center, uint16_t radius, uint8_t c);
+	// Rebuilds the rows that changed. Until the next set(), count() then only reads, so it can be
+	// called from several threads at once.
+	void update_dirty_rows();
+
+	void invalidate(const Widelands::Coords& coords);
+	// Returns the nodes passed to invalidate() since the last call, duplicates are possible
+	std::vector<Widelands::Coords> take_invalidated();
+
+private:
+	void update_row(int16_t y);
+
+	int16_t width_;
+	int16_t height_;
+	uint8_t nr_classes_;
+	std::vector<uint8_t> classes_;
+	// For every class and row there are width + 1 entries, the first one always being 0
+	std::vector<uint16_t> prefix_counts_;
+	std::vector<bool> dirty_rows_;
+	std::vector<Widelands::Coords> invalidated_;
+};
+
+// Military buildings of the other players, summed up around every node. Like FieldClassCounts,
+// sums within a radius cost one lookup per row. Buildings are only counted at their main position.
+// The owner keeps it up to date by set_building() and remove_building(), the grid follows the
+// changes incrementally.
+struct MilitaryInfluence {
+	enum Layer : uint8_t {
+		// Stationed soldiers of hostile militarysites and warehouses
+		kEnemySoldiers = 0,
+		kEnemyMilitarySites,
+		kEnemyMilitaryConstructionSites,
+		kEnemyWarehouses,
+		// All hostile buildings, including the above ones
+		kEnemyBuildings,
+		// Stationed soldiers of allied militarysites
+		kAllySoldiers,
+		kNumLayers
+	};
+
+	enum class BuildingType : uint8_t {
+		kMilitarySite,
+		kMilitaryConstructionSite,
+		kWarehouse,
+		kOther
+	};
+
+	MilitaryInfluence();
+
+	void init(int16_t width, int16_t height);
+	bool is_initialized() const {
+		return width_ > 0;
+	}
+
+	// Adds the building or replaces what was known about it. Buildings are identified by their main
+	// position and not by serial: NoteImmovable reports new buildings before they get a serial.
+	void set_building(const Widelands::Coords& coords,
+	                  Widelands::PlayerNumber owner,
+	                  BuildingType type,
+	                  uint16_t soldiers);
+	void remove_building(const Widelands::Coords& coords);
+	bool has_building(const Widelands::Coords& coords) const {
+		return buildings_.count(coords.hash()) > 0;
+	}
+	// Moves the buildings of the player to the enemy or ally layers if the relation changed
+	void set_hostile(Widelands::PlayerNumber pn, bool hostile);
+
+	uint32_t sum(const Widelands::Coords& center, uint16_t radius, Layer layer);
+
+private:
+	struct Building {
+		Widelands::Coords coords;
+		Widelands::PlayerNumber owner;
+		BuildingType type;
+		uint16_t soldiers;
+	};
+
+	bool is_hostile(Widelands::PlayerNumber pn) const {
+		return pn < hostile_.size() && hostile_[pn];
+	}
+	// Adds (sign 1) or takes away (sign -1) the building's values
+	void apply(const Building& building, int8_t sign);
+	void update_row(int16_t y);
+
+	int16_t width_;
+	int16_t height_;
+	// Key is the hash of the building's main position
+	std::unordered_map<uint32_t, Building> buildings_;
+	std::vector<bool> hostile_;
+	// kNumLayers values for every node, then for every layer and row width + 1 prefix sums
+	std::vector<uint16_t> values_;
+	std::vector<uint16_t> prefix_sums_;
+	std::vector<bool> dirty_rows_;
 };
 
 // This is a struct that stores strength of players, info on teams and provides some outputs from
@@ -915,6 +1185,56 @@ public:
 	bool remove_old_flag(const Time& gametime);
 };
 
+// Remembers, for flags that were checked for shortcut roads, how far the flags around them are over
+// the existing roads and how long a new road to them would be. Keys are hashes of flag positions.
+// Road distances only change with the road network, so an entry is dropped when a flag or road of
+// the player appears or disappears within its radius. Whether a new road can be built depends also
+// on trees, buildings and borders, so road lengths expire after a while in addition.
+// This is not saved, a new game simply starts with an empty cache.
+struct FlagConnections {
+	// <hash of flag coordinates, distance over roads from the origin flag>
+	using RoadDistances = std::unordered_map<uint32_t, uint32_t>;
+
+	// Road distances to the flags around the origin, nullptr if they are not known for this radius
+	const RoadDistances* get_road_distances(uint32_t origin, uint16_t radius) const;
+	const RoadDistances&
+	set_road_distances(Widelands::Coords origin, uint16_t radius, RoadDistances distances);
+
+	// Steps of a new road from the origin to the target flag, -1 if none can be built. Returns
+	// false if this is not known for the given cost of buildable fields (see Map::findpath()).
+	bool get_road_length(uint32_t origin,
+	                     uint32_t target,
+	                     int32_t fields_necessity,
+	                     const Time& gametime,
+	                     int32_t* length) const;
+	// Only kept for origins whose road distances are known, the target must be within their radius
+	void set_road_length(uint32_t origin,
+	                     uint32_t target,
+	                     int32_t fields_necessity,
+	                     int32_t length,
+	                     const Time& gametime);
+
+	// A flag or road of the player was built or removed on these positions
+	void invalidate(const Widelands::Map&, const Widelands::BaseImmovable::PositionList&);
+	size_t count() const {
+		return origins_.size();
+	}
+
+private:
+	struct RoadLength {
+		int32_t fields_necessity;
+		int32_t length;
+		Time expiry_time;
+	};
+	struct Origin {
+		Widelands::Coords coords;
+		uint16_t radius;
+		RoadDistances road_distances;
+		std::unordered_map<uint32_t, RoadLength> road_lengths;
+	};
+	std::unordered_map<uint32_t, Origin> origins_;
+};
+
 // This is one-time structure - initiated and filled up when investigating possible roads to be
 // built to a flag. At the end the flags are scored based on gained info), ordered and if treshold
 // is achieved the road is to be built
@@ -0,0 +1,255 @@
+/*
+ * Copyright (C) 2020 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "ai/ai_training.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+
+#include <boost/format.hpp>
+
+#include "ai/defaultai.h"
+#include "base/log.h"
+#include "base/wexception.h"
+#include "io/filesystem/layered_filesystem.h"
+#include "logic/ai_dna_handler.h"
+#include "logic/filesystem_constants.h"
+#include "logic/game_settings.h"
+#include "logic/map.h"
+#include "logic/map_objects/tribes/tribe_basic_info.h"
+#include "logic/player.h"
+#include "logic/playercommand.h"
+#include "logic/playersmanager.h"
+#include "map_io/map_loader.h"
+
+namespace AI {
+
+const char* const kTrainingResultFile = "training_result";
+
+namespace {
+
+int32_t last_sample(const std::vector<uint32_t>& samples) {
+	return samples.empty() ? 0 : samples.back();
+}
+
+}  // namespace
+
+int32_t training_fitness(const Widelands::Game::GeneralStats& stats) {
+	// Land and military strength are what the AI's own review values most, buildings and
+	// productivity show a working economy, and fights count for whoever won them
+	return last_sample(stats.land_size) + 10 * last_sample(stats.nr_buildings) +
+	       20 * last_sample(stats.miltary_strength) + last_sample(stats.productivity) +
+	       50 * (last_sample(stats.nr_msites_defeated) + last_sample(stats.nr_civil_blds_defeated)) -
+	       50 * last_sample(stats.nr_msites_lost) - 20 * last_sample(stats.nr_civil_blds_lost);
+}
+
+std::vector<TrainingCandidate> select_training_parents(std::vector<TrainingCandidate> candidates,
+                                                       size_t const count) {
+	std::stable_sort(candidates.begin(), candidates.end(),
+	                 [](const TrainingCandidate& a, const TrainingCandidate& b) {
+		                 return a.fitness > b.fitness;
+	                 });
+	std::vector<TrainingCandidate> parents;
+	for (size_t i = 0; i < count && !candidates.empty(); ++i) {
+		parents.push_back(candidates.at(i % std::min(count, candidates.size())));
+	}
+	return parents;
+}
+
+TrainingGameController::TrainingGameController(Widelands::Game& game,
+                                               const Time& end_time,
+                                               const Duration& step,
+                                               const std::string& savegame)
+   : game_(game),
+     end_time_(end_time),
+     step_(step),
+     savegame_(savegame),
+     player_cmdserial_(0),
+     results_written_(false) {
+}
+
+TrainingGameController::~TrainingGameController() {
+}
+
+void TrainingGameController::think() {
+	if (!game_.is_loaded()) {
+		return;
+	}
+	if (computerplayers_.empty()) {
+		const Widelands::PlayerNumber nr_players = game_.map().get_nrplayers();
+		iterate_players_existing(p, nr_players, game_, plr) {
+			computerplayers_.emplace_back(
+			   ComputerPlayer::get_implementation(plr->get_ai())->instantiate(game_, p));
+		}
+	}
+	// Several training games share the cores of the computer already, so the players don't
+	// need to think in parallel
+	for (const std::unique_ptr<ComputerPlayer>& ai : computerplayers_) {
+		ai->think();
+	}
+}
+
+void TrainingGameController::send_player_command(Widelands::PlayerCommand* pc) {
+	pc->set_cmdserial(++player_cmdserial_);
+	game_.enqueue_command(pc);
+}
+
+Duration TrainingGameController::get_frametime() {
+	return step_;
+}
+
+GameController::GameType TrainingGameController::get_game_type() {
+	return GameController::GameType::kSingleplayer;
+}
+
+uint32_t TrainingGameController::real_speed() {
+	return 1000;
+}
+
+uint32_t TrainingGameController::desired_speed() {
+	return 1000;
+}
+
+void TrainingGameController::set_desired_speed(uint32_t) {
+}
+
+bool TrainingGameController::is_paused() {
+	return false;
+}
+
+void TrainingGameController::set_paused(bool) {
+}
+
+bool TrainingGameController::is_headless_game_over() {
+	if (game_.get_gametime() < end_time_) {
+		return false;
+	}
+	if (!results_written_) {
+		write_results();
+		results_written_ = true;
+	}
+	return true;
+}
+
+bool TrainingGameController::is_headless_realtime() {
+	return false;
+}
+
+void TrainingGameController::write_results() {
+	const Widelands::Game::GeneralStatsVector& stats = game_.get_general_statistics();
+	Widelands::AiDnaHandler dna_handler;
+	Profile result;
+
+	const Widelands::PlayerNumber nr_players = game_.map().get_nrplayers();
+	iterate_players_existing(p, nr_players, game_, plr) {
+		const Widelands::Player::AiPersistentState& dna = *plr->get_mutable_ai_persistent_state();
+		if (!dna.initialized) {
+			continue;
+		}
+		const std::string dna_file = (boost::format("%s%straining_player_%u%s") % kAiDir %
+		                              g_fs->file_separator() % static_cast<unsigned>(p) %
+		                              kAiExtension)
+		                                .str();
+		dna_handler.save_dna(dna, dna_file);
+
+		const int32_t fitness = p <= stats.size() ? training_fitness(stats.at(p - 1)) : 0;
+		const std::string section_name =
+		   (boost::format("player_%u") % static_cast<unsigned>(p)).str();
+		Section& section = result.create_section(section_name.c_str());
+		section.set_string("dna", dna_file);
+		section.set_string("tribe", plr->tribe().name());
+		section.set_int("fitness", fitness);
+		log_info("[Training]: player %u (%s) reached a fitness of %d\n", static_cast<unsigned>(p),
+		         plr->tribe().name().c_str(), fitness);
+	}
+	result.write(kTrainingResultFile, false);
+
+	if (!savegame_.empty()) {
+		std::string error;
+		if (!game_.save_handler().save_game(game_, savegame_, &error)) {
+			log_err("[Training]: saving %s failed: %s\n", savegame_.c_str(), error.c_str());
+		}
+	}
+}
+
+void run_training_game(Section& training) {
+	const std::string filename = training.get_safe_string("map");
+	Widelands::Map map;
+	std::unique_ptr<Widelands::MapLoader> ml = map.get_correct_loader(filename);
+	if (ml == nullptr) {
+		throw wexception("%s is not a map", filename.c_str());
+	}
+	map.set_filename(filename);
+	ml->preload_map(true);
+
+	GameSettings settings;
+	settings.mapname = map.get_name();
+	settings.mapfilename = filename;
+	settings.map_theme = map.get_background_theme();
+	settings.map_background = map.get_background();
+	settings.win_condition_script =
+	   training.get_string("win_condition", "scripting/win_conditions/endless_game.lua");
+	settings.tribes = Widelands::get_all_tribeinfos();
+
+	const uint32_t max_players = map.get_nrplayers();
+	const uint32_t nr_players = std::min(training.get_natural("players", max_players), max_players);
+	if (nr_players == 0) {
+		throw wexception("a training game needs at least one player");
+	}
+	const std::string ai = training.get_string("ai", DefaultAI::normal_impl.name.c_str());
+	const std::string tribe = training.get_string("tribe", "");
+	for (uint32_t i = 0; i < map.get_nrplayers(); ++i) {
+		PlayerSettings player;
+		player.state =
+		   i < nr_players ? PlayerSettings::State::kComputer : PlayerSettings::State::kClosed;
+		player.initialization_index = 0;
+		player.name = (boost::format("AI %u") % (i + 1)).str();
+		player.tribe = tribe.empty() ?
+		                  settings.tribes.at(std::rand() % settings.tribes.size()).name :  // NOLINT
+		                  tribe;
+		player.random_tribe = false;
+		player.ai = ai;
+		player.random_ai = false;
+		player.team = 0;
+		player.closeable = false;
+		player.shared_in = 0;
+		settings.players.push_back(player);
+	}
+
+	Widelands::Game game;
+	game.set_ai_training_mode(true);
+	game.set_write_replay(false);
+	game.set_write_syncstream(false);
+
+	TrainingGameController controller(game, Time(training.get_natural("duration", 120) * 60 * 1000),
+	                                  Duration(training.get_natural("step", 100)),
+	                                  training.get_string("savegame", ""));
+	game.set_game_controller(&controller);
+	try {
+		game.init_newgame(settings);
+		game.run(Widelands::Game::StartGameType::kMap, "", false, "training");
+	} catch (...) {
+		game.set_game_controller(nullptr);
+		throw;
+	}
+	game.set_game_controller(nullptr);
+}
+
+}  // namespace AI
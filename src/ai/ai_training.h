@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2020 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#ifndef WL_AI_AI_TRAINING_H
+#define WL_AI_AI_TRAINING_H
+
+#include <string>
+#include <vector>
+
+#include "ai/computer_player.h"
+#include "io/profile.h"
+#include "logic/game.h"
+#include "logic/game_controller.h"
+
+namespace AI {
+
+/// The file in the home directory that a training game writes its results to
+extern const char* const kTrainingResultFile;
+
+/// How well a player did in a training game, judged by the last sample of its statistics.
+/// Higher is better.
+int32_t training_fitness(const Widelands::Game::GeneralStats& stats);
+
+// The DNA that a player of a training game played with, and how well it did
+struct TrainingCandidate {
+	std::string dna_file;
+	int32_t fitness;
+};
+
+// Returns the 'count' fittest candidates, best first. If there are fewer candidates, the best
+// ones are repeated.
+std::vector<TrainingCandidate> select_training_parents(std::vector<TrainingCandidate> candidates,
+                                                       size_t count);
+
+/**
+ * Plays a game between computer players in AI training mode, without user
+ * interface and as fast as the computer can. Every frame advances the game by
+ * a fixed step. When the end time has been reached, the DNA of every player
+ * is written to "ai/training_player_<n>.wai" and its fitness to \ref
+ * kTrainingResultFile, both in the home directory. If 'savegame' is not empty,
+ * the game is saved to that file too, e.g. for benchmarks of the late game.
+ */
+class TrainingGameController : public GameController {
+public:
+	TrainingGameController(Widelands::Game&,
+	                       const Time& end_time,
+	                       const Duration& step,
+	                       const std::string& savegame = "");
+	~TrainingGameController() override;
+
+	void think() override;
+	void send_player_command(Widelands::PlayerCommand*) override;
+	Duration get_frametime() override;
+	GameController::GameType get_game_type() override;
+	uint32_t real_speed() override;
+	uint32_t desired_speed() override;
+	void set_desired_speed(uint32_t speed) override;
+	bool is_paused() override;
+	void set_paused(bool paused) override;
+	bool is_headless_game_over() override;
+	bool is_headless_realtime() override;
+
+private:
+	void write_results();
+
+	Widelands::Game& game_;
+	const Time end_time_;
+	const Duration step_;
+	const std::string savegame_;
+	uint32_t player_cmdserial_;
+	bool results_written_;
+	std::vector<std::unique_ptr<ComputerPlayer>> computerplayers_;
+};
+
+/**
+ * Sets up and plays one training game. The environment must have been set up
+ * with \ref initialize_headless_environment already. The DNA files
+ * "ai/ai_input_<n>.wai" in the home directory are the parents of the players'
+ * DNA, if there are none, the ones in the data directory are used.
+ *
+ * The keys of the section are
+ *  - map: filename of the map to play (mandatory)
+ *  - players: the number of players, default all players of the map
+ *  - ai: the AI that plays, default "normal"
+ *  - tribe: the tribe of all players, random if not given
+ *  - win_condition: the win condition script, default endless game
+ *  - duration: minutes of gametime to play, default 120
+ *  - step: milliseconds of gametime per frame, default 100
+ *  - savegame: file in the home directory that the game is saved to when it
+ *    ends, default none
+ */
+void run_training_game(Section& training);
+
+}  // namespace AI
+
+#endif  // end of include guard: WL_AI_AI_TRAINING_H
@@ -0,0 +1,268 @@
+/*
+ * Copyright (C) 2020 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#ifdef _WIN32
+#error "The AI training needs fork() and is not available on Windows"
+#endif
+
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <boost/format.hpp>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "ai/ai_training.h"
+#include "base/log.h"
+#include "base/spawn.h"
+#include "base/wexception.h"
+#include "build_info.h"
+#include "headless_environment.h"
+#include "io/fileread.h"
+#include "io/filesystem/disk_filesystem.h"
+#include "io/filesystem/layered_filesystem.h"
+#include "io/profile.h"
+#include "logic/filesystem_constants.h"
+#include "wlapplication_options.h"
+
+/**
+ * Trains the AI without user interface. Every generation plays a number of
+ * games between computer players in AI training mode on this computer, as
+ * many at the same time as there are cores. The DNA of the fittest players
+ * becomes the parents of the next generation; the AI mutates it when a game
+ * starts. The first generation descends from the DNA in the data directory.
+ *
+ * Every game runs in its own process, because the game logic can only run
+ * once per process. It has its own home directory gen_<g>/game_<n> in the
+ * training directory. After every generation, the ranking is written to
+ * gen_<g>/summary and the DNA of the parents to best/ai_input_<n>.wai. Copy
+ * those to data/ai to make the AI play with them.
+ *
+ * The config file has a [training] section with the keys of \ref
+ * AI::run_training_game and
+ *  - generations: the number of generations, default 10
+ *  - games: the number of games per generation, default the number of workers
+ *  - workers: the number of games played at the same time, default the number
+ *    of cores
+ *  - seed: the seed for the tribes and the DNA of the players, default 1
+ *  - homedir: the training directory, which must not be the home directory
+ *    of the user. Default is "ai_training".
+ *  - datadir: the data directory, default is the installed one
+ */
+
+namespace {
+
+// AiDnaHandler reads the parents from ai_input_1.wai to ai_input_4.wai
+constexpr size_t kNumberOfParents = 4;
+
+std::string game_dir(uint32_t generation, uint32_t game) {
+	return (boost::format("gen_%u/game_%u") % generation % game).str();
+}
+
+std::string parent_file(uint32_t number) {
+	return (boost::format("ai_input_%u%s") % number % kAiExtension).str();
+}
+
+/// Plays a game in the given home directory, this runs in a child process.
+int run_game(Section& training, const std::string& homedir, uint32_t seed) {
+	Profile config;
+	Section& environment = config.create_section("environment");
+	environment.set_string("homedir", homedir);
+	if (training.has_val("datadir")) {
+		environment.set_string("datadir", training.get_safe_string("datadir"));
+	}
+	// The tribes and the crossing of the parents' DNA are random
+	std::srand(seed);
+
+	g_fs = new LayeredFileSystem();
+	try {
+		initialize_headless_environment(environment);
+		// Only the results are of interest
+		set_config_int("autosave", 0);
+		AI::run_training_game(training);
+	} catch (const std::exception& e) {
+		log_err("Training game in %s: %s\n", homedir.c_str(), e.what());
+		cleanup_headless_environment();
+		return 1;
+	}
+	cleanup_headless_environment();
+	return 0;
+}
+
+void copy_file(FileSystem& fs, const std::string& from, const std::string& to) {
+	FileRead fr;
+	fr.open(fs, from);
+	fs.write(to, fr.data(fr.get_size(), 0), fr.get_size());
+}
+
+/// Plays all games of a generation, at most 'workers' at the same time.
+void play_generation(Section& training,
+                     FileSystem& fs,
+                     const std::string& homedir,
+                     uint32_t generation,
+                     uint32_t games,
+                     uint32_t workers,
+                     const std::vector<AI::TrainingCandidate>& parents) {
+	const uint32_t seed = training.get_natural("seed", 1);
+	for (uint32_t game = 1; game <= games; ++game) {
+		const std::string dir = game_dir(generation, game);
+		fs.ensure_directory_exists(dir + "/" + kAiDir);
+		for (size_t i = 0; i < parents.size(); ++i) {
+			copy_file(fs, parents.at(i).dna_file, dir + "/" + kAiDir + "/" + parent_file(i + 1));
+		}
+	}
+
+	std::set<pid_t> running;
+	uint32_t next_game = 1;
+	uint32_t failed = 0;
+	while (next_game <= games || !running.empty()) {
+		while (next_game <= games && running.size() < workers) {
+			const std::string dir = homedir + "/" + game_dir(generation, next_game);
+			const uint32_t game_seed = seed + generation * games + next_game;
+			running.insert(
+			   spawn([&training, dir, game_seed]() { return run_game(training, dir, game_seed); }));
+			++next_game;
+		}
+		int status;
+		const pid_t pid = waitpid(-1, &status, 0);
+		if (pid < 0) {
+			throw wexception("waitpid() failed");
+		}
+		if (running.erase(pid) > 0 && !(WIFEXITED(status) && WEXITSTATUS(status) == 0)) {
+			++failed;
+		}
+	}
+	if (failed > 0) {
+		log_warn("[Training]: %u of %u games of generation %u failed, see the log above\n", failed,
+		         games, generation);
+	}
+}
+
+/// Reads the results of all games of a generation.
+std::vector<AI::TrainingCandidate>
+collect_results(FileSystem& fs, uint32_t generation, uint32_t games) {
+	std::vector<AI::TrainingCandidate> candidates;
+	for (uint32_t game = 1; game <= games; ++game) {
+		const std::string dir = game_dir(generation, game);
+		const std::string result_file = dir + "/" + AI::kTrainingResultFile;
+		if (!fs.file_exists(result_file)) {
+			continue;
+		}
+		Profile result;
+		result.read(result_file.c_str(), nullptr, fs);
+		while (Section* player = result.get_next_section()) {
+			AI::TrainingCandidate candidate;
+			candidate.dna_file = dir + "/" + player->get_safe_string("dna");
+			candidate.fitness = player->get_int("fitness");
+			candidates.push_back(candidate);
+		}
+	}
+	return candidates;
+}
+
+/// Writes the ranking of a generation and keeps the DNA of the new parents.
+void report_generation(FileSystem& fs,
+                       uint32_t generation,
+                       std::vector<AI::TrainingCandidate> candidates,
+                       const std::vector<AI::TrainingCandidate>& parents) {
+	candidates = AI::select_training_parents(candidates, candidates.size());
+	int64_t sum = 0;
+	Profile summary;
+	for (size_t i = 0; i < candidates.size(); ++i) {
+		const std::string section_name = (boost::format("rank_%u") % (i + 1)).str();
+		Section& section = summary.create_section(section_name.c_str());
+		section.set_string("dna", candidates.at(i).dna_file);
+		section.set_int("fitness", candidates.at(i).fitness);
+		sum += candidates.at(i).fitness;
+	}
+	summary.write((boost::format("gen_%u/summary") % generation).str().c_str(), false, fs);
+
+	fs.ensure_directory_exists("best");
+	for (size_t i = 0; i < parents.size(); ++i) {
+		copy_file(fs, parents.at(i).dna_file, std::string("best/") + parent_file(i + 1));
+	}
+
+	log_info("[Training]: generation %u: best fitness %d (%s), average %d, worst %d\n", generation,
+	         candidates.front().fitness, candidates.front().dna_file.c_str(),
+	         static_cast<int>(sum / static_cast<int64_t>(candidates.size())),
+	         candidates.back().fitness);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+	if (argc != 2) {
+		log_err("Usage: %s <config file>\n", argv[0]);
+		return 1;
+	}
+	log_info("This is the Widelands AI training, version %s (%s)\n", build_id().c_str(),
+	         build_type().c_str());
+
+	const std::string config_path = argv[1];
+	Profile config;
+	{
+		std::string config_dir = FileSystem::fs_dirname(config_path);
+		if (config_dir.empty()) {
+			config_dir = ".";
+		}
+		try {
+			std::unique_ptr<FileSystem> config_fs(&FileSystem::create(config_dir));
+			config.read(FileSystem::fs_filename(config_path.c_str()), nullptr, *config_fs);
+		} catch (const std::exception& e) {
+			log_err("Unable to read %s: %s\n", config_path.c_str(), e.what());
+			return 1;
+		}
+	}
+
+	try {
+		Section& training = config.get_safe_section("training");
+		training.get_safe_string("map");
+		const uint32_t generations = training.get_natural("generations", 10);
+		const uint32_t workers = std::max(
+		   training.get_natural("workers", std::thread::hardware_concurrency()), 1u);
+		const uint32_t games = std::max(training.get_natural("games", workers), 1u);
+		const std::string homedir = training.get_string("homedir", "ai_training");
+
+		std::unique_ptr<FileSystem> fs(new RealFSImpl(homedir));
+		fs->ensure_directory_exists(".");
+
+		// Without parents, the games use the DNA from the data directory
+		std::vector<AI::TrainingCandidate> parents;
+		for (uint32_t generation = 0; generation < generations; ++generation) {
+			log_info("[Training]: playing generation %u with %u games\n", generation, games);
+			play_generation(training, *fs, homedir, generation, games, workers, parents);
+			const std::vector<AI::TrainingCandidate> candidates =
+			   collect_results(*fs, generation, games);
+			if (candidates.empty()) {
+				throw wexception("no game of generation %u was finished", generation);
+			}
+			parents = AI::select_training_parents(candidates, kNumberOfParents);
+			report_generation(*fs, generation, candidates, parents);
+		}
+		log_info("[Training]: done, the best DNA is in %s/best\n", homedir.c_str());
+	} catch (const std::exception& e) {
+		log_err("AI training: %s\n", e.what());
+		return 1;
+	}
+	return 0;
+}
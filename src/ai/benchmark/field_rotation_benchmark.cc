@@ -0,0 +1,356 @@
+/*
+ * Copyright (C) 2020 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#ifndef __linux__
+#error "The field rotation benchmark reads the cache misses from perf events, which need Linux"
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "ai/ai_help_structs.h"
+#include "base/log.h"
+#include "base/macros.h"
+#include "game_io/game_loader.h"
+#include "headless_environment.h"
+#include "io/filesystem/layered_filesystem.h"
+#include "io/profile.h"
+#include "logic/game.h"
+#include "logic/map.h"
+#include "logic/player.h"
+
+/**
+ * Compares one cycle of DefaultAI::update_all_buildable_fields() on the
+ * FieldRotation that the AI keeps its buildable fields in with the deque of
+ * pointers to separately allocated fields that it used before. For every
+ * player of the given savegame, the fields that the AI would observe are
+ * taken from the map, and the rotation part of the cycle is run on both
+ * containers: the 35 fields whose turn it is, and the search for special
+ * fields starting in the middle. update_buildable_field() is left out, it
+ * costs the same for both containers.
+ *
+ * The time, the cache misses and the allocations per cycle are reported.
+ * Cache misses are only counted if the kernel allows perf events to this
+ * process, see /proc/sys/kernel/perf_event_paranoid.
+ *
+ * Use a savegame from late in the game, e.g. one written by wl_ai_training
+ * with the 'savegame' key in its config.
+ *
+ * Usage: benchmark_ai_fields <savegame> [<cycles>] [<datadir>]
+ */
+
+namespace {
+
+size_t allocations = 0;
+
+// As in defaultai.cc
+constexpr Duration kFieldInfoExpiration(12 * 1000);
+constexpr uint16_t kMinimalFieldsCheck = 35;
+
+/// Counts the cache misses of this process in user space.
+class CacheMissCounter {
+public:
+	CacheMissCounter() {
+		perf_event_attr attr;
+		memset(&attr, 0, sizeof(attr));
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.size = sizeof(attr);
+		attr.config = PERF_COUNT_HW_CACHE_MISSES;
+		attr.disabled = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		fd_ = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+	}
+	~CacheMissCounter() {
+		if (fd_ >= 0) {
+			close(fd_);
+		}
+	}
+
+	bool available() const {
+		return fd_ >= 0;
+	}
+	void start() {
+		if (fd_ >= 0) {
+			ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+			ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+		}
+	}
+	uint64_t stop() {
+		uint64_t result = 0;
+		if (fd_ >= 0) {
+			ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+			if (read(fd_, &result, sizeof(result)) != sizeof(result)) {
+				result = 0;
+			}
+		}
+		return result;
+	}
+
+private:
+	int fd_;
+
+	DISALLOW_COPY_AND_ASSIGN(CacheMissCounter);
+};
+
+/// How the AI kept its buildable fields before FieldRotation: every field was
+/// allocated on its own, and the queue was rotated by popping the front and
+/// pushing it to the back.
+class DequeRotation {
+public:
+	DequeRotation() = default;
+	~DequeRotation() {
+		for (AI::BuildableField* field : fields_) {
+			delete field;
+		}
+	}
+
+	bool empty() const {
+		return fields_.empty();
+	}
+	size_t size() const {
+		return fields_.size();
+	}
+	AI::BuildableField& next() {
+		return *fields_.front();
+	}
+	void advance() {
+		fields_.push_back(fields_.front());
+		fields_.pop_front();
+	}
+	void remove_next() {
+		delete fields_.front();
+		fields_.pop_front();
+	}
+	AI::BuildableField& in_turns(size_t offset) {
+		return *fields_[offset];
+	}
+	void push_back(AI::BuildableField* field) {
+		fields_.push_back(field);
+	}
+
+private:
+	std::deque<AI::BuildableField*> fields_;
+
+	DISALLOW_COPY_AND_ASSIGN(DequeRotation);
+};
+
+/// The part of DefaultAI::update_all_buildable_fields() that walks the container.
+template <typename Rotation>
+void buildable_fields_cycle(Rotation& fields,
+                            const Widelands::Player& player,
+                            const Time& gametime) {
+	uint16_t i = 0;
+	uint8_t non_small_needed = 4;
+	uint8_t near_border_needed = 10;
+
+	while (!fields.empty() && i < std::min<uint16_t>(kMinimalFieldsCheck, fields.size())) {
+		AI::BuildableField& bf = fields.next();
+		if ((bf.field_info_expiration - kFieldInfoExpiration + Duration(1000)) <= gametime) {
+			const int32_t maxsize = player.get_buildcaps(bf.coords) & Widelands::BUILDCAPS_SIZEMASK;
+			if (bf.coords.field->get_owned_by() != player.player_number() || maxsize == 0) {
+				fields.remove_next();
+				continue;
+			}
+			if (non_small_needed > 0 && maxsize > 1) {
+				--non_small_needed;
+			}
+			if (near_border_needed > 0 && bf.near_border) {
+				--near_border_needed;
+			}
+		}
+		bf.field_info_expiration = gametime + kFieldInfoExpiration;
+		fields.advance();
+		++i;
+	}
+
+	if (fields.size() < kMinimalFieldsCheck * 3) {
+		return;
+	}
+	for (uint32_t j = fields.size() / 2; j < fields.size(); ++j) {
+		if (non_small_needed + near_border_needed == 0) {
+			break;
+		}
+		AI::BuildableField& bf = fields.in_turns(j);
+		if (bf.coords.field->get_owned_by() != player.player_number()) {
+			continue;
+		}
+		if (bf.field_info_expiration + Duration(20 * 1000) > gametime) {
+			continue;
+		}
+		const int32_t maxsize = player.get_buildcaps(bf.coords) & Widelands::BUILDCAPS_SIZEMASK;
+		const bool update_due_size = non_small_needed && maxsize > 1;
+		const bool update_due_border = near_border_needed && bf.near_border;
+		if (!(update_due_size || update_due_border)) {
+			continue;
+		}
+		if (update_due_size) {
+			--non_small_needed;
+		}
+		if (update_due_border) {
+			--near_border_needed;
+		}
+		bf.field_info_expiration = gametime + kFieldInfoExpiration;
+	}
+}
+
+struct CycleCost {
+	double nanoseconds;
+	double cache_misses;
+	double allocations;
+};
+
+template <typename Rotation>
+CycleCost run_cycles(Rotation& fields,
+                     const Widelands::Player& player,
+                     Time gametime,
+                     uint32_t cycles,
+                     CacheMissCounter& counter) {
+	const size_t allocations_before = allocations;
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	counter.start();
+	for (uint32_t i = 0; i < cycles; ++i) {
+		buildable_fields_cycle(fields, player, gametime);
+		gametime.increment(Duration(1000));
+	}
+	const uint64_t cache_misses = counter.stop();
+	const double nanoseconds =
+	   std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+	return CycleCost{nanoseconds / cycles, static_cast<double>(cache_misses) / cycles,
+	                 static_cast<double>(allocations - allocations_before) / cycles};
+}
+
+/// The fields of the player that the AI would keep in its buildable fields.
+std::vector<Widelands::FCoords> buildable_fields_of(const Widelands::Map& map,
+                                                    const Widelands::Player& player) {
+	std::vector<Widelands::FCoords> result;
+	for (Widelands::MapIndex i = 0; i < map.max_index(); ++i) {
+		const Widelands::FCoords fc = map.get_fcoords(map[i]);
+		if (fc.field->get_owned_by() == player.player_number() &&
+		    (player.get_buildcaps(fc) & Widelands::BUILDCAPS_SIZEMASK) != 0) {
+			result.push_back(fc);
+		}
+	}
+	return result;
+}
+
+void benchmark_player(const Widelands::Game& game,
+                      const Widelands::Player& player,
+                      uint32_t cycles,
+                      CacheMissCounter& counter) {
+	const std::vector<Widelands::FCoords> coords = buildable_fields_of(game.map(), player);
+	if (coords.size() < kMinimalFieldsCheck) {
+		log_info("Player %u: only %" PRIuS " buildable fields, skipped\n",
+		         static_cast<unsigned>(player.player_number()), coords.size());
+		return;
+	}
+
+	std::vector<AI::BuildableField*> by_turn;
+	for (const Widelands::FCoords& fc : coords) {
+		by_turn.push_back(new AI::BuildableField(fc));
+	}
+	// In a long game, fields are dropped and added back all the time, so their turns have
+	// nothing to do with where they are on the map or in memory.
+	std::shuffle(by_turn.begin(), by_turn.end(), std::minstd_rand(by_turn.size()));
+	DequeRotation before;
+	AI::FieldRotation<AI::BuildableField> now;
+	for (AI::BuildableField* field : by_turn) {
+		before.push_back(field);
+		now.add(field->coords);
+	}
+
+	const CycleCost before_cost = run_cycles(before, player, game.get_gametime(), cycles, counter);
+	const CycleCost now_cost = run_cycles(now, player, game.get_gametime(), cycles, counter);
+
+	log_info("Player %u, %" PRIuS " buildable fields, per cycle:\n",
+	         static_cast<unsigned>(player.player_number()), coords.size());
+	log_info("  time:         %8.0f ns before, %8.0f ns now\n", before_cost.nanoseconds,
+	         now_cost.nanoseconds);
+	if (counter.available()) {
+		log_info("  cache misses: %8.1f before, %8.1f now\n", before_cost.cache_misses,
+		         now_cost.cache_misses);
+	}
+	log_info("  allocations:  %8.2f before, %8.2f now\n", before_cost.allocations,
+	         now_cost.allocations);
+}
+
+}  // namespace
+
+void* operator new(size_t size) {
+	++allocations;
+	if (void* const result = std::malloc(size > 0 ? size : 1)) {
+		return result;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+	std::free(pointer);
+}
+
+int main(int argc, char** argv) {
+	if (argc < 2 || argc > 4) {
+		log_err("Usage: %s <savegame> [<cycles>] [<datadir>]\n", argv[0]);
+		return 1;
+	}
+	const std::string savegame = argv[1];
+	const uint32_t cycles = argc > 2 ? std::max(std::atoi(argv[2]), 1) : 10000;
+
+	Profile config;
+	Section& environment = config.create_section("environment");
+	if (argc > 3) {
+		environment.set_string("datadir", argv[3]);
+	}
+
+	g_fs = new LayeredFileSystem();
+	try {
+		initialize_headless_environment(environment);
+
+		Widelands::Game game;
+		Widelands::GameLoader(savegame, game).load_game();
+
+		CacheMissCounter counter;
+		if (!counter.available()) {
+			log_warn("Perf events are not available, the cache misses are not counted\n");
+		}
+		const Widelands::PlayerNumber nr_players = game.map().get_nrplayers();
+		iterate_players_existing(p, nr_players, game, player) {
+			benchmark_player(game, *player, cycles, counter);
+		}
+	} catch (const std::exception& e) {
+		log_err("Benchmark failed: %s\n", e.what());
+		cleanup_headless_environment();
+		return 1;
+	}
+	cleanup_headless_environment();
+	return 0;
+}
@@ -19,7 +19,15 @@
 
 #include "ai/computer_player.h"
 
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <thread>
+
 #include "ai/defaultai.h"
+#include "base/worker_pool.h"
+#include "logic/game.h"
+#include "logic/playercommand.h"
 
 namespace AI {
 
@@ -30,6 +38,43 @@ ComputerPlayer::ComputerPlayer(Widelands::Game& g, Widelands::PlayerNumber const
 ComputerPlayer::~ComputerPlayer() {
 }
 
+// static
+void ComputerPlayer::think_all(Widelands::Game& game, const std::vector<ComputerPlayer*>& players) {
+	if (players.size() < 2) {
+		for (ComputerPlayer* player : players) {
+			player->think();
+		}
+		return;
+	}
+
+	// The calling thread works, too
+	static WorkerPool pool(std::max(std::thread::hardware_concurrency(), 1u) - 1);
+
+	std::vector<std::vector<std::unique_ptr<Widelands::PlayerCommand>>> commands(players.size());
+	std::vector<std::function<void()>> tasks;
+	for (size_t i = 0; i < players.size(); ++i) {
+		ComputerPlayer* player = players[i];
+		std::vector<std::unique_ptr<Widelands::PlayerCommand>>* player_commands = &commands[i];
+		tasks.push_back([player, player_commands]() {
+			Widelands::Game::defer_player_commands(player_commands);
+			try {
+				player->think();
+			} catch (...) {
+				Widelands::Game::defer_player_commands(nullptr);
+				throw;
+			}
+			Widelands::Game::defer_player_commands(nullptr);
+		});
+	}
+	pool.run(tasks);
+
+	for (std::vector<std::unique_ptr<Widelands::PlayerCommand>>& player_commands : commands) {
+		for (std::unique_ptr<Widelands::PlayerCommand>& command : player_commands) {
+			game.send_player_command(command.release());
+		}
+	}
+}
+
 struct EmptyAI : ComputerPlayer {
 	EmptyAI(Widelands::Game& g, const Widelands::PlayerNumber pid) : ComputerPlayer(g, pid) {
 	}
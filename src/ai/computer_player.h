@@ -20,6 +20,8 @@
 #ifndef WL_AI_COMPUTER_PLAYER_H
 #define WL_AI_COMPUTER_PLAYER_H
 
+#include <vector>
+
 #include <boost/algorithm/string/predicate.hpp>
 
 #include "base/macros.h"
@@ -47,6 +49,15 @@ struct ComputerPlayer {
 
 	virtual void think() = 0;
 
+	/**
+	 * Lets all the given computer players think at the same time, on as many
+	 * threads as the machine has cores. The game must not change meanwhile,
+	 * so all of them see the same state of it. The player commands that they
+	 * issue are sent afterwards, in the order of 'players', so the outcome does
+	 * not depend on which thread finishes first.
+	 */
+	static void think_all(Widelands::Game&, const std::vector<ComputerPlayer*>& players);
+
 	Widelands::Game& game() const {
 		return game_;
 	}
@@ -20,6 +20,7 @@
 #include "ai/defaultai.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cstdlib>
 #include <memory>
 
@@ -46,6 +47,7 @@
 #include "logic/map_objects/tribes/tribes.h"
 #include "logic/map_objects/tribes/warehouse.h"
 #include "logic/map_objects/world/world.h"
+#include "logic/mapfringeregion.h"
 #include "logic/mapregion.h"
 #include "logic/player.h"
 #include "logic/playercommand.h"
@@ -73,6 +75,7 @@ constexpr bool kPrintStats = false;
 
 // for scheduler
 constexpr int kMaxJobs = 4;
+constexpr std::chrono::milliseconds kThinkTimeBudget(10);
 
 // Count of mine types / ground resources
 constexpr int kMineTypes = 4;
@@ -93,8 +96,8 @@ DefaultAI::NormalImpl DefaultAI::normal_impl;
 DefaultAI::WeakImpl DefaultAI::weak_impl;
 DefaultAI::VeryWeakImpl DefaultAI::very_weak_impl;
 
-Time DefaultAI::last_seafaring_check_ = Time(0);
-bool DefaultAI::map_allows_seafaring_ = false;
+thread_local Time DefaultAI::last_seafaring_check_ = Time(0);
+thread_local bool DefaultAI::map_allows_seafaring_ = false;
 
 /// Constructor of DefaultAI
 DefaultAI::DefaultAI(Widelands::Game& ggame, Widelands::PlayerNumber const pid, AiType const t)
@@ -105,6 +108,8 @@ DefaultAI::DefaultAI(Widelands::Game& ggame, Widelands::PlayerNumber const pid,
      attackers_count_(0),
      next_ai_think_(0),
      scheduler_delay_counter_(0),
+     productionsites_left_to_check_(0),
+     mines_left_to_check_(0),
      wood_policy_(WoodPolicy::kAllowRangers),
      numof_psites_in_constr(0),
      num_ports(0),
@@ -129,6 +134,7 @@ DefaultAI::DefaultAI(Widelands::Game& ggame, Widelands::PlayerNumber const pid,
 	// Subscribe to NoteFieldPossession.
 	field_possession_subscriber_ = Notifications::subscribe<Widelands::NoteFieldPossession>(
 	   [this](const Widelands::NoteFieldPossession& note) {
+		   field_classes_.invalidate(note.fc);
 		   if (note.player != player_) {
 			   return;
 		   }
@@ -143,9 +149,29 @@ DefaultAI::DefaultAI(Widelands::Game& ggame, Widelands::PlayerNumber const pid,
 		   if (player_ == nullptr) {
 			   return;
 		   }
+		   // Buildings, flags and roads change the buildcaps of the nodes around them
+		   if (field_classes_.is_initialized()) {
+			   for (const Widelands::Coords& coords : note.pi->get_positions(game())) {
+				   invalidate_field_classes(coords, 2);
+			   }
+		   }
 		   if (note.pi->owner().player_number() != player_->player_number()) {
+			   // GAINED comes from set_owner() before init(), the building has no serial yet
+			   if (military_influence_.is_initialized()) {
+				   if (upcast(const Widelands::Building, building, note.pi)) {
+					   if (note.ownership == Widelands::NoteImmovable::Ownership::LOST) {
+						   military_influence_.remove_building(building->get_position());
+					   } else {
+						   update_military_influence(*building);
+					   }
+				   }
+			   }
 			   return;
 		   }
+		   if (note.pi->descr().type() == Widelands::MapObjectType::FLAG ||
+		       note.pi->descr().type() == Widelands::MapObjectType::ROAD) {
+			   flag_connections_.invalidate(game().map(), note.pi->get_positions(game()));
+		   }
 		   if (note.ownership == Widelands::NoteImmovable::Ownership::GAINED) {
 			   gain_immovable(*note.pi);
 		   } else {
@@ -153,6 +179,14 @@ DefaultAI::DefaultAI(Widelands::Game& ggame, Widelands::PlayerNumber const pid,
 		   }
 	   });
 
+	// Subscribe to NoteFieldTerrainChanged.
+	terrain_subscriber_ = Notifications::subscribe<Widelands::NoteFieldTerrainChanged>(
+	   [this](const Widelands::NoteFieldTerrainChanged& note) {
+		   if (field_classes_.is_initialized()) {
+			   invalidate_field_classes(note.fc, 1);
+		   }
+	   });
+
 	// Subscribe to ProductionSiteOutOfResources.
 	outofresource_subscriber_ =
 	   Notifications::subscribe<Widelands::NoteProductionSiteOutOfResources>(
@@ -216,19 +250,24 @@ DefaultAI::DefaultAI(Widelands::Game& ggame, Widelands::PlayerNumber const pid,
 			   break;
 		   }
 	   });
+
+	// Subscribe to NoteBuilding, soldiers entering or leaving are reported as changed workers
+	buildingnotes_subscriber_ = Notifications::subscribe<Widelands::NoteBuilding>(
+	   [this](const Widelands::NoteBuilding& note) {
+		   if (player_ == nullptr || !military_influence_.is_initialized()) {
+			   return;
+		   }
+		   if (upcast(const Widelands::Building, building,
+		              game().objects().get_object(note.serial))) {
+			   if (building->owner().player_number() != player_->player_number() &&
+			       military_influence_.has_building(building->get_position())) {
+				   update_military_influence(*building);
+			   }
+		   }
+	   });
 }
 
 DefaultAI::~DefaultAI() {
-	while (!buildable_fields.empty()) {
-		delete buildable_fields.back();
-		buildable_fields.pop_back();
-	}
-
-	while (!mineable_fields.empty()) {
-		delete mineable_fields.back();
-		mineable_fields.pop_back();
-	}
-
 	while (!economies.empty()) {
 		delete economies.back();
 		economies.pop_back();
@@ -270,9 +309,7 @@ void DefaultAI::think() {
 
 	SchedulerTaskId due_task = SchedulerTaskId::kUnset;
 
-	sort_task_pool();
-
-	const int32_t delay_time = gametime.get() - taskPool.front().due_time.get();
+	const int32_t delay_time = gametime.get() - scheduler_.top().due_time.get();
 
 	// Here we decide how many jobs will be run now (none - 5)
 	// in case no job is due now, it can be zero
@@ -304,22 +341,12 @@ void DefaultAI::think() {
 
 	jobs_to_run_count = (jobs_to_run_count > kMaxJobs) ? kMaxJobs : jobs_to_run_count;
 	assert(jobs_to_run_count > 0 && jobs_to_run_count <= kMaxJobs);
-	assert(jobs_to_run_count < taskPool.size());
+	assert(jobs_to_run_count < scheduler_.size());
 
 	// Pool of tasks to be executed this run. In ideal situation it will consist of one task only.
-	std::vector<SchedulerTask> current_task_queue;
-	assert(current_task_queue.empty());
-	// Here we push SchedulerTask members into the temporary queue, providing that a task is due now
-	// and
-	// the limit (jobs_to_run_count) is not exceeded
-	for (uint8_t i = 0; i < jobs_to_run_count; ++i) {
-		if (taskPool[i].due_time <= gametime) {
-			current_task_queue.push_back(taskPool[i]);
-			sort_task_pool();
-		} else {
-			break;
-		}
-	}
+	// These are the tasks that are due now, but not more than the limit (jobs_to_run_count)
+	std::vector<SchedulerTask> current_task_queue =
+	   scheduler_.due_tasks(gametime, jobs_to_run_count);
 
 	assert(!current_task_queue.empty() && current_task_queue.size() <= jobs_to_run_count);
 
@@ -327,11 +354,21 @@ void DefaultAI::think() {
 	std::sort(current_task_queue.begin(), current_task_queue.end());
 
 	// Performing tasks from temporary queue one by one
+	const std::chrono::steady_clock::time_point think_start = std::chrono::steady_clock::now();
+	auto out_of_time = [&think_start]() {
+		return std::chrono::steady_clock::now() - think_start > kThinkTimeBudget;
+	};
 	for (const SchedulerTask& task : current_task_queue) {
 
+		// The first task is always run, further ones only while the time budget of this think
+		// lasts. Tasks that are left over stay due and are run by one of the next thinks.
+		if (&task != &current_task_queue.front() && out_of_time()) {
+			break;
+		}
+
 		due_task = task.id;
 
-		++sched_stat_[static_cast<uint32_t>(due_task)];
+		TaskScheduler::CostTimer cost_timer(scheduler_, due_task);
 
 		// Now AI runs a job selected above to be performed in this turn
 		// (only one but some of them needs to run check_economies() to
@@ -395,17 +432,23 @@ void DefaultAI::think() {
 			if (check_economies()) {  // economies must be consistent
 				return;
 			}
-			{
-				set_taskpool_task_time(
-				   gametime + Duration(15000), SchedulerTaskId::kCheckProductionsites);
-				// testing 5 productionsites (if there are 5 of them)
-				int32_t ps_to_check = (productionsites.size() < 5) ? productionsites.size() : 5;
-				for (int j = 0; j < ps_to_check; ++j) {
-					// one productionsite per one check_productionsites() call
-					if (check_productionsites(gametime)) {
-						// if significant change takes place do not go on
-						break;
-					}
+			set_taskpool_task_time(gametime + Duration(15000), SchedulerTaskId::kCheckProductionsites);
+			// testing 5 productionsites (if there are 5 of them)
+			if (productionsites_left_to_check_ == 0) {
+				productionsites_left_to_check_ = 5;
+			}
+			productionsites_left_to_check_ =
+			   std::min<uint32_t>(productionsites_left_to_check_, productionsites.size());
+			while (productionsites_left_to_check_ > 0) {
+				--productionsites_left_to_check_;
+				// one productionsite per one check_productionsites() call
+				if (check_productionsites(gametime)) {
+					// if significant change takes place do not go on
+					productionsites_left_to_check_ = 0;
+				} else if (productionsites_left_to_check_ > 0 && out_of_time()) {
+					// the others are checked by the next think
+					set_taskpool_task_time(gametime, SchedulerTaskId::kCheckProductionsites);
+					break;
 				}
 			}
 			break;
@@ -430,15 +473,21 @@ void DefaultAI::think() {
 				return;
 			}
 			set_taskpool_task_time(gametime + Duration(15000), SchedulerTaskId::kCheckMines);
-			// checking 3 mines if possible
-			{
-				int32_t mines_to_check = (mines_.size() < 5) ? mines_.size() : 5;
-				for (int j = 0; j < mines_to_check; ++j) {
-					// every run of check_mines_() checks one mine
-					if (check_mines_(gametime)) {
-						// if significant change takes place do not go on
-						break;
-					}
+			// checking 5 mines if possible
+			if (mines_left_to_check_ == 0) {
+				mines_left_to_check_ = 5;
+			}
+			mines_left_to_check_ = std::min<uint32_t>(mines_left_to_check_, mines_.size());
+			while (mines_left_to_check_ > 0) {
+				--mines_left_to_check_;
+				// every run of check_mines_() checks one mine
+				if (check_mines_(gametime)) {
+					// if significant change takes place do not go on
+					mines_left_to_check_ = 0;
+				} else if (mines_left_to_check_ > 0 && out_of_time()) {
+					// the others are checked by the next think
+					set_taskpool_task_time(gametime, SchedulerTaskId::kCheckMines);
+					break;
 				}
 			}
 			break;
@@ -972,62 +1021,54 @@ void DefaultAI::late_initialization() {
 		resource_necessity_water_needed_ = true;
 	}
 
-	// Populating taskPool with all AI jobs and their starting times
-	taskPool.push_back(SchedulerTask(std::max<Time>(gametime, Time(0)),
-	                                 SchedulerTaskId::kConstructBuilding, 6,
-	                                 "construct a building"));
-	taskPool.push_back(SchedulerTask(
-	   std::max<Time>(gametime, Time(1000)), SchedulerTaskId::kRoadCheck, 2, "roads check"));
-	taskPool.push_back(SchedulerTask(std::max<Time>(gametime, Time(15 * 1000)),
-	                                 SchedulerTaskId::kCheckProductionsites, 5,
-	                                 "productionsites check"));
-	taskPool.push_back(SchedulerTask(std::max<Time>(gametime, Time(30 * 1000)),
-	                                 SchedulerTaskId::kProductionsitesStats, 1,
-	                                 "productionsites statistics"));
-	taskPool.push_back(SchedulerTask(
-	   std::max<Time>(gametime, Time(30 * 1000)), SchedulerTaskId::kCheckMines, 5, "check mines"));
-	taskPool.push_back(SchedulerTask(std::max<Time>(gametime, Time(0)),
-	                                 SchedulerTaskId::kCheckMilitarysites, 5,
-	                                 "check militarysites"));
-	taskPool.push_back(SchedulerTask(
-	   std::max<Time>(gametime, Time(30 * 1000)), SchedulerTaskId::kCheckShips, 5, "check ships"));
-	taskPool.push_back(SchedulerTask(std::max<Time>(gametime, Time(1000)),
-	                                 SchedulerTaskId::kCheckEconomies, 1, "check economies"));
-	taskPool.push_back(SchedulerTask(std::max<Time>(gametime, Time(30 * 1000)),
-	                                 SchedulerTaskId::KMarineDecisions, 5, "marine decisions"));
-	taskPool.push_back(SchedulerTask(std::max<Time>(gametime, Time(2 * 60 * 1000)),
-	                                 SchedulerTaskId::kCheckTrainingsites, 5,
-	                                 "check training sites"));
-	taskPool.push_back(SchedulerTask(std::max<Time>(gametime, Time(1000)),
-	                                 SchedulerTaskId::kBbuildableFieldsCheck, 2,
-	                                 "check buildable fields"));
-	taskPool.push_back(SchedulerTask(std::max<Time>(gametime, Time(1000)),
-	                                 SchedulerTaskId::kMineableFieldsCheck, 2,
-	                                 "check mineable fields"));
-	taskPool.push_back(SchedulerTask(std::max<Time>(gametime, Time(1000)),
-	                                 SchedulerTaskId::kUnbuildableFCheck, 1,
-	                                 "check unbuildable fields"));
-	taskPool.push_back(SchedulerTask(std::max<Time>(gametime, Time(15 * 60 * 1000)),
-	                                 SchedulerTaskId::kWareReview, 9, "wares review"));
-	taskPool.push_back(SchedulerTask(std::max<Time>(gametime, Time(10 * 60 * 1000)),
-	                                 SchedulerTaskId::kPrintStats, 9, "print statistics"));
-	taskPool.push_back(SchedulerTask(std::max<Time>(gametime, Time(60 * 1000)),
-	                                 SchedulerTaskId::kCountMilitaryVacant, 2,
-	                                 "count military vacant"));
-	taskPool.push_back(SchedulerTask(std::max<Time>(gametime, Time(10 * 60 * 1000)),
-	                                 SchedulerTaskId::kCheckEnemySites, 6, "check enemy sites"));
+	// Populating the scheduler with all AI jobs and their starting times
+	scheduler_.add(SchedulerTask(std::max<Time>(gametime, Time(0)),
+	                             SchedulerTaskId::kConstructBuilding, 6, "construct a building"));
+	scheduler_.add(SchedulerTask(std::max<Time>(gametime, Time(1000)),
+	                             SchedulerTaskId::kRoadCheck, 2, "roads check"));
+	scheduler_.add(SchedulerTask(std::max<Time>(gametime, Time(15 * 1000)),
+	                             SchedulerTaskId::kCheckProductionsites, 5,
+	                             "productionsites check"));
+	scheduler_.add(SchedulerTask(std::max<Time>(gametime, Time(30 * 1000)),
+	                             SchedulerTaskId::kProductionsitesStats, 1,
+	                             "productionsites statistics"));
+	scheduler_.add(SchedulerTask(std::max<Time>(gametime, Time(30 * 1000)),
+	                             SchedulerTaskId::kCheckMines, 5, "check mines"));
+	scheduler_.add(SchedulerTask(std::max<Time>(gametime, Time(0)),
+	                             SchedulerTaskId::kCheckMilitarysites, 5, "check militarysites"));
+	scheduler_.add(SchedulerTask(std::max<Time>(gametime, Time(30 * 1000)),
+	                             SchedulerTaskId::kCheckShips, 5, "check ships"));
+	scheduler_.add(SchedulerTask(std::max<Time>(gametime, Time(1000)),
+	                             SchedulerTaskId::kCheckEconomies, 1, "check economies"));
+	scheduler_.add(SchedulerTask(std::max<Time>(gametime, Time(30 * 1000)),
+	                             SchedulerTaskId::KMarineDecisions, 5, "marine decisions"));
+	scheduler_.add(SchedulerTask(std::max<Time>(gametime, Time(2 * 60 * 1000)),
+	                             SchedulerTaskId::kCheckTrainingsites, 5, "check training sites"));
+	scheduler_.add(SchedulerTask(std::max<Time>(gametime, Time(1000)),
+	                             SchedulerTaskId::kBbuildableFieldsCheck, 2,
+	                             "check buildable fields"));
+	scheduler_.add(SchedulerTask(std::max<Time>(gametime, Time(1000)),
+	                             SchedulerTaskId::kMineableFieldsCheck, 2, "check mineable fields"));
+	scheduler_.add(SchedulerTask(std::max<Time>(gametime, Time(1000)),
+	                             SchedulerTaskId::kUnbuildableFCheck, 1,
+	                             "check unbuildable fields"));
+	scheduler_.add(SchedulerTask(std::max<Time>(gametime, Time(15 * 60 * 1000)),
+	                             SchedulerTaskId::kWareReview, 9, "wares review"));
+	scheduler_.add(SchedulerTask(std::max<Time>(gametime, Time(10 * 60 * 1000)),
+	                             SchedulerTaskId::kPrintStats, 9, "print statistics"));
+	scheduler_.add(SchedulerTask(std::max<Time>(gametime, Time(60 * 1000)),
+	                             SchedulerTaskId::kCountMilitaryVacant, 2, "count military vacant"));
+	scheduler_.add(SchedulerTask(std::max<Time>(gametime, Time(10 * 60 * 1000)),
+	                             SchedulerTaskId::kCheckEnemySites, 6, "check enemy sites"));
 	if (ai_training_mode_) {
-		taskPool.push_back(SchedulerTask(std::max<Time>(gametime, Time(10 * 1000)),
-		                                 SchedulerTaskId::kManagementUpdate, 8, "reviewing"));
+		scheduler_.add(SchedulerTask(std::max<Time>(gametime, Time(10 * 1000)),
+		                             SchedulerTaskId::kManagementUpdate, 8, "reviewing"));
 	}
-	taskPool.push_back(SchedulerTask(std::max<Time>(gametime, Time(9 * 1000)),
-	                                 SchedulerTaskId::kUpdateStats, 6, "update player stats"));
-	taskPool.push_back(SchedulerTask(
-	   std::max<Time>(gametime, Time(10 * 1000)), SchedulerTaskId::kUpdateStats, 15, "review"));
+	scheduler_.add(SchedulerTask(std::max<Time>(gametime, Time(9 * 1000)),
+	                             SchedulerTaskId::kUpdateStats, 6, "update player stats"));
 
-	taskPool.push_back(SchedulerTask(std::max<Time>(gametime, Time(10 * 1000)),
-	                                 SchedulerTaskId::kWarehouseFlagDist, 5,
-	                                 "Flag-Warehouse Update"));
+	scheduler_.add(SchedulerTask(std::max<Time>(gametime, Time(10 * 1000)),
+	                             SchedulerTaskId::kWarehouseFlagDist, 5, "Flag-Warehouse Update"));
 
 	const Widelands::Map& map = game().map();
 
@@ -1087,20 +1128,7 @@ void DefaultAI::late_initialization() {
 		}
 	}
 
-	// getting list of all fields nearby port space
-	// TODO(tiborb): it seems port spaces can change over time so ports_vicinity needs to be
-	// refreshed from
-	// time to time
-	for (const Widelands::Coords& c : map.get_port_spaces()) {
-		Widelands::MapRegion<Widelands::Area<Widelands::FCoords>> mr(
-		   map, Widelands::Area<Widelands::FCoords>(map.get_fcoords(c), 3));
-		do {
-			const uint32_t hash = mr.location().hash();
-			if (!ports_vicinity.count(hash)) {
-				ports_vicinity.insert(hash);
-			}
-		} while (mr.advance(map));
-	}
+	world_analysis_ = WorldAnalysis::get(game());
 
 	// printing identified basic buildings if we are in the basic economy mode
 	basic_economy_established = persistent_data->remaining_basic_buildings.empty();
@@ -1115,6 +1143,20 @@ void DefaultAI::late_initialization() {
 
 	update_player_stat(gametime);
 
+	// Buildings of the other players, later changes come by notes
+	military_influence_.init(map.get_width(), map.get_height());
+	for (int16_t y = 0; y < map.get_height(); ++y) {
+		for (int16_t x = 0; x < map.get_width(); ++x) {
+			const Widelands::Coords coords(x, y);
+			if (upcast(const Widelands::Building, building, map[coords].get_immovable())) {
+				if (building->get_position() == coords &&
+				    building->owner().player_number() != player_number()) {
+					update_military_influence(*building);
+				}
+			}
+		}
+	}
+
 	// Initialise the max duration of a single ship's expedition
 	const uint32_t map_area = uint32_t(map.get_height()) * map.get_width();
 	const uint32_t map_area_root = round(sqrt(map_area));
@@ -1172,6 +1214,9 @@ void DefaultAI::update_all_buildable_fields(const Time& gametime) {
 	// To be sure we have some info about enemies we might see
 	update_player_stat(gametime);
 
+	// A full pass over the map takes about 32 calls
+	update_field_classes(std::max(1, game().map().get_height() / 32));
+
 	// Generally we check fields as they are in the container, but we need also given
 	// number of "special" fields. So if given number of fields are not found within
 	// "regular" check, we must go on and look also on other fields...
@@ -1181,23 +1226,20 @@ void DefaultAI::update_all_buildable_fields(const Time& gametime) {
 	// we test 35 fields that were update more than 1 seconds ago
 	while (!buildable_fields.empty() &&
 	       i < std::min<uint16_t>(kMinimalFieldsCheck, buildable_fields.size())) {
-		BuildableField& bf = *buildable_fields.front();
+		BuildableField& bf = buildable_fields.next();
 
-		if ((buildable_fields.front()->field_info_expiration - kFieldInfoExpiration +
-		     Duration(1000)) <= gametime) {
+		if ((bf.field_info_expiration - kFieldInfoExpiration + Duration(1000)) <= gametime) {
 
 			//  check whether we lost ownership of the node
 			if (bf.coords.field->get_owned_by() != player_number()) {
-				delete &bf;
-				buildable_fields.pop_front();
+				buildable_fields.remove_next();
 				continue;
 			}
 
 			//  check whether we can still construct regular buildings on the node
 			if ((player_->get_buildcaps(bf.coords) & Widelands::BUILDCAPS_SIZEMASK) == 0) {
 				unusable_fields.push_back(bf.coords);
-				delete &bf;
-				buildable_fields.pop_front();
+				buildable_fields.remove_next();
 				continue;
 			}
 
@@ -1216,8 +1258,7 @@ void DefaultAI::update_all_buildable_fields(const Time& gametime) {
 			}
 		}
 		bf.field_info_expiration = gametime + kFieldInfoExpiration;
-		buildable_fields.push_back(&bf);
-		buildable_fields.pop_front();
+		buildable_fields.advance();
 
 		++i;
 	}
@@ -1235,25 +1276,26 @@ void DefaultAI::update_all_buildable_fields(const Time& gametime) {
 		if (non_small_needed + near_border_needed == 0) {
 			break;
 		}
+		BuildableField& bf = buildable_fields.in_turns(j);
 
 		// Skip if the field is not ours or was updated lately
-		if (buildable_fields[j]->coords.field->get_owned_by() != player_number()) {
+		if (bf.coords.field->get_owned_by() != player_number()) {
 			continue;
 		}
 		// We are not interested in fields where info has expired less than 20s ago
-		if (buildable_fields[j]->field_info_expiration + Duration(20 * 1000) > gametime) {
+		if (bf.field_info_expiration + Duration(20 * 1000) > gametime) {
 			continue;
 		}
 
 		// Continue if field is blocked at the moment
-		if (blocked_fields.is_blocked(buildable_fields[j]->coords)) {
+		if (blocked_fields.is_blocked(bf.coords)) {
 			continue;
 		}
 
 		// Few constants to keep the code cleaner
 		const int32_t field_maxsize =
-		   player_->get_buildcaps(buildable_fields[j]->coords) & Widelands::BUILDCAPS_SIZEMASK;
-		const bool field_near_border = buildable_fields[j]->near_border;
+		   player_->get_buildcaps(bf.coords) & Widelands::BUILDCAPS_SIZEMASK;
+		const bool field_near_border = bf.near_border;
 
 		// Let decide if we need to update and for what reason
 		const bool update_due_size = non_small_needed && field_maxsize > 1;
@@ -1274,8 +1316,8 @@ void DefaultAI::update_all_buildable_fields(const Time& gametime) {
 		}
 
 		// and finnaly update the buildable field
-		update_buildable_field(*buildable_fields[j]);
-		buildable_fields[j]->field_info_expiration = gametime + kFieldInfoExpiration;
+		update_buildable_field(bf);
+		bf.field_info_expiration = gametime + kFieldInfoExpiration;
 	}
 }
 
@@ -1292,40 +1334,37 @@ void DefaultAI::update_all_mineable_fields(const Time& gametime) {
 	// we test 30 fields that were updated more than 1 seconds ago
 	// to avoid re-test of the same field twice
 	while (!mineable_fields.empty() &&
-	       (mineable_fields.front()->field_info_expiration - kMineFieldInfoExpiration +
+	       (mineable_fields.next().field_info_expiration - kMineFieldInfoExpiration +
 	        Duration(1000)) <= gametime &&
 	       i < 30) {
-		MineableField* mf = mineable_fields.front();
+		MineableField& mf = mineable_fields.next();
 
 		//  check whether we lost ownership of the node
-		if (mf->coords.field->get_owned_by() != player_number()) {
-			delete mf;
-			mineable_fields.pop_front();
+		if (mf.coords.field->get_owned_by() != player_number()) {
+			mineable_fields.remove_next();
 			continue;
 		}
 
 		//  check whether we can still construct regular buildings on the node
-		if ((player_->get_buildcaps(mf->coords) & Widelands::BUILDCAPS_MINE) == 0) {
-			unusable_fields.push_back(mf->coords);
-			delete mf;
-			mineable_fields.pop_front();
+		if ((player_->get_buildcaps(mf.coords) & Widelands::BUILDCAPS_MINE) == 0) {
+			unusable_fields.push_back(mf.coords);
+			mineable_fields.remove_next();
 			continue;
 		}
 
-		update_mineable_field(*mf);
-		mf->field_info_expiration = gametime + kMineFieldInfoExpiration;
-		mineable_fields.push_back(mf);
-		mineable_fields.pop_front();
+		update_mineable_field(mf);
+		mf.field_info_expiration = gametime + kMineFieldInfoExpiration;
+		mineable_fields.advance();
 
 		++i;
 	}
 	// Updating overall statistics, first we flush the data and then iterate over all mine fields
 	// ignoring fields that are blocked usually because they are not accessible
 	mine_fields_stat.zero();
-	for (const auto& mineable_field : mineable_fields) {
-		if (mineable_field->coords.field->get_resources_amount() > 0 &&
-		    !blocked_fields.is_blocked(mineable_field->coords)) {
-			mine_fields_stat.add(mineable_field->coords.field->get_resources());
+	for (const MineableField& mineable_field : mineable_fields) {
+		if (mineable_field.coords.field->get_resources_amount() > 0 &&
+		    !blocked_fields.is_blocked(mineable_field.coords)) {
+			mine_fields_stat.add(mineable_field.coords.field->get_resources());
 		}
 	}
 
@@ -1364,16 +1403,16 @@ void DefaultAI::update_all_not_buildable_fields() {
 
 		// check whether building capabilities have improved
 		if (player_->get_buildcaps(unusable_fields.front()) & Widelands::BUILDCAPS_SIZEMASK) {
-			buildable_fields.push_back(new BuildableField(unusable_fields.front()));
+			BuildableField& bf = buildable_fields.add(unusable_fields.front());
 			unusable_fields.pop_front();
-			update_buildable_field(*buildable_fields.back());
+			update_buildable_field(bf);
 			continue;
 		}
 
 		if (player_->get_buildcaps(unusable_fields.front()) & Widelands::BUILDCAPS_MINE) {
-			mineable_fields.push_back(new MineableField(unusable_fields.front()));
+			MineableField& mf = mineable_fields.add(unusable_fields.front());
 			unusable_fields.pop_front();
-			update_mineable_field(*mineable_fields.back());
+			update_mineable_field(mf);
 			continue;
 		}
 
@@ -1382,17 +1421,84 @@ void DefaultAI::update_all_not_buildable_fields() {
 	}
 }
 
+/// Returns the classes of the node as seen by this player, see FieldClassCounts
+uint8_t DefaultAI::classify_field(const Widelands::FCoords& fc) {
+	const Widelands::NodeCaps caps = fc.field->nodecaps();
+	const Widelands::PlayerNumber owner = fc.field->get_owned_by();
+	uint8_t classes = 0;
+	if (owner == Widelands::neutral()) {
+		if (caps & Widelands::MOVECAPS_WALK) {
+			classes |= 1 << FieldClassCounts::kUnownedWalkable;
+		}
+		if (caps & (Widelands::BUILDCAPS_SIZEMASK | Widelands::BUILDCAPS_MINE)) {
+			classes |= 1 << FieldClassCounts::kUnownedBuildable;
+		}
+		if (caps & Widelands::BUILDCAPS_MINE) {
+			classes |= 1 << FieldClassCounts::kUnownedMineable;
+		}
+		if (world_analysis_->is_port_vicinity(fc)) {
+			classes |= 1 << FieldClassCounts::kUnownedPortVicinity;
+		}
+	} else if (owner != player_number() && (caps & Widelands::MOVECAPS_WALK)) {
+		classes |= 1 << (player_->is_hostile(*game().get_player(owner)) ?
+		                    FieldClassCounts::kEnemyWalkable :
+		                    FieldClassCounts::kAllyWalkable);
+	}
+	return classes;
+}
+
+/// Classifies the nodes that were invalidated since the last call and the given number of rows
+void DefaultAI::update_field_classes(int16_t rows_to_refresh) {
+	const Widelands::Map& map = game().map();
+	if (!field_classes_.is_initialized()) {
+		field_classes_.init(map.get_width(), map.get_height());
+		rows_to_refresh = map.get_height();
+	}
+	for (const Widelands::Coords& coords : field_classes_.take_invalidated()) {
+		field_classes_.set(coords, classify_field(map.get_fcoords(coords)));
+	}
+	for (; rows_to_refresh > 0; --rows_to_refresh) {
+		for (int16_t x = 0; x < map.get_width(); ++x) {
+			const Widelands::FCoords fc =
+			   map.get_fcoords(Widelands::Coords(x, field_classes_next_row_));
+			field_classes_.set(fc, classify_field(fc));
+		}
+		field_classes_next_row_ = (field_classes_next_row_ + 1) % map.get_height();
+	}
+}
+
+void DefaultAI::invalidate_field_classes(const Widelands::Coords& coords, uint16_t radius) {
+	const Widelands::Map& map = game().map();
+	Widelands::MapRegion<Widelands::Area<>> mr(map, Widelands::Area<>(coords, radius));
+	do {
+		field_classes_.invalidate(mr.location());
+	} while (mr.advance(map));
+}
+
+void DefaultAI::update_military_influence(const Widelands::Building& building) {
+	MilitaryInfluence::BuildingType type = MilitaryInfluence::BuildingType::kOther;
+	uint16_t soldiers = 0;
+	if (upcast(const Widelands::MilitarySite, militarysite, &building)) {
+		type = MilitaryInfluence::BuildingType::kMilitarySite;
+		soldiers = militarysite->soldier_control()->stationed_soldiers().size();
+	} else if (upcast(const Widelands::Warehouse, warehouse, &building)) {
+		type = MilitaryInfluence::BuildingType::kWarehouse;
+		soldiers = warehouse->soldier_control()->stationed_soldiers().size();
+	} else if (upcast(const Widelands::ConstructionSite, constructionsite, &building)) {
+		if (constructionsite->building().type() == Widelands::MapObjectType::MILITARYSITE) {
+			type = MilitaryInfluence::BuildingType::kMilitaryConstructionSite;
+		}
+	}
+	military_influence_.set_building(
+	   building.get_position(), building.owner().player_number(), type, soldiers);
+}
+
 /// Updates one buildable field
 void DefaultAI::update_buildable_field(BuildableField& field) {
 	// look if there is any unowned land nearby
 	const Widelands::Map& map = game().map();
 	const Time& gametime = game().get_gametime();
-	FindNodeUnownedWalkable find_unowned_walkable(player_, game());
-	FindEnemyNodeWalkable find_enemy_owned_walkable(player_, game());
-	FindNodeUnownedBuildable find_unowned_buildable(player_, game());
-	FindNodeUnownedMineable find_unowned_mines_pots(player_, game());
 	FindNodeUnownedMineable find_unowned_iron_mines(player_, game(), iron_resource_id);
-	FindNodeAllyOwned find_ally(player_, game(), player_number());
 	Widelands::PlayerNumber const pn = player_->player_number();
 	const Widelands::World& world = game().world();
 
@@ -1413,13 +1519,11 @@ void DefaultAI::update_buildable_field(BuildableField& field) {
 		}
 	}
 
-	field.unowned_land_nearby = map.find_fields(
-	   game(), Widelands::Area<Widelands::FCoords>(field.coords, actual_enemy_check_area), nullptr,
-	   find_unowned_walkable);
-
-	field.enemy_owned_land_nearby = map.find_fields(
-	   game(), Widelands::Area<Widelands::FCoords>(field.coords, actual_enemy_check_area), nullptr,
-	   find_enemy_owned_walkable);
+	update_field_classes();
+	field.unowned_land_nearby = field_classes_.count(
+	   field.coords, actual_enemy_check_area, FieldClassCounts::kUnownedWalkable);
+	field.enemy_owned_land_nearby = field_classes_.count(
+	   field.coords, actual_enemy_check_area, FieldClassCounts::kEnemyWalkable);
 
 	field.nearest_buildable_spot_nearby = std::numeric_limits<uint16_t>::max();
 	field.unowned_buildable_spots_nearby = 0;
@@ -1428,52 +1532,43 @@ void DefaultAI::update_buildable_field(BuildableField& field) {
 	    (field.enemy_owned_land_nearby > 0 &&
 	     field.enemy_military_presence <
 	        std::abs(management_data.get_military_number_at(174)) / 10)) {
-		std::vector<Widelands::Coords> found_buildable_fields;
-
 		// first looking for unowned buildable spots
-		field.unowned_buildable_spots_nearby = map.find_fields(
-		   game(), Widelands::Area<Widelands::FCoords>(field.coords, kBuildableSpotsCheckArea),
-		   &found_buildable_fields, find_unowned_buildable);
-		field.unowned_buildable_spots_nearby += map.find_fields(
-		   game(), Widelands::Area<Widelands::FCoords>(field.coords, kBuildableSpotsCheckArea),
-		   &found_buildable_fields, find_enemy_owned_walkable);
-		// Now iterate over fields to collect statistics
-		for (auto& coords : found_buildable_fields) {
-			// We are not interested in blocked fields
-			if (blocked_fields.is_blocked(coords)) {
-				continue;
-			}
-			// And now looking for nearest field
-			const uint32_t cur_distance = map.calc_distance(coords, field.coords);
-			if (cur_distance < field.nearest_buildable_spot_nearby) {
-				field.nearest_buildable_spot_nearby = cur_distance;
+		field.unowned_buildable_spots_nearby =
+		   field_classes_.count(
+		      field.coords, kBuildableSpotsCheckArea, FieldClassCounts::kUnownedBuildable) +
+		   field_classes_.count(
+		      field.coords, kBuildableSpotsCheckArea, FieldClassCounts::kEnemyWalkable);
+
+		// And now looking for nearest field that is not blocked, ring by ring
+		if (field.unowned_buildable_spots_nearby > 0) {
+			Widelands::MapFringeRegion<> mr(map, Widelands::Area<>(field.coords, 1));
+			while (field.nearest_buildable_spot_nearby == std::numeric_limits<uint16_t>::max()) {
+				do {
+					const Widelands::Coords& coords = mr.location();
+					if ((field_classes_.has(coords, FieldClassCounts::kUnownedBuildable) ||
+					     field_classes_.has(coords, FieldClassCounts::kEnemyWalkable)) &&
+					    !blocked_fields.is_blocked(coords)) {
+						field.nearest_buildable_spot_nearby = mr.radius();
+					}
+				} while (mr.advance(map));
+				if (mr.radius() == kBuildableSpotsCheckArea) {
+					break;
+				}
+				mr.extend(map);
 			}
 		}
 
-		// now looking for unowned_portspace_vicinity_nearby
-		Widelands::MapRegion<Widelands::Area<Widelands::FCoords>> mr(
-		   map, Widelands::Area<Widelands::FCoords>(field.coords, kBuildableSpotsCheckArea));
-		do {
-
-			if (mr.location().field->get_owned_by() == 0 &&
-			    ports_vicinity.count(mr.location().hash()) > 0) {
-				++field.unowned_portspace_vicinity_nearby;
-			}
-		} while (mr.advance(map));
+		field.unowned_portspace_vicinity_nearby = field_classes_.count(
+		   field.coords, kBuildableSpotsCheckArea, FieldClassCounts::kUnownedPortVicinity);
 	}
 
 	// Is this near the border? Get rid of fields owned by ally
-	if (map.find_fields(
-	       game(), Widelands::Area<Widelands::FCoords>(field.coords, 3), nullptr, find_ally) ||
-	    map.find_fields(game(), Widelands::Area<Widelands::FCoords>(field.coords, 3), nullptr,
-	                    find_unowned_walkable)) {
-		field.near_border = true;
-	} else {
-		field.near_border = false;
-	}
+	field.near_border =
+	   field_classes_.count(field.coords, 3, FieldClassCounts::kAllyWalkable) > 0 ||
+	   field_classes_.count(field.coords, 3, FieldClassCounts::kUnownedWalkable) > 0;
 
 	// are we going to count resources now?
-	static bool resource_count_now = false;
+	thread_local bool resource_count_now = false;
 	resource_count_now = false;
 	// Testing in first 10 seconds or if last testing was more then 60 sec ago
 	if (field.last_resources_check_time < Time(10000) ||
@@ -1485,11 +1580,9 @@ void DefaultAI::update_buildable_field(BuildableField& field) {
 	// testing mines
 	if (resource_count_now) {
 		uint32_t close_mines =
-		   map.find_fields(game(), Widelands::Area<Widelands::FCoords>(field.coords, kProductionArea),
-		                   nullptr, find_unowned_mines_pots);
-		uint32_t distant_mines = map.find_fields(
-		   game(), Widelands::Area<Widelands::FCoords>(field.coords, kDistantResourcesArea), nullptr,
-		   find_unowned_mines_pots);
+		   field_classes_.count(field.coords, kProductionArea, FieldClassCounts::kUnownedMineable);
+		uint32_t distant_mines = field_classes_.count(
+		   field.coords, kDistantResourcesArea, FieldClassCounts::kUnownedMineable);
 		distant_mines = distant_mines - close_mines;
 		field.unowned_mines_spots_nearby = 4 * close_mines + distant_mines / 2;
 		if (distant_mines > 0) {
@@ -1516,7 +1609,7 @@ void DefaultAI::update_buildable_field(BuildableField& field) {
 	}
 
 	// testing for near portspaces
-	if (ports_vicinity.count(field.coords.hash()) > 0) {
+	if (world_analysis_->is_port_vicinity(field.coords)) {
 		field.portspace_nearby = ExtendedBool::kTrue;
 	} else {
 		field.portspace_nearby = ExtendedBool::kFalse;
@@ -1556,35 +1649,19 @@ void DefaultAI::update_buildable_field(BuildableField& field) {
 	assert((player_->get_buildcaps(field.coords) & Widelands::BUILDCAPS_SIZEMASK) <=
 	       field.max_buildcap_nearby);
 
-	// Testing surface water (once only)
-	// TODO(GunChleoc): We can change the terrain by scripting, so we should work with notifications
-	// here.
-	// Let's leave this as it is for now for performance reasons - terrain change of water is
-	// currently only
-	// used in the Atlantean scenario.
-	if (field.water_nearby == kUncalculated) {
-		assert(field.open_water_nearby == kUncalculated);
-
-		FindNodeWater find_water(game().world());
-		field.water_nearby =
-		   map.find_fields(game(), Widelands::Area<Widelands::FCoords>(field.coords, kProductionArea),
-		                   nullptr, find_water);
-
-		if (field.water_nearby > 0) {
-			FindNodeOpenWater find_open_water(game().world());
-			field.open_water_nearby = map.find_fields(
-			   game(), Widelands::Area<Widelands::FCoords>(field.coords, kProductionArea), nullptr,
-			   find_open_water);
-		}
+	// Testing surface water, the shared analysis follows terrain changes
+	field.water_nearby =
+	   world_analysis_->count(field.coords, kProductionArea, WorldAnalysis::kWater);
+	field.open_water_nearby =
+	   field.water_nearby > 0 ?
+	      world_analysis_->count(field.coords, kProductionArea, WorldAnalysis::kOpenWater) :
+	      0;
+	assert(field.open_water_nearby <= field.water_nearby);
 
-		if (resource_necessity_water_needed_) {  // for atlanteans
-			field.distant_water =
-			   map.find_fields(
-			      game(), Widelands::Area<Widelands::FCoords>(field.coords, kDistantResourcesArea),
-			      nullptr, find_water) -
-			   field.water_nearby;
-			assert(field.open_water_nearby <= field.water_nearby);
-		}
+	if (resource_necessity_water_needed_) {  // for atlanteans
+		field.distant_water =
+		   world_analysis_->count(field.coords, kDistantResourcesArea, WorldAnalysis::kWater) -
+		   field.water_nearby;
 	}
 
 	Widelands::FCoords fse;
@@ -1602,7 +1679,8 @@ void DefaultAI::update_buildable_field(BuildableField& field) {
 	if (field.water_nearby > 0 &&
 	    (field.fish_nearby == kUncalculated || (resource_count_now && gametime.get() % 10 == 0))) {
 		Widelands::CheckStepWalkOn fisher_cstep(Widelands::MOVECAPS_WALK, true);
-		static std::vector<Widelands::Coords> fish_fields_list;  // pity this contains duplicates
+		// pity this contains duplicates
+		thread_local std::vector<Widelands::Coords> fish_fields_list;
 		fish_fields_list.clear();
 		map.find_reachable_fields(game(),
 		                          Widelands::Area<Widelands::FCoords>(field.coords, kProductionArea),
@@ -1610,7 +1688,7 @@ void DefaultAI::update_buildable_field(BuildableField& field) {
 		                          Widelands::FindNodeResource(world.resource_index("resource_fish")));
 
 		// This is "list" of unique fields in fish_fields_list we got above
-		static std::set<Widelands::Coords> counted_fields;
+		thread_local std::set<Widelands::Coords> counted_fields;
 		counted_fields.clear();
 		field.fish_nearby = 0;
 		for (auto fish_coords : fish_fields_list) {
@@ -1696,7 +1774,7 @@ void DefaultAI::update_buildable_field(BuildableField& field) {
 	field.unconnected_nearby = false;
 
 	// collect information about productionsites nearby
-	static std::vector<Widelands::ImmovableFound> immovables;
+	thread_local std::vector<Widelands::ImmovableFound> immovables;
 	immovables.reserve(50);
 	immovables.clear();
 	// Search in a radius of range
@@ -1704,7 +1782,7 @@ void DefaultAI::update_buildable_field(BuildableField& field) {
 	   game(), Widelands::Area<Widelands::FCoords>(field.coords, kProductionArea + 2), &immovables);
 
 	// function seems to return duplicates, so we will use serial numbers to filter them out
-	static std::set<uint32_t> unique_serials;
+	thread_local std::set<uint32_t> unique_serials;
 	unique_serials.clear();
 
 	for (const Widelands::ImmovableFound& imm_found : immovables) {
@@ -1734,15 +1812,33 @@ void DefaultAI::update_buildable_field(BuildableField& field) {
 	}
 
 	// Now testing military aspects
+	field.enemy_military_presence = military_influence_.sum(
+	   field.coords, actual_enemy_check_area, MilitaryInfluence::kEnemySoldiers);
+	const uint32_t enemy_warehouses_nearby = military_influence_.sum(
+	   field.coords, actual_enemy_check_area, MilitaryInfluence::kEnemyWarehouses);
+	field.enemy_military_sites =
+	   military_influence_.sum(
+	      field.coords, actual_enemy_check_area, MilitaryInfluence::kEnemyMilitarySites) +
+	   military_influence_.sum(field.coords, actual_enemy_check_area,
+	                           MilitaryInfluence::kEnemyMilitaryConstructionSites) +
+	   enemy_warehouses_nearby;
+	field.enemy_wh_nearby = enemy_warehouses_nearby > 0;
+	field.ally_military_presence = military_influence_.sum(
+	   field.coords, actual_enemy_check_area, MilitaryInfluence::kAllySoldiers);
+	if (military_influence_.sum(
+	       field.coords, actual_enemy_check_area, MilitaryInfluence::kEnemyBuildings) > 0) {
+		field.enemy_nearby = true;
+	}
+
 	immovables.clear();
 	map.find_immovables(game(),
 	                    Widelands::Area<Widelands::FCoords>(field.coords, actual_enemy_check_area),
 	                    &immovables);
 
 	// We are interested in unconnected immovables, but we must be also close to connected ones
-	static bool any_connected_imm = false;
+	thread_local bool any_connected_imm = false;
 	any_connected_imm = false;
-	static bool any_unconnected_imm = false;
+	thread_local bool any_unconnected_imm = false;
 	any_unconnected_imm = false;
 	unique_serials.clear();
 
@@ -1756,37 +1852,16 @@ void DefaultAI::update_buildable_field(BuildableField& field) {
 		// testing if immovable is owned by someone else and collecting some statistics
 		if (upcast(Widelands::Building const, building, &base_immovable)) {
 
+			// Military buildings of the other players are summed up by military_influence_
 			const Widelands::PlayerNumber bpn = building->owner().player_number();
 			if (player_statistics.get_is_enemy(bpn)) {  // owned by enemy
 				assert(!player_statistics.players_in_same_team(bpn, pn));
-				field.enemy_nearby = true;
-				if (upcast(Widelands::MilitarySite const, militarysite, building)) {
-					field.enemy_military_presence +=
-					   militarysite->soldier_control()->stationed_soldiers().size();
-					++field.enemy_military_sites;
-				}
-				if (upcast(Widelands::ConstructionSite const, constructionsite, building)) {
-					const Widelands::BuildingDescr& target_descr = constructionsite->building();
-					if (target_descr.type() == Widelands::MapObjectType::MILITARYSITE) {
-						++field.enemy_military_sites;
-					}
-				}
-
-				// Warehouses are counted here too as they can host soldiers as well
-				if (upcast(Widelands::Warehouse const, warehouse, building)) {
-					field.enemy_military_presence +=
-					   warehouse->soldier_control()->stationed_soldiers().size();
-					++field.enemy_military_sites;
-					field.enemy_wh_nearby = true;
+				if (building->descr().type() == Widelands::MapObjectType::WAREHOUSE) {
 					enemy_warehouses.insert(building->get_position().hash());
 				}
 				continue;
 			} else if (bpn != pn) {  // it is an ally
 				assert(!player_statistics.get_is_enemy(bpn));
-				if (upcast(Widelands::MilitarySite const, militarysite, building)) {
-					field.ally_military_presence +=
-					   militarysite->soldier_control()->stationed_soldiers().size();
-				}
 				continue;
 			}
 
@@ -2080,7 +2155,7 @@ void DefaultAI::update_buildable_field(BuildableField& field) {
 
 	// is new site allowed at all here?
 	field.defense_msite_allowed = false;
-	static int16_t multiplicator = 10;
+	thread_local int16_t multiplicator = 10;
 	multiplicator = 10;
 	if (soldier_status_ == SoldiersStatus::kBadShortage) {
 		multiplicator = 4;
@@ -2232,9 +2307,9 @@ bool DefaultAI::construct_building(const Time& gametime) {
 	}
 
 	// Just used for easy checking whether a mine or something else was built.
-	static bool mine = false;
+	thread_local bool mine = false;
 	mine = false;
-	static uint32_t consumers_nearby_count = 0;
+	thread_local uint32_t consumers_nearby_count = 0;
 	consumers_nearby_count = 0;
 
 	const Widelands::Map& map = game().map();
@@ -2250,11 +2325,11 @@ bool DefaultAI::construct_building(const Time& gametime) {
 
 	// We calculate owned buildable spots, of course ignoring ones that are blocked
 	// for now
-	for (const BuildableField* bf : buildable_fields) {
-		if (blocked_fields.is_blocked(bf->coords)) {
+	for (const BuildableField& bf : buildable_fields) {
+		if (blocked_fields.is_blocked(bf.coords)) {
 			continue;
 		}
-		++spots_avail.at(bf->coords.field->nodecaps() & Widelands::BUILDCAPS_SIZEMASK);
+		++spots_avail.at(bf.coords.field->nodecaps() & Widelands::BUILDCAPS_SIZEMASK);
 	}
 
 	spots_ = spots_avail.at(Widelands::BUILDCAPS_SMALL);
@@ -2265,7 +2340,7 @@ bool DefaultAI::construct_building(const Time& gametime) {
 	// the proportion depends on size of economy
 	// this proportion defines how dense the buildings will be
 	// it is degressive (allows high density on the beginning)
-	static int32_t needed_spots = 0;
+	thread_local int32_t needed_spots = 0;
 	if (productionsites.size() < 50) {
 		needed_spots = productionsites.size();
 	} else if (productionsites.size() < 100) {
@@ -2311,7 +2386,7 @@ bool DefaultAI::construct_building(const Time& gametime) {
 	const Widelands::PlayerNumber pn = player_number();
 
 	// Genetic algorithm is used here
-	static bool inputs[2 * kFNeuronBitSize] = {0};
+	thread_local bool inputs[2 * kFNeuronBitSize] = {0};
 	for (int i = 0; i < 2 * kFNeuronBitSize; i++) {
 		inputs[i] = 0;
 	}
@@ -2409,9 +2484,9 @@ bool DefaultAI::construct_building(const Time& gametime) {
 	inputs[57] = (mine_fields_stat.has_critical_ore_fields());
 	inputs[58] = (!mine_fields_stat.has_critical_ore_fields());
 
-	static int16_t needs_boost_economy_score = management_data.get_military_number_at(61) / 5;
+	thread_local int16_t needs_boost_economy_score = management_data.get_military_number_at(61) / 5;
 	needs_boost_economy_score = management_data.get_military_number_at(61) / 5;
-	static int16_t increase_score_limit_score = 0;
+	thread_local int16_t increase_score_limit_score = 0;
 	increase_score_limit_score = 0;
 
 	for (uint8_t i = 0; i < kFNeuronBitSize; ++i) {
@@ -2450,9 +2525,9 @@ bool DefaultAI::construct_building(const Time& gametime) {
 	const bool increase_least_score_limit =
 	   (increase_score_limit_score > management_data.get_military_number_at(45) / 5);
 
-	static uint16_t concurent_ms_in_constr_no_enemy = 1;
+	thread_local uint16_t concurent_ms_in_constr_no_enemy = 1;
 	concurent_ms_in_constr_no_enemy = 1;
-	static uint16_t concurent_ms_in_constr_enemy_nearby = 2;
+	thread_local uint16_t concurent_ms_in_constr_enemy_nearby = 2;
 	concurent_ms_in_constr_enemy_nearby = 2;
 
 	// resetting highest_nonmil_prio_ so it can be recalculated anew
@@ -2708,18 +2783,18 @@ bool DefaultAI::construct_building(const Time& gametime) {
 	}
 
 	// first scan all buildable fields for regular buildings
-	for (BuildableField* const bf : buildable_fields) {
-		if (bf->field_info_expiration < gametime) {
+	for (BuildableField& bf : buildable_fields) {
+		if (bf.field_info_expiration < gametime) {
 			continue;
 		}
 
 		// Continue if field is blocked at the moment
-		if (blocked_fields.is_blocked(bf->coords)) {
+		if (blocked_fields.is_blocked(bf.coords)) {
 			continue;
 		}
 
 		assert(player_);
-		int32_t const maxsize = player_->get_buildcaps(bf->coords) & Widelands::BUILDCAPS_SIZEMASK;
+		int32_t const maxsize = player_->get_buildcaps(bf.coords) & Widelands::BUILDCAPS_SIZEMASK;
 
 		// For every field test all buildings
 		for (BuildingObserver& bo : buildings_) {
@@ -2768,7 +2843,7 @@ bool DefaultAI::construct_building(const Time& gametime) {
 
 			// testing for reserved ports
 			if (!bo.is(BuildingAttribute::kPort)) {
-				if (bf->portspace_nearby == ExtendedBool::kTrue) {
+				if (bf.portspace_nearby == ExtendedBool::kTrue) {
 					if (num_ports == 0) {
 						continue;
 					}
@@ -2780,13 +2855,13 @@ bool DefaultAI::construct_building(const Time& gametime) {
 
 			if (bo.type == BuildingObserver::Type::kProductionsite) {
 
-				prio += management_data.neuron_pool[44].get_result_safe(bf->military_score_ / 20) / 5;
+				prio += management_data.neuron_pool[44].get_result_safe(bf.military_score_ / 20) / 5;
 
 				// Some productionsites strictly require supporting sites nearby
 				if (bo.requires_supporters) {
 					uint16_t supporters_nearby = 0;
 					for (auto output : bo.ware_outputs) {
-						supporters_nearby += bf->supporters_nearby.at(output);
+						supporters_nearby += bf.supporters_nearby.at(output);
 					}
 					if (supporters_nearby == 0) {
 						continue;
@@ -2800,14 +2875,14 @@ bool DefaultAI::construct_building(const Time& gametime) {
 						assert(bo.total_count() - bo.unconnected_count == 0);
 					}
 
-					if (bf->ground_water < 2) {
+					if (bf.ground_water < 2) {
 						continue;
 					}
 
 					prio += bo.primary_priority;
 
 					// keep wells more distant
-					if (bf->collecting_producers_nearby.at(bo.get_collected_map_resource()) > 2) {
+					if (bf.collecting_producers_nearby.at(bo.get_collected_map_resource()) > 2) {
 						continue;
 					}
 
@@ -2817,7 +2892,7 @@ bool DefaultAI::construct_building(const Time& gametime) {
 					}
 
 					prio += -10 +
-					        std::abs(management_data.get_military_number_at(59) / 50) * bf->ground_water;
+					        std::abs(management_data.get_military_number_at(59) / 50) * bf.ground_water;
 
 				} else if (bo.is(BuildingAttribute::kLumberjack)) {
 
@@ -2827,18 +2902,18 @@ bool DefaultAI::construct_building(const Time& gametime) {
 						prio += 5 * std::abs(management_data.get_military_number_at(17));
 					}
 
-					if (bf->trees_nearby < trees_nearby_treshold_ &&
+					if (bf.trees_nearby < trees_nearby_treshold_ &&
 					    bo.new_building == BuildingNecessity::kAllowed) {
 						continue;
 					}
 
 					prio += std::abs(management_data.get_military_number_at(26)) *
-					        (bf->trees_nearby - trees_nearby_treshold_) / 10;
+					        (bf.trees_nearby - trees_nearby_treshold_) / 10;
 
 					// consider cutters and rangers nearby
-					prio += 2 * bf->supporters_nearby.at(bo.get_collected_map_resource()) *
+					prio += 2 * bf.supporters_nearby.at(bo.get_collected_map_resource()) *
 					        std::abs(management_data.get_military_number_at(25));
-					prio -= bf->collecting_producers_nearby.at(bo.get_collected_map_resource()) *
+					prio -= bf.collecting_producers_nearby.at(bo.get_collected_map_resource()) *
 					        std::abs(management_data.get_military_number_at(36)) * 3;
 
 				} else if (bo.is(BuildingAttribute::kNeedsRocks)) {
@@ -2846,12 +2921,12 @@ bool DefaultAI::construct_building(const Time& gametime) {
 					// Quarries are generally to be built everywhere where rocks are
 					// no matter the need for granite, as rocks are considered an obstacle
 					// to expansion
-					if (bf->rocks_nearby < 1) {
+					if (bf.rocks_nearby < 1) {
 						continue;
 					}
-					prio += 2 * bf->rocks_nearby;
+					prio += 2 * bf.rocks_nearby;
 
-					if (bf->rocks_nearby > 0 && bf->near_border) {
+					if (bf.rocks_nearby > 0 && bf.near_border) {
 						prio += management_data.get_military_number_at(27) / 2;
 					}
 
@@ -2871,11 +2946,11 @@ bool DefaultAI::construct_building(const Time& gametime) {
 
 					// to prevent to many quaries on one spot
 					prio =
-					   prio - 50 * bf->collecting_producers_nearby.at(bo.get_collected_map_resource());
+					   prio - 50 * bf.collecting_producers_nearby.at(bo.get_collected_map_resource());
 
 				} else if (bo.is(BuildingAttribute::kHunter)) {
 
-					if (bf->critters_nearby < 5) {
+					if (bf.critters_nearby < 5) {
 						continue;
 					}
 
@@ -2886,14 +2961,14 @@ bool DefaultAI::construct_building(const Time& gametime) {
 					// Overdue priority here
 					prio += bo.primary_priority;
 
-					prio += bf->supporters_nearby.at(bo.get_collected_map_resource()) * 5;
+					prio += bf.supporters_nearby.at(bo.get_collected_map_resource()) * 5;
 
-					prio += (bf->critters_nearby * 3) - 8 -
-					        5 * bf->collecting_producers_nearby.at(bo.get_collected_map_resource());
+					prio += (bf.critters_nearby * 3) - 8 -
+					        5 * bf.collecting_producers_nearby.at(bo.get_collected_map_resource());
 
 				} else if (bo.is(BuildingAttribute::kFisher)) {  // fisher
 
-					if (bf->fish_nearby <= 15) {
+					if (bf.fish_nearby <= 15) {
 						continue;
 					}
 
@@ -2904,10 +2979,10 @@ bool DefaultAI::construct_building(const Time& gametime) {
 					// Overdue priority here
 					prio += bo.primary_priority;
 
-					prio -= bf->collecting_producers_nearby.at(bo.get_collected_map_resource()) * 20;
-					prio += bf->supporters_nearby.at(bo.get_collected_map_resource()) * 20;
+					prio -= bf.collecting_producers_nearby.at(bo.get_collected_map_resource()) * 20;
+					prio += bf.supporters_nearby.at(bo.get_collected_map_resource()) * 20;
 
-					prio += -5 + bf->fish_nearby *
+					prio += -5 + bf.fish_nearby *
 					                (1 + std::abs(management_data.get_military_number_at(63) / 15));
 					if (resource_necessity_water_needed_) {
 						prio *= 3;
@@ -2931,37 +3006,37 @@ bool DefaultAI::construct_building(const Time& gametime) {
 							        (bo.cnt_target - bo.total_count());
 						}
 
-						prio -= bf->water_nearby / 5;
+						prio -= bf.water_nearby / 5;
 
 						for (auto ph : bo.production_hints) {
 							assert(ph != Widelands::INVALID_INDEX);
 							prio += management_data.neuron_pool[67].get_result_safe(
-							           bf->collecting_producers_nearby.at(ph) * 5, kAbsValue) /
+							           bf.collecting_producers_nearby.at(ph) * 5, kAbsValue) /
 							        2;
 						}
 
 						prio +=
-						   management_data.neuron_pool[49].get_result_safe(bf->trees_nearby, kAbsValue) /
+						   management_data.neuron_pool[49].get_result_safe(bf.trees_nearby, kAbsValue) /
 						   5;
 
 						for (auto ph : bo.production_hints) {
 							assert(ph != Widelands::INVALID_INDEX);
-							prio += bf->collecting_producers_nearby.at(ph) * 5 -
+							prio += bf.collecting_producers_nearby.at(ph) * 5 -
 							        (expansion_type.get_expansion_type() != ExpansionMode::kEconomy) * 15 -
-							        bf->space_consumers_nearby *
+							        bf.space_consumers_nearby *
 							           std::abs(management_data.get_military_number_at(102)) / 5 -
-							        bf->rocks_nearby / 3 + bf->supporters_nearby.at(ph) * 3;
+							        bf.rocks_nearby / 3 + bf.supporters_nearby.at(ph) * 3;
 						}
 						// don't block port building spots with trees
-						if (bf->unowned_portspace_vicinity_nearby > 0) {
+						if (bf.unowned_portspace_vicinity_nearby > 0) {
 							prio -= 500;
 						}
 						// frisian claypit and frisian farm
 					} else if (bo.is(BuildingAttribute::kSupportingProducer)) {
 						// we dont like trees nearby
-						prio += 1 - bf->trees_nearby / 3;
+						prio += 1 - bf.trees_nearby / 3;
 						// and be far from rangers
-						prio += 1 - bf->rangers_nearby *
+						prio += 1 - bf.rangers_nearby *
 						               std::abs(management_data.get_military_number_at(102)) / 5;
 
 						// This is for a special case this is also supporter, it considers
@@ -2969,7 +3044,7 @@ bool DefaultAI::construct_building(const Time& gametime) {
 						for (auto ph : bo.production_hints) {
 							assert(ph != Widelands::INVALID_INDEX);
 							prio += management_data.neuron_pool[51].get_result_safe(
-							           bf->collecting_producers_nearby.at(ph) * 5, kAbsValue) /
+							           bf.collecting_producers_nearby.at(ph) * 5, kAbsValue) /
 							        2;
 						}
 						// now we find out if the supporter is needed depending on output stocklevel
@@ -2989,35 +3064,35 @@ bool DefaultAI::construct_building(const Time& gametime) {
 						// taking into account the vicinity
 						for (auto ph : bo.production_hints) {
 							assert(ph != Widelands::INVALID_INDEX);
-							prio += bf->collecting_producers_nearby.at(ph) * 10;
-							prio -= bf->supporters_nearby.at(ph) * 15;
+							prio += bf.collecting_producers_nearby.at(ph) * 10;
+							prio -= bf.supporters_nearby.at(ph) * 15;
 						}
 
-						if (bf->enemy_nearby) {  // not close to the enemy
+						if (bf.enemy_nearby) {  // not close to the enemy
 							prio -= 20;
 						}
 
 						// don't block port building spots with immovables
 						if (bo.is(BuildingAttribute::kSpaceConsumer) &&
-						    bf->unowned_portspace_vicinity_nearby > 0) {
+						    bf.unowned_portspace_vicinity_nearby > 0) {
 							prio -= 500;
 						}
 
 						if (bo.is(BuildingAttribute::kSpaceConsumer) &&
-						    bf->water_nearby) {  // not close to water
+						    bf.water_nearby) {  // not close to water
 							prio -= std::abs(management_data.get_military_number_at(103)) / 5;
 						}
 
 						if (bo.is(BuildingAttribute::kSpaceConsumer) &&
-						    bf->unowned_mines_spots_nearby) {  // not close to mountains
+						    bf.unowned_mines_spots_nearby) {  // not close to mountains
 							prio -= std::abs(management_data.get_military_number_at(104)) / 5;
 						}
 						// frisian berry farm
 					} else if (bo.is(BuildingAttribute::kSpaceConsumer)) {
 						// we dont like trees nearby
-						prio += 1 - bf->trees_nearby / 4;
+						prio += 1 - bf.trees_nearby / 4;
 						// and be far from rangers
-						prio += 1 - bf->rangers_nearby *
+						prio += 1 - bf.rangers_nearby *
 						               std::abs(management_data.get_military_number_at(102)) / 5;
 
 						// now we find out if the supporter is needed depending on stocklevel
@@ -3035,24 +3110,24 @@ bool DefaultAI::construct_building(const Time& gametime) {
 						// taking into account the vicinity
 						for (auto ph : bo.production_hints) {
 							assert(ph != Widelands::INVALID_INDEX);
-							prio += bf->collecting_producers_nearby.at(ph) * 10;
-							prio -= bf->supporters_nearby.at(ph) * 8;
+							prio += bf.collecting_producers_nearby.at(ph) * 10;
+							prio -= bf.supporters_nearby.at(ph) * 8;
 						}
 
-						if (bf->enemy_nearby) {  // not close to the enemy
+						if (bf.enemy_nearby) {  // not close to the enemy
 							prio -= 20;
 						}
 
 						// don't block port building spots with immovables
-						if (bf->unowned_portspace_vicinity_nearby > 0) {
+						if (bf.unowned_portspace_vicinity_nearby > 0) {
 							prio -= 500;
 						}
 
-						if (bf->water_nearby) {  // not close to water
+						if (bf.water_nearby) {  // not close to water
 							prio -= std::abs(management_data.get_military_number_at(103)) / 5;
 						}
 
-						if (bf->unowned_mines_spots_nearby) {  // not close to mountains
+						if (bf.unowned_mines_spots_nearby) {  // not close to mountains
 							prio -= std::abs(management_data.get_military_number_at(104)) / 5;
 						}
 
@@ -3060,12 +3135,12 @@ bool DefaultAI::construct_building(const Time& gametime) {
 
 						// especially for fish breeders
 						if (bo.is(BuildingAttribute::kNeedsCoast) &&
-						    (bf->water_nearby < 6 || bf->fish_nearby < 6)) {
+						    (bf.water_nearby < 6 || bf.fish_nearby < 6)) {
 							continue;
 						}
 						if (bo.is(BuildingAttribute::kNeedsCoast)) {
-							prio += (-6 + bf->water_nearby) / 3;
-							prio += (-6 + bf->fish_nearby) / 3;
+							prio += (-6 + bf.water_nearby) / 3;
+							prio += (-6 + bf.fish_nearby) / 3;
 						}
 
 						const uint32_t current_stocklevel = (get_stocklevel(bo, gametime));
@@ -3082,23 +3157,23 @@ bool DefaultAI::construct_building(const Time& gametime) {
 
 						for (auto ph : bo.production_hints) {
 							assert(ph != Widelands::INVALID_INDEX);
-							prio += bf->collecting_producers_nearby.at(ph) * 10;
-							prio -= bf->supporters_nearby.at(ph) * 20;
+							prio += bf.collecting_producers_nearby.at(ph) * 10;
+							prio -= bf.supporters_nearby.at(ph) * 20;
 						}
 
-						if (bf->enemy_nearby) {
+						if (bf.enemy_nearby) {
 							prio -= 20;
 						}
 
-						if (bf->unowned_portspace_vicinity_nearby > 0) {
+						if (bf.unowned_portspace_vicinity_nearby > 0) {
 							prio -= 500;
 						}
 					}
 
 				} else if (bo.is(BuildingAttribute::kRecruitment)) {
 					prio += bo.primary_priority;
-					prio -= bf->unowned_land_nearby * 2;
-					prio -= (bf->enemy_nearby) * 100;
+					prio -= bf.unowned_land_nearby * 2;
+					prio -= (bf.enemy_nearby) * 100;
 					prio -= (expansion_type.get_expansion_type() != ExpansionMode::kEconomy) * 100;
 				} else {  // finally normal productionsites
 					assert(bo.production_hints.empty());
@@ -3124,41 +3199,41 @@ bool DefaultAI::construct_building(const Time& gametime) {
 
 						if (bo.is(BuildingAttribute::kSpaceConsumer)) {  // e.g. farms
 							// we dont like trees nearby
-							prio += 1 - bf->trees_nearby / 4;
+							prio += 1 - bf.trees_nearby / 4;
 							// we attempt to cluster space consumers together
-							prio += bf->space_consumers_nearby * 2;
+							prio += bf.space_consumers_nearby * 2;
 							// and be far from rangers
-							prio += 1 - bf->rangers_nearby *
+							prio += 1 - bf.rangers_nearby *
 							               std::abs(management_data.get_military_number_at(102)) / 5;
 						} else {
 							// leave some free space between them
-							prio -= bf->collecting_producers_nearby.at(bo.get_collected_map_resource()) *
+							prio -= bf.collecting_producers_nearby.at(bo.get_collected_map_resource()) *
 							        std::abs(management_data.get_military_number_at(108)) / 5;
 						}
 
 						if (bo.is(BuildingAttribute::kSpaceConsumer) &&
-						    bf->water_nearby) {  // not close to water
+						    bf.water_nearby) {  // not close to water
 							prio -= std::abs(management_data.get_military_number_at(103)) / 5;
 						}
 
 						if (bo.is(BuildingAttribute::kSpaceConsumer) &&
-						    bf->unowned_mines_spots_nearby) {  // not close to mountains
+						    bf.unowned_mines_spots_nearby) {  // not close to mountains
 							prio -= std::abs(management_data.get_military_number_at(104)) / 5;
 						}
 						if (bo.is(BuildingAttribute::kSpaceConsumer) &&
-						    bf->unowned_portspace_vicinity_nearby > 0) {  // do not block Ports
+						    bf.unowned_portspace_vicinity_nearby > 0) {  // do not block Ports
 							prio -= 500;
 						}
 						if (bo.is(BuildingAttribute::kNeedsBerry)) {
 							prio += std::abs(management_data.get_military_number_at(13)) *
-							        bf->bushes_nearby / 12;
+							        bf.bushes_nearby / 12;
 						}
 					} else if (bo.is(BuildingAttribute::kShipyard)) {
 						// for now AI builds only one shipyard
 						assert(bo.total_count() == 0);
-						if (bf->open_water_nearby > 3 && map_allows_seafaring_) {
+						if (bf.open_water_nearby > 3 && map_allows_seafaring_) {
 							prio += productionsites.size() * 5 +
-							        bf->open_water_nearby *
+							        bf.open_water_nearby *
 							           std::abs(management_data.get_military_number_at(109)) / 10;
 						} else {
 							continue;
@@ -3178,7 +3253,7 @@ bool DefaultAI::construct_building(const Time& gametime) {
 					// This considers supporters nearby
 					for (auto ph : bo.ware_outputs) {
 						prio += management_data.neuron_pool[52].get_result_safe(
-						           bf->supporters_nearby.at(ph) * 5, kAbsValue) /
+						           bf.supporters_nearby.at(ph) * 5, kAbsValue) /
 						        2;
 					}
 
@@ -3199,7 +3274,7 @@ bool DefaultAI::construct_building(const Time& gametime) {
 					consumers_nearby_count = 0;
 
 					for (const Widelands::DescriptionIndex& output : bo.ware_outputs) {
-						consumers_nearby_count += bf->consumers_nearby.at(output);
+						consumers_nearby_count += bf.consumers_nearby.at(output);
 					}
 
 					if (consumers_nearby_count > 0) {
@@ -3210,8 +3285,8 @@ bool DefaultAI::construct_building(const Time& gametime) {
 				// Consider border with exemption of some huts
 				if (!(bo.is(BuildingAttribute::kLumberjack) || bo.is(BuildingAttribute::kNeedsCoast) ||
 				      bo.is(BuildingAttribute::kFisher))) {
-					prio += recalc_with_border_range(*bf, prio);
-				} else if (bf->near_border && (bo.is(BuildingAttribute::kLumberjack) ||
+					prio += recalc_with_border_range(bf, prio);
+				} else if (bf.near_border && (bo.is(BuildingAttribute::kLumberjack) ||
 				                               bo.is(BuildingAttribute::kNeedsCoast))) {
 					prio /= 2;
 				}
@@ -3222,14 +3297,14 @@ bool DefaultAI::construct_building(const Time& gametime) {
 				prio += bo.primary_priority;
 
 				// Two possibilities why to construct militarysite here
-				if (!bf->defense_msite_allowed &&
-				    (bf->nearest_buildable_spot_nearby < bo.desc->get_conquers() ||
-				     bf->unowned_portspace_vicinity_nearby > 0) &&
-				    (bf->military_in_constr_nearby + bf->military_unstationed) <
+				if (!bf.defense_msite_allowed &&
+				    (bf.nearest_buildable_spot_nearby < bo.desc->get_conquers() ||
+				     bf.unowned_portspace_vicinity_nearby > 0) &&
+				    (bf.military_in_constr_nearby + bf.military_unstationed) <
 				       concurent_ms_in_constr_no_enemy) {
 					// it will conquer new buildable spots for buildings or mines
-				} else if (bf->defense_msite_allowed &&
-				           (bf->military_in_constr_nearby + bf->military_unstationed) <
+				} else if (bf.defense_msite_allowed &&
+				           (bf.military_in_constr_nearby + bf.military_unstationed) <
 				              concurent_ms_in_constr_enemy_nearby) {
 					// we need it to increase capacity on the field
 					if (bo.fighting_type) {
@@ -3238,14 +3313,14 @@ bool DefaultAI::construct_building(const Time& gametime) {
 				} else {
 					continue;
 				}
-				if (bf->unowned_mines_spots_nearby > 2 && bo.mountain_conqueror) {
+				if (bf.unowned_mines_spots_nearby > 2 && bo.mountain_conqueror) {
 					prio += 5;
 				}
 				prio += std::abs(management_data.get_military_number_at(35)) / 5 *
 				        (static_cast<int16_t>(bo.desc->get_conquers()) -
-				         static_cast<int16_t>(bf->nearest_buildable_spot_nearby));
+				         static_cast<int16_t>(bf.nearest_buildable_spot_nearby));
 
-				prio += bf->military_score_;
+				prio += bf.military_score_;
 
 				// if place+building is not good enough
 				if (prio <= persistent_data->target_military_score) {
@@ -3257,11 +3332,11 @@ bool DefaultAI::construct_building(const Time& gametime) {
 			} else if (bo.type == BuildingObserver::Type::kWarehouse) {
 
 				// exclude spots on border
-				if (bf->near_border && !bo.is(BuildingAttribute::kPort)) {
+				if (bf.near_border && !bo.is(BuildingAttribute::kPort)) {
 					continue;
 				}
-				assert(bf->is_portspace != ExtendedBool::kUnset);
-				if (bf->is_portspace != ExtendedBool::kTrue && bo.is(BuildingAttribute::kPort)) {
+				assert(bf.is_portspace != ExtendedBool::kUnset);
+				if (bf.is_portspace != ExtendedBool::kTrue && bo.is(BuildingAttribute::kPort)) {
 					continue;
 				}
 				prio += bo.primary_priority;
@@ -3271,7 +3346,7 @@ bool DefaultAI::construct_building(const Time& gametime) {
 				uint16_t nearest_distance = std::numeric_limits<uint16_t>::max();
 				for (const WarehouseSiteObserver& wh_obs : warehousesites) {
 					const uint16_t actual_distance =
-					   map.calc_distance(bf->coords, wh_obs.site->get_position());
+					   map.calc_distance(bf.coords, wh_obs.site->get_position());
 					nearest_distance = std::min(nearest_distance, actual_distance);
 				}
 				// but limit to 30
@@ -3283,15 +3358,15 @@ bool DefaultAI::construct_building(const Time& gametime) {
 				prio +=
 				   management_data.neuron_pool[47].get_result_safe(nearest_distance / 2, kAbsValue) / 2;
 
-				prio += bf->own_non_military_nearby * 3;
+				prio += bf.own_non_military_nearby * 3;
 
 				// dont be close to enemies
-				if (bf->enemy_nearby) {
+				if (bf.enemy_nearby) {
 					prio -= 40;
 				}
 
 				// being too close to a border is not good either
-				if ((bf->unowned_land_nearby || bf->enemy_owned_land_nearby > 10) &&
+				if ((bf.unowned_land_nearby || bf.enemy_owned_land_nearby > 10) &&
 				    !bo.is(BuildingAttribute::kPort) && prio > 0) {
 					prio /= 2;
 					prio -= 10;
@@ -3305,23 +3380,23 @@ bool DefaultAI::construct_building(const Time& gametime) {
 				prio += bo.primary_priority;
 
 				// for spots close to a border
-				if (bf->near_border) {
+				if (bf.near_border) {
 					prio -= 5;
 				}
 
 				// take care about borders and enemies
-				if (bf->enemy_nearby) {
+				if (bf.enemy_nearby) {
 					prio -= 20;
 				}
 
-				if (bf->unowned_land_nearby || bf->enemy_owned_land_nearby) {
+				if (bf.unowned_land_nearby || bf.enemy_owned_land_nearby) {
 					prio -= 15;
 				}
 			}
 
 			// think of space consuming buildings nearby like farms or vineyards
 			if (bo.type != BuildingObserver::Type::kMilitarysite) {
-				prio -= bf->space_consumers_nearby * 10;
+				prio -= bf.space_consumers_nearby * 10;
 			}
 
 			// Stop here, if priority is 0 or less.
@@ -3330,22 +3405,22 @@ bool DefaultAI::construct_building(const Time& gametime) {
 			}
 
 			// Prefer road side fields
-			prio += bf->preferred ? 5 : 0;
+			prio += bf.preferred ? 5 : 0;
 
 			// don't waste good land for small huts
 			const bool space_stress = (spots_avail.at(Widelands::BUILDCAPS_MEDIUM) < 5 ||
 			                           spots_avail.at(Widelands::BUILDCAPS_BIG) < 5);
 
 			if (space_stress && bo.type == BuildingObserver::Type::kMilitarysite) {
-				prio -= (bf->max_buildcap_nearby - bo.desc->get_size()) * 10;
+				prio -= (bf.max_buildcap_nearby - bo.desc->get_size()) * 10;
 			} else if (space_stress) {
-				prio -= (bf->max_buildcap_nearby - bo.desc->get_size()) * 30;
+				prio -= (bf.max_buildcap_nearby - bo.desc->get_size()) * 30;
 			} else {
-				prio -= (bf->max_buildcap_nearby - bo.desc->get_size()) * 5;
+				prio -= (bf.max_buildcap_nearby - bo.desc->get_size()) * 5;
 			}
 
 			// prefer vicinity of ports (with exemption of warehouses)
-			if (bf->port_nearby && bo.type == BuildingObserver::Type::kMilitarysite) {
+			if (bf.port_nearby && bo.type == BuildingObserver::Type::kMilitarysite) {
 				prio *= 2;
 			}
 
@@ -3362,7 +3437,7 @@ bool DefaultAI::construct_building(const Time& gametime) {
 			if (prio > proposed_priority) {
 				best_building = &bo;
 				proposed_priority = prio;
-				proposed_coords = bf->coords;
+				proposed_coords = bf.coords;
 			}
 		}  // ending loop over buildings
 	}     // ending loop over fields
@@ -3394,23 +3469,23 @@ bool DefaultAI::construct_building(const Time& gametime) {
 				}
 
 				// iterating over fields
-				for (MineableField* const mf : mineable_fields) {
-					if (mf->field_info_expiration <= gametime) {
+				for (const MineableField& mf : mineable_fields) {
+					if (mf.field_info_expiration <= gametime) {
 						continue;
 					}
 
-					if (mf->coords.field->get_resources() != bo.mines) {
+					if (mf.coords.field->get_resources() != bo.mines) {
 						continue;
 					}
 
 					// Continue if field is blocked at the moment
-					if (blocked_fields.is_blocked(mf->coords)) {
+					if (blocked_fields.is_blocked(mf.coords)) {
 						continue;
 					}
 
 					int32_t prio = 0;
 					Widelands::MapRegion<Widelands::Area<Widelands::FCoords>> mr(
-					   map, Widelands::Area<Widelands::FCoords>(mf->coords, 2));
+					   map, Widelands::Area<Widelands::FCoords>(mf.coords, 2));
 					do {
 						if (bo.mines == mr.location().field->get_resources()) {
 							prio += mr.location().field->get_resources_amount();
@@ -3425,7 +3500,7 @@ bool DefaultAI::construct_building(const Time& gametime) {
 					}
 
 					// applying nearnest penalty
-					prio -= mf->mines_nearby * std::abs(management_data.get_military_number_at(126));
+					prio -= mf.mines_nearby * std::abs(management_data.get_military_number_at(126));
 
 					// applying max needed
 					prio += bo.primary_priority;
@@ -3435,22 +3510,22 @@ bool DefaultAI::construct_building(const Time& gametime) {
 					// depending on count of same mines nearby,
 					// though this does not reflects how many resources
 					// are (left) in nearby mines
-					prio += mf->same_mine_fields_nearby;
+					prio += mf.same_mine_fields_nearby;
 
 					// Continue if field is blocked at the moment
-					if (blocked_fields.is_blocked(mf->coords)) {
+					if (blocked_fields.is_blocked(mf.coords)) {
 						continue;
 					}
 
 					// Prefer road side fields
-					prio += mf->preferred ? 1 : 0;
+					prio += mf.preferred ? 1 : 0;
 
 					prio += bo.primary_priority;
 
 					if (prio > proposed_priority) {
 						best_building = &bo;
 						proposed_priority = prio;
-						proposed_coords = mf->coords;
+						proposed_coords = mf.coords;
 						mine = true;
 					}
 
@@ -4082,19 +4157,31 @@ bool DefaultAI::create_shortcut_road(const Widelands::Flag& flag,
 	}
 
 	// now we walk over roads and if field is reachable by roads, we change the distance assigned
-	// above
-	std::map<uint32_t, NearFlag> nearflags;  // only used to collect flags reachable walk over roads
-	nearflags[flag.get_position().hash()] = NearFlag(&flag, 0);
+	// above. The walk is only repeated after the roads around the flag have changed.
+	const uint32_t flag_hash = flag.get_position().hash();
+	const FlagConnections::RoadDistances* road_distances =
+	   flag_connections_.get_road_distances(flag_hash, checkradius);
+	if (road_distances == nullptr) {
+		// only used to collect flags reachable walk over roads
+		std::map<uint32_t, NearFlag> nearflags;
+		nearflags[flag_hash] = NearFlag(&flag, 0);
 
-	collect_nearflags(nearflags, flag, checkradius);
+		collect_nearflags(nearflags, flag, checkradius);
+
+		FlagConnections::RoadDistances distances;
+		for (const auto& nf_walk : nearflags) {
+			distances[nf_walk.first] = nf_walk.second.current_road_distance;
+		}
+		road_distances = &flag_connections_.set_road_distances(
+		   flag.get_position(), checkradius, std::move(distances));
+	}
 
 	// Sending calculated walking costs from nearflags to RoadCandidates to update info on
 	// Candidate flags/roads
-	for (auto& nf_walk : nearflags) {
-		const uint32_t nf_hash = nf_walk.second.flag->get_position().hash();
-		// NearFlag contains also flags beyond check radius, these are not relevant for us
-		if (flag_candidates.has_candidate(nf_hash)) {
-			flag_candidates.set_cur_road_distance(nf_hash, nf_walk.second.current_road_distance);
+	for (const auto& road_distance : *road_distances) {
+		// Distances are known also for flags beyond check radius, these are not relevant for us
+		if (flag_candidates.has_candidate(road_distance.first)) {
+			flag_candidates.set_cur_road_distance(road_distance.first, road_distance.second);
 		}
 	}
 
@@ -4123,15 +4210,22 @@ bool DefaultAI::create_shortcut_road(const Widelands::Flag& flag,
 		if (possible_roads_count > 10) {
 			break;
 		}
-		const Widelands::Coords coords = Widelands::Coords::unhash(flag_candidate.coords_hash);
-		Widelands::Path path;
+		int32_t road_length;
+		if (!flag_connections_.get_road_length(
+		       flag_hash, flag_candidate.coords_hash, fields_necessity, gametime, &road_length)) {
+			const Widelands::Coords coords = Widelands::Coords::unhash(flag_candidate.coords_hash);
+			Widelands::Path path;
 
-		// value of pathcost is not important, it just indicates, that the path can be built
+			// value of pathcost is not important, it just indicates, that the path can be built
+			const int32_t pathcost =
+			   map.findpath(flag.get_position(), coords, 0, path, check, 0, fields_necessity);
+			road_length = (pathcost >= 0) ? path.get_nsteps() : -1;
+			flag_connections_.set_road_length(
+			   flag_hash, flag_candidate.coords_hash, fields_necessity, road_length, gametime);
+		}
 		// We send this information to RoadCandidates, with length of possible road if applicable
-		const int32_t pathcost =
-		   map.findpath(flag.get_position(), coords, 0, path, check, 0, fields_necessity);
-		if (pathcost >= 0) {
-			flag_candidates.set_road_possible(flag_candidate.coords_hash, path.get_nsteps());
+		if (road_length >= 0) {
+			flag_candidates.set_road_possible(flag_candidate.coords_hash, road_length);
 			++possible_roads_count;
 		}
 	}
@@ -4146,6 +4240,17 @@ bool DefaultAI::create_shortcut_road(const Widelands::Flag& flag,
 	if (winner) {
 		const Widelands::Coords target_coords = Widelands::Coords::unhash(winner->coords_hash);
 
+		// The length of the road may have been remembered from an earlier check and something
+		// may block the road by now
+		Widelands::Path* path = new Widelands::Path();
+		if (map.findpath(flag.get_position(), target_coords, 0, *path, check, 0, fields_necessity) <
+		    0) {
+			delete path;
+			flag_connections_.set_road_length(
+			   flag_hash, winner->coords_hash, fields_necessity, -1, gametime);
+			return false;
+		}
+
 		// This is to prohibit the flag for some time but with exemption of warehouse
 		if (flag_warehouse_distance.get_distance(winner->coords_hash, gametime, &tmp_wh) > 0) {
 			flag_warehouse_distance.set_road_built(winner->coords_hash, gametime);
@@ -4155,15 +4260,7 @@ bool DefaultAI::create_shortcut_road(const Widelands::Flag& flag,
 		   flag.get_position().hash(), winner->start_flag_dist_to_wh + winner->possible_road_distance,
 		   gametime, 0);  // faking the warehouse
 
-		Widelands::Path& path = *new Widelands::Path();
-#ifndef NDEBUG
-		const int32_t pathcost =
-		   map.findpath(flag.get_position(), target_coords, 0, path, check, 0, fields_necessity);
-		assert(pathcost >= 0);
-#else
-		map.findpath(flag.get_position(), target_coords, 0, path, check, 0, fields_necessity);
-#endif
-		game().send_player_build_road(player_number(), path);
+		game().send_player_build_road(player_number(), *path);
 		return true;
 	}
 	// We can't build a road so let's block the vicinity as an indication this area is not
@@ -4211,35 +4308,33 @@ void DefaultAI::collect_nearflags(std::map<uint32_t, NearFlag>& nearflags,
                                   const Widelands::Flag& flag,
                                   const uint16_t checkradius) {
 	// Algorithm to walk on roads
-	// All nodes are marked as to_be_checked == true first and once the node is checked it is changed
-	// to false. Under some conditions, the same node can be checked twice, the to_be_checked can
-	// be set back to true. Because less hoops (fewer flag-to-flag roads) does not always mean
-	// shortest road.
+	// The flags are checked in the order of their road distance from the starting flag, the
+	// nearest first. When a shorter connection to a flag is found, the flag is queued once more,
+	// because less hoops (fewer flag-to-flag roads) does not always mean shortest road. Queued
+	// entries with an outdated distance are skipped.
 
 	const Widelands::Map& map = game().map();
 
-	for (;;) {
-		// looking for a node with shortest existing road distance from starting flag and one that has
-		// to be checked
-		uint32_t start_field = kNoField;
-		uint32_t nearest_distance = 10000;
-		for (auto item : nearflags) {
-			if (item.second.current_road_distance < nearest_distance && item.second.to_be_checked) {
-				nearest_distance = item.second.current_road_distance;
-				start_field = item.first;
-			}
-		}
-		// OK, we failed to find a NearFlag where to_be_checked == true, so quitting the loop now
-		if (start_field == kNoField) {
-			break;
+	std::priority_queue<NearFlag> queue;
+	for (const auto& item : nearflags) {
+		queue.push(item.second);
+	}
+
+	while (!queue.empty()) {
+		const NearFlag queued = queue.top();
+		queue.pop();
+		const uint32_t start_field = queued.flag->get_position().hash();
+		NearFlag& start = nearflags[start_field];
+		if (!start.to_be_checked || queued.current_road_distance > start.current_road_distance) {
+			continue;
 		}
 
-		nearflags[start_field].to_be_checked = false;
+		start.to_be_checked = false;
 
 		// Now going over roads leading from this flag
 		for (uint8_t i = Widelands::WalkingDir::FIRST_DIRECTION;
 		     i <= Widelands::WalkingDir::LAST_DIRECTION; ++i) {
-			Widelands::Road* const road = nearflags[start_field].flag->get_road(i);
+			Widelands::Road* const road = start.flag->get_road(i);
 
 			if (!road) {
 				continue;
@@ -4247,7 +4342,7 @@ void DefaultAI::collect_nearflags(std::map<uint32_t, NearFlag>& nearflags,
 
 			Widelands::Flag* endflag = &road->get_flag(Widelands::Road::FlagStart);
 
-			if (endflag == nearflags[start_field].flag) {
+			if (endflag == start.flag) {
 				endflag = &road->get_flag(Widelands::Road::FlagEnd);
 			}
 
@@ -4259,24 +4354,23 @@ void DefaultAI::collect_nearflags(std::map<uint32_t, NearFlag>& nearflags,
 				continue;
 			}
 
+			const uint32_t new_distance = start.current_road_distance + road->get_path().get_nsteps();
+
 			// There is few scenarios for this neighbour flag
-			if (nearflags.count(endflag_hash) == 0) {
+			auto it = nearflags.find(endflag_hash);
+			if (it == nearflags.end()) {
 				// This is brand new flag
-				// calculating diff how much closer we will get to the flag
-				nearflags[endflag_hash] =
-				   NearFlag(endflag, nearflags[start_field].current_road_distance +
-				                        road->get_path().get_nsteps());
+				it = nearflags.insert(std::make_pair(endflag_hash, NearFlag(endflag, new_distance)))
+				        .first;
+			} else if (it->second.current_road_distance > new_distance) {
+				// We know about this flag already, but this current connection is shorter than one
+				// found before. So let re-check neighbours once more
+				it->second.current_road_distance = new_distance;
+				it->second.to_be_checked = true;
 			} else {
-				// We know about this flag already
-				if (nearflags[endflag_hash].current_road_distance >
-				    nearflags[start_field].current_road_distance + road->get_path().get_nsteps()) {
-					// ..but this current connection is shorter than one found before
-					nearflags[endflag_hash].current_road_distance =
-					   nearflags[start_field].current_road_distance + road->get_path().get_nsteps();
-					// So let re-check neighbours once more
-					nearflags[endflag_hash].to_be_checked = true;
-				}
+				continue;
 			}
+			queue.push(it->second);
 		}
 	}
 }
@@ -5153,7 +5247,8 @@ BuildingNecessity DefaultAI::check_building_necessity(BuildingObserver& bo,
                                                       const Time& gametime) {
 	bo.primary_priority = 0;
 
-	static BasicEconomyBuildingStatus site_needed_for_economy = BasicEconomyBuildingStatus::kNone;
+	thread_local BasicEconomyBuildingStatus site_needed_for_economy =
+	   BasicEconomyBuildingStatus::kNone;
 	site_needed_for_economy = BasicEconomyBuildingStatus::kNone;
 	if (gametime > Time(2 * 60 * 1000) && gametime < Time(120 * 60 * 1000) &&
 	    !basic_economy_established) {
@@ -5415,7 +5510,7 @@ BuildingNecessity DefaultAI::check_building_necessity(BuildingObserver& bo,
 				return BuildingNecessity::kForbidden;
 			}
 
-			static int16_t inputs[kFNeuronBitSize] = {0};
+			thread_local int16_t inputs[kFNeuronBitSize] = {0};
 			// Reseting values as the variable is static
 			for (int i = 0; i < kFNeuronBitSize; i++) {
 				inputs[i] = 0;
@@ -5515,9 +5610,9 @@ BuildingNecessity DefaultAI::check_building_necessity(BuildingObserver& bo,
 			}
 
 			// genetic algorithm to decide whether new rangers are needed
-			static int16_t tmp_target = 2;
+			thread_local int16_t tmp_target = 2;
 			tmp_target = 2;
-			static int16_t inputs[2 * kFNeuronBitSize] = {0};
+			thread_local int16_t inputs[2 * kFNeuronBitSize] = {0};
 			// Reseting values as the variable is static
 			for (int i = 0; i < 2 * kFNeuronBitSize; i++) {
 				inputs[i] = 0;
@@ -5758,7 +5853,7 @@ BuildingNecessity DefaultAI::check_building_necessity(BuildingObserver& bo,
 				return BuildingNecessity::kForbidden;
 			}
 
-			static int16_t inputs[kFNeuronBitSize] = {0};
+			thread_local int16_t inputs[kFNeuronBitSize] = {0};
 			// Reseting values as the variable is static
 			for (int i = 0; i < kFNeuronBitSize; i++) {
 				inputs[i] = 0;
@@ -5825,7 +5920,7 @@ BuildingNecessity DefaultAI::check_building_necessity(BuildingObserver& bo,
 
 		} else if (bo.max_needed_preciousness > 0) {
 
-			static int16_t inputs[4 * kFNeuronBitSize] = {0};
+			thread_local int16_t inputs[4 * kFNeuronBitSize] = {0};
 			// Reseting values as the variable is static
 			for (int i = 0; i < 4 * kFNeuronBitSize; i++) {
 				inputs[i] = 0;
@@ -6832,6 +6927,7 @@ void DefaultAI::update_player_stat(const Time& gametime) {
 				player_statistics.add(pn, j, me->team_number(), this_player->team_number(),
 				                      cur_strength, old_strength, old60_strength, cass, cur_land,
 				                      old_land, old60_land);
+				military_influence_.set_hostile(j, player_statistics.get_is_enemy(j));
 			} catch (const std::out_of_range&) {
 				log_warn_time(gametime, "ComputerPlayer(%d): genstats entry missing - size :%d\n",
 				              static_cast<unsigned int>(player_number()),
@@ -6891,36 +6987,12 @@ void DefaultAI::review_wares_targets(const Time& gametime) {
 
 // Sets due_time based on job ID
 void DefaultAI::set_taskpool_task_time(const Time& gametime, const SchedulerTaskId task) {
-
-	for (auto& item : taskPool) {
-		if (item.id == task) {
-			item.due_time = gametime;
-			return;
-		}
-	}
-	NEVER_HERE();
+	scheduler_.set_due_time(task, gametime);
 }
 
 // Retrieves due time of the task based on its ID
 const Time& DefaultAI::get_taskpool_task_time(const SchedulerTaskId task) {
-	for (const auto& item : taskPool) {
-		if (item.id == task) {
-			return item.due_time;
-		}
-	}
-
-	throw wexception("AI internal error: nonexistent task.");
-}
-
-// This performs one "iteration" of sorting based on due_time
-// We by design do not need full sorting...
-void DefaultAI::sort_task_pool() {
-	assert(!taskPool.empty());
-	for (int8_t i = taskPool.size() - 1; i > 0; --i) {
-		if (taskPool[i - 1].due_time > taskPool[i].due_time) {
-			std::iter_swap(taskPool.begin() + i - 1, taskPool.begin() + i);
-		}
-	}
+	return scheduler_.get_due_time(task);
 }
 
 // following two functions count mines of the same type (same output,
@@ -6972,6 +7044,15 @@ void DefaultAI::print_stats(const Time& gametime) {
 
 	Widelands::PlayerNumber const pn = player_number();
 
+	// Real time the scheduler tasks took so far
+	log_dbg_time(gametime, " AI %1d: %-28s %6s %9s %9s\n", pn, "Scheduler task", "runs", "avg. us",
+	             "max. us");
+	for (const SchedulerTask& task : scheduler_.tasks()) {
+		const TaskScheduler::TaskCost& cost = scheduler_.get_cost(task.id);
+		log_dbg_time(gametime, "        %-28s %6u %9u %9u\n", task.descr.c_str(), cost.runs,
+		             cost.average_us(), cost.max_us);
+	}
+
 	const Widelands::DescriptionIndex& nr_buildings = game().tribes().nrbuildings();
 	std::set<Widelands::DescriptionIndex> materials;
 
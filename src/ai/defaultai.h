@@ -22,9 +22,11 @@
 #define WL_AI_DEFAULTAI_H
 
 #include <memory>
+#include <unordered_map>
 
 #include "ai/ai_help_structs.h"
 #include "ai/computer_player.h"
+#include "ai/world_analysis.h"
 #include "base/i18n.h"
 #include "economy/economy.h"
 #include "logic/map_objects/immovable.h"
@@ -172,6 +174,10 @@ private:
 	void update_all_mineable_fields(const Time&);
 	void update_all_not_buildable_fields();
 	void update_buildable_field(BuildableField&);
+	uint8_t classify_field(const Widelands::FCoords&);
+	void update_field_classes(int16_t rows_to_refresh = 0);
+	void invalidate_field_classes(const Widelands::Coords&, uint16_t radius);
+	void update_military_influence(const Widelands::Building&);
 	void update_mineable_field(MineableField&);
 	void update_productionsite_stats();
 
@@ -179,7 +185,6 @@ private:
 	BuildingNecessity
 	check_building_necessity(BuildingObserver& bo, PerfEvaluation purpose, const Time&);
 	BuildingNecessity check_warehouse_necessity(BuildingObserver&, const Time& gametime);
-	void sort_task_pool();
 	void sort_by_priority();
 	void set_taskpool_task_time(const Time&, SchedulerTaskId);
 	const Time& get_taskpool_task_time(SchedulerTaskId);
@@ -198,6 +203,8 @@ private:
 	// calculating distances from local warehouse to flags
 	void check_flag_distances(const Time&);
 	FlagWarehouseDistances flag_warehouse_distance;
+	// Road distances and possible roads around flags, for create_shortcut_road()
+	FlagConnections flag_connections_;
 
 	bool check_economies();
 	bool check_productionsites(const Time&);
@@ -287,24 +294,33 @@ private:
 	EventTimeQueue soldier_attacks_log;
 
 	// used by AI scheduler
-	uint32_t sched_stat_[20] = {0};
 	Time next_ai_think_;
 	// this is helping counter to track how many scheduler tasks are too delayed
 	// the purpose is to print out a warning that the game is pacing too fast
 	int32_t scheduler_delay_counter_;
+	// productionsites and mines that are left to check in the current round; a round that
+	// doesn't fit into the time budget of a think goes on in the next think
+	uint32_t productionsites_left_to_check_;
+	uint32_t mines_left_to_check_;
 
 	WoodPolicy wood_policy_;
 	uint16_t trees_nearby_treshold_;
 
 	std::vector<BuildingObserver> buildings_;
 	std::deque<Widelands::FCoords> unusable_fields;
-	std::deque<BuildableField*> buildable_fields;
+	FieldRotation<BuildableField> buildable_fields;
 	BlockedFields blocked_fields;
-	std::unordered_set<uint32_t> ports_vicinity;
+	// Shared with the other computer players of the game
+	std::shared_ptr<WorldAnalysis> world_analysis_;
+	FieldClassCounts field_classes_;
+	// Growing trees and changed teams are not notified, so the rows are classified again in turns
+	int16_t field_classes_next_row_ = 0;
+	// Buildings of the other players, updated by notes
+	MilitaryInfluence military_influence_;
 	PlayersStrengths player_statistics;
 	ManagementData management_data;
 	ExpansionType expansion_type;
-	std::deque<MineableField*> mineable_fields;
+	FieldRotation<MineableField> mineable_fields;
 	std::deque<Widelands::Flag const*> new_flags;
 	std::deque<Widelands::Road const*> roads;
 	std::deque<EconomyObserver*> economies;
@@ -315,13 +331,12 @@ private:
 	std::deque<TrainingSiteObserver> trainingsites;
 	std::deque<ShipObserver> allships;
 	std::vector<WareObserver> wares;
-	// This is a vector that is filled up on initiatlization
-	// and no items are added/removed afterwards
-	std::vector<SchedulerTask> taskPool;
-	std::map<uint32_t, EnemySiteObserver> enemy_sites;
+	// This is filled up on initiatlization and no tasks are added/removed afterwards
+	TaskScheduler scheduler_;
+	std::unordered_map<uint32_t, EnemySiteObserver> enemy_sites;
 	std::set<uint32_t> enemy_warehouses;
 	// it will map mined material to observer
-	std::map<int32_t, MineTypesObserver> mines_per_type;
+	std::unordered_map<int32_t, MineTypesObserver> mines_per_type;
 	std::vector<uint32_t> spots_avail;
 	MineFieldsObserver mine_fields_stat;
 
@@ -383,9 +398,9 @@ private:
 
 	// seafaring related
 	enum { kReprioritize, kStopShipyard, kStapShipyard };
-	static Time last_seafaring_check_;
+	static thread_local Time last_seafaring_check_;
 	// False by default, until Map::allows_seafaring() is true
-	static bool map_allows_seafaring_;
+	static thread_local bool map_allows_seafaring_;
 	uint32_t expedition_ship_;
 	Duration expedition_max_duration;
 	std::vector<int16_t> marine_task_queue;
@@ -402,11 +417,14 @@ private:
 	std::unique_ptr<Notifications::Subscriber<Widelands::NoteFieldPossession>>
 	   field_possession_subscriber_;
 	std::unique_ptr<Notifications::Subscriber<Widelands::NoteImmovable>> immovable_subscriber_;
+	std::unique_ptr<Notifications::Subscriber<Widelands::NoteFieldTerrainChanged>>
+	   terrain_subscriber_;
 	std::unique_ptr<Notifications::Subscriber<Widelands::NoteProductionSiteOutOfResources>>
 	   outofresource_subscriber_;
 	std::unique_ptr<Notifications::Subscriber<Widelands::NoteTrainingSiteSoldierTrained>>
 	   soldiertrained_subscriber_;
 	std::unique_ptr<Notifications::Subscriber<Widelands::NoteShip>> shipnotes_subscriber_;
+	std::unique_ptr<Notifications::Subscriber<Widelands::NoteBuilding>> buildingnotes_subscriber_;
 };
 
 }  // namespace AI
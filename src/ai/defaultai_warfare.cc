@@ -65,7 +65,7 @@ bool DefaultAI::check_enemy_sites(const Time& gametime) {
 		Widelands::FCoords f = map.get_fcoords(ms->get_position());
 
 		// get list of immovable around this our military site
-		static std::vector<Widelands::ImmovableFound> immovables;
+		thread_local std::vector<Widelands::ImmovableFound> immovables;
 		immovables.clear();
 		immovables.reserve(40);
 		map.find_immovables(
@@ -106,7 +106,7 @@ bool DefaultAI::check_enemy_sites(const Time& gametime) {
 	uint8_t best_score = 0;
 	uint32_t count = 0;
 	// sites that were either conquered or destroyed
-	static std::vector<uint32_t> disappeared_sites;
+	thread_local std::vector<uint32_t> disappeared_sites;
 	disappeared_sites.clear();
 	disappeared_sites.reserve(6);
 
@@ -196,6 +196,9 @@ bool DefaultAI::check_enemy_sites(const Time& gametime) {
 				defenders = wh->soldier_control()->present_soldiers();
 				defenders_strength = calculate_strength(defenders);
 
+				// Soldiers entering a warehouse are not notified
+				update_military_influence(*wh);
+
 				flag = &wh->base_flag();
 				is_warehouse = true;
 				if (is_visible && wh->attack_target()->can_be_attacked()) {
@@ -271,50 +274,25 @@ bool DefaultAI::check_enemy_sites(const Time& gametime) {
 					                   player_statistics.get_old60_player_land(pn);
 				}
 
-				static std::vector<Widelands::ImmovableFound> immovables;
-				immovables.reserve(50);
-				immovables.clear();
-				static std::set<uint32_t> unique_serials;
-				unique_serials.clear();
-				// find militarysites near our target (radius 10) to check enemies power in region
-				map.find_immovables(game(),
-				                    Widelands::Area<Widelands::FCoords>(
-				                       map.get_fcoords(Widelands::Coords::unhash(observer.first)), 10),
-				                    &immovables);
-				for (const Widelands::ImmovableFound& im_found : immovables) {
-					const Widelands::BaseImmovable& base_immovable = *im_found.object;
-
-					if (!unique_serials.insert(base_immovable.serial()).second) {
-						continue;  // serial was not inserted in the set, so this is duplicate
-					}
-
-					// testing vicinity of the enemy building
-					if (upcast(Widelands::Building const, building, &base_immovable)) {
-
-						const Widelands::PlayerNumber bpn = building->owner().player_number();
-						if (player_statistics.get_is_enemy(bpn)) {  // owned by enemy
-							assert(!player_statistics.players_in_same_team(bpn, pn));
-							if (upcast(Widelands::MilitarySite const, militarysite, building)) {
-								// adding up enemies soldiers in region but not the one that can't move
-								// out to intercept our attackers
-								enemy_military_presence_in_region_ +=
-								   (militarysite->soldier_control()->stationed_soldiers().size() - 1);
-								// counting enemies buildings
-								++enemy_military_sites_in_region_;
-							}
-							// Warehouses are counted here too as they can host soldiers as well
-							if (upcast(Widelands::Warehouse const, warehouse, building)) {
-								enemy_military_presence_in_region_ +=
-								   warehouse->soldier_control()->stationed_soldiers().size();
-								++enemy_military_sites_in_region_;
-							}
-						}
-					}
-				}
+				// enemies power in the region of our target (radius 10), not counting the soldiers
+				// that can't move out of militarysites to intercept our attackers
+				const Widelands::Coords target = Widelands::Coords::unhash(observer.first);
+				const uint32_t soldiers_in_region =
+				   military_influence_.sum(target, 10, MilitaryInfluence::kEnemySoldiers);
+				const uint32_t militarysites_in_region =
+				   military_influence_.sum(target, 10, MilitaryInfluence::kEnemyMilitarySites);
+				enemy_military_presence_in_region_ =
+				   soldiers_in_region > militarysites_in_region ?
+				      soldiers_in_region - militarysites_in_region :
+				      0;
+				// Warehouses are counted here too as they can host soldiers as well
+				enemy_military_sites_in_region_ =
+				   militarysites_in_region +
+				   military_influence_.sum(target, 10, MilitaryInfluence::kEnemyWarehouses);
 				observer.second.enemy_military_presence_in_region = enemy_military_presence_in_region_;
 				observer.second.enemy_military_sites_in_region = enemy_military_sites_in_region_;
 
-				static int16_t inputs[4 * kFNeuronBitSize] = {0};
+				thread_local int16_t inputs[4 * kFNeuronBitSize] = {0};
 				// Reseting values as the variable is static
 				for (int j = 0; j < 4 * kFNeuronBitSize; j++) {
 					inputs[j] = 0;
@@ -1124,7 +1102,7 @@ BuildingNecessity DefaultAI::check_building_necessity(BuildingObserver& bo, cons
 	                         3)};
 	const uint16_t total_score = scores[0] + scores[1] + scores[2];
 
-	static int32_t inputs[4 * kFNeuronBitSize] = {0};
+	thread_local int32_t inputs[4 * kFNeuronBitSize] = {0};
 	// Reseting values as the variable is static
 	for (int i = 0; i < 4 * kFNeuronBitSize; i++) {
 		inputs[i] = 0;
@@ -21,6 +21,7 @@
 
 #include "ai/ai_help_structs.h"
 #include "base/macros.h"
+#include "base/wexception.h"
 
 // Triggered by BOOST_AUTO_TEST_CASE
 CLANG_DIAG_OFF("-Wdisabled-macro-expansion")
@@ -230,3 +231,308 @@ BOOST_AUTO_TEST_CASE(flag_has_candidate) {
 }
 
 BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(field_class_counts)
+
+BOOST_AUTO_TEST_CASE(field_class_counts_area_size) {
+	AI::FieldClassCounts fcc;
+	fcc.init(16, 16);
+	for (int16_t y = 0; y < 16; ++y) {
+		for (int16_t x = 0; x < 16; ++x) {
+			fcc.set(Widelands::Coords(x, y), 1 << AI::FieldClassCounts::kUnownedWalkable);
+		}
+	}
+	for (uint16_t radius = 0; radius < 8; ++radius) {
+		// Wrapping around the map edge must not make a difference
+		BOOST_CHECK_EQUAL(fcc.count(Widelands::Coords(7, 8), radius,
+		                            AI::FieldClassCounts::kUnownedWalkable),
+		                  3 * radius * radius + 3 * radius + 1);
+		BOOST_CHECK_EQUAL(fcc.count(Widelands::Coords(0, 15), radius,
+		                            AI::FieldClassCounts::kUnownedWalkable),
+		                  3 * radius * radius + 3 * radius + 1);
+		BOOST_CHECK_EQUAL(
+		   fcc.count(Widelands::Coords(7, 8), radius, AI::FieldClassCounts::kEnemyWalkable), 0);
+	}
+	// Like Map::find_fields, nodes are counted several times if the area overlaps itself
+	AI::FieldClassCounts small;
+	small.init(4, 4);
+	for (int16_t y = 0; y < 4; ++y) {
+		for (int16_t x = 0; x < 4; ++x) {
+			small.set(Widelands::Coords(x, y), 1 << AI::FieldClassCounts::kAllyWalkable);
+		}
+	}
+	BOOST_CHECK_EQUAL(
+	   small.count(Widelands::Coords(1, 1), 3, AI::FieldClassCounts::kAllyWalkable), 37);
+}
+
+BOOST_AUTO_TEST_CASE(field_class_counts_neighbours) {
+	AI::FieldClassCounts fcc;
+	fcc.init(16, 16);
+	// Above an even row the neighbours are the node with the same x and the one left of it
+	fcc.set(Widelands::Coords(3, 3), 1 << AI::FieldClassCounts::kUnownedBuildable);
+	fcc.set(Widelands::Coords(4, 3), 1 << AI::FieldClassCounts::kUnownedBuildable);
+	fcc.set(Widelands::Coords(5, 3), 1 << AI::FieldClassCounts::kUnownedBuildable);
+	BOOST_CHECK_EQUAL(
+	   fcc.count(Widelands::Coords(4, 4), 1, AI::FieldClassCounts::kUnownedBuildable), 2);
+	BOOST_CHECK_EQUAL(
+	   fcc.count(Widelands::Coords(4, 4), 0, AI::FieldClassCounts::kUnownedBuildable), 0);
+
+	// Above an odd row it is the node with the same x and the one right of it
+	fcc.set(Widelands::Coords(3, 4), 1 << AI::FieldClassCounts::kUnownedBuildable);
+	fcc.set(Widelands::Coords(4, 4), 1 << AI::FieldClassCounts::kUnownedBuildable);
+	fcc.set(Widelands::Coords(5, 4), 1 << AI::FieldClassCounts::kUnownedBuildable);
+	BOOST_CHECK_EQUAL(
+	   fcc.count(Widelands::Coords(4, 5), 1, AI::FieldClassCounts::kUnownedBuildable), 2);
+	BOOST_CHECK_EQUAL(
+	   fcc.count(Widelands::Coords(4, 4), 0, AI::FieldClassCounts::kUnownedBuildable), 1);
+
+	// Changed nodes are seen by the next query
+	fcc.set(Widelands::Coords(4, 4), 0);
+	BOOST_CHECK_EQUAL(
+	   fcc.count(Widelands::Coords(4, 5), 1, AI::FieldClassCounts::kUnownedBuildable), 1);
+	BOOST_CHECK(fcc.has(Widelands::Coords(5, 4), AI::FieldClassCounts::kUnownedBuildable));
+	BOOST_CHECK(!fcc.has(Widelands::Coords(4, 4), AI::FieldClassCounts::kUnownedBuildable));
+}
+
+BOOST_AUTO_TEST_CASE(field_class_counts_invalidate) {
+	AI::FieldClassCounts fcc;
+	// Nothing is collected before the grid exists
+	fcc.invalidate(Widelands::Coords(1, 1));
+	fcc.init(8, 8);
+	BOOST_CHECK(fcc.take_invalidated().empty());
+	fcc.invalidate(Widelands::Coords(1, 1));
+	fcc.invalidate(Widelands::Coords(2, 1));
+	BOOST_CHECK_EQUAL(fcc.take_invalidated().size(), 2);
+	BOOST_CHECK(fcc.take_invalidated().empty());
+}
+
+BOOST_AUTO_TEST_CASE(field_class_counts_own_classes) {
+	AI::FieldClassCounts fcc;
+	fcc.init(8, 8, 2);
+	fcc.set(Widelands::Coords(2, 2), 1 << 0 | 1 << 1);
+	fcc.set(Widelands::Coords(3, 2), 1 << 1);
+	fcc.update_dirty_rows();
+	BOOST_CHECK_EQUAL(fcc.count(Widelands::Coords(2, 2), 1, 0), 1);
+	BOOST_CHECK_EQUAL(fcc.count(Widelands::Coords(2, 2), 1, 1), 2);
+	BOOST_CHECK(fcc.has(Widelands::Coords(3, 2), 1));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(military_influence)
+
+BOOST_AUTO_TEST_CASE(military_influence_updates) {
+	AI::MilitaryInfluence influence;
+	influence.set_hostile(2, true);
+	influence.init(16, 16);
+	influence.set_building(
+	   Widelands::Coords(4, 4), 2, AI::MilitaryInfluence::BuildingType::kMilitarySite, 3);
+	influence.set_building(
+	   Widelands::Coords(6, 4), 3, AI::MilitaryInfluence::BuildingType::kMilitarySite, 2);
+	BOOST_CHECK_EQUAL(
+	   influence.sum(Widelands::Coords(4, 4), 1, AI::MilitaryInfluence::kEnemySoldiers), 3);
+	BOOST_CHECK_EQUAL(
+	   influence.sum(Widelands::Coords(4, 4), 2, AI::MilitaryInfluence::kAllySoldiers), 2);
+	BOOST_CHECK_EQUAL(
+	   influence.sum(Widelands::Coords(4, 4), 1, AI::MilitaryInfluence::kAllySoldiers), 0);
+
+	// Soldiers arriving replace the former count
+	influence.set_building(
+	   Widelands::Coords(4, 4), 2, AI::MilitaryInfluence::BuildingType::kMilitarySite, 5);
+	BOOST_CHECK_EQUAL(
+	   influence.sum(Widelands::Coords(4, 4), 1, AI::MilitaryInfluence::kEnemySoldiers), 5);
+	BOOST_CHECK_EQUAL(
+	   influence.sum(Widelands::Coords(4, 4), 1, AI::MilitaryInfluence::kEnemyBuildings), 1);
+
+	// Player 3 becomes hostile
+	influence.set_hostile(3, true);
+	BOOST_CHECK_EQUAL(
+	   influence.sum(Widelands::Coords(4, 4), 2, AI::MilitaryInfluence::kEnemySoldiers), 7);
+	BOOST_CHECK_EQUAL(
+	   influence.sum(Widelands::Coords(4, 4), 2, AI::MilitaryInfluence::kAllySoldiers), 0);
+	BOOST_CHECK_EQUAL(
+	   influence.sum(Widelands::Coords(4, 4), 2, AI::MilitaryInfluence::kEnemyMilitarySites), 2);
+
+	influence.remove_building(Widelands::Coords(4, 4));
+	BOOST_CHECK(!influence.has_building(Widelands::Coords(4, 4)));
+	BOOST_CHECK_EQUAL(
+	   influence.sum(Widelands::Coords(4, 4), 2, AI::MilitaryInfluence::kEnemySoldiers), 2);
+	BOOST_CHECK_EQUAL(
+	   influence.sum(Widelands::Coords(4, 4), 2, AI::MilitaryInfluence::kEnemyBuildings), 1);
+}
+
+// The notes in the order a game sends them when a militarysite is built: set_owner() reports the
+// constructionsite before init(), so it has neither a serial nor soldiers yet. On completion the
+// constructionsite is lost before the militarysite is gained at the same position.
+BOOST_AUTO_TEST_CASE(military_influence_counts_built_site) {
+	AI::MilitaryInfluence influence;
+	influence.init(16, 16);
+	influence.set_hostile(2, true);
+	const Widelands::Coords first(4, 4);
+	const Widelands::Coords second(8, 4);
+
+	// Two constructionsites started in the same think
+	influence.set_building(
+	   first, 2, AI::MilitaryInfluence::BuildingType::kMilitaryConstructionSite, 0);
+	influence.set_building(
+	   second, 2, AI::MilitaryInfluence::BuildingType::kMilitaryConstructionSite, 0);
+	BOOST_CHECK_EQUAL(influence.sum(first, 4, AI::MilitaryInfluence::kEnemyBuildings), 2);
+	BOOST_CHECK_EQUAL(
+	   influence.sum(first, 4, AI::MilitaryInfluence::kEnemyMilitaryConstructionSites), 2);
+
+	// The first one is finished, its soldier arrives with a NoteBuilding
+	influence.remove_building(first);
+	influence.set_building(first, 2, AI::MilitaryInfluence::BuildingType::kMilitarySite, 0);
+	BOOST_CHECK(influence.has_building(first));
+	influence.set_building(first, 2, AI::MilitaryInfluence::BuildingType::kMilitarySite, 1);
+	BOOST_CHECK_EQUAL(influence.sum(first, 1, AI::MilitaryInfluence::kEnemyMilitarySites), 1);
+	BOOST_CHECK_EQUAL(influence.sum(first, 1, AI::MilitaryInfluence::kEnemySoldiers), 1);
+	BOOST_CHECK_EQUAL(influence.sum(first, 4, AI::MilitaryInfluence::kEnemyBuildings), 2);
+	BOOST_CHECK_EQUAL(
+	   influence.sum(first, 4, AI::MilitaryInfluence::kEnemyMilitaryConstructionSites), 1);
+
+	// Losing the second site leaves the first one counted
+	influence.remove_building(second);
+	BOOST_CHECK(influence.has_building(first));
+	BOOST_CHECK_EQUAL(influence.sum(first, 4, AI::MilitaryInfluence::kEnemyBuildings), 1);
+	BOOST_CHECK_EQUAL(influence.sum(first, 4, AI::MilitaryInfluence::kEnemySoldiers), 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(field_rotation)
+
+namespace {
+struct TestField {
+	explicit TestField(const Widelands::FCoords& fc) : coords(fc) {
+	}
+	Widelands::FCoords coords;
+};
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(field_rotation_turns) {
+	AI::FieldRotation<TestField> fields;
+	BOOST_CHECK(fields.empty());
+	for (int16_t x = 0; x < 4; ++x) {
+		fields.add(Widelands::FCoords(Widelands::Coords(x, 0), nullptr));
+	}
+	BOOST_CHECK_EQUAL(fields.size(), 4);
+	BOOST_CHECK_EQUAL(fields.next().coords.x, 0);
+	fields.advance();
+	BOOST_CHECK_EQUAL(fields.next().coords.x, 1);
+	BOOST_CHECK_EQUAL(fields.in_turns(3).coords.x, 0);
+
+	// The last field takes the slot of the removed one and gets its turn
+	fields.remove_next();
+	BOOST_CHECK_EQUAL(fields.size(), 3);
+	BOOST_CHECK_EQUAL(fields.next().coords.x, 3);
+	fields.advance();
+	fields.advance();
+	BOOST_CHECK_EQUAL(fields.next().coords.x, 0);
+
+	// Removing the last slot passes the turn to the first one
+	fields.advance();
+	fields.advance();
+	fields.remove_next();
+	BOOST_CHECK_EQUAL(fields.size(), 2);
+	BOOST_CHECK_EQUAL(fields.next().coords.x, 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(task_scheduler)
+
+BOOST_AUTO_TEST_CASE(task_scheduler_order) {
+	AI::TaskScheduler scheduler;
+	scheduler.add(AI::SchedulerTask(Time(3000), AI::SchedulerTaskId::kRoadCheck, 2, "roads"));
+	scheduler.add(AI::SchedulerTask(Time(1000), AI::SchedulerTaskId::kCheckMines, 5, "mines"));
+	scheduler.add(AI::SchedulerTask(Time(2000), AI::SchedulerTaskId::kCheckShips, 5, "ships"));
+	BOOST_CHECK_EQUAL(scheduler.size(), 3);
+	BOOST_CHECK(scheduler.top().id == AI::SchedulerTaskId::kCheckMines);
+
+	// Rescheduling moves a task in both directions
+	scheduler.set_due_time(AI::SchedulerTaskId::kCheckMines, Time(4000));
+	BOOST_CHECK(scheduler.top().id == AI::SchedulerTaskId::kCheckShips);
+	scheduler.set_due_time(AI::SchedulerTaskId::kRoadCheck, Time(500));
+	BOOST_CHECK(scheduler.top().id == AI::SchedulerTaskId::kRoadCheck);
+	BOOST_CHECK_EQUAL(scheduler.get_due_time(AI::SchedulerTaskId::kCheckMines).get(), 4000);
+
+	// Only tasks that are due are returned, the earliest first
+	std::vector<AI::SchedulerTask> due = scheduler.due_tasks(Time(2500), 3);
+	BOOST_CHECK_EQUAL(due.size(), 2);
+	BOOST_CHECK(due[0].id == AI::SchedulerTaskId::kRoadCheck);
+	BOOST_CHECK(due[1].id == AI::SchedulerTaskId::kCheckShips);
+	BOOST_CHECK_EQUAL(scheduler.due_tasks(Time(5000), 1).size(), 1);
+
+	// Every task can be scheduled only once
+	BOOST_CHECK_THROW(
+	   scheduler.add(AI::SchedulerTask(Time(0), AI::SchedulerTaskId::kRoadCheck, 2, "roads")),
+	   WException);
+	BOOST_CHECK_THROW(scheduler.set_due_time(AI::SchedulerTaskId::kPrintStats, Time(0)), WException);
+}
+
+BOOST_AUTO_TEST_CASE(task_scheduler_costs) {
+	AI::TaskScheduler scheduler;
+	scheduler.add(AI::SchedulerTask(Time(0), AI::SchedulerTaskId::kRoadCheck, 2, "roads"));
+	BOOST_CHECK_EQUAL(scheduler.get_cost(AI::SchedulerTaskId::kRoadCheck).average_us(), 0);
+	scheduler.add_cost(AI::SchedulerTaskId::kRoadCheck, 100);
+	scheduler.add_cost(AI::SchedulerTaskId::kRoadCheck, 300);
+	const AI::TaskScheduler::TaskCost& cost = scheduler.get_cost(AI::SchedulerTaskId::kRoadCheck);
+	BOOST_CHECK_EQUAL(cost.runs, 2);
+	BOOST_CHECK_EQUAL(cost.average_us(), 200);
+	BOOST_CHECK_EQUAL(cost.max_us, 300);
+	{
+		// Counts as a run when it goes out of scope
+		AI::TaskScheduler::CostTimer timer(scheduler, AI::SchedulerTaskId::kCheckMines);
+	}
+	BOOST_CHECK_EQUAL(scheduler.get_cost(AI::SchedulerTaskId::kCheckMines).runs, 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(flag_connections)
+
+BOOST_AUTO_TEST_CASE(flag_connections_road_distances) {
+	AI::FlagConnections connections;
+	const Widelands::Coords origin(10, 10);
+	BOOST_CHECK(connections.get_road_distances(origin.hash(), 8) == nullptr);
+
+	AI::FlagConnections::RoadDistances distances;
+	distances[origin.hash()] = 0;
+	distances[Widelands::Coords(12, 10).hash()] = 2;
+	connections.set_road_distances(origin, 8, distances);
+	const AI::FlagConnections::RoadDistances* cached =
+	   connections.get_road_distances(origin.hash(), 8);
+	BOOST_REQUIRE(cached != nullptr);
+	BOOST_CHECK_EQUAL(cached->at(Widelands::Coords(12, 10).hash()), 2);
+
+	// Distances are only valid for the radius they were collected in
+	BOOST_CHECK(connections.get_road_distances(origin.hash(), 10) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(flag_connections_road_lengths) {
+	AI::FlagConnections connections;
+	const Widelands::Coords origin(10, 10);
+	const uint32_t target = Widelands::Coords(14, 10).hash();
+	int32_t length = 0;
+
+	// Only kept for known origins
+	connections.set_road_length(origin.hash(), target, 5, 4, Time(0));
+	BOOST_CHECK(!connections.get_road_length(origin.hash(), target, 5, Time(0), &length));
+
+	connections.set_road_distances(origin, 8, AI::FlagConnections::RoadDistances());
+	connections.set_road_length(origin.hash(), target, 5, 4, Time(1000));
+	BOOST_CHECK(connections.get_road_length(origin.hash(), target, 5, Time(1000), &length));
+	BOOST_CHECK_EQUAL(length, 4);
+	// A different cost of buildable fields can lead to another road
+	BOOST_CHECK(!connections.get_road_length(origin.hash(), target, 10, Time(1000), &length));
+	// Possible roads expire
+	BOOST_CHECK(!connections.get_road_length(
+	   origin.hash(), target, 5, Time(1000) + AI::kRoadLengthExpirationPeriod, &length));
+
+	// A new radius means that the possible roads are looked for again
+	connections.set_road_distances(origin, 10, AI::FlagConnections::RoadDistances());
+	BOOST_CHECK(!connections.get_road_length(origin.hash(), target, 5, Time(1000), &length));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
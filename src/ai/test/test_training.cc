@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2020 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include "ai/ai_training.h"
+#include "base/macros.h"
+
+// Triggered by BOOST_AUTO_TEST_CASE
+CLANG_DIAG_OFF("-Wdisabled-macro-expansion")
+CLANG_DIAG_OFF("-Wused-but-marked-unused")
+
+BOOST_AUTO_TEST_SUITE(ai_training)
+
+BOOST_AUTO_TEST_CASE(fitness_uses_last_sample) {
+	Widelands::Game::GeneralStats stats;
+	BOOST_CHECK_EQUAL(AI::training_fitness(stats), 0);
+
+	stats.land_size = {10, 100};
+	stats.nr_buildings = {1, 5};
+	BOOST_CHECK_EQUAL(AI::training_fitness(stats), 150);
+
+	// Losing military sites costs more than winning a fight elsewhere gains
+	stats.nr_msites_lost = {0, 2};
+	stats.nr_civil_blds_defeated = {0, 1};
+	BOOST_CHECK_EQUAL(AI::training_fitness(stats), 100);
+}
+
+BOOST_AUTO_TEST_CASE(select_fittest_parents) {
+	const std::vector<AI::TrainingCandidate> candidates = {
+	   {"a", 10}, {"b", 30}, {"c", 20}, {"d", 30}, {"e", -5}};
+	const std::vector<AI::TrainingCandidate> parents = AI::select_training_parents(candidates, 3);
+	BOOST_REQUIRE_EQUAL(parents.size(), 3);
+	// Equally fit candidates keep their order
+	BOOST_CHECK_EQUAL(parents.at(0).dna_file, "b");
+	BOOST_CHECK_EQUAL(parents.at(1).dna_file, "d");
+	BOOST_CHECK_EQUAL(parents.at(2).dna_file, "c");
+}
+
+BOOST_AUTO_TEST_CASE(select_repeats_parents) {
+	const std::vector<AI::TrainingCandidate> candidates = {{"a", 1}, {"b", 2}};
+	const std::vector<AI::TrainingCandidate> parents = AI::select_training_parents(candidates, 4);
+	BOOST_REQUIRE_EQUAL(parents.size(), 4);
+	BOOST_CHECK_EQUAL(parents.at(0).dna_file, "b");
+	BOOST_CHECK_EQUAL(parents.at(1).dna_file, "a");
+	BOOST_CHECK_EQUAL(parents.at(2).dna_file, "b");
+	BOOST_CHECK_EQUAL(parents.at(3).dna_file, "a");
+
+	BOOST_CHECK(AI::select_training_parents(std::vector<AI::TrainingCandidate>(), 4).empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
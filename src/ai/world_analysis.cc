@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2020 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "ai/world_analysis.h"
+
+#include <map>
+#include <mutex>
+
+#include "logic/editor_game_base.h"
+#include "logic/map_objects/world/terrain_description.h"
+#include "logic/map_objects/world/world.h"
+#include "logic/mapregion.h"
+
+namespace AI {
+
+namespace {
+// Port spaces attract computer players within this radius
+constexpr uint16_t kPortVicinityRadius = 3;
+}  // namespace
+
+// static
+std::shared_ptr<WorldAnalysis> WorldAnalysis::get(const Widelands::EditorGameBase& egbase) {
+	// Computer players initialize themselves while thinking, so several may ask at once
+	static std::mutex mutex;
+	static std::map<const Widelands::EditorGameBase*, std::weak_ptr<WorldAnalysis>> analyses;
+
+	std::lock_guard<std::mutex> lock(mutex);
+	for (auto it = analyses.begin(); it != analyses.end();) {
+		if (it->second.expired()) {
+			it = analyses.erase(it);
+		} else {
+			++it;
+		}
+	}
+	std::weak_ptr<WorldAnalysis>& entry = analyses[&egbase];
+	std::shared_ptr<WorldAnalysis> result = entry.lock();
+	if (result == nullptr) {
+		result.reset(new WorldAnalysis(egbase));
+		entry = result;
+	}
+	return result;
+}
+
+WorldAnalysis::WorldAnalysis(const Widelands::EditorGameBase& egbase)
+   : egbase_(egbase), find_water_(egbase.world()) {
+	const Widelands::Map& map = egbase.map();
+	counts_.init(map.get_width(), map.get_height(), kNumClasses);
+
+	// TODO(tiborb): it seems port spaces can change over time so the vicinity needs to be
+	// refreshed from time to time
+	for (const Widelands::Coords& c : map.get_port_spaces()) {
+		Widelands::MapRegion<Widelands::Area<Widelands::FCoords>> mr(
+		   map, Widelands::Area<Widelands::FCoords>(map.get_fcoords(c), kPortVicinityRadius));
+		do {
+			counts_.set(mr.location(), 1 << kPortVicinity);
+		} while (mr.advance(map));
+	}
+
+	for (int16_t y = 0; y < map.get_height(); ++y) {
+		for (int16_t x = 0; x < map.get_width(); ++x) {
+			classify(map.get_fcoords(Widelands::Coords(x, y)));
+		}
+	}
+	counts_.update_dirty_rows();
+
+	// The note is sent before the node caps are recalculated, which is why classify() only looks
+	// at the terrains.
+	terrain_subscriber_ = Notifications::subscribe<Widelands::NoteFieldTerrainChanged>(
+	   [this](const Widelands::NoteFieldTerrainChanged& note) {
+		   const Widelands::Map& m = egbase_.map();
+		   Widelands::MapRegion<Widelands::Area<Widelands::FCoords>> mr(
+		      m, Widelands::Area<Widelands::FCoords>(note.fc, 1));
+		   do {
+			   classify(mr.location());
+		   } while (mr.advance(m));
+		   counts_.update_dirty_rows();
+	   });
+}
+
+uint32_t WorldAnalysis::count(const Widelands::Coords& center, uint16_t radius, Class c) {
+	return counts_.count(center, radius, c);
+}
+
+void WorldAnalysis::classify(const Widelands::FCoords& fc) {
+	const Widelands::Map& map = egbase_.map();
+	const Widelands::World& world = egbase_.world();
+	uint8_t classes = is_port_vicinity(fc) ? 1 << kPortVicinity : 0;
+	if (find_water_.accept(egbase_, fc)) {
+		classes |= 1 << kWater;
+
+		const Widelands::FCoords nw = map.tl_n(fc);
+		const Widelands::DescriptionIndex triangles[] = {
+		   fc.field->terrain_r(),          fc.field->terrain_d(),
+		   map.l_n(fc).field->terrain_r(), nw.field->terrain_r(),
+		   nw.field->terrain_d(),          map.tr_n(fc).field->terrain_d()};
+		// The same as MOVECAPS_SWIM without MOVECAPS_WALK in Map::calc_nodecaps_pass1()
+		bool open_water = true;
+		for (Widelands::DescriptionIndex terrain : triangles) {
+			const Widelands::TerrainDescription::Is is = world.terrain_descr(terrain).get_is();
+			open_water &= (is & Widelands::TerrainDescription::Is::kWater) &&
+			              (is & Widelands::TerrainDescription::Is::kUnwalkable) &&
+			              !(is & Widelands::TerrainDescription::Is::kUnreachable);
+		}
+		if (open_water) {
+			classes |= 1 << kOpenWater;
+		}
+	}
+	counts_.set(fc, classes);
+}
+
+}  // namespace AI
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2020 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#ifndef WL_AI_WORLD_ANALYSIS_H
+#define WL_AI_WORLD_ANALYSIS_H
+
+#include <memory>
+
+#include "ai/ai_help_structs.h"
+#include "base/macros.h"
+#include "logic/map.h"
+#include "notifications/notifications.h"
+
+namespace AI {
+
+// Analysis of the map that doesn't depend on a player, like where water and port spaces are.
+// All computer players of a game share one instance, so the work and memory needed for it don't
+// grow with the number of computer players.
+// The analysis is computed when the first computer player asks for it. Afterwards it only changes
+// on notes, which are sent by the logic thread while no computer player is thinking. Queries are
+// therefore safe from several computer players thinking in parallel.
+// Resources and mine spots are not part of it. The amounts of resources fall as they are mined
+// or fished and rise where fish are bred, and whether a node is a mine spot depends on the
+// immovables on and around it. Both change all the time, without notes, and each computer player
+// only ever looks at them on its own land, so they stay with the computer player.
+class WorldAnalysis {
+public:
+	enum Class : uint8_t {
+		// Like FindNodeWater
+		kWater = 0,
+		// Like FindNodeOpenWater, but decided by the terrains: all six triangles around the node
+		// are unwalkable water and none is unreachable, so the node can be swum to but not walked
+		// to. Unlike FindNodeOpenWater, it ignores impassable immovables on the node.
+		kOpenWater,
+		kPortVicinity,
+		kNumClasses
+	};
+
+	// Returns the analysis of the game's map, computing it if no other computer player uses it yet
+	static std::shared_ptr<WorldAnalysis> get(const Widelands::EditorGameBase& egbase);
+
+	explicit WorldAnalysis(const Widelands::EditorGameBase& egbase);
+
+	// Number of nodes of the class within the area, counted exactly like Map::find_fields does
+	uint32_t count(const Widelands::Coords& center, uint16_t radius, Class c);
+	bool is_port_vicinity(const Widelands::Coords& coords) const {
+		return counts_.has(coords, kPortVicinity);
+	}
+
+private:
+	void classify(const Widelands::FCoords& fc);
+
+	const Widelands::EditorGameBase& egbase_;
+	FindNodeWater find_water_;
+	FieldClassCounts counts_;
+
+	std::unique_ptr<Notifications::Subscriber<Widelands::NoteFieldTerrainChanged>>
+	   terrain_subscriber_;
+
+	DISALLOW_COPY_AND_ASSIGN(WorldAnalysis);
+};
+}  // namespace AI
+
+#endif  // end of include guard: WL_AI_WORLD_ANALYSIS_H
@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2020 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "base/fast_hash.h"
+
+#include "base/wexception.h"
+#include "io/streamread.h"
+#include "io/streamwrite.h"
+
+namespace {
+
+// The primes of xxHash64
+constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t kPrime3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t kPrime5 = 0x27D4EB2F165667C5ULL;
+
+inline uint64_t rotate_left(const uint64_t x, const unsigned bits) {
+	return (x << bits) | (x >> (64 - bits));
+}
+
+// Assemble the word byte by byte, so that the hash is the same on all machines.
+// Compilers turn this into a single load on little endian machines.
+inline uint64_t load_little_64(const uint8_t* p) {
+	return static_cast<uint64_t>(p[0]) | (static_cast<uint64_t>(p[1]) << 8) |
+	       (static_cast<uint64_t>(p[2]) << 16) | (static_cast<uint64_t>(p[3]) << 24) |
+	       (static_cast<uint64_t>(p[4]) << 32) | (static_cast<uint64_t>(p[5]) << 40) |
+	       (static_cast<uint64_t>(p[6]) << 48) | (static_cast<uint64_t>(p[7]) << 56);
+}
+
+}  // namespace
+
+FastHash::FastHash() {
+	reset();
+}
+
+void FastHash::reset() {
+	accumulator_ = kPrime5;
+	tail_ = 0;
+	length_ = 0;
+}
+
+inline void FastHash::process_word(const uint64_t word) {
+	accumulator_ = rotate_left(accumulator_ + word * kPrime2, 31) * kPrime1;
+}
+
+void FastHash::data(const void* const data, const size_t size) {
+	const uint8_t* p = static_cast<const uint8_t*>(data);
+	const uint8_t* const end = p + size;
+	unsigned tail_size = length_ & 7;
+	length_ += size;
+
+	// Complete the word that was started by the last call
+	if (tail_size != 0) {
+		while (p != end && tail_size != 8) {
+			tail_ |= static_cast<uint64_t>(*p++) << (8 * tail_size++);
+		}
+		if (tail_size != 8) {
+			return;
+		}
+		process_word(tail_);
+		tail_ = 0;
+	}
+
+	for (; end - p >= 8; p += 8) {
+		process_word(load_little_64(p));
+	}
+
+	for (tail_size = 0; p != end; ++tail_size) {
+		tail_ |= static_cast<uint64_t>(*p++) << (8 * tail_size);
+	}
+}
+
+uint64_t FastHash::value() const {
+	uint64_t result = accumulator_ ^ (length_ * kPrime1);
+	result = rotate_left(result ^ (tail_ * kPrime5), 27) * kPrime1 + kPrime3;
+
+	// Avalanche, so that every input bit affects every output bit
+	result ^= result >> 33;
+	result *= kPrime2;
+	result ^= result >> 29;
+	result *= kPrime3;
+	result ^= result >> 32;
+	return result;
+}
+
+void FastHash::read_state(StreamRead& sr) {
+	accumulator_ = static_cast<uint64_t>(sr.unsigned_32()) << 32;
+	accumulator_ |= sr.unsigned_32();
+	tail_ = static_cast<uint64_t>(sr.unsigned_32()) << 32;
+	tail_ |= sr.unsigned_32();
+	length_ = static_cast<uint64_t>(sr.unsigned_32()) << 32;
+	length_ |= sr.unsigned_32();
+	const unsigned tail_size = length_ & 7;
+	if (tail_size == 0 ? tail_ != 0 : (tail_ >> (8 * tail_size)) != 0) {
+		throw wexception("Invalid hash state");
+	}
+}
+
+void FastHash::write_state(StreamWrite& sw) const {
+	sw.unsigned_32(accumulator_ >> 32);
+	sw.unsigned_32(accumulator_ & 0xffffffff);
+	sw.unsigned_32(tail_ >> 32);
+	sw.unsigned_32(tail_ & 0xffffffff);
+	sw.unsigned_32(length_ >> 32);
+	sw.unsigned_32(length_ & 0xffffffff);
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2020 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#ifndef WL_BASE_FAST_HASH_H
+#define WL_BASE_FAST_HASH_H
+
+#include <cstdint>
+#include <cstdlib>
+
+class StreamRead;
+class StreamWrite;
+
+/**
+ * A streaming 64 bit hash that is much faster than MD5, but not suitable
+ * for cryptographic purposes. It is used for the synchronization checks,
+ * where the data is hashed 8 bytes at a time.
+ *
+ * The result does not depend on how the data is split into calls of
+ * \ref data, nor on the byte order of the machine.
+ */
+class FastHash {
+public:
+	FastHash();
+
+	/// Reset the hash to its initial state.
+	void reset();
+
+	/// Consume new data.
+	void data(const void* data, size_t size);
+
+	/// \return the hash of all data so far. More data may be added afterwards.
+	uint64_t value() const;
+
+	void read_state(StreamRead&);
+	void write_state(StreamWrite&) const;
+
+private:
+	void process_word(uint64_t word);
+
+	uint64_t accumulator_;
+	// Bytes that don't fill a complete word yet, in little endian order
+	uint64_t tail_;
+	// Total number of bytes so far. The lowest 3 bits are the number of bytes in 'tail_'.
+	uint64_t length_;
+};
+
+#endif  // end of include guard: WL_BASE_FAST_HASH_H
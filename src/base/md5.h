@@ -90,6 +90,15 @@ public:
 		ctx.buflen = 0;
 	}
 
+	/// Access the internal state of the computation, so that it can be stored and restored later.
+	const Md5Ctx& get_state() const {
+		return ctx;
+	}
+	void set_state(const Md5Ctx& state) {
+		can_handle_data = 1;
+		ctx = state;
+	}
+
 	/// This function consumes new data. It buffers it and calculates one MD5
 	/// block when the buffer is full.
 	///
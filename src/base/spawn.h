@@ -0,0 +1,36 @@
+/*
+ * Copyright (C) 2020 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#ifndef WL_BASE_SPAWN_H
+#define WL_BASE_SPAWN_H
+
+#include <functional>
+
+#include <sys/types.h>
+
+/**
+ * Runs \p function in a new process and returns its process id. The process
+ * exits with the return value of \p function. Call this before setting up
+ * anything that the processes must not share, e.g. the file systems.
+ *
+ * Throws a wexception if the process can't be created.
+ */
+pid_t spawn(const std::function<int()>& function);
+
+#endif  // end of include guard: WL_BASE_SPAWN_H
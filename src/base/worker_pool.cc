@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2020 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "base/worker_pool.h"
+
+#include <cassert>
+
+WorkerPool::WorkerPool(unsigned const nr_workers)
+   : tasks_(nullptr), next_task_(0), unfinished_tasks_(0), stopping_(false) {
+	for (unsigned i = 0; i < nr_workers; ++i) {
+		workers_.emplace_back([this]() { work(); });
+	}
+}
+
+WorkerPool::~WorkerPool() {
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stopping_ = true;
+	}
+	tasks_available_.notify_all();
+	for (std::thread& worker : workers_) {
+		worker.join();
+	}
+}
+
+void WorkerPool::run(const std::vector<std::function<void()>>& tasks) {
+	std::unique_lock<std::mutex> lock(mutex_);
+	assert(tasks_ == nullptr);
+	tasks_ = &tasks;
+	next_task_ = 0;
+	unfinished_tasks_ = tasks.size();
+	tasks_available_.notify_all();
+
+	while (run_next_task(lock)) {
+	}
+	tasks_done_.wait(lock, [this]() { return unfinished_tasks_ == 0; });
+	tasks_ = nullptr;
+
+	if (error_) {
+		std::exception_ptr error = error_;
+		error_ = nullptr;
+		std::rethrow_exception(error);
+	}
+}
+
+/**
+ * Takes the next task of the current batch and runs it without holding the
+ * lock, which must be locked when this is called.
+ *
+ * \return false if there was no task left
+ */
+bool WorkerPool::run_next_task(std::unique_lock<std::mutex>& lock) {
+	if (tasks_ == nullptr || next_task_ >= tasks_->size()) {
+		return false;
+	}
+	const std::function<void()>& task = (*tasks_)[next_task_++];
+
+	lock.unlock();
+	std::exception_ptr error;
+	try {
+		task();
+	} catch (...) {
+		error = std::current_exception();
+	}
+	lock.lock();
+
+	if (error && !error_) {
+		error_ = error;
+	}
+	if (--unfinished_tasks_ == 0) {
+		tasks_done_.notify_all();
+	}
+	return true;
+}
+
+void WorkerPool::work() {
+	std::unique_lock<std::mutex> lock(mutex_);
+	for (;;) {
+		tasks_available_.wait(lock, [this]() {
+			return stopping_ || (tasks_ != nullptr && next_task_ < tasks_->size());
+		});
+		if (stopping_) {
+			return;
+		}
+		run_next_task(lock);
+	}
+}
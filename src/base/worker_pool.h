@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2020 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#ifndef WL_BASE_WORKER_POOL_H
+#define WL_BASE_WORKER_POOL_H
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "base/macros.h"
+
+/**
+ * A fixed set of threads that run batches of tasks.
+ *
+ * \ref run hands the tasks out to the workers and to the calling thread, and
+ * only returns when all of them are done. So the tasks may use everything that
+ * the caller keeps alive and unchanged in the meantime.
+ */
+class WorkerPool {
+public:
+	/// Starts 'nr_workers' threads that help the caller of \ref run. Without
+	/// any, the caller runs all tasks itself.
+	explicit WorkerPool(unsigned nr_workers);
+	~WorkerPool();
+
+	/// Runs all tasks, in no particular order, and waits until they are done.
+	/// If a task throws, the other tasks are still run, and the first exception
+	/// is rethrown afterwards.
+	void run(const std::vector<std::function<void()>>& tasks);
+
+private:
+	void work();
+	bool run_next_task(std::unique_lock<std::mutex>& lock);
+
+	std::vector<std::thread> workers_;
+	std::mutex mutex_;
+	std::condition_variable tasks_available_;
+	std::condition_variable tasks_done_;
+
+	/// The batch that is being run, if any
+	const std::vector<std::function<void()>>* tasks_;
+	size_t next_task_;
+	size_t unfinished_tasks_;
+	std::exception_ptr error_;
+	bool stopping_;
+
+	DISALLOW_COPY_AND_ASSIGN(WorkerPool);
+};
+
+#endif  // end of include guard: WL_BASE_WORKER_POOL_H
@@ -46,6 +46,11 @@ void Economy::initialize_serial() {
 	last_economy_serial_ = 0;
 }
 
+// static
+void Economy::set_next_serial(Serial const serial) {
+	last_economy_serial_ = serial;
+}
+
 Economy::Economy(Player& player, WareWorker wwtype)
    : Economy(player, last_economy_serial_++, wwtype) {
 }
@@ -444,6 +449,11 @@ bool Economy::has_request(Request& req) const {
 	return std::find(requests_.begin(), requests_.end(), &req) != requests_.end();
 }
 
+uint32_t Economy::request_position(const Request& req) const {
+	RequestList::const_iterator const it = std::find(requests_.begin(), requests_.end(), &req);
+	return it == requests_.end() ? std::numeric_limits<uint32_t>::max() : it - requests_.begin();
+}
+
 /**
  * Remove the request from this economy.
  * Important: This must only be called by the \ref Request class.
@@ -729,7 +739,7 @@ void Economy::process_requests(Game& game, RSPairStruct* supply_pairs) {
 		// We somehow get desynced request lists that don't trigger desync
 		// alerts, so add info to the sync stream here.
 		{
-			::StreamWrite& ss = game.syncstream();
+			::StreamWrite& ss = game.syncstream(SyncCategory::kEconomy, owner().player_number());
 			ss.unsigned_8(SyncEntry::kProcessRequests);
 			ss.unsigned_8(req.get_type());
 			ss.unsigned_8(req.get_index());
@@ -1063,7 +1073,7 @@ void Economy::handle_active_supplies(Game& game) {
 	// Actually start with the transfers in a separate second phase,
 	// to avoid potential future problems caused by the supplies_ changing
 	// under us in some way.
-	::StreamWrite& ss = game.syncstream();
+	::StreamWrite& ss = game.syncstream(SyncCategory::kEconomy, owner().player_number());
 	ss.unsigned_8(SyncEntry::kHandleActiveSupplies);
 	ss.unsigned_32(assignments.size());
 
@@ -91,6 +91,11 @@ public:
 
 	// Initialize the global serial on game start
 	static void initialize_serial();
+	// The serial that the next new economy gets, for savegames
+	static Serial next_serial() {
+		return last_economy_serial_;
+	}
+	static void set_next_serial(Serial serial);
 
 	/// Configurable target quantity for the supply of a ware type in the
 	/// economy.
@@ -159,6 +164,9 @@ public:
 
 	void add_request(Request&);
 	void remove_request(Request&);
+	/// \return the position of the request in the list of open requests, or the largest possible
+	/// value if it isn't in there. See \ref Request::write
+	uint32_t request_position(const Request&) const;
 
 	void add_supply(Supply&);
 	void remove_supply(Supply&);
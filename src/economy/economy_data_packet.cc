@@ -19,22 +19,61 @@
 
 #include "economy/economy_data_packet.h"
 
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+
 #include "base/log.h"
 #include "economy/economy.h"
+#include "economy/flag.h"
+#include "economy/supply.h"
 #include "io/fileread.h"
 #include "io/filewrite.h"
 #include "logic/map_objects/tribes/tribe_descr.h"
+#include "logic/map_objects/tribes/warehouse.h"
 #include "logic/player.h"
 #include "map_io/map_object_loader.h"
 
-constexpr uint16_t kCurrentPacketVersion = 5;
+// Version 5 didn't store the order of flags, warehouses, requests and supplies
+constexpr uint16_t kCurrentPacketVersion = 6;
 
 namespace Widelands {
 
-void EconomyDataPacket::read(FileRead& fr) {
+namespace {
+
+/**
+ * The order of a list of flags, warehouses or supplies when the game was saved.
+ * Loading adds them to the economy in another order than the game did, but the
+ * game logic picks the first of equally good candidates from these lists.
+ */
+class SavedOrder {
+public:
+	explicit SavedOrder(FileRead& fr) {
+		for (uint32_t position = 0, size = fr.unsigned_32(); position < size; ++position) {
+			positions_[fr.unsigned_32()] = position;
+		}
+	}
+
+	bool operator()(Serial const a, Serial const b) const {
+		return position(a) < position(b);
+	}
+
+private:
+	// Objects that were not in the list go to the end
+	uint32_t position(Serial const serial) const {
+		const auto it = positions_.find(serial);
+		return it == positions_.end() ? std::numeric_limits<uint32_t>::max() : it->second;
+	}
+
+	std::unordered_map<Serial, uint32_t> positions_;
+};
+
+}  // namespace
+
+void EconomyDataPacket::read(FileRead& fr, const MapObjectLoader& mol) {
 	try {
 		uint16_t const packet_version = fr.unsigned_16();
-		if (packet_version == kCurrentPacketVersion) {
+		if (packet_version >= 5 && packet_version <= kCurrentPacketVersion) {
 			const Serial saved_serial = fr.unsigned_32();
 			if (eco_->serial_ != saved_serial) {
 				throw GameDataError(
@@ -128,6 +167,27 @@ void EconomyDataPacket::read(FileRead& fr) {
 			if (other_eco) {
 				other_eco->request_timerid_ = eco_->request_timerid_;
 			}
+			if (packet_version >= 6) {
+				const SavedOrder flags(fr);
+				std::stable_sort(eco_->flags_.begin(), eco_->flags_.end(),
+				                 [&flags](const Flag* a, const Flag* b) {
+					                 return flags(a->serial(), b->serial());
+				                 });
+				const SavedOrder warehouses(fr);
+				std::stable_sort(eco_->warehouses_.begin(), eco_->warehouses_.end(),
+				                 [&warehouses](const Warehouse* a, const Warehouse* b) {
+					                 return warehouses(a->serial(), b->serial());
+				                 });
+				const SavedOrder supplies(fr);
+				eco_->supplies_.stable_sort([&supplies](const Supply* a, const Supply* b) {
+					return supplies(a->serial(), b->serial());
+				});
+				// The requests have stored their positions themselves
+				std::stable_sort(eco_->requests_.begin(), eco_->requests_.end(),
+				                 [&mol](const Request* a, const Request* b) {
+					                 return mol.economy_position(*a) < mol.economy_position(*b);
+				                 });
+			}
 		} else {
 			throw UnhandledVersionError("EconomyDataPacket", packet_version, kCurrentPacketVersion);
 		}
@@ -159,5 +219,19 @@ void EconomyDataPacket::write(FileWrite& fw) {
 	}
 	fw.unsigned_32(0);  //  terminator
 	fw.unsigned_32(eco_->request_timerid_);
+
+	// Loading adds these to the economy in another order, see SavedOrder
+	fw.unsigned_32(eco_->flags_.size());
+	for (const Flag* flag : eco_->flags_) {
+		fw.unsigned_32(flag->serial());
+	}
+	fw.unsigned_32(eco_->warehouses_.size());
+	for (const Warehouse* warehouse : eco_->warehouses_) {
+		fw.unsigned_32(warehouse->serial());
+	}
+	fw.unsigned_32(eco_->supplies_.get_nrsupplies());
+	for (size_t i = 0; i < eco_->supplies_.get_nrsupplies(); ++i) {
+		fw.unsigned_32(eco_->supplies_[i].serial());
+	}
 }
 }  // namespace Widelands
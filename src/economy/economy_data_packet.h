@@ -27,6 +27,7 @@ class FileWrite;
 
 namespace Widelands {
 class Economy;
+class MapObjectLoader;
 
 class EconomyDataPacket {
 public:
@@ -34,7 +35,7 @@ public:
 		assert(eco_);
 	}
 
-	void read(FileRead&);
+	void read(FileRead&, const MapObjectLoader&);
 	void write(FileWrite&);
 
 private:
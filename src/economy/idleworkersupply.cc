@@ -87,6 +87,10 @@ PlayerImmovable* IdleWorkerSupply::get_position(Game& game) {
 	return worker_.get_location(game);
 }
 
+Serial IdleWorkerSupply::serial() const {
+	return worker_.serial();
+}
+
 uint32_t IdleWorkerSupply::nr_supplies(const Game& game, const Request& req) const {
 	assert(req.get_type() != wwWORKER || worker_.owner().tribe().has_worker(req.get_index()));
 	if (req.get_type() == wwWORKER &&
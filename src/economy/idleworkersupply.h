@@ -31,6 +31,7 @@ struct IdleWorkerSupply : public Supply {
 
 	void set_economy(Economy*);
 	PlayerImmovable* get_position(Game&) override;
+	Serial serial() const override;
 
 	bool is_active() const override;
 	SupplyProviders provider_type(Game*) const override;
@@ -19,6 +19,8 @@
 
 #include "economy/request.h"
 
+#include <limits>
+
 #include "base/log.h"
 #include "base/macros.h"
 #include "economy/economy.h"
@@ -94,7 +96,8 @@ Request::~Request() {
 }
 
 // Modified to allow Requirements and SoldierRequests
-constexpr uint16_t kCurrentPacketVersion = 6;
+// Version 6 didn't store the position in the economy's list of requests
+constexpr uint16_t kCurrentPacketVersion = 7;
 
 /**
  * Read this request from a file
@@ -110,7 +113,7 @@ void Request::read(FileRead& fr,
                    const TribesLegacyLookupTable& tribes_lookup_table) {
 	try {
 		uint16_t const packet_version = fr.unsigned_16();
-		if (packet_version == kCurrentPacketVersion) {
+		if (packet_version >= 6 && packet_version <= kCurrentPacketVersion) {
 			const TribeDescr& tribe = target_.owner().tribe();
 			char const* const type_name = fr.c_string();
 			DescriptionIndex const wai = tribe.ware_index(tribes_lookup_table.lookup_ware(type_name));
@@ -178,6 +181,10 @@ void Request::read(FileRead& fr,
 			if (is_open()) {
 				economy_->add_request(*this);
 			}
+			if (packet_version >= 7) {
+				// The economy restores the order of its requests, see EconomyDataPacket
+				mol.set_economy_position(*this, fr.unsigned_32());
+			}
 		} else {
 			throw UnhandledVersionError("Request", packet_version, kCurrentPacketVersion);
 		}
@@ -224,6 +231,9 @@ void Request::write(FileWrite& fw, Game& game, MapObjectSaver& mos) const {
 		}
 	}
 	requirements_.write(fw, game, mos);
+	// Loading adds the requests to their economy in another order
+	fw.unsigned_32(economy_ != nullptr ? economy_->request_position(*this) :
+	                                     std::numeric_limits<uint32_t>::max());
 }
 
 /**
@@ -411,7 +421,7 @@ void Request::set_required_interval(const Duration& interval) {
 void Request::start_transfer(Game& game, Supply& supp) {
 	assert(is_open());
 
-	::StreamWrite& ss = game.syncstream();
+	::StreamWrite& ss = game.syncstream(SyncCategory::kEconomy, target().owner().player_number());
 	ss.unsigned_8(SyncEntry::kStartTransfer);
 	ss.unsigned_32(target().serial());
 	ss.unsigned_32(supp.get_position(game)->serial());
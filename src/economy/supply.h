@@ -52,6 +52,12 @@ enum class SupplyProviders { kWarehouse, kFlagOrRoad, kShip };
 struct Supply : public Trackable {
 	virtual PlayerImmovable* get_position(Game&) = 0;
 
+	/**
+	 * Return the serial of the ware, worker or warehouse that offers this
+	 * supply.
+	 */
+	virtual Serial serial() const = 0;
+
 	/**
 	 * Indicates whether this supply is active as explained above (out
 	 * on the road network).
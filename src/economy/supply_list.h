@@ -20,6 +20,7 @@
 #ifndef WL_ECONOMY_SUPPLY_LIST_H
 #define WL_ECONOMY_SUPPLY_LIST_H
 
+#include <algorithm>
 #include <cstddef>
 #include <vector>
 
@@ -48,6 +49,11 @@ struct SupplyList {
 
 	bool have_supplies(Game& game, const Request&);
 
+	/// Sort the supplies and keep the order of equal ones
+	template <typename Compare> void stable_sort(Compare compare) {
+		std::stable_sort(supplies_.begin(), supplies_.end(), compare);
+	}
+
 private:
 	using Supplies = std::vector<Supply*>;
 	Supplies supplies_;
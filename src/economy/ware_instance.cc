@@ -54,6 +54,7 @@ struct IdleWareSupply : public Supply {
 
 	//  implementation of Supply
 	PlayerImmovable* get_position(Game&) override;
+	Serial serial() const override;
 	bool is_active() const override;
 	SupplyProviders provider_type(Game*) const override;
 	bool has_storage() const override;
@@ -121,6 +122,10 @@ PlayerImmovable* IdleWareSupply::get_position(Game& game) {
 	return nullptr;
 }
 
+Serial IdleWareSupply::serial() const {
+	return ware_.serial();
+}
+
 bool IdleWareSupply::is_active() const {
 	return true;
 }
@@ -60,6 +60,7 @@ struct WarehouseSupply : public Supply {
 
 	// Supply implementation
 	PlayerImmovable* get_position(Game&) override;
+	Serial serial() const override;
 	bool is_active() const override;
 	SupplyProviders provider_type(Game*) const override;
 	bool has_storage() const override;
@@ -0,0 +1,220 @@
+/*
+ * Copyright (C) 2020 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+#include "base/log.h"
+#include "base/macros.h"
+#include "base/wexception.h"
+#include "game_io/game_loader.h"
+#include "game_io/game_saver.h"
+#include "headless_environment.h"
+#include "io/filesystem/layered_filesystem.h"
+#include "io/filewrite.h"
+#include "io/profile.h"
+#include "logic/filesystem_constants.h"
+#include "logic/game.h"
+#include "logic/sync_digest.h"
+
+/**
+ * Compares the throughput of the fixed width stream fast paths with writing
+ * every value through data(), like before they were added:
+ *  - A GameSaver pass over the given savegame. The game is saved into a
+ *    directory below the temp directory, so that compression does not hide
+ *    the time spent in the streams.
+ *  - Hashing the syncstream, value by value vs. in blocks of 4 kB like
+ *    Game::SyncWrapper does now.
+ *
+ * Usage: benchmark_game_saver <savegame> [<repetitions>] [<datadir>]
+ * The best time of all repetitions is reported.
+ */
+
+namespace {
+
+constexpr uint32_t kSyncRecords = 1000000;
+
+double milliseconds_since(const std::chrono::steady_clock::time_point& start) {
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+	   .count();
+}
+
+/// Collects small writes in blocks of 4 kB before passing them on to the hasher,
+/// like Game::SyncWrapper.
+class BlockedSync : public StreamWrite {
+public:
+	explicit BlockedSync(Widelands::SyncHasher& target) : target_(target) {
+		buffer_ = pending_;
+		buffer_end_ = pending_ + kPendingSize;
+	}
+	~BlockedSync() override {
+		flush_pending();
+	}
+
+	void select(Widelands::SyncCategory category, Widelands::PlayerNumber player) {
+		if (Widelands::SyncDigest::leaf(category, player) != target_.current_leaf()) {
+			flush_pending();
+			target_.select(category, player);
+		}
+	}
+	void data(void const* const data, size_t const size) override {
+		flush_pending();
+		target_.data(data, size);
+	}
+	void flush_pending() {
+		if (buffer_ != pending_) {
+			target_.data(pending_, buffer_ - pending_);
+		}
+		buffer_ = pending_;
+	}
+
+private:
+	static constexpr size_t kPendingSize = 4096;
+	char pending_[kPendingSize];
+	Widelands::SyncHasher& target_;
+
+	DISALLOW_COPY_AND_ASSIGN(BlockedSync);
+};
+
+/// Passes every value on to the hasher on its own, like the game did before.
+class PerValueSync : public StreamWrite {
+public:
+	explicit PerValueSync(Widelands::SyncHasher& target) : target_(target) {
+	}
+
+	void select(Widelands::SyncCategory category, Widelands::PlayerNumber player) {
+		target_.select(category, player);
+	}
+	void data(void const* const data, size_t const size) override {
+		target_.data(data, size);
+	}
+
+private:
+	Widelands::SyncHasher& target_;
+
+	DISALLOW_COPY_AND_ASSIGN(PerValueSync);
+};
+
+/// Writes records shaped like the ones that bobs and immovables contribute to
+/// the syncstream, switching categories every now and then.
+template <typename Sync> void write_sync_records(Sync& sync, uint32_t count) {
+	for (uint32_t i = 0; i < count; ++i) {
+		if (i % 64 == 0) {
+			sync.select(i % 128 == 0 ? Widelands::SyncCategory::kBobs :
+			                           Widelands::SyncCategory::kImmovables,
+			            0);
+		}
+		sync.unsigned_32(i * 2654435761U);
+		sync.unsigned_32(i);
+		sync.signed_16(-static_cast<int16_t>(i & 0x7fff));
+		sync.signed_16(static_cast<int16_t>(i & 0x7fff));
+		sync.unsigned_8(i & 0xff);
+	}
+}
+
+template <typename Sync> double hash_sync_records(Widelands::SyncDigest* digest) {
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	Widelands::SyncHasher hasher;
+	{
+		Sync sync(hasher);
+		write_sync_records(sync, kSyncRecords);
+	}
+	*digest = hasher.digest();
+	return milliseconds_since(start);
+}
+
+double save_game(Widelands::Game& game, bool fast_paths) {
+	const std::string dir = kTempFileDir + "/benchmark_game_saver" + kTempFileExtension;
+	if (g_fs->file_exists(dir)) {
+		g_fs->fs_unlink(dir);
+	}
+	FileWrite::set_fast_paths(fast_paths);
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	{
+		std::unique_ptr<FileSystem> fs(g_fs->create_sub_file_system(dir, FileSystem::DIR));
+		Widelands::GameSaver(*fs, game).save();
+	}
+	const double result = milliseconds_since(start);
+	FileWrite::set_fast_paths(true);
+	g_fs->fs_unlink(dir);
+	return result;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+	if (argc < 2 || argc > 4) {
+		log_err("Usage: %s <savegame> [<repetitions>] [<datadir>]\n", argv[0]);
+		return 1;
+	}
+	const std::string savegame = argv[1];
+	const int repetitions = argc > 2 ? std::max(std::atoi(argv[2]), 1) : 5;
+
+	Profile config;
+	Section& environment = config.create_section("environment");
+	if (argc > 3) {
+		environment.set_string("datadir", argv[3]);
+	}
+
+	g_fs = new LayeredFileSystem();
+	try {
+		initialize_headless_environment(environment);
+
+		double legacy_save = 0;
+		double fast_save = 0;
+		{
+			Widelands::Game game;
+			Widelands::GameLoader(savegame, game).load_game();
+			for (int i = 0; i < repetitions; ++i) {
+				const double legacy = save_game(game, false);
+				const double fast = save_game(game, true);
+				legacy_save = i == 0 ? legacy : std::min(legacy_save, legacy);
+				fast_save = i == 0 ? fast : std::min(fast_save, fast);
+			}
+		}
+
+		double legacy_hash = 0;
+		double fast_hash = 0;
+		for (int i = 0; i < repetitions; ++i) {
+			Widelands::SyncDigest legacy_digest;
+			Widelands::SyncDigest fast_digest;
+			const double legacy = hash_sync_records<PerValueSync>(&legacy_digest);
+			const double fast = hash_sync_records<BlockedSync>(&fast_digest);
+			if (legacy_digest != fast_digest) {
+				throw wexception("hashing in blocks changed the sync digest");
+			}
+			legacy_hash = i == 0 ? legacy : std::min(legacy_hash, legacy);
+			fast_hash = i == 0 ? fast : std::min(fast_hash, fast);
+		}
+
+		log_info("Saving %s: %.1f ms before, %.1f ms now\n", savegame.c_str(), legacy_save,
+		         fast_save);
+		log_info("Hashing %u sync records: %.1f ms before, %.1f ms now\n", kSyncRecords,
+		         legacy_hash, fast_hash);
+	} catch (const std::exception& e) {
+		log_err("Benchmark failed: %s\n", e.what());
+		cleanup_headless_environment();
+		return 1;
+	}
+	cleanup_headless_environment();
+	return 0;
+}
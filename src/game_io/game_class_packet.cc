@@ -19,6 +19,7 @@
 
 #include "game_io/game_class_packet.h"
 
+#include "economy/economy.h"
 #include "io/fileread.h"
 #include "io/filewrite.h"
 #include "logic/game.h"
@@ -26,16 +27,25 @@
 
 namespace Widelands {
 
-constexpr uint16_t kCurrentPacketVersion = 4;
+constexpr uint16_t kCurrentPacketVersion = 6;
 
 void GameClassPacket::read(FileSystem& fs, Game& game, MapObjectLoader*) {
 	try {
 		FileRead fr;
 		fr.open(fs, "binary/game_class");
 		uint16_t const packet_version = fr.unsigned_16();
-		if (packet_version == kCurrentPacketVersion) {
+		// Version 4 didn't store the last serial, version 5 didn't store the economy serial
+		if (packet_version >= 4 && packet_version <= kCurrentPacketVersion) {
 			game.gametime_ = Time(fr);
 			game.scenario_difficulty_ = fr.unsigned_32();
+			if (packet_version >= 5) {
+				// Map objects are loaded with the serials they had when the game was saved
+				game.objects().keep_serials(fr.unsigned_32());
+			}
+			if (packet_version >= 6) {
+				// New economies get the same serials as in the game that was saved
+				Economy::set_next_serial(fr.unsigned_32());
+			}
 		} else {
 			throw UnhandledVersionError("GameClassPacket", packet_version, kCurrentPacketVersion);
 		}
@@ -64,6 +74,10 @@ void GameClassPacket::write(FileSystem& fs, Game& game, MapObjectSaver* const) {
 
 	fw.unsigned_32(game.scenario_difficulty_);
 
+	// Map objects keep their serials, so that player commands remain valid across reloading
+	fw.unsigned_32(game.objects().last_serial());
+	fw.unsigned_32(Economy::next_serial());
+
 	// TODO(sirver,trading): save/load trade_agreements and related data.
 
 	// We do not care for players, since they were set
@@ -63,9 +63,7 @@ void GamePlayerAiPersistentPacket::read(FileSystem& fs, Game& game, MapObjectLoa
 				}
 				assert(player->ai_data.magic_numbers.size() ==
 				       Widelands::Player::AiPersistentState::kMagicNumbersSize);
-				for (size_t i = 0; i < magic_numbers_size; ++i) {
-					player->ai_data.magic_numbers.at(i) = fr.signed_16();
-				}
+				fr.read_array(player->ai_data.magic_numbers.data(), magic_numbers_size);
 
 				// Neurons
 				const size_t neuron_pool_size = fr.unsigned_32();
@@ -76,14 +74,10 @@ void GamePlayerAiPersistentPacket::read(FileSystem& fs, Game& game, MapObjectLoa
 				}
 				assert(player->ai_data.neuron_weights.size() ==
 				       Widelands::Player::AiPersistentState::kNeuronPoolSize);
-				for (size_t i = 0; i < neuron_pool_size; ++i) {
-					player->ai_data.neuron_weights.at(i) = fr.signed_8();
-				}
+				fr.read_array(player->ai_data.neuron_weights.data(), neuron_pool_size);
 				assert(player->ai_data.neuron_functs.size() ==
 				       Widelands::Player::AiPersistentState::kNeuronPoolSize);
-				for (size_t i = 0; i < neuron_pool_size; ++i) {
-					player->ai_data.neuron_functs.at(i) = fr.signed_8();
-				}
+				fr.read_array(player->ai_data.neuron_functs.data(), neuron_pool_size);
 
 				// F-neurons
 				const size_t f_neuron_pool_size = fr.unsigned_32();
@@ -94,9 +88,7 @@ void GamePlayerAiPersistentPacket::read(FileSystem& fs, Game& game, MapObjectLoa
 				}
 				assert(player->ai_data.f_neurons.size() ==
 				       Widelands::Player::AiPersistentState::kFNeuronPoolSize);
-				for (size_t i = 0; i < f_neuron_pool_size; ++i) {
-					player->ai_data.f_neurons.at(i) = fr.unsigned_32();
-				}
+				fr.read_array(player->ai_data.f_neurons.data(), f_neuron_pool_size);
 
 				// Remaining buildings for basic economy
 				assert(player->ai_data.remaining_basic_buildings.empty());
@@ -151,29 +143,21 @@ void GamePlayerAiPersistentPacket::write(FileSystem& fs, Game& game, MapObjectSa
 		assert(player->ai_data.magic_numbers.size() ==
 		       Widelands::Player::AiPersistentState::kMagicNumbersSize);
 		fw.unsigned_32(player->ai_data.magic_numbers.size());
-		for (int16_t magic_number : player->ai_data.magic_numbers) {
-			fw.signed_16(magic_number);
-		}
+		fw.write_array(player->ai_data.magic_numbers);
 		// Neurons
 		fw.unsigned_32(Widelands::Player::AiPersistentState::kNeuronPoolSize);
 		assert(player->ai_data.neuron_weights.size() ==
 		       Widelands::Player::AiPersistentState::kNeuronPoolSize);
 		assert(player->ai_data.neuron_functs.size() ==
 		       Widelands::Player::AiPersistentState::kNeuronPoolSize);
-		for (size_t i = 0; i < Widelands::Player::AiPersistentState::kNeuronPoolSize; ++i) {
-			fw.signed_8(player->ai_data.neuron_weights.at(i));
-		}
-		for (size_t i = 0; i < Widelands::Player::AiPersistentState::kNeuronPoolSize; ++i) {
-			fw.signed_8(player->ai_data.neuron_functs.at(i));
-		}
+		fw.write_array(player->ai_data.neuron_weights);
+		fw.write_array(player->ai_data.neuron_functs);
 
 		// F-Neurons
 		assert(player->ai_data.f_neurons.size() ==
 		       Widelands::Player::AiPersistentState::kFNeuronPoolSize);
 		fw.unsigned_32(player->ai_data.f_neurons.size());
-		for (uint32_t f_neuron : player->ai_data.f_neurons) {
-			fw.unsigned_32(f_neuron);
-		}
+		fw.write_array(player->ai_data.f_neurons);
 
 		// Remaining buildings for basic economy
 		fw.unsigned_32(player->ai_data.remaining_basic_buildings.size());
@@ -81,7 +81,7 @@ void GamePlayerEconomiesPacket::read(FileSystem& fs, Game& game, MapObjectLoader
 							assert(flag->owner().player_number() == player->player_number());
 							assert(flag->get_economy(type));
 							EconomyDataPacket d(flag->get_economy(type));
-							d.read(fr);
+							d.read(fr, *mol);
 						} catch (const GameDataError& e) {
 							throw GameDataError(
 							   "Error reading economy data for flag %u: %s", serial, e.what());
@@ -91,7 +91,7 @@ void GamePlayerEconomiesPacket::read(FileSystem& fs, Game& game, MapObjectLoader
 							assert(ship->owner().player_number() == player->player_number());
 							assert(ship->get_economy(type));
 							EconomyDataPacket d(ship->get_economy(type));
-							d.read(fr);
+							d.read(fr, *mol);
 						} catch (const GameDataError& e) {
 							throw GameDataError("Error reading economy data for ship %u '%s': %s", serial,
 							                    ship->get_shipname().c_str(), e.what());
@@ -40,7 +40,12 @@ constexpr const char* kMinimapFilename = "minimap.png";
 
 // Win condition localization can come from the 'widelands' or 'win_conditions' textdomain.
 std::string GamePreloadPacket::get_localized_win_condition() const {
-	const std::string result = _(win_condition_);
+	return localize_win_condition(win_condition_);
+}
+
+// static
+std::string GamePreloadPacket::localize_win_condition(const std::string& win_condition) {
+	const std::string result = _(win_condition);
 	i18n::Textdomain td("win_conditions");
 	return _(result);
 }
@@ -48,6 +48,7 @@ struct GamePreloadPacket : public GameDataPacket {
 		return win_condition_;
 	}
 	std::string get_localized_win_condition() const;
+	static std::string localize_win_condition(const std::string& win_condition);
 	const Time& get_gametime() const {
 		return gametime_;
 	}
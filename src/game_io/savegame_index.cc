@@ -0,0 +1,243 @@
+/*
+ * Copyright (C) 2020 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "game_io/savegame_index.h"
+
+#include <memory>
+
+#include "base/log.h"
+#include "game_io/game_preload_packet.h"
+#include "io/fileread.h"
+#include "io/filesystem/filesystem_exceptions.h"
+#include "io/filesystem/layered_filesystem.h"
+#include "io/filewrite.h"
+#include "logic/filesystem_constants.h"
+#include "logic/game_data_error.h"
+
+namespace Widelands {
+
+namespace {
+
+constexpr uint16_t kCurrentPacketVersion = 2;
+const std::string kIndexFilename = "index";
+const std::string kThumbnailExtension = ".png";
+/// Every savegame contains this file, and it is written anew with each save
+const std::string kPreloadFilename = "preload";
+
+uint64_t read_unsigned_64(FileRead& fr) {
+	const uint64_t high = fr.unsigned_32();
+	return (high << 32) | fr.unsigned_32();
+}
+
+void write_unsigned_64(FileWrite& fw, const uint64_t value) {
+	fw.unsigned_32(value >> 32);
+	fw.unsigned_32(value & 0xffffffff);
+}
+
+}  // namespace
+
+SavegameIndex::SavegameIndex(const std::string& directory)
+   : directory_(directory), changed_(false) {
+	read();
+}
+
+std::string SavegameIndex::index_dir() const {
+	return directory_ + FileSystem::file_separator() + kSavegameIndexDir;
+}
+
+std::string SavegameIndex::thumbnail_filename(const std::string& key) const {
+	return index_dir() + FileSystem::file_separator() + key + kThumbnailExtension;
+}
+
+void SavegameIndex::read() {
+	FileRead fr;
+	if (!fr.try_open(*g_fs, index_dir() + FileSystem::file_separator() + kIndexFilename)) {
+		return;
+	}
+
+	try {
+		const uint16_t packet_version = fr.unsigned_16();
+		if (packet_version != kCurrentPacketVersion) {
+			throw UnhandledVersionError("SavegameIndex", packet_version, kCurrentPacketVersion);
+		}
+		for (uint32_t i = fr.unsigned_32(); i; --i) {
+			const std::string key = fr.string();
+			Entry& entry = entries_[key];
+			entry.mtime = read_unsigned_64(fr);
+			entry.size = read_unsigned_64(fr);
+			entry.error = fr.string();
+			entry.mapname = fr.string();
+			entry.win_condition = fr.string();
+			entry.version = fr.string();
+			entry.gametime = fr.unsigned_32();
+			entry.number_of_players = fr.unsigned_8();
+			entry.savetimestamp = fr.unsigned_32();
+			entry.gametype = static_cast<GameController::GameType>(fr.unsigned_8());
+			entry.has_minimap = fr.unsigned_8();
+		}
+	} catch (const std::exception& e) {
+		// The index is only a cache, so we simply rebuild it.
+		log_warn("Discarding savegame index for %s: %s\n", directory_.c_str(), e.what());
+		entries_.clear();
+		changed_ = true;
+	}
+}
+
+void SavegameIndex::write() {
+	if (!changed_) {
+		return;
+	}
+
+	FileWrite fw;
+	fw.unsigned_16(kCurrentPacketVersion);
+	fw.unsigned_32(entries_.size());
+	for (const auto& key_and_entry : entries_) {
+		const Entry& entry = key_and_entry.second;
+		fw.string(key_and_entry.first);
+		write_unsigned_64(fw, entry.mtime);
+		write_unsigned_64(fw, entry.size);
+		fw.string(entry.error);
+		fw.string(entry.mapname);
+		fw.string(entry.win_condition);
+		fw.string(entry.version);
+		fw.unsigned_32(entry.gametime);
+		fw.unsigned_8(entry.number_of_players);
+		fw.unsigned_32(entry.savetimestamp);
+		fw.unsigned_8(static_cast<uint8_t>(entry.gametype));
+		fw.unsigned_8(entry.has_minimap ? 1 : 0);
+	}
+
+	try {
+		g_fs->ensure_directory_exists(index_dir());
+		fw.write(*g_fs, index_dir() + FileSystem::file_separator() + kIndexFilename);
+		changed_ = false;
+	} catch (const std::exception& e) {
+		log_warn("Unable to write savegame index for %s: %s\n", directory_.c_str(), e.what());
+	}
+}
+
+const SavegameIndex::Entry&
+SavegameIndex::get(const std::string& filename, const std::string& savename, Game& game) {
+	const std::string key = FileSystem::fs_filename(filename.c_str());
+	requested_.insert(key);
+
+	// Rewriting the files in a directory doesn't change the directory's modification time
+	const std::string stamped = g_fs->is_directory(savename) ?
+	                               savename + FileSystem::file_separator() + kPreloadFilename :
+	                               savename;
+	// A modification time of 0 means that it is unknown, so we can't trust the entry.
+	const uint64_t mtime = g_fs->get_modification_time(stamped);
+	const uint64_t size = g_fs->get_file_size(stamped);
+	auto it = entries_.find(key);
+	if (it != entries_.end() && mtime != 0 && it->second.mtime == mtime &&
+	    it->second.size == size) {
+		return it->second;
+	}
+
+	Entry& entry = entries_[key];
+	entry = Entry();
+	entry.mtime = mtime;
+	entry.size = size;
+	changed_ = true;
+
+	try {
+		std::unique_ptr<FileSystem> fs(g_fs->make_sub_file_system(savename));
+		GamePreloadPacket gpdp;
+		gpdp.read(*fs, game);
+		entry.mapname = gpdp.get_mapname();
+		entry.win_condition = gpdp.get_win_condition();
+		entry.version = gpdp.get_version();
+		entry.gametime = gpdp.get_gametime().get();
+		entry.number_of_players = gpdp.get_number_of_players();
+		entry.savetimestamp = gpdp.get_savetimestamp();
+		entry.gametype = gpdp.get_gametype();
+
+		if (!gpdp.get_minimap_path().empty()) {
+			// Copy the minimap, so that the game details don't need to open the archive either
+			try {
+				FileRead fr;
+				fr.open(*fs, gpdp.get_minimap_path());
+				g_fs->ensure_directory_exists(index_dir());
+				g_fs->write(thumbnail_filename(key), fr.data(fr.get_size(), 0), fr.get_size());
+				entry.has_minimap = true;
+			} catch (const std::exception& e) {
+				log_warn("Unable to cache minimap for %s: %s\n", savename.c_str(), e.what());
+			}
+		}
+	} catch (const std::exception& e) {
+		entry.error = e.what();
+	}
+	return entry;
+}
+
+std::string SavegameIndex::minimap_path(const std::string& filename) const {
+	const std::string key = FileSystem::fs_filename(filename.c_str());
+	auto it = entries_.find(key);
+	if (it == entries_.end() || !it->second.has_minimap) {
+		return "";
+	}
+	return thumbnail_filename(key);
+}
+
+void SavegameIndex::remove_entry(const std::string& key) {
+	auto it = entries_.find(key);
+	if (it == entries_.end()) {
+		return;
+	}
+	if (it->second.has_minimap) {
+		try {
+			g_fs->fs_unlink(thumbnail_filename(key));
+		} catch (const FileError& e) {
+			log_warn("Unable to delete cached minimap: %s\n", e.what());
+		}
+	}
+	entries_.erase(it);
+	changed_ = true;
+}
+
+void SavegameIndex::remove_stale_entries() {
+	std::set<std::string> stale;
+	for (const auto& key_and_entry : entries_) {
+		if (requested_.count(key_and_entry.first) == 0) {
+			stale.insert(key_and_entry.first);
+		}
+	}
+	for (const std::string& key : stale) {
+		remove_entry(key);
+	}
+}
+
+// static
+void SavegameIndex::invalidate(const std::string& filename) {
+	std::string directory = FileSystem::fs_dirname(filename);
+	if (!directory.empty()) {
+		// fs_dirname always returns a directory with a separator at the end.
+		directory.pop_back();
+	}
+	SavegameIndex index(directory);
+	index.remove_entry(FileSystem::fs_filename(filename.c_str()));
+	index.write();
+}
+
+// static
+bool SavegameIndex::is_index_directory(const std::string& path) {
+	return FileSystem::fs_filename(path.c_str()) == kSavegameIndexDir;
+}
+
+}  // namespace Widelands
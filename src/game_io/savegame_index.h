@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2020 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#ifndef WL_GAME_IO_SAVEGAME_INDEX_H
+#define WL_GAME_IO_SAVEGAME_INDEX_H
+
+#include <map>
+#include <set>
+#include <string>
+
+#include "logic/game_controller.h"
+
+namespace Widelands {
+
+class Game;
+
+/**
+ * A persistent index of the preload data of all savegames or replays in a
+ * directory, so that the load screens don't need to open every archive.
+ *
+ * The index lives in the hidden subdirectory 'kSavegameIndexDir' together with
+ * a copy of each game's minimap. Entries are validated lazily: an archive is
+ * only read again if its modification time or size has changed.
+ */
+class SavegameIndex {
+public:
+	struct Entry {
+		/// Modification time and size of the archive when the entry was created. For savegames
+		/// that are directories, these are taken from the preload file inside.
+		uint64_t mtime = 0;
+		uint64_t size = 0;
+		/// The error message if the preload data could not be read, empty otherwise
+		std::string error;
+
+		std::string mapname;
+		std::string win_condition;
+		std::string version;
+		uint32_t gametime = 0;
+		uint8_t number_of_players = 0;
+		uint32_t savetimestamp = 0;
+		GameController::GameType gametype = GameController::GameType::kUndefined;
+		/// Whether a copy of the minimap is available via minimap_path()
+		bool has_minimap = false;
+	};
+
+	/// Reads the index for 'directory'. A missing or unreadable index is treated as empty.
+	explicit SavegameIndex(const std::string& directory);
+
+	/// Returns the entry for the listed file 'filename'. Its preload data is read from the
+	/// archive 'savename' if there is no up-to-date entry yet.
+	const Entry& get(const std::string& filename, const std::string& savename, Game& game);
+
+	/// Returns the path of the cached minimap for 'filename', or an empty string if there is none.
+	std::string minimap_path(const std::string& filename) const;
+
+	/// Drops all entries that were not requested with get() since the index was read.
+	void remove_stale_entries();
+
+	/// Writes the index back to disk if it has changed.
+	void write();
+
+	/// Drops the entry for 'filename' from the index of its directory. Call this whenever a
+	/// savegame or replay is overwritten or deleted.
+	static void invalidate(const std::string& filename);
+
+	/// Whether 'path' is an index directory. These should not be listed as subdirectories.
+	static bool is_index_directory(const std::string& path);
+
+private:
+	void read();
+	void remove_entry(const std::string& key);
+	std::string index_dir() const;
+	std::string thumbnail_filename(const std::string& key) const;
+
+	const std::string directory_;
+	std::map<std::string, Entry> entries_;
+	std::set<std::string> requested_;
+	bool changed_;
+};
+
+}  // namespace Widelands
+
+#endif  // end of include guard: WL_GAME_IO_SAVEGAME_INDEX_H
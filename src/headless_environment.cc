@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2020 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "headless_environment.h"
+
+#include <memory>
+
+#include <SDL.h>
+
+#include "base/i18n.h"
+#include "base/log.h"
+#include "base/wexception.h"
+#include "config.h"
+#include "graphic/graphic.h"
+#include "io/filesystem/disk_filesystem.h"
+#include "io/filesystem/layered_filesystem.h"
+#include "logic/filesystem_constants.h"
+#include "sound/sound_handler.h"
+#include "wlapplication_options.h"
+
+namespace {
+
+std::string default_homedir() {
+#ifdef _WIN32
+	return FileSystem::get_homedir() + "\\.widelands";
+#elif defined USE_XDG
+	return FileSystem::get_userdatadir();
+#else
+	return FileSystem::get_homedir() + "/.widelands";
+#endif
+}
+
+}  // namespace
+
+void initialize_headless_environment(Section& config) {
+	i18n::set_locale("en");
+
+	if (SDL_Init(SDL_INIT_VIDEO) != 0) {
+		throw wexception("Failed to initialize SDL: %s", SDL_GetError());
+	}
+
+	const std::string homedir = config.get_string("homedir", default_homedir().c_str());
+	std::unique_ptr<FileSystem> home(new RealFSImpl(homedir));
+	home->ensure_directory_exists(".");
+	g_fs->set_home_file_system(home.release());
+	g_fs->ensure_directory_exists(kSaveDir);
+	g_fs->ensure_directory_exists(kReplayDir);
+	log_info("Set home directory: %s\n", homedir.c_str());
+
+#ifdef USE_XDG
+	set_config_directory(config.get_string("homedir", FileSystem::get_userconfigdir().c_str()));
+#else
+	set_config_directory(homedir);
+#endif
+	read_config();
+
+	const std::string datadir = config.get_string("datadir", INSTALL_DATADIR);
+	log_info("Adding directory: %s\n", datadir.c_str());
+	g_fs->add_file_system(&FileSystem::create(datadir));
+
+	// Nothing is ever drawn, but the descriptions need the graphics to load
+	g_gr = new Graphic();
+	g_gr->initialize(Graphic::TraceGl::kNo, 1, 1, false, false);
+
+	SoundHandler::disable_backend();
+	g_sh = new SoundHandler();
+}
+
+void cleanup_headless_environment() {
+	delete g_sh;
+	g_sh = nullptr;
+	delete g_gr;
+	g_gr = nullptr;
+	delete g_fs;
+	g_fs = nullptr;
+	SDL_Quit();
+}
@@ -0,0 +1,38 @@
+/*
+ * Copyright (C) 2020 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#ifndef WL_HEADLESS_ENVIRONMENT_H
+#define WL_HEADLESS_ENVIRONMENT_H
+
+#include "io/profile.h"
+
+/**
+ * Sets up the parts of Widelands that a game needs, but nothing to interact
+ * with. g_fs must have been created already.
+ *
+ * The given section may override the directories with the keys
+ *  - homedir: the home directory, default is the one of the user
+ *  - datadir: the data directory, default is the installed one
+ */
+void initialize_headless_environment(Section& config);
+
+/// Tears down everything that \ref initialize_headless_environment set up, and g_fs.
+void cleanup_headless_environment();
+
+#endif  // end of include guard: WL_HEADLESS_ENVIRONMENT_H
@@ -19,6 +19,7 @@
 
 #include "io/fileread.h"
 
+#include <algorithm>
 #include <cassert>
 
 FileRead::FileRead() : data_(nullptr), length_(0) {
@@ -33,7 +34,8 @@ FileRead::~FileRead() {
 void FileRead::open(FileSystem& fs, const std::string& filename) {
 	assert(!data_);
 	data_ = static_cast<char*>(fs.load(filename, length_));
-	filepos_ = 0;
+	buffer_ = data_;
+	buffer_end_ = data_ + length_;
 }
 
 bool FileRead::try_open(FileSystem& fs, const std::string& filename) {
@@ -49,6 +51,7 @@ void FileRead::close() {
 	assert(data_);
 	free(data_);
 	data_ = nullptr;
+	buffer_ = buffer_end_ = nullptr;
 }
 
 size_t FileRead::get_size() const {
@@ -56,7 +59,7 @@ size_t FileRead::get_size() const {
 }
 
 bool FileRead::end_of_file() const {
-	return length_ <= filepos_;
+	return buffer_end_ <= buffer_;
 }
 
 void FileRead::set_file_pos(const Pos& pos) {
@@ -64,39 +67,37 @@ void FileRead::set_file_pos(const Pos& pos) {
 	if (pos >= length_) {
 		throw FileBoundaryExceeded();
 	}
-	filepos_ = pos;
+	buffer_ = data_ + pos;
 }
 
 FileRead::Pos FileRead::get_pos() const {
-	return filepos_;
+	return buffer_ - data_;
 }
 
 size_t FileRead::data(void* dst, size_t bufsize) {
 	assert(data_);
-	size_t read = 0;
-	for (; read < bufsize && filepos_ < length_; ++read, ++filepos_) {
-		static_cast<char*>(dst)[read] = data_[filepos_];
-	}
+	const size_t read = buffer_ < buffer_end_ ? std::min<size_t>(bufsize, buffer_end_ - buffer_) : 0;
+	memcpy(dst, buffer_, read);
+	buffer_ += read;
 	return read;
 }
 
 char* FileRead::data(uint32_t const bytes, const Pos& pos) {
 	assert(data_);
-	Pos i = pos;
-	if (pos.is_null()) {
-		i = filepos_;
-		filepos_ += bytes;
-	}
+	const size_t i = pos.is_null() ? get_pos() : pos;
 	if (length_ < i + bytes) {
 		throw FileBoundaryExceeded();
 	}
+	if (pos.is_null()) {
+		buffer_ += bytes;
+	}
 	return data_ + i;
 }
 
 char* FileRead::c_string(const Pos& pos) {
 	assert(data_);
 
-	Pos i = pos.is_null() ? filepos_ : pos;
+	Pos i = pos.is_null() ? get_pos() : pos;
 	if (i >= length_) {
 		throw FileBoundaryExceeded();
 	}
@@ -108,7 +109,7 @@ char* FileRead::c_string(const Pos& pos) {
 		throw FileBoundaryExceeded();
 	}
 	if (pos.is_null()) {
-		filepos_ = i;
+		buffer_ = data_ + i;
 	}
 	return result;
 }
@@ -121,19 +122,20 @@ char* FileRead::read_line() {
 	if (end_of_file()) {
 		return nullptr;
 	}
-	char* result = data_ + filepos_;
-	for (; data_[filepos_] && data_[filepos_] != '\n'; ++filepos_) {
-		if (data_[filepos_] == '\r') {
-			data_[filepos_] = '\0';
-			++filepos_;
-			if (data_[filepos_] == '\n') {
+	size_t filepos = get_pos();
+	char* result = data_ + filepos;
+	for (; data_[filepos] && data_[filepos] != '\n'; ++filepos) {
+		if (data_[filepos] == '\r') {
+			data_[filepos] = '\0';
+			++filepos;
+			if (data_[filepos] == '\n') {
 				break;
 			} else {
 				throw typename StreamRead::DataError("CR not immediately followed by LF");
 			}
 		}
 	}
-	data_[filepos_] = '\0';
-	++filepos_;
+	data_[filepos] = '\0';
+	buffer_ = data_ + filepos + 1;
 	return result;
 }
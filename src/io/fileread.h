@@ -112,9 +112,9 @@ public:
 	char* read_line();
 
 private:
+	// The current file position is the start of the StreamRead window.
 	char* data_;
 	size_t length_;
-	Pos filepos_;
 };
 
 #endif  // end of include guard: WL_IO_FILEREAD_H
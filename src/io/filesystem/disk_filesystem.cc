@@ -56,12 +56,16 @@
 struct FileSystemPath : public std::string {
 	bool exists_;
 	bool is_directory_;
+	time_t mtime_;
+	size_t size_;
 
 	explicit FileSystemPath(const std::string& path) : std::string(path) {
 		struct stat st;
 
 		exists_ = (stat(c_str(), &st) != -1);
 		is_directory_ = exists_ && S_ISDIR(st.st_mode);
+		mtime_ = exists_ ? st.st_mtime : 0;
+		size_ = exists_ && !is_directory_ ? static_cast<size_t>(st.st_size) : 0;
 	}
 };
 
@@ -171,6 +175,14 @@ bool RealFSImpl::is_directory(const std::string& path) const {
 	return FileSystemPath(canonicalize_name(path)).is_directory_;
 }
 
+time_t RealFSImpl::get_modification_time(const std::string& path) const {
+	return FileSystemPath(canonicalize_name(path)).mtime_;
+}
+
+size_t RealFSImpl::get_file_size(const std::string& path) const {
+	return FileSystemPath(canonicalize_name(path)).size_;
+}
+
 /**
  * Make a sub filesystem out of this filesystem
  */
@@ -32,6 +32,8 @@ public:
 	bool is_writable() const override;
 	bool file_exists(const std::string& path) const override;
 	bool is_directory(const std::string& path) const override;
+	time_t get_modification_time(const std::string& path) const override;
+	size_t get_file_size(const std::string& path) const override;
 	void ensure_directory_exists(const std::string& fs_dirname) override;
 	void make_directory(const std::string& fs_dirname) override;
 
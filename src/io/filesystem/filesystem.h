@@ -20,6 +20,7 @@
 #ifndef WL_IO_FILESYSTEM_FILESYSTEM_H
 #define WL_IO_FILESYSTEM_FILESYSTEM_H
 
+#include <ctime>
 #include <set>
 #include <string>
 #include <vector>
@@ -49,6 +50,11 @@ public:
 	virtual bool is_directory(const std::string& path) const = 0;
 	virtual bool file_exists(const std::string& path) const = 0;
 
+	/// Returns the time of the last modification of 'path', or 0 if it is unknown.
+	virtual time_t get_modification_time(const std::string& path) const = 0;
+	/// Returns the size of the file 'path' in bytes, or 0 if it is unknown.
+	virtual size_t get_file_size(const std::string& path) const = 0;
+
 	virtual void* load(const std::string& fname, size_t& length) = 0;
 
 	virtual void write(const std::string& fname, void const* data, size_t length) = 0;
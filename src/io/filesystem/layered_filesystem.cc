@@ -25,6 +25,56 @@
 #include "io/filesystem/filesystem_exceptions.h"
 #include "io/streamread.h"
 
+namespace {
+
+// The index keeps track of the filesystems that contain a file in a bit mask
+constexpr size_t kMaxIndexedFileSystems = 32;
+
+bool is_hidden(const std::string& path) {
+	const size_t pos = path.find_last_of('/');
+	return path[pos == std::string::npos ? 0 : pos + 1] == '.';
+}
+
+/**
+ * Convert a relative path into the form used by the index, i.e. without empty
+ * and "." components. Returns false if the path can't be indexed, e.g. because
+ * it is absolute, goes up with "..", or contains hidden components, which are
+ * not listed by disk filesystems. Zip filesystems list their files with a
+ * leading separator, so 'is_listing' allows for this.
+ */
+bool normalize_path(const std::string& path, bool is_listing, std::string* result) {
+	result->clear();
+	if (path.empty() || path[0] == '~' || (path[0] == '/' && !is_listing) ||
+	    path.find_first_of("\\:*?[") != std::string::npos) {
+		return false;
+	}
+	size_t start = 0;
+	while (start <= path.size()) {
+		size_t end = path.find('/', start);
+		if (end == std::string::npos) {
+			end = path.size();
+		}
+		if (end > start && !(end == start + 1 && path[start] == '.')) {
+			if (path[start] == '.') {
+				return false;
+			}
+			if (!result->empty()) {
+				result->push_back('/');
+			}
+			result->append(path, start, end - start);
+		}
+		start = end + 1;
+	}
+	return !result->empty();
+}
+
+std::string parent_directory(const std::string& normalized_path) {
+	const size_t pos = normalized_path.find_last_of('/');
+	return pos == std::string::npos ? std::string() : normalized_path.substr(0, pos);
+}
+
+}  // namespace
+
 LayeredFileSystem* g_fs;
 LayeredFileSystem::LayeredFileSystem() : home_(nullptr) {
 }
@@ -45,12 +95,115 @@ bool LayeredFileSystem::is_writable() const {
 
 void LayeredFileSystem::add_file_system(FileSystem* fs) {
 	filesystems_.emplace_back(fs);
+	invalidate_index();
+}
+
+void LayeredFileSystem::remove_file_system(const FileSystem* fs) {
+	for (auto it = filesystems_.begin(); it != filesystems_.end(); ++it) {
+		if (it->get() == fs) {
+			filesystems_.erase(it);
+			invalidate_index();
+			return;
+		}
+	}
+	throw wexception("LayeredFileSystem: Trying to remove a filesystem that is not in the stack");
 }
 
 void LayeredFileSystem::set_home_file_system(FileSystem* fs) {
 	home_.reset(fs);
 }
 
+/**
+ * Look up 'path' in the index of the filesystems below the home filesystem.
+ * Returns kNotIndexed if the caller needs to probe the filesystems instead.
+ */
+LayeredFileSystem::IndexLookup LayeredFileSystem::find_in_index(const std::string& path,
+                                                                IndexEntry* entry) const {
+	std::string normalized;
+	if (filesystems_.size() > kMaxIndexedFileSystems || !normalize_path(path, false, &normalized)) {
+		return IndexLookup::kNotIndexed;
+	}
+	const std::string directory = parent_directory(normalized);
+	if (directory.empty()) {
+		// Zip filesystems can't list their root directory
+		return IndexLookup::kNotIndexed;
+	}
+
+	std::lock_guard<std::mutex> lock(index_mutex_);
+	const IndexedDirectory& indexed = indexed_directory(directory);
+	if (!indexed.is_valid) {
+		return IndexLookup::kNotIndexed;
+	}
+	const auto it = indexed.entries.find(normalized);
+	if (it == indexed.entries.end()) {
+		return IndexLookup::kNotFound;
+	}
+	*entry = it->second;
+	return IndexLookup::kFound;
+}
+
+const LayeredFileSystem::IndexedDirectory&
+LayeredFileSystem::indexed_directory(const std::string& directory) const {
+	const auto it = index_.find(directory);
+	if (it != index_.end()) {
+		return it->second;
+	}
+
+	IndexedDirectory indexed;
+	for (size_t i = filesystems_.size(); i > 0; --i) {
+		const size_t filesystem = i - 1;
+		for (const std::string& file : filesystems_[filesystem]->list_directory(directory)) {
+			indexed.files.insert(file);
+
+			std::string normalized;
+			if (!normalize_path(file, true, &normalized) ||
+			    parent_directory(normalized) != directory) {
+				// Hidden files are never looked up in the index, but anything else
+				// that we don't understand means that we can't trust the index.
+				if (!is_hidden(file)) {
+					indexed.is_valid = false;
+				}
+				continue;
+			}
+			auto entry = indexed.entries.emplace(normalized, IndexEntry{filesystem, 0});
+			entry.first->second.filesystems |= 1u << filesystem;
+		}
+	}
+	return index_.emplace(directory, std::move(indexed)).first->second;
+}
+
+void LayeredFileSystem::invalidate_index() {
+	std::lock_guard<std::mutex> lock(index_mutex_);
+	index_.clear();
+}
+
+/**
+ * Returns the filesystem that 'path' is read from: the home filesystem or the
+ * topmost filesystem that contains it. Returns nullptr if it doesn't exist.
+ */
+FileSystem* LayeredFileSystem::find_file_system(const std::string& path) const {
+	if (home_ && home_->file_exists(path)) {
+		return home_.get();
+	}
+
+	IndexEntry entry;
+	switch (find_in_index(path, &entry)) {
+	case IndexLookup::kFound:
+		return filesystems_[entry.filesystem].get();
+	case IndexLookup::kNotFound:
+		return nullptr;
+	case IndexLookup::kNotIndexed:
+		break;
+	}
+
+	for (auto it = filesystems_.rbegin(); it != filesystems_.rend(); ++it) {
+		if ((*it)->file_exists(path)) {
+			return it->get();
+		}
+	}
+	return nullptr;
+}
+
 /**
  * Find files in all sub-filesystems in the given path, with the given pattern.
  * Store all found files in results.
@@ -70,6 +223,14 @@ FilenameSet LayeredFileSystem::list_directory(const std::string& path) const {
 		}
 	}
 
+	std::string directory;
+	if (filesystems_.size() <= kMaxIndexedFileSystems && normalize_path(path, false, &directory)) {
+		std::lock_guard<std::mutex> lock(index_mutex_);
+		const IndexedDirectory& indexed = indexed_directory(directory);
+		results.insert(indexed.files.begin(), indexed.files.end());
+		return results;
+	}
+
 	for (auto it = filesystems_.rbegin(); it != filesystems_.rend(); ++it) {
 		files = (*it)->list_directory(path);
 
@@ -84,16 +245,7 @@ FilenameSet LayeredFileSystem::list_directory(const std::string& path) const {
  * Returns true if the file can be found in at least one of the sub-filesystems
  */
 bool LayeredFileSystem::file_exists(const std::string& path) const {
-	if (home_ && home_->file_exists(path)) {
-		return true;
-	}
-	for (auto it = filesystems_.rbegin(); it != filesystems_.rend(); ++it) {
-		if ((*it)->file_exists(path)) {
-			return true;
-		}
-	}
-
-	return false;
+	return find_file_system(path) != nullptr;
 }
 
 /**
@@ -105,6 +257,21 @@ bool LayeredFileSystem::is_directory(const std::string& path) const {
 		return true;
 	}
 
+	IndexEntry entry;
+	switch (find_in_index(path, &entry)) {
+	case IndexLookup::kFound:
+		for (size_t i = 0; i < filesystems_.size(); ++i) {
+			if ((entry.filesystems & (1u << i)) && filesystems_[i]->is_directory(path)) {
+				return true;
+			}
+		}
+		return false;
+	case IndexLookup::kNotFound:
+		return false;
+	case IndexLookup::kNotIndexed:
+		break;
+	}
+
 	for (auto it = filesystems_.rbegin(); it != filesystems_.rend(); ++it) {
 		if ((*it)->is_directory(path)) {
 			return true;
@@ -114,6 +281,24 @@ bool LayeredFileSystem::is_directory(const std::string& path) const {
 	return false;
 }
 
+/**
+ * Returns the modification time of 'path' in the first sub-filesystem where it
+ * exists, or 0 if it can't be found.
+ */
+time_t LayeredFileSystem::get_modification_time(const std::string& path) const {
+	FileSystem* fs = find_file_system(path);
+	return fs ? fs->get_modification_time(path) : 0;
+}
+
+/**
+ * Returns the size of 'path' in the first sub-filesystem where it exists, or 0
+ * if it can't be found.
+ */
+size_t LayeredFileSystem::get_file_size(const std::string& path) const {
+	FileSystem* fs = find_file_system(path);
+	return fs ? fs->get_file_size(path) : 0;
+}
+
 /**
  * Read the given file into alloced memory; called by FileRead::open.
  * Throws an exception if the file couldn't be opened.
@@ -123,14 +308,8 @@ bool LayeredFileSystem::is_directory(const std::string& path) const {
  * Let's just avoid any possible hassles with that.
  */
 void* LayeredFileSystem::load(const std::string& fname, size_t& length) {
-	if (home_ && home_->file_exists(fname)) {
-		return home_->load(fname, length);
-	}
-
-	for (auto it = filesystems_.rbegin(); it != filesystems_.rend(); ++it) {
-		if ((*it)->file_exists(fname)) {
-			return (*it)->load(fname, length);
-		}
+	if (FileSystem* fs = find_file_system(fname)) {
+		return fs->load(fname, length);
 	}
 
 	throw FileNotFoundError("LayeredFileSystem: Could not load file", paths_error_message(fname));
@@ -149,6 +328,7 @@ void LayeredFileSystem::write(const std::string& fname,
 
 	for (auto it = filesystems_.rbegin(); it != filesystems_.rend(); ++it) {
 		if ((*it)->is_writable()) {
+			invalidate_index();
 			return (*it)->write(fname, data, length);
 		}
 	}
@@ -162,14 +342,8 @@ void LayeredFileSystem::write(const std::string& fname,
  * it exists.
  */
 StreamRead* LayeredFileSystem::open_stream_read(const std::string& fname) {
-	if (home_ && home_->file_exists(fname)) {
-		return home_->open_stream_read(fname);
-	}
-
-	for (auto it = filesystems_.rbegin(); it != filesystems_.rend(); ++it) {
-		if ((*it)->file_exists(fname)) {
-			return (*it)->open_stream_read(fname);
-		}
+	if (FileSystem* fs = find_file_system(fname)) {
+		return fs->open_stream_read(fname);
 	}
 
 	throw FileNotFoundError(
@@ -186,6 +360,7 @@ StreamWrite* LayeredFileSystem::open_stream_write(const std::string& fname) {
 
 	for (auto it = filesystems_.rbegin(); it != filesystems_.rend(); ++it) {
 		if ((*it)->is_writable()) {
+			invalidate_index();
 			return (*it)->open_stream_write(fname);
 		}
 	}
@@ -203,6 +378,7 @@ void LayeredFileSystem::make_directory(const std::string& dirname) {
 
 	for (auto it = filesystems_.rbegin(); it != filesystems_.rend(); ++it) {
 		if ((*it)->is_writable()) {
+			invalidate_index();
 			return (*it)->make_directory(dirname);
 		}
 	}
@@ -220,6 +396,7 @@ void LayeredFileSystem::ensure_directory_exists(const std::string& dirname) {
 
 	for (auto it = filesystems_.rbegin(); it != filesystems_.rend(); ++it) {
 		if ((*it)->is_writable()) {
+			invalidate_index();
 			return (*it)->ensure_directory_exists(dirname);
 		}
 	}
@@ -237,6 +414,7 @@ FileSystem* LayeredFileSystem::make_sub_file_system(const std::string& dirname)
 
 	for (auto it = filesystems_.rbegin(); it != filesystems_.rend(); ++it) {
 		if ((*it)->is_writable() && (*it)->file_exists(dirname)) {
+			invalidate_index();
 			return (*it)->make_sub_file_system(dirname);
 		}
 	}
@@ -255,6 +433,7 @@ FileSystem* LayeredFileSystem::create_sub_file_system(const std::string& dirname
 
 	for (auto it = filesystems_.rbegin(); it != filesystems_.rend(); ++it) {
 		if ((*it)->is_writable() && !(*it)->file_exists(dirname)) {
+			invalidate_index();
 			return (*it)->create_sub_file_system(dirname, type);
 		}
 	}
@@ -278,6 +457,7 @@ void LayeredFileSystem::fs_unlink(const std::string& file) {
 
 	for (auto it = filesystems_.rbegin(); it != filesystems_.rend(); ++it) {
 		if ((*it)->is_writable() && (*it)->file_exists(file)) {
+			invalidate_index();
 			(*it)->fs_unlink(file);
 			return;
 		}
@@ -294,6 +474,7 @@ void LayeredFileSystem::fs_rename(const std::string& old_name, const std::string
 	}
 	for (auto it = filesystems_.rbegin(); it != filesystems_.rend(); ++it) {
 		if ((*it)->is_writable() && (*it)->file_exists(old_name)) {
+			invalidate_index();
 			(*it)->fs_rename(old_name, new_name);
 			return;
 		}
@@ -21,6 +21,8 @@
 #define WL_IO_FILESYSTEM_LAYERED_FILESYSTEM_H
 
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 
 #include "io/filesystem/filesystem.h"
 
@@ -42,6 +44,13 @@
  *
  * $CWD  <-- the current-working directory; this is useful for debugging, when
  * the executable isn't in the root of the game-data directory
+ *
+ * Lookups in the filesystems below the home filesystem are served from an
+ * index that is built lazily per directory. It is discarded whenever the stack
+ * changes or something is written through this class to one of these
+ * filesystems. Changes to them from outside of this class won't be noticed,
+ * which is fine for the game data directories. The home filesystem is always
+ * probed directly.
  */
 class LayeredFileSystem : public FileSystem {
 public:
@@ -52,6 +61,9 @@ public:
 	// filesystem.
 	void add_file_system(FileSystem*);
 
+	// Remove the given filesystem from the stack and delete it.
+	void remove_file_system(const FileSystem*);
+
 	// Set the home filesystem (which is the preferred filesystem for writing
 	// files). Take ownership of the given filesystem.
 	void set_home_file_system(FileSystem*);
@@ -61,6 +73,8 @@ public:
 	bool is_writable() const override;
 	bool file_exists(const std::string& path) const override;
 	bool is_directory(const std::string& path) const override;
+	time_t get_modification_time(const std::string& path) const override;
+	size_t get_file_size(const std::string& path) const override;
 	void ensure_directory_exists(const std::string& fs_dirname) override;
 	void make_directory(const std::string& fs_dirname) override;
 
@@ -82,11 +96,48 @@ public:
 	unsigned long long disk_space() override;  // NOLINT
 
 private:
+	/// Which of the filesystems below the home filesystem contain an indexed file
+	struct IndexEntry {
+		/// The topmost filesystem that contains the file
+		size_t filesystem;
+		/// Bit mask of all filesystems that contain the file
+		uint32_t filesystems;
+	};
+
+	/// The merged contents of a directory
+	struct IndexedDirectory {
+		IndexedDirectory() : is_valid(true) {
+		}
+
+		/// False if a listing couldn't be indexed. Lookups then probe the filesystems directly.
+		bool is_valid;
+		/// The files as listed by the filesystems
+		FilenameSet files;
+		/// Normalized filename -> filesystems
+		std::unordered_map<std::string, IndexEntry> entries;
+	};
+
+	enum class IndexLookup { kNotIndexed, kNotFound, kFound };
+
+	/// Looks up 'path' in the index, indexing its directory first if necessary.
+	IndexLookup find_in_index(const std::string& path, IndexEntry* entry) const;
+	/// Returns the index of the given normalized directory, creating it if necessary.
+	/// The caller must hold 'index_mutex_'.
+	const IndexedDirectory& indexed_directory(const std::string& directory) const;
+	/// Discards the index, e.g. after a filesystem below the home filesystem was modified.
+	void invalidate_index();
+
+	FileSystem* find_file_system(const std::string& path) const;
+
 	/// This is used to assemble an error message for exceptions that includes all file paths
 	std::string paths_error_message(const std::string& filename) const;
 
 	std::vector<std::unique_ptr<FileSystem>> filesystems_;
 	std::unique_ptr<FileSystem> home_;
+
+	/// Normalized directory -> merged contents of all filesystems below the home filesystem
+	mutable std::unordered_map<std::string, IndexedDirectory> index_;
+	mutable std::mutex index_mutex_;
 };
 
 /// Access all game data files etc. through this FileSystem
@@ -25,6 +25,7 @@
 
 #include "base/macros.h"
 #include "io/filesystem/disk_filesystem.h"
+#include "io/filesystem/layered_filesystem.h"
 
 #ifdef _WIN32
 static std::string Win32Path(std::string s) {
@@ -188,5 +189,50 @@ BOOST_AUTO_TEST_CASE(test_canonicalize_name_home_expansion) {
 	TEST_CANONICALIZE_NAME("/opt", "a/~path/here", "/opt/a/~path/here")
 	TEST_CANONICALIZE_NAME("/opt", "a/path~/here", "/opt/a/path~/here")
 }
+
+// Lookups through the layered filesystem's index have to agree with the layers
+BOOST_AUTO_TEST_CASE(test_layered_filesystem) {
+	RealFSImpl base(RealFSImpl("").get_working_directory());
+	const std::string testdir = "test_layered_filesystem";
+	base.fs_unlink(testdir);
+	base.ensure_directory_exists(testdir + "/lower/dir");
+	base.ensure_directory_exists(testdir + "/upper/dir");
+	base.write(testdir + "/lower/dir/a", "l", 1);
+	base.write(testdir + "/lower/dir/c", "l", 1);
+	base.write(testdir + "/upper/dir/b", "u", 1);
+	base.write(testdir + "/upper/dir/c", "u", 1);
+
+	LayeredFileSystem layered;
+	layered.add_file_system(new RealFSImpl(testdir + "/lower"));
+	FileSystem* upper = new RealFSImpl(testdir + "/upper");
+	layered.add_file_system(upper);
+
+	BOOST_CHECK(layered.file_exists("dir/a"));
+	BOOST_CHECK(layered.file_exists("dir/b"));
+	BOOST_CHECK(layered.file_exists("./dir//c"));
+	BOOST_CHECK(!layered.file_exists("dir/d"));
+	BOOST_CHECK(layered.is_directory("dir"));
+	BOOST_CHECK(!layered.is_directory("dir/a"));
+	BOOST_CHECK_EQUAL(layered.list_directory("dir").size(), 3);
+
+	size_t length = 0;
+	void* data = layered.load("dir/c", length);
+	BOOST_CHECK_EQUAL(length, 1);
+	BOOST_CHECK_EQUAL(*static_cast<char*>(data), 'u');
+	free(data);
+
+	// Writing and removing filesystems must be noticed
+	layered.write("dir/d", "u", 1);
+	BOOST_CHECK(layered.file_exists("dir/d"));
+	BOOST_CHECK_EQUAL(layered.list_directory("dir").size(), 4);
+
+	layered.remove_file_system(upper);
+	BOOST_CHECK(!layered.file_exists("dir/b"));
+	data = layered.load("dir/c", length);
+	BOOST_CHECK_EQUAL(*static_cast<char*>(data), 'l');
+	free(data);
+
+	base.fs_unlink(testdir);
+}
 #endif
 BOOST_AUTO_TEST_SUITE_END()
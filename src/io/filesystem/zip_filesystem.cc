@@ -256,6 +256,43 @@ bool ZipFilesystem::file_exists(const std::string& path) const {
 	return false;
 }
 
+/**
+ * Returns the modification time that is stored in the zip file for 'path', or 0
+ * if the file does not exist.
+ */
+time_t ZipFilesystem::get_modification_time(const std::string& path) const {
+	if (!file_exists(path)) {
+		return 0;
+	}
+
+	unz_file_info file_info;
+	unzGetCurrentFileInfo(zip_file_->read_handle(), &file_info, nullptr, 0, nullptr, 0, nullptr, 0);
+
+	struct tm date;
+	memset(&date, 0, sizeof(date));
+	date.tm_sec = file_info.tmu_date.tm_sec;
+	date.tm_min = file_info.tmu_date.tm_min;
+	date.tm_hour = file_info.tmu_date.tm_hour;
+	date.tm_mday = file_info.tmu_date.tm_mday;
+	date.tm_mon = file_info.tmu_date.tm_mon;
+	date.tm_year = file_info.tmu_date.tm_year - 1900;
+	date.tm_isdst = -1;
+	return mktime(&date);
+}
+
+/**
+ * Returns the uncompressed size of 'path', or 0 if the file does not exist.
+ */
+size_t ZipFilesystem::get_file_size(const std::string& path) const {
+	if (!file_exists(path)) {
+		return 0;
+	}
+
+	unz_file_info file_info;
+	unzGetCurrentFileInfo(zip_file_->read_handle(), &file_info, nullptr, 0, nullptr, 0, nullptr, 0);
+	return file_info.uncompressed_size;
+}
+
 /**
  * Returns true if the given file is a directory, and false if it doesn't.
  * Also returns false if the pathname is invalid
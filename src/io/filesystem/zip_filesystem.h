@@ -38,6 +38,8 @@ public:
 	FilenameSet list_directory(const std::string& path) const override;
 
 	bool is_directory(const std::string& path) const override;
+	time_t get_modification_time(const std::string& path) const override;
+	size_t get_file_size(const std::string& path) const override;
 	bool file_exists(const std::string& path) const override;
 
 	void* load(const std::string& fname, size_t& length) override;
@@ -19,11 +19,15 @@
 
 #include "io/filewrite.h"
 
+#include <algorithm>
 #include <cassert>
 
 #include "io/filesystem/disk_filesystem.h"
 #include "io/filesystem/filesystem.h"
 
+// static
+bool FileWrite::fast_paths_ = true;
+
 FileWrite::FileWrite() : data_(nullptr), length_(0), max_size_(0), filepos_(0) {
 }
 
@@ -36,23 +40,43 @@ void FileWrite::clear() {
 	data_ = nullptr;
 	length_ = max_size_ = 0;
 	filepos_ = 0;
+	buffer_ = buffer_end_ = nullptr;
+}
+
+void FileWrite::close_window() {
+	if (buffer_ != nullptr) {
+		filepos_ = buffer_ - data_;
+		length_ = std::max<size_t>(length_, filepos_);
+		buffer_ = buffer_end_ = nullptr;
+	}
+}
+
+void FileWrite::open_window() {
+	if (fast_paths_ && data_ != nullptr && filepos_ <= max_size_) {
+		buffer_ = data_ + filepos_;
+		buffer_end_ = data_ + max_size_;
+	}
 }
 
 void FileWrite::write(FileSystem& fs, const std::string& filename) {
+	close_window();
 	fs.write(filename, data_, length_);
 	clear();
 }
 
 FileWrite::Pos FileWrite::get_pos() const {
-	return filepos_;
+	return buffer_ != nullptr ? Pos(buffer_ - data_) : filepos_;
 }
 
 void FileWrite::set_pos(const Pos& pos) {
+	close_window();
 	filepos_ = pos;
+	open_window();
 }
 
 void FileWrite::data(const void* const src, const size_t size, Pos const pos = Pos::null()) {
 	assert(data_ || !length_);
+	close_window();
 
 	Pos i = pos;
 	if (pos.is_null()) {
@@ -61,10 +85,9 @@ void FileWrite::data(const void* const src, const size_t size, Pos const pos = P
 	}
 	if (i + size > length_) {
 		if (i + size > max_size_) {
-			max_size_ += 4096;
-			if (max_size_ < i + size) {
-				max_size_ = i + size;
-			}
+			// Grow geometrically, so that writing large files takes linear time
+			max_size_ = std::max<size_t>(
+			   fast_paths_ ? std::max<size_t>(max_size_ * 2, 4096) : max_size_ + 4096, i + size);
 			char* new_data = static_cast<char*>(realloc(data_, max_size_));
 			assert(new_data);
 			data_ = new_data;
@@ -72,12 +95,19 @@ void FileWrite::data(const void* const src, const size_t size, Pos const pos = P
 		length_ = i + size;
 	}
 	memcpy(data_ + i, src, size);
+	open_window();
 }
 
 void FileWrite::data(void const* const src, size_t const size) {
 	data(src, size, Pos::null());
 }
 
+// static
+void FileWrite::set_fast_paths(bool const enabled) {
+	fast_paths_ = enabled;
+}
+
 std::string FileWrite::get_data() const {
-	return std::string(data_, length_);
+	return std::string(
+	   data_, buffer_ != nullptr ? std::max<size_t>(length_, buffer_ - data_) : length_);
 }
@@ -90,11 +90,25 @@ public:
 	/// Returns the current buffer. Use this for in_memory operations.
 	std::string get_data() const;
 
+	/// Only for benchmarks: With 'enabled' false, all FileWrites send every
+	/// value through data() and grow their memory in steps of 4 kB, like they
+	/// did before the fixed width fast paths were added.
+	static void set_fast_paths(bool enabled);
+
 private:
+	/// Takes over the bytes that were written through the StreamWrite window
+	/// into filepos_ and length_.
+	void close_window();
+	/// Lets the StreamWrite window cover the allocated memory after filepos_.
+	void open_window();
+
 	char* data_;
 	size_t length_;
 	size_t max_size_;
+	// Only up to date while the StreamWrite window is closed.
 	Pos filepos_;
+
+	static bool fast_paths_;
 };
 
 #endif  // end of include guard: WL_IO_FILEWRITE_H
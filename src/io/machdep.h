@@ -62,6 +62,15 @@ inline float swap_float(const float x) {
 	return s;
 }
 
+/// Reverses the byte order of any fixed width value.
+template <typename T> inline T swap_bytes(const T x) {
+	T s;
+	for (size_t i = 0; i < sizeof(T); ++i) {
+		reinterpret_cast<uint8_t*>(&s)[i] = reinterpret_cast<const uint8_t*>(&x)[sizeof(T) - 1 - i];
+	}
+	return s;
+}
+
 inline uint8_t deref_8(void const* const ptr) {
 	return *reinterpret_cast<uint8_t const*>(ptr);
 }
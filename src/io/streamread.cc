@@ -22,7 +22,6 @@
 #include <cstdarg>
 
 #include "base/wexception.h"
-#include "io/machdep.h"
 
 StreamRead::~StreamRead() {
 }
@@ -53,52 +52,16 @@ void StreamRead::data_complete(void* const read_data, const size_t size) {
 	}
 }
 
-int8_t StreamRead::signed_8() {
-	int8_t x;
-	data_complete(&x, 1);
-	return x;
-}
-
-uint8_t StreamRead::unsigned_8() {
-	uint8_t x;
-	data_complete(&x, 1);
-	return x;
-}
-
-int16_t StreamRead::signed_16() {
-	int16_t x;
-	data_complete(&x, 2);
-	return little_16(x);
-}
-
-uint16_t StreamRead::unsigned_16() {
-	uint16_t x;
-	data_complete(&x, 2);
-	return little_16(x);
-}
-
-int32_t StreamRead::signed_32() {
-	int32_t x;
-	data_complete(&x, 4);
-	return little_32(x);
-}
-
-uint32_t StreamRead::unsigned_32() {
-	uint32_t x;
-	data_complete(&x, 4);
-	return little_32(x);
-}
-
-float StreamRead::float_32() {
-	uint32_t x;
-	data_complete(&x, 4);
-	x = little_32(x);
-	float rv;
-	memcpy(&rv, &x, 4);
-	return rv;
-}
-
 std::string StreamRead::string() {
+	if (buffer_ < buffer_end_) {
+		const char* const end = static_cast<const char*>(memchr(buffer_, 0, buffer_end_ - buffer_));
+		if (end != nullptr) {
+			std::string x(buffer_, end);
+			buffer_ = end + 1;
+			return x;
+		}
+	}
+
 	std::string x;
 	char ch;
 
@@ -20,8 +20,14 @@
 #ifndef WL_IO_STREAMREAD_H
 #define WL_IO_STREAMREAD_H
 
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
 #include "base/macros.h"
 #include "base/wexception.h"
+#include "io/machdep.h"
 
 /**
  * Abstract base class for stream-like data sources.
@@ -38,7 +44,7 @@
  */
 class StreamRead {
 public:
-	explicit StreamRead() {
+	explicit StreamRead() : buffer_(nullptr), buffer_end_(nullptr) {
 	}
 	virtual ~StreamRead();
 
@@ -57,13 +63,30 @@ public:
 
 	void data_complete(void* data, size_t size);
 
-	int8_t signed_8();
-	uint8_t unsigned_8();
-	int16_t signed_16();
-	uint16_t unsigned_16();
-	int32_t signed_32();
-	uint32_t unsigned_32();
-	float float_32();
+	int8_t signed_8() {
+		return fixed<int8_t>();
+	}
+	uint8_t unsigned_8() {
+		return fixed<uint8_t>();
+	}
+	int16_t signed_16() {
+		return little_16(fixed<int16_t>());
+	}
+	uint16_t unsigned_16() {
+		return little_16(fixed<uint16_t>());
+	}
+	int32_t signed_32() {
+		return little_32(fixed<int32_t>());
+	}
+	uint32_t unsigned_32() {
+		return little_32(fixed<uint32_t>());
+	}
+	float float_32() {
+		const uint32_t x = little_32(fixed<uint32_t>());
+		float rv;
+		memcpy(&rv, &x, 4);
+		return rv;
+	}
 	std::string string();
 	virtual char const* c_string() {
 		throw;
@@ -77,7 +100,38 @@ public:
 	};
 #define data_error(...) DataError(__VA_ARGS__)
 
+	/// Read 'count' little endian values of a fixed width type at once.
+	/// Mirror of \ref StreamWrite::write_array.
+	template <typename T> void read_array(T* const values, const size_t count) {
+		static_assert(std::is_arithmetic<T>::value, "Only plain numbers can be read in bulk");
+		data_complete(values, count * sizeof(T));
+#if SDL_BYTEORDER != SDL_LIL_ENDIAN
+		for (size_t i = 0; i < count; ++i) {
+			values[i] = swap_bytes(values[i]);
+		}
+#endif
+	}
+
+protected:
+	/// Implementations can point this window to memory that the fixed width
+	/// readers may consume directly without going through data(). buffer_ is
+	/// advanced past every byte read this way, so implementations need to
+	/// account for it before touching their own state again.
+	const char* buffer_;
+	const char* buffer_end_;
+
 private:
+	template <typename T> T fixed() {
+		T x;
+		if (buffer_end_ - buffer_ >= static_cast<ptrdiff_t>(sizeof(T))) {
+			memcpy(&x, buffer_, sizeof(T));
+			buffer_ += sizeof(T);
+		} else {
+			data_complete(&x, sizeof(T));
+		}
+		return x;
+	}
+
 	DISALLOW_COPY_AND_ASSIGN(StreamRead);
 };
 
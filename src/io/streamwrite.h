@@ -20,8 +20,11 @@
 #ifndef WL_IO_STREAMWRITE_H
 #define WL_IO_STREAMWRITE_H
 
+#include <cstddef>
 #include <cstring>
 #include <string>
+#include <type_traits>
+#include <vector>
 
 #include "base/macros.h"
 #include "io/machdep.h"
@@ -38,7 +41,7 @@
  */
 class StreamWrite {
 public:
-	explicit StreamWrite() {
+	explicit StreamWrite() : buffer_(nullptr), buffer_end_(nullptr) {
 	}
 	virtual ~StreamWrite();
 
@@ -59,32 +62,27 @@ public:
 	void print_f(char const*, ...) __attribute__((format(printf, 2, 3)));
 
 	void signed_8(int8_t const x) {
-		data(&x, 1);
+		fixed(x);
 	}
 	void unsigned_8(uint8_t const x) {
-		data(&x, 1);
+		fixed(x);
 	}
 	void signed_16(int16_t const x) {
-		int16_t const y = little_16(x);
-		data(&y, 2);
+		fixed<int16_t>(little_16(x));
 	}
 	void unsigned_16(uint16_t const x) {
-		uint16_t const y = little_16(x);
-		data(&y, 2);
+		fixed<uint16_t>(little_16(x));
 	}
 	void signed_32(int32_t const x) {
-		uint32_t const y = little_32(x);
-		data(&y, 4);
+		fixed<uint32_t>(little_32(x));
 	}
 	void unsigned_32(uint32_t const x) {
-		uint32_t const y = little_32(x);
-		data(&y, 4);
+		fixed<uint32_t>(little_32(x));
 	}
 	void float_32(const float x) {
 		uint32_t y;
 		memcpy(&y, &x, 4);
-		y = little_32(y);
-		data(&y, 4);
+		fixed<uint32_t>(little_32(y));
 	}
 	void string(const std::string& str) {
 		data(str.c_str(), str.size() + 1);
@@ -106,7 +104,40 @@ public:
 		data(x.c_str(), x.size());
 	}
 
+	/// Write 'count' little endian values of a fixed width type at once. This
+	/// is a single call to data() on little endian machines.
+	template <typename T> void write_array(const T* const values, const size_t count) {
+		static_assert(std::is_arithmetic<T>::value, "Only plain numbers can be written in bulk");
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+		data(values, count * sizeof(T));
+#else
+		for (size_t i = 0; i < count; ++i) {
+			fixed(swap_bytes(values[i]));
+		}
+#endif
+	}
+	template <typename T> void write_array(const std::vector<T>& values) {
+		write_array(values.data(), values.size());
+	}
+
+protected:
+	/// Implementations can point this window to memory that the fixed width
+	/// writers may fill directly without going through data(). buffer_ is
+	/// advanced past every byte written this way, so implementations need to
+	/// account for it before touching their own state again.
+	char* buffer_;
+	char* buffer_end_;
+
 private:
+	template <typename T> void fixed(const T x) {
+		if (buffer_end_ - buffer_ >= static_cast<ptrdiff_t>(sizeof(T))) {
+			memcpy(buffer_, &x, sizeof(T));
+			buffer_ += sizeof(T);
+		} else {
+			data(&x, sizeof(T));
+		}
+	}
+
 	DISALLOW_COPY_AND_ASSIGN(StreamWrite);
 };
 
@@ -0,0 +1,234 @@
+/*
+ * Copyright (C) 2020 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "base/macros.h"
+#include "base/md5.h"
+#include "io/filesystem/disk_filesystem.h"
+#include "io/fileread.h"
+#include "io/filewrite.h"
+
+// BOOST_CHECK_EQUAL generates an old-style cast usage warning, so ignore
+#pragma GCC diagnostic ignored "-Wold-style-cast"
+
+// Triggered by BOOST_AUTO_TEST_CASE
+CLANG_DIAG_OFF("-Wdisabled-macro-expansion")
+CLANG_DIAG_OFF("-Wused-but-marked-unused")
+
+namespace {
+
+/// Goes through data() for every single value, like all streams did before
+/// the fixed width fast paths were added.
+class LegacyWrite : public StreamWrite {
+public:
+	void data(const void* const write_data, const size_t size) override {
+		result.append(static_cast<const char*>(write_data), size);
+	}
+	std::string result;
+};
+
+/// Reads from a string, either through data() only or through the window.
+class StringRead : public StreamRead {
+public:
+	StringRead(const std::string& input, bool use_window) : input_(input), pos_(0) {
+		if (use_window) {
+			buffer_ = input_.data();
+			buffer_end_ = input_.data() + input_.size();
+		}
+	}
+	size_t data(void* const read_data, const size_t bufsize) override {
+		if (buffer_ != nullptr) {
+			pos_ = buffer_ - input_.data();
+		}
+		const size_t read = std::min(bufsize, input_.size() - pos_);
+		memcpy(read_data, input_.data() + pos_, read);
+		pos_ += read;
+		if (buffer_ != nullptr) {
+			buffer_ = input_.data() + pos_;
+		}
+		return read;
+	}
+	bool end_of_file() const override {
+		return (buffer_ != nullptr ? static_cast<size_t>(buffer_ - input_.data()) : pos_) >=
+		       input_.size();
+	}
+
+private:
+	const std::string input_;
+	size_t pos_;
+};
+
+void write_values(StreamWrite& fw, uint32_t count) {
+	for (uint32_t i = 0; i < count; ++i) {
+		fw.unsigned_8(i & 0xff);
+		fw.signed_16(-static_cast<int16_t>(i & 0x7fff));
+		fw.unsigned_32(i * 2654435761U);
+		fw.float_32(i * 0.5f);
+		if (i % 16 == 0) {
+			fw.string("value " + std::to_string(i));
+		}
+	}
+}
+
+void check_values(StreamRead& fr, uint32_t count) {
+	for (uint32_t i = 0; i < count; ++i) {
+		BOOST_REQUIRE_EQUAL(fr.unsigned_8(), i & 0xff);
+		BOOST_REQUIRE_EQUAL(fr.signed_16(), -static_cast<int16_t>(i & 0x7fff));
+		BOOST_REQUIRE_EQUAL(fr.unsigned_32(), i * 2654435761U);
+		BOOST_REQUIRE_EQUAL(fr.float_32(), i * 0.5f);
+		if (i % 16 == 0) {
+			BOOST_REQUIRE_EQUAL(fr.string(), "value " + std::to_string(i));
+		}
+	}
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(StreamTests)
+
+BOOST_AUTO_TEST_CASE(filewrite_matches_plain_stream) {
+	LegacyWrite legacy;
+	FileWrite fw;
+	write_values(legacy, 5000);
+	write_values(fw, 5000);
+	BOOST_CHECK(fw.get_data() == legacy.result);
+	BOOST_CHECK_EQUAL(fw.get_pos(), legacy.result.size());
+
+	// Patch a value in the middle and continue writing at the end
+	fw.set_pos(1);
+	fw.signed_16(1234);
+	BOOST_CHECK_EQUAL(fw.get_pos(), 3U);
+	BOOST_CHECK_EQUAL(fw.get_data().size(), legacy.result.size());
+	fw.set_pos(legacy.result.size());
+	fw.unsigned_32(42);
+	BOOST_CHECK_EQUAL(fw.get_data().size(), legacy.result.size() + 4);
+}
+
+BOOST_AUTO_TEST_CASE(read_with_and_without_window) {
+	FileWrite fw;
+	write_values(fw, 5000);
+	{
+		StringRead fr(fw.get_data(), false);
+		check_values(fr, 5000);
+		BOOST_CHECK(fr.end_of_file());
+	}
+	{
+		StringRead fr(fw.get_data(), true);
+		check_values(fr, 5000);
+		BOOST_CHECK(fr.end_of_file());
+	}
+}
+
+BOOST_AUTO_TEST_CASE(arrays) {
+	const std::vector<int8_t> bytes = {-1, 2, -3};
+	const std::vector<int16_t> shorts = {-1000, 2000, -3000, 4000};
+	const std::vector<uint32_t> ints = {0xdeadbeef, 1, 0x80000000};
+
+	FileWrite fw;
+	fw.write_array(bytes);
+	fw.write_array(shorts);
+	fw.write_array(ints);
+
+	// Arrays are compatible with writing the values one by one
+	LegacyWrite legacy;
+	for (int8_t value : bytes) {
+		legacy.signed_8(value);
+	}
+	for (int16_t value : shorts) {
+		legacy.signed_16(value);
+	}
+	for (uint32_t value : ints) {
+		legacy.unsigned_32(value);
+	}
+	BOOST_CHECK(fw.get_data() == legacy.result);
+
+	StringRead fr(fw.get_data(), true);
+	std::vector<int8_t> read_bytes(bytes.size());
+	std::vector<int16_t> read_shorts(shorts.size());
+	std::vector<uint32_t> read_ints(ints.size());
+	fr.read_array(read_bytes.data(), read_bytes.size());
+	fr.read_array(read_shorts.data(), read_shorts.size());
+	fr.read_array(read_ints.data(), read_ints.size());
+	BOOST_CHECK(read_bytes == bytes);
+	BOOST_CHECK(read_shorts == shorts);
+	BOOST_CHECK(read_ints == ints);
+	BOOST_CHECK(fr.end_of_file());
+	BOOST_CHECK_THROW(fr.read_array(read_ints.data(), 1), StreamRead::DataError);
+}
+
+BOOST_AUTO_TEST_CASE(fileread) {
+	RealFSImpl fs(FileSystem::get_working_directory());
+	const std::string filename = "test_io_stream.tmp";
+
+	FileWrite fw;
+	write_values(fw, 5000);
+	const size_t lines_pos = fw.get_pos();
+	fw.text("first line\r\nsecond line\n");
+	fw.write(fs, filename);
+
+	FileRead fr;
+	fr.open(fs, filename);
+	fs.fs_unlink(filename);
+
+	BOOST_CHECK_EQUAL(fr.get_pos(), 0U);
+	check_values(fr, 5000);
+	BOOST_CHECK(fr.end_of_file() == false);
+	BOOST_CHECK_EQUAL(fr.get_pos(), lines_pos);
+	BOOST_CHECK_EQUAL(std::string(fr.read_line()), "first line");
+	BOOST_CHECK_EQUAL(std::string(fr.read_line()), "second line");
+	BOOST_CHECK(fr.end_of_file());
+	BOOST_CHECK(fr.read_line() == nullptr);
+	BOOST_CHECK_THROW(fr.unsigned_8(), StreamRead::DataError);
+
+	fr.set_file_pos(3);
+	BOOST_CHECK_EQUAL(fr.unsigned_32(), 0U);
+	BOOST_CHECK_EQUAL(fr.float_32(), 0.f);
+	BOOST_CHECK_EQUAL(fr.get_pos(), 11U);
+	BOOST_CHECK_EQUAL(std::string(fr.c_string()), "value 0");
+	BOOST_CHECK_EQUAL(fr.get_pos(), 19U);
+	BOOST_CHECK_THROW(fr.data(fr.get_size(), FileRead::Pos::null()), FileRead::FileBoundaryExceeded);
+	BOOST_CHECK_EQUAL(fr.get_pos(), 19U);
+	BOOST_CHECK_EQUAL(fr.unsigned_8(), 1U);
+}
+
+// The sync hash used to get every value on its own, now the game collects them
+// in blocks of 4 kB first. This must not change the checksum.
+BOOST_AUTO_TEST_CASE(hash_in_blocks) {
+	MD5Checksum<StreamWrite> per_value;
+	write_values(per_value, 5000);
+	per_value.finish_checksum();
+
+	MD5Checksum<StreamWrite> in_blocks;
+	FileWrite block;
+	write_values(block, 5000);
+	const std::string buffer = block.get_data();
+	for (size_t pos = 0; pos < buffer.size(); pos += 4096) {
+		in_blocks.data(buffer.data() + pos, std::min<size_t>(4096, buffer.size() - pos));
+	}
+	in_blocks.finish_checksum();
+
+	BOOST_CHECK(per_value.get_checksum() == in_blocks.get_checksum());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -94,34 +94,40 @@ void AiDnaHandler::dump_output(Widelands::Player::AiPersistentState* pd, uint8_t
 
 	log_dbg(" %d: AI to be dumped to %s\n", pn, full_filename.c_str());
 
+	save_dna(*pd, full_filename);
+}
+
+// This writes the AI data in the format that fetch_dna() reads
+void AiDnaHandler::save_dna(const Widelands::Player::AiPersistentState& pd,
+                            const std::string& filename) {
 	Profile prof;
 
 	Section& mn = prof.create_section("magic_numbers");
-	assert(pd->magic_numbers.size() == Widelands::Player::AiPersistentState::kMagicNumbersSize);
-	for (size_t i = 0; i < pd->magic_numbers.size(); ++i) {
-		mn.set_int(std::to_string(static_cast<int32_t>(i)).c_str(), pd->magic_numbers.at(i));
+	assert(pd.magic_numbers.size() == Widelands::Player::AiPersistentState::kMagicNumbersSize);
+	for (size_t i = 0; i < pd.magic_numbers.size(); ++i) {
+		mn.set_int(std::to_string(static_cast<int32_t>(i)).c_str(), pd.magic_numbers.at(i));
 	}
 
 	Section& nv = prof.create_section("neuron_values");
-	assert(pd->neuron_weights.size() == Widelands::Player::AiPersistentState::kNeuronPoolSize);
-	for (size_t i = 0; i < pd->neuron_weights.size(); ++i) {
-		nv.set_int(std::to_string(static_cast<int32_t>(i)).c_str(), pd->neuron_weights.at(i));
+	assert(pd.neuron_weights.size() == Widelands::Player::AiPersistentState::kNeuronPoolSize);
+	for (size_t i = 0; i < pd.neuron_weights.size(); ++i) {
+		nv.set_int(std::to_string(static_cast<int32_t>(i)).c_str(), pd.neuron_weights.at(i));
 	}
 
 	Section& nf = prof.create_section("neuron_functions");
-	assert(pd->neuron_functs.size() == Widelands::Player::AiPersistentState::kNeuronPoolSize);
-	for (size_t i = 0; i < pd->neuron_functs.size(); ++i) {
-		nf.set_int(std::to_string(static_cast<int32_t>(i)).c_str(), pd->neuron_functs.at(i));
+	assert(pd.neuron_functs.size() == Widelands::Player::AiPersistentState::kNeuronPoolSize);
+	for (size_t i = 0; i < pd.neuron_functs.size(); ++i) {
+		nf.set_int(std::to_string(static_cast<int32_t>(i)).c_str(), pd.neuron_functs.at(i));
 	}
 
 	Section& fn = prof.create_section("fneurons");
-	assert(pd->f_neurons.size() == Widelands::Player::AiPersistentState::kFNeuronPoolSize);
-	for (size_t i = 0; i < pd->f_neurons.size(); ++i) {
-		fn.set_natural(std::to_string(static_cast<int64_t>(i)).c_str(), pd->f_neurons.at(i));
+	assert(pd.f_neurons.size() == Widelands::Player::AiPersistentState::kFNeuronPoolSize);
+	for (size_t i = 0; i < pd.f_neurons.size(); ++i) {
+		fn.set_natural(std::to_string(static_cast<int64_t>(i)).c_str(), pd.f_neurons.at(i));
 	}
 
 	std::string comment = "See wiki for more info: https://www.widelands.org/wiki/Ai%20Training/";
 
-	prof.write(full_filename.c_str(), false, *g_fs, comment.c_str());
+	prof.write(filename.c_str(), false, *g_fs, comment.c_str());
 }
 }  // namespace Widelands
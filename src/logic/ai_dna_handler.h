@@ -39,6 +39,7 @@ public:
 	               std::vector<uint32_t>&,
 	               uint8_t);
 	void dump_output(Widelands::Player::AiPersistentState* pd, uint8_t);
+	void save_dna(const Widelands::Player::AiPersistentState& pd, const std::string& filename);
 };
 }  // namespace Widelands
 #endif  // end of include guard: WL_LOGIC_AI_DNA_HANDLER_H
@@ -113,7 +113,9 @@ void CmdQueue::run_queue(const Duration& interval, Time& game_time_var) {
 			assert(game_time_var == c.duetime());
 
 			if (dynamic_cast<GameLogicCommand*>(&c)) {
-				StreamWrite& ss = game_.syncstream();
+				StreamWrite& ss = game_.syncstream(dynamic_cast<PlayerCommand*>(&c) ?
+				                                      SyncCategory::kPlayerCommands :
+				                                      SyncCategory::kCommandQueue);
 				ss.unsigned_8(SyncEntry::kRunQueue);
 				ss.unsigned_32(c.duetime().get());
 				ss.unsigned_32(static_cast<uint32_t>(c.id()));
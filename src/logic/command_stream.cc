@@ -0,0 +1,227 @@
+/*
+ * Copyright (C) 2020 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "logic/command_stream.h"
+
+#include <cinttypes>
+#include <limits>
+
+#include "base/wexception.h"
+#include "logic/widelands_geometry_io.h"
+
+namespace Widelands {
+
+namespace {
+
+// A 64 bit value never needs more than 10 groups of 7 bits
+constexpr unsigned kMaxVarintBytes = 10;
+
+}  // namespace
+
+CommandStream::CommandStream() {
+	clear();
+	reset_pending_ = false;
+}
+
+void CommandStream::reset() {
+	clear();
+	reset_pending_ = true;
+}
+
+void CommandStream::clear() {
+	nr_serials_ = 0;
+	nr_coords_ = 0;
+	time_ = 0;
+}
+
+template <typename T, size_t N>
+void CommandStream::use(std::array<T, N>& recent, size_t& size, size_t index, const T& value) {
+	if (index >= size) {
+		if (size < N) {
+			++size;
+		}
+		index = size - 1;
+	}
+	for (; index > 0; --index) {
+		recent[index] = recent[index - 1];
+	}
+	recent[0] = value;
+}
+
+/*** class CommandWriter ***/
+
+void CommandWriter::varint(uint64_t value) {
+	uint8_t buffer[kMaxVarintBytes];
+	size_t length = 0;
+	while (value >= 0x80) {
+		buffer[length++] = static_cast<uint8_t>(value) | 0x80;
+		value >>= 7;
+	}
+	buffer[length++] = static_cast<uint8_t>(value);
+	stream_.data(buffer, length);
+}
+
+void CommandWriter::serial(const Serial value) {
+	size_t index = 0;
+	while (index < state_.nr_serials_ && state_.serials_[index] != value) {
+		++index;
+	}
+	if (index < state_.nr_serials_) {
+		varint(index);
+	} else {
+		varint(CommandStream::kRecentSerials + static_cast<uint64_t>(value));
+	}
+	CommandStream::use(state_.serials_, state_.nr_serials_, index, value);
+}
+
+void CommandWriter::coords(const Coords& value) {
+	size_t index = 0;
+	while (index < state_.nr_coords_ && state_.coords_[index] != value) {
+		++index;
+	}
+	if (index < state_.nr_coords_) {
+		varint(index);
+	} else {
+		// New places tend to be close to the last one
+		const Coords last = state_.nr_coords_ > 0 ? state_.coords_[0] : Coords(0, 0);
+		varint(CommandStream::kRecentCoords);
+		varint(zigzag(value.x - last.x));
+		varint(zigzag(value.y - last.y));
+	}
+	CommandStream::use(state_.coords_, state_.nr_coords_, index, value);
+}
+
+void CommandWriter::time(const Time& value) {
+	const uint64_t reset = state_.reset_pending_ ? 1 : 0;
+	state_.reset_pending_ = false;
+	varint((zigzag(static_cast<int64_t>(value.get()) - state_.time_) << 1) | reset);
+	state_.time_ = value.get();
+}
+
+/*** class CommandReader ***/
+
+uint64_t CommandReader::varint() {
+	uint64_t value = 0;
+	for (unsigned i = 0; i < kMaxVarintBytes; ++i) {
+		const uint8_t byte = stream_.unsigned_8();
+		value |= static_cast<uint64_t>(byte & 0x7f) << (7 * i);
+		if (!(byte & 0x80)) {
+			return value;
+		}
+	}
+	throw wexception("CommandReader: variable length quantity is too long");
+}
+
+uint64_t CommandReader::varint(const uint64_t max) {
+	const uint64_t value = varint();
+	if (value > max) {
+		throw wexception("CommandReader: value %" PRIu64 " is out of range", value);
+	}
+	return value;
+}
+
+uint16_t CommandReader::unsigned_16() {
+	if (state_ == nullptr) {
+		return stream_.unsigned_16();
+	}
+	return varint(std::numeric_limits<uint16_t>::max());
+}
+
+uint32_t CommandReader::unsigned_32() {
+	if (state_ == nullptr) {
+		return stream_.unsigned_32();
+	}
+	return varint(std::numeric_limits<uint32_t>::max());
+}
+
+int16_t CommandReader::signed_16() {
+	if (state_ == nullptr) {
+		return stream_.signed_16();
+	}
+	return unzigzag(varint(std::numeric_limits<uint16_t>::max()));
+}
+
+int32_t CommandReader::signed_32() {
+	if (state_ == nullptr) {
+		return stream_.signed_32();
+	}
+	return unzigzag(varint(std::numeric_limits<uint32_t>::max()));
+}
+
+Serial CommandReader::serial() {
+	if (state_ == nullptr) {
+		return stream_.unsigned_32();
+	}
+	const uint64_t value = varint(CommandStream::kRecentSerials +
+	                              static_cast<uint64_t>(std::numeric_limits<Serial>::max()));
+	if (value < CommandStream::kRecentSerials) {
+		if (value >= state_->nr_serials_) {
+			throw wexception("CommandReader: unknown recent serial %" PRIu64, value);
+		}
+		const Serial result = state_->serials_[value];
+		CommandStream::use(state_->serials_, state_->nr_serials_, value, result);
+		return result;
+	}
+	const Serial result = value - CommandStream::kRecentSerials;
+	CommandStream::use(state_->serials_, state_->nr_serials_, state_->nr_serials_, result);
+	return result;
+}
+
+Coords CommandReader::coords() {
+	if (state_ == nullptr) {
+		return read_coords_32(&stream_);
+	}
+	const uint64_t index = varint(CommandStream::kRecentCoords);
+	if (index < CommandStream::kRecentCoords) {
+		if (index >= state_->nr_coords_) {
+			throw wexception("CommandReader: unknown recent coordinates %" PRIu64, index);
+		}
+		const Coords result = state_->coords_[index];
+		CommandStream::use(state_->coords_, state_->nr_coords_, index, result);
+		return result;
+	}
+	const Coords last = state_->nr_coords_ > 0 ? state_->coords_[0] : Coords(0, 0);
+	const int64_t x = last.x + unzigzag(varint(std::numeric_limits<uint32_t>::max()));
+	const int64_t y = last.y + unzigzag(varint(std::numeric_limits<uint32_t>::max()));
+	if (x < std::numeric_limits<int16_t>::min() || x > std::numeric_limits<int16_t>::max() ||
+	    y < std::numeric_limits<int16_t>::min() || y > std::numeric_limits<int16_t>::max()) {
+		throw wexception("CommandReader: coordinates are out of range");
+	}
+	const Coords result(static_cast<int16_t>(x), static_cast<int16_t>(y));
+	CommandStream::use(state_->coords_, state_->nr_coords_, state_->nr_coords_, result);
+	return result;
+}
+
+Time CommandReader::time() {
+	if (state_ == nullptr) {
+		return Time(stream_.unsigned_32());
+	}
+	const uint64_t value = varint();
+	if (value & 1) {
+		state_->clear();
+	}
+	const int64_t time = state_->time_ + unzigzag(value >> 1);
+	if (time < 0 || time > std::numeric_limits<uint32_t>::max()) {
+		throw wexception("CommandReader: time %" PRId64 " is out of range", time);
+	}
+	state_->time_ = static_cast<uint32_t>(time);
+	return Time(state_->time_);
+}
+
+}  // namespace Widelands
@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2020 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#ifndef WL_LOGIC_COMMAND_STREAM_H
+#define WL_LOGIC_COMMAND_STREAM_H
+
+#include <array>
+
+#include "base/macros.h"
+#include "base/times.h"
+#include "io/streamread.h"
+#include "io/streamwrite.h"
+#include "logic/widelands.h"
+#include "logic/widelands_geometry.h"
+
+namespace Widelands {
+
+/**
+ * The shared state of one direction of a compact player command stream.
+ *
+ * Player commands mostly refer to objects and places that the player has just
+ * been working with, and they are sent at steadily increasing times. So both
+ * ends remember the most recently used serials and coordinates and the last
+ * time, and only send an index into these dictionaries or a small delta.
+ *
+ * The writer and the reader each need their own instance, and both have to
+ * see exactly the same sequence of values. A writer can call \ref reset to
+ * start over, e.g. when somebody starts reading in the middle of the stream;
+ * the next \ref CommandWriter::time then tells the reader to reset, too.
+ */
+class CommandStream {
+public:
+	CommandStream();
+
+	/// Forget everything and tell the other end to do the same.
+	void reset();
+
+private:
+	friend class CommandWriter;
+	friend class CommandReader;
+
+	static constexpr size_t kRecentSerials = 16;
+	static constexpr size_t kRecentCoords = 8;
+
+	void clear();
+
+	/// Move the entry at 'index' to the front, or push 'value' to the front if
+	/// 'index' is past the end.
+	template <typename T, size_t N>
+	static void use(std::array<T, N>& recent, size_t& size, size_t index, const T& value);
+
+	std::array<Serial, kRecentSerials> serials_;
+	size_t nr_serials_;
+	std::array<Coords, kRecentCoords> coords_;
+	size_t nr_coords_;
+	uint32_t time_;
+	bool reset_pending_;
+};
+
+/**
+ * Writes player commands to a compact command stream. Integers are written as
+ * variable length quantities, so that small values only take a single byte.
+ */
+class CommandWriter {
+public:
+	CommandWriter(StreamWrite& stream, CommandStream& state) : stream_(stream), state_(state) {
+	}
+
+	void unsigned_8(uint8_t value) {
+		stream_.unsigned_8(value);
+	}
+	void unsigned_16(uint16_t value) {
+		varint(value);
+	}
+	void unsigned_32(uint32_t value) {
+		varint(value);
+	}
+	void signed_16(int16_t value) {
+		varint(zigzag(value));
+	}
+	void signed_32(int32_t value) {
+		varint(zigzag(value));
+	}
+
+	void serial(Serial);
+	void coords(const Coords&);
+
+	/// Every unit of the stream needs to start with a time, so that the
+	/// reader learns about resets before it decodes anything else.
+	void time(const Time&);
+
+private:
+	void varint(uint64_t value);
+	static uint64_t zigzag(int64_t value) {
+		return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+	}
+
+	StreamWrite& stream_;
+	CommandStream& state_;
+
+	DISALLOW_COPY_AND_ASSIGN(CommandWriter);
+};
+
+/**
+ * Reads player commands. This is the mirror of \ref CommandWriter, and it can
+ * also read the fixed width format that replays used before the compact
+ * format was introduced.
+ */
+class CommandReader {
+public:
+	/// Read a compact command stream
+	CommandReader(StreamRead& stream, CommandStream& state) : stream_(stream), state_(&state) {
+	}
+	/// Read fixed width commands from old replays
+	explicit CommandReader(StreamRead& stream) : stream_(stream), state_(nullptr) {
+	}
+
+	uint8_t unsigned_8() {
+		return stream_.unsigned_8();
+	}
+	uint16_t unsigned_16();
+	uint32_t unsigned_32();
+	int16_t signed_16();
+	int32_t signed_32();
+
+	Serial serial();
+	Coords coords();
+	Time time();
+
+private:
+	uint64_t varint();
+	uint64_t varint(uint64_t max);
+	static int64_t unzigzag(uint64_t value) {
+		return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+	}
+
+	StreamRead& stream_;
+	CommandStream* state_;
+
+	DISALLOW_COPY_AND_ASSIGN(CommandReader);
+};
+
+}  // namespace Widelands
+
+#endif  // end of include guard: WL_LOGIC_COMMAND_STREAM_H
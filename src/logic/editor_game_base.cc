@@ -200,6 +200,11 @@ World* EditorGameBase::mutable_world(bool render_only) {
 		ScopedTimer timer("Registering the world took %ums");
 		Notifications::publish(UI::NoteLoadingMessage(_("Loading world…")));
 		world_.reset(new World(description_manager_.get(), render_only));
+		description_manager_->set_snapshot_loader(
+		   DescriptionSnapshot::Owner::kWorld,
+		   [this](const LuaTable& table, MapObjectType type) {
+			   world_->add_world_object_type(table, type);
+		   });
 	}
 	return world_.get();
 }
@@ -222,6 +227,11 @@ Tribes* EditorGameBase::mutable_tribes() {
 		ScopedTimer timer("Registering the tribes took %ums");
 		Notifications::publish(UI::NoteLoadingMessage(_("Loading tribes…")));
 		tribes_.reset(new Tribes(description_manager_.get(), lua_.get()));
+		description_manager_->set_snapshot_loader(
+		   DescriptionSnapshot::Owner::kTribes,
+		   [this](const LuaTable& table, MapObjectType type) {
+			   tribes_->add_tribe_object_type(table, *mutable_world(), type);
+		   });
 	}
 	return tribes_.get();
 }
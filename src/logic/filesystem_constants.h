@@ -38,6 +38,12 @@ const std::string kWidelandsMapExtension = ".wmf";
 const std::string kS2MapExtension1 = ".swd";
 const std::string kS2MapExtension2 = ".wld";
 
+/// Filesystem names for cached data that can be recreated at any time
+const std::string kCacheDir = "cache";
+const std::string kMapCatalogueFile = "cache/maps";
+const std::string kLuaCacheDir = "cache/lua";
+const std::string kDescriptionSnapshotFile = "cache/descriptions";
+
 /// Filesystem names for temp files holding static data that needs to be accessible via filesystem
 /// Kept in a separate dir to avoid filesystem conflicts
 const std::string kTempFileDir = "temp";
@@ -53,6 +59,8 @@ constexpr double kTempBackupsKeepAroundTime = 24 * 60 * 60;
 /// Filesystem names and timeouts for replays
 const std::string kReplayDir = "replays";
 const std::string kReplayExtension = ".wrpl";
+const std::string kReplayKeyframeIndexExtension = ".wki";
+const std::string kReplayKeyframeInfix = ".keyframe";
 const std::string kSyncstreamExtension = ".wss";
 const std::string kSyncstreamExcerptExtension = ".wse";
 // The time in seconds for how long old replays/syncstreams should be kept
@@ -64,6 +72,8 @@ const std::string kSaveDir = "save";
 const std::string kCampVisFile = "save/campaigns.conf";
 const std::string kSavegameExtension = ".wgf";
 const std::string kAutosavePrefix = "wl_autosave";
+/// Hidden subdirectory of savegame and replay directories caching their preload data
+const std::string kSavegameIndexDir = ".index";
 // Default autosave interval in minutes
 constexpr int kDefaultAutosaveInterval = 15;
 
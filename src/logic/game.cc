@@ -22,6 +22,7 @@
 #include <cstdlib>
 #include <memory>
 #include <string>
+#include <vector>
 
 #ifndef _WIN32
 #include <unistd.h>  // for usleep
@@ -30,6 +31,8 @@
 #include <windows.h>
 #endif
 
+#include <SDL_timer.h>
+
 #include "base/i18n.h"
 #include "base/log.h"
 #include "base/macros.h"
@@ -73,7 +76,14 @@ namespace Widelands {
 /// Define this to get lots of debugging output concerned with syncs
 // #define SYNC_DEBUG
 
+/// Time in ms between two calls of think() when there is no user interface
+constexpr uint32_t kHeadlessFrameTime = 10;
+
+/// Games that record a replay save a keyframe at multiples of this gametime, see take_keyframe()
+constexpr Duration kKeyframeInterval(10 * 60 * 1000);
+
 Game::SyncWrapper::~SyncWrapper() {
+	flush_pending();
 	if (dump_ != nullptr) {
 		if (!syncstreamsave_) {
 			try {
@@ -95,6 +105,22 @@ void Game::SyncWrapper::start_dump(const std::string& fname) {
 }
 
 void Game::SyncWrapper::data(void const* const sync_data, size_t const size) {
+	flush_pending();
+	write_through(sync_data, size);
+}
+
+void Game::SyncWrapper::flush_pending() {
+	if (buffer_ != nullptr && buffer_ != pending_) {
+		write_through(pending_, buffer_ - pending_);
+	}
+#ifndef SYNC_DEBUG
+	// With SYNC_DEBUG, every single write is logged, so we don't collect them
+	buffer_ = pending_;
+	buffer_end_ = pending_ + kPendingSize;
+#endif
+}
+
+void Game::SyncWrapper::write_through(void const* const sync_data, size_t const size) {
 #ifdef SYNC_DEBUG
 	uint32_t time = game_.get_gametime();
 	log_dbg_time(game_.get_gametime(), "[sync:%08u t=%6u]", counter_, time);
@@ -153,6 +179,7 @@ Game::~Game() {
 }
 
 void Game::sync_reset() {
+	syncwrapper_.flush_pending();
 	syncwrapper_.counter_ = 0;
 
 	synchash_.reset();
@@ -271,7 +298,8 @@ bool Game::run_splayer_scenario_direct(const std::string& mapname,
  *
  */
 void Game::init_newgame(const GameSettings& settings) {
-	assert(has_loader_ui());
+	// Only games without user interface can do without a loading screen
+	assert(has_loader_ui() || get_ibase() == nullptr);
 
 	Notifications::publish(UI::NoteLoadingMessage(_("Preloading map…")));
 
@@ -365,7 +393,7 @@ void Game::init_newgame(const GameSettings& settings) {
  * run<Returncode>() takes care about this difference.
  */
 void Game::init_savegame(const GameSettings& settings) {
-	assert(has_loader_ui());
+	assert(has_loader_ui() || get_ibase() == nullptr);
 
 	Notifications::publish(UI::NoteLoadingMessage(_("Preloading map…")));
 
@@ -444,7 +472,9 @@ bool Game::run_load_game(const std::string& filename, const std::string& script_
  */
 void Game::postload() {
 	EditorGameBase::postload();
-	get_ibase()->postload();
+	if (get_ibase() != nullptr) {
+		get_ibase()->postload();
+	}
 }
 
 /**
@@ -468,7 +498,7 @@ bool Game::run(StartGameType const start_game_type,
                const std::string& script_to_run,
                bool replay,
                const std::string& prefix_for_replays) {
-	assert(has_loader_ui());
+	assert(has_loader_ui() || get_ibase() == nullptr);
 
 	replay_ = replay;
 	postload();
@@ -555,6 +585,7 @@ bool Game::run(StartGameType const start_game_type,
 			syncwrapper_.start_dump(fname);
 		}
 	}
+	schedule_regular_keyframe();
 
 	sync_reset();
 
@@ -570,9 +601,15 @@ bool Game::run(StartGameType const start_game_type,
 
 	state_ = gs_running;
 
-	remove_loader_ui();
+	if (has_loader_ui()) {
+		remove_loader_ui();
+	}
 
-	get_ibase()->run<UI::Panel::Returncodes>();
+	if (get_ibase() != nullptr) {
+		get_ibase()->run<UI::Panel::Returncodes>();
+	} else {
+		run_headless();
+	}
 
 	state_ = gs_ending;
 
@@ -586,6 +623,21 @@ bool Game::run(StartGameType const start_game_type,
 	return true;
 }
 
+/**
+ * Advances the game without a user interface until the game controller
+ * decides that it is over.
+ */
+void Game::run_headless() {
+	assert(ctrl_);
+	while (!ctrl_->is_headless_game_over()) {
+		think();
+		if (ctrl_->is_headless_realtime()) {
+			// Nothing is drawn, so don't let the loop eat up all of the CPU
+			SDL_Delay(kHeadlessFrameTime);
+		}
+	}
+}
+
 /**
  * think() is called by the UI objects initiated during Game::run()
  * during their modal loop.
@@ -602,7 +654,16 @@ void Game::think() {
 		// computer and the fps if and when the game is saved - this is very bad
 		// for scenarios and even worse for the regression suite (which relies on
 		// the timings of savings.
-		cmdqueue().run_queue(Duration(ctrl_->get_frametime()), get_gametime_pointer());
+		Duration frametime = ctrl_->get_frametime();
+		// Keyframes are taken exactly at the gametime that they are scheduled for
+		if (next_keyframe_.is_valid() && get_gametime() + frametime > next_keyframe_) {
+			frametime = next_keyframe_ - get_gametime();
+		}
+		cmdqueue().run_queue(frametime, get_gametime_pointer());
+
+		if (get_gametime() == next_keyframe_) {
+			take_keyframe();
+		}
 
 		// check if autosave is needed
 		savehandler_.think(*this);
@@ -618,6 +679,9 @@ void Game::think() {
 void Game::cleanup_for_load() {
 	state_ = gs_notrunning;
 
+	if (get_ibase() != nullptr) {
+		get_ibase()->cleanup_for_load();
+	}
 	EditorGameBase::cleanup_for_load();
 
 	cmdqueue().flush();
@@ -628,15 +692,17 @@ void Game::cleanup_for_load() {
 
 /**
  * Game logic code may write to the synchronization
- * token stream. All written data will be hashed and can be used to
- * check for network or replay desyncs.
+ * token stream. All written data will be hashed into the checksum
+ * of the given category and can be used to check for network or
+ * replay desyncs.
  *
  * \return the synchronization token stream
  *
  * \note This is returned as a \ref StreamWrite object to prevent
  * the caller from messing with the checksumming process.
  */
-StreamWrite& Game::syncstream() {
+StreamWrite& Game::syncstream(const SyncCategory category, const PlayerNumber player) {
+	syncwrapper_.select(category, player);
 	return syncwrapper_;
 }
 
@@ -644,6 +710,7 @@ StreamWrite& Game::syncstream() {
  * Switches to the next part of the syncstream excerpt.
  */
 void Game::report_sync_request() {
+	syncwrapper_.flush_pending();
 	syncwrapper_.current_excerpt_id_ =
 	   (syncwrapper_.current_excerpt_id_ + 1) % SyncWrapper::kExcerptSize;
 	syncwrapper_.excerpts_buffer_[syncwrapper_.current_excerpt_id_].clear();
@@ -655,6 +722,7 @@ void Game::report_sync_request() {
  * Playernumber should be negative when called by network clients
  */
 void Game::report_desync(int32_t playernumber) {
+	syncwrapper_.flush_pending();
 	if (syncwrapper_.dumpfname_.empty()) {
 		log_err_time(get_gametime(),
 		             "Error: A desync occurred but no filename for the syncstream has been set.");
@@ -688,17 +756,82 @@ void Game::report_desync(int32_t playernumber) {
 }
 
 /**
- * Calculate the current synchronization checksum and copy
- * it into the given array, without affecting the subsequent
- * checksumming process.
+ * Calculate the current synchronization checksums without affecting the
+ * subsequent checksumming process.
  *
- * \return the checksum
+ * \return the checksums
+ */
+SyncDigest Game::get_sync_digest() const {
+	syncwrapper_.flush_pending();
+	return synchash_.digest();
+}
+
+/**
+ * Get and set the state of the synchronization hash computation.
+ * This allows replays to continue checking for desyncs after seeking.
+ */
+const SyncHasher& Game::get_sync_state() const {
+	syncwrapper_.flush_pending();
+	return synchash_;
+}
+void Game::set_sync_state(const SyncHasher& state) {
+	syncwrapper_.flush_pending();
+	synchash_.set_state(state);
+}
+
+/**
+ * Replace the state of the running game with the given savegame.
+ * This is used for seeking in replays.
+ */
+void Game::restore_savegame(const std::string& filename) {
+	assert(state_ == gs_running);
+
+	create_loader_ui({"general_game"}, false, map().get_background_theme(), map().get_background());
+	cleanup_for_load();
+	{
+		GameLoader gl(filename, *this);
+		gl.load_game();
+	}
+	sync_reset();
+	schedule_regular_keyframe();
+	state_ = gs_running;
+	remove_loader_ui();
+}
+
+/**
+ * Schedule the next of the keyframes that games recording a replay take at
+ * regular intervals.
  */
-Md5Checksum Game::get_sync_hash() const {
-	MD5Checksum<StreamWrite> copy(synchash_);
+void Game::schedule_regular_keyframe() {
+	if (replaywriter_ == nullptr) {
+		next_keyframe_ = Time();
+		return;
+	}
+	next_keyframe_ =
+	   Time((get_gametime().get() / kKeyframeInterval.get() + 1) * kKeyframeInterval.get());
+}
 
-	copy.finish_checksum();
-	return copy.get_checksum();
+/**
+ * Save the game without interrupting it, so that replay viewers can start
+ * from the same state when they seek. Loading a savegame restores the map
+ * objects with their serials and the lists that the game logic picks from in
+ * their order, so together with the random number generator and the sync state
+ * it continues exactly like this game.
+ */
+void Game::take_keyframe() {
+	assert(state_ == gs_running);
+	assert(replaywriter_);
+
+	const std::string filename = replaywriter_->next_keyframe_filename();
+	std::string error;
+	if (!savehandler_.save_game(*this, filename, &error)) {
+		log_err_time(get_gametime(), "Failed to save keyframe: %s\n", error.c_str());
+		schedule_regular_keyframe();
+		return;
+	}
+
+	replaywriter_->write_keyframe();
+	schedule_regular_keyframe();
 }
 
 /**
@@ -709,8 +842,9 @@ Md5Checksum Game::get_sync_hash() const {
  */
 uint32_t Game::logic_rand() {
 	uint32_t const result = rng().rand();
-	syncstream().unsigned_8(SyncEntry::kRandom);
-	syncstream().unsigned_32(result);
+	StreamWrite& ss = syncstream(SyncCategory::kRandom);
+	ss.unsigned_8(SyncEntry::kRandom);
+	ss.unsigned_32(result);
 	return result;
 }
 
@@ -719,10 +853,24 @@ uint32_t Game::logic_rand() {
  * It takes the appropriate action, i.e. either add to the cmd_queue or send
  * across the network.
  */
+namespace {
+// The player commands that the current thread holds back, see defer_player_commands()
+thread_local std::vector<std::unique_ptr<PlayerCommand>>* deferred_player_commands = nullptr;
+}  // namespace
+
 void Game::send_player_command(PlayerCommand* pc) {
+	if (deferred_player_commands != nullptr) {
+		deferred_player_commands->emplace_back(pc);
+		return;
+	}
 	ctrl_->send_player_command(pc);
 }
 
+// static
+void Game::defer_player_commands(std::vector<std::unique_ptr<PlayerCommand>>* commands) {
+	deferred_player_commands = commands;
+}
+
 /**
  * Actually enqueue a command.
  *
@@ -21,13 +21,14 @@
 #define WL_LOGIC_GAME_H
 
 #include <memory>
+#include <vector>
 
-#include "base/md5.h"
 #include "base/random.h"
 #include "io/streamwrite.h"
 #include "logic/cmd_queue.h"
 #include "logic/editor_game_base.h"
 #include "logic/save_handler.h"
+#include "logic/sync_digest.h"
 #include "logic/trade_agreement.h"
 #include "scripting/logic.h"
 
@@ -235,18 +236,28 @@ public:
 
 	void logic_rand_seed(uint32_t const seed) {
 		rng().seed(seed);
-		syncstream().unsigned_8(SyncEntry::kRandomSeed);
-		syncstream().unsigned_32(seed);
+		StreamWrite& ss = syncstream(SyncCategory::kRandom);
+		ss.unsigned_8(SyncEntry::kRandomSeed);
+		ss.unsigned_32(seed);
 	}
 
-	StreamWrite& syncstream();
+	/// The player is only needed for \ref SyncCategory::kEconomy
+	StreamWrite& syncstream(SyncCategory category, PlayerNumber player = 0);
 	void report_sync_request();
 	void report_desync(int32_t playernumber);
-	Md5Checksum get_sync_hash() const;
+	SyncDigest get_sync_digest() const;
+	const SyncHasher& get_sync_state() const;
+	void set_sync_state(const SyncHasher&);
+
+	void restore_savegame(const std::string& filename);
 
 	void enqueue_command(Command* const);
 
 	void send_player_command(Widelands::PlayerCommand*);
+	/// While 'commands' is set, the player commands that are sent from the
+	/// calling thread are appended to it instead of being sent. This lets
+	/// computer players think on other threads, see \ref AI::ComputerPlayer::think_all
+	static void defer_player_commands(std::vector<std::unique_ptr<PlayerCommand>>* commands);
 
 	void send_player_bulldoze(PlayerImmovable&, bool recurse = false);
 	void send_player_dismantle(PlayerImmovable&, bool keep_wares);
@@ -332,11 +343,14 @@ public:
 
 private:
 	void sync_reset();
+	void run_headless();
+	void take_keyframe();
+	void schedule_regular_keyframe();
 
-	MD5Checksum<StreamWrite> synchash_;
+	SyncHasher synchash_;
 
 	struct SyncWrapper : public StreamWrite {
-		SyncWrapper(Game& game, StreamWrite& target)
+		SyncWrapper(Game& game, SyncHasher& target)
 		   : game_(game),
 		     target_(target),
 		     counter_(0),
@@ -353,15 +367,35 @@ private:
 		/// \ref syncstreamsave_ has been set.
 		void start_dump(const std::string& fname);
 
+		/// Switch the checksum that the following data is hashed into.
+		void select(SyncCategory category, PlayerNumber player) {
+			if (SyncDigest::leaf(category, player) != target_.current_leaf()) {
+				flush_pending();
+				target_.select(category, player);
+			}
+		}
+
 		void data(void const* data, size_t size) override;
 
 		void flush() override {
+			flush_pending();
 			target_.flush();
 		}
 
+		/// Passes the bytes collected in \ref pending_ on to the dump and the target.
+		/// Needs to be called before anybody looks at the state of the target.
+		void flush_pending();
+
+	private:
+		void write_through(void const* data, size_t size);
+
+		// Small writes are collected here and passed on in bulk
+		static constexpr size_t kPendingSize = 4096;
+		char pending_[kPendingSize];
+
 	public:
 		Game& game_;
-		StreamWrite& target_;
+		SyncHasher& target_;
 		uint32_t counter_;
 		uint32_t next_diskspacecheck_;
 		std::unique_ptr<StreamWrite> dump_;
@@ -378,7 +412,9 @@ private:
 		// Array of byte buffers
 		// std::string is used as a binary buffer here
 		std::string excerpts_buffer_[kExcerptSize];
-	} syncwrapper_;
+	};
+	// Mutable, because pending sync data needs to be flushed before computing the sync hash
+	mutable SyncWrapper syncwrapper_;
 
 	GameController* ctrl_;
 
@@ -405,6 +441,9 @@ private:
 
 	std::unique_ptr<ReplayWriter> replaywriter_;
 
+	/// The gametime at which the next keyframe will be saved
+	Time next_keyframe_;
+
 	uint32_t scenario_difficulty_;
 
 	GeneralStatsVector general_stats_;
@@ -94,6 +94,36 @@ public:
 		set_paused(!is_paused());
 	}
 
+	/**
+	 * Jump to the given gametime. This is only supported by replays.
+	 */
+	virtual void seek(const Time& /* time */) {
+	}
+
+	/**
+	 * A short summary of how well the network keeps up with the game, to be
+	 * shown to the player. Empty if there is nothing to report.
+	 */
+	virtual std::string network_status() {
+		return std::string();
+	}
+
+	/**
+	 * Whether a game that runs without a user interface is over. This is
+	 * only used by the dedicated server and by AI training.
+	 */
+	virtual bool is_headless_game_over() {
+		return true;
+	}
+
+	/**
+	 * Whether a game without user interface has to wait for the real time to
+	 * pass. If not, it is simulated as fast as possible.
+	 */
+	virtual bool is_headless_realtime() {
+		return true;
+	}
+
 	/**
 	 * Report a player result once he has left the game. This may be done through lua
 	 * by the win_condition scripts.
@@ -136,11 +136,8 @@ void Bob::cleanup(EditorGameBase& egbase) {
 	set_owner(nullptr);  // implicitly remove ourselves from owner's map
 
 	if (position_.field) {
+		unlink_from_field();
 		position_.field = nullptr;
-		*linkpprev_ = linknext_;
-		if (linknext_) {
-			linknext_->linkpprev_ = linkpprev_;
-		}
 	}
 
 	MapObject::cleanup(egbase);
@@ -906,20 +903,11 @@ void Bob::set_position(EditorGameBase& egbase, const Coords& coords) {
 	FCoords oldposition = position_;
 
 	if (position_.field) {
-		*linkpprev_ = linknext_;
-		if (linknext_) {
-			linknext_->linkpprev_ = linkpprev_;
-		}
+		unlink_from_field();
 	}
 
 	position_ = egbase.map().get_fcoords(coords);
-
-	linknext_ = position_.field->bobs;
-	linkpprev_ = &position_.field->bobs;
-	if (linknext_) {
-		linknext_->linkpprev_ = &linknext_;
-	}
-	*linkpprev_ = this;
+	link_to_field();
 
 	if (owner_) {
 		owner_->see_area(Area<FCoords>(get_position(), descr().vision_range()));
@@ -936,7 +924,7 @@ void Bob::set_position(EditorGameBase& egbase, const Coords& coords) {
 	// in pathfinding even when two paths have the same length, and in
 	// randomly generated movements.
 	if (upcast(Game, game, &egbase)) {
-		StreamWrite& ss = game->syncstream();
+		StreamWrite& ss = game->syncstream(SyncCategory::kBobs);
 		ss.unsigned_8(SyncEntry::kBobSetPosition);
 		ss.unsigned_32(serial());
 		ss.signed_16(coords.x);
@@ -944,6 +932,24 @@ void Bob::set_position(EditorGameBase& egbase, const Coords& coords) {
 	}
 }
 
+/// Insert the bob at the head of the list of bobs on its field
+void Bob::link_to_field() {
+	linknext_ = position_.field->bobs;
+	linkpprev_ = &position_.field->bobs;
+	if (linknext_) {
+		linknext_->linkpprev_ = &linknext_;
+	}
+	*linkpprev_ = this;
+}
+
+/// Remove the bob from the list of bobs on its field
+void Bob::unlink_from_field() {
+	*linkpprev_ = linknext_;
+	if (linknext_) {
+		linknext_->linkpprev_ = linkpprev_;
+	}
+}
+
 /// Give debug information.
 void Bob::log_general_info(const EditorGameBase& egbase) const {
 	FORMAT_WARNINGS_OFF
@@ -1013,7 +1019,8 @@ Load/save support
 ==============================
 */
 
-constexpr uint8_t kCurrentPacketVersion = 1;
+// Version 1 didn't store the position of the bob on its field
+constexpr uint8_t kCurrentPacketVersion = 2;
 
 Bob::Loader::Loader() {
 }
@@ -1023,7 +1030,7 @@ void Bob::Loader::load(FileRead& fr) {
 
 	try {
 		uint8_t packet_version = fr.unsigned_8();
-		if (packet_version == kCurrentPacketVersion) {
+		if (packet_version >= 1 && packet_version <= kCurrentPacketVersion) {
 
 			Bob& bob = get<Bob>();
 
@@ -1042,6 +1049,9 @@ void Bob::Loader::load(FileRead& fr) {
 			}
 
 			bob.set_position(egbase(), read_coords_32(&fr));
+			if (packet_version >= 2) {
+				mol().set_field_position(bob, fr.unsigned_32());
+			}
 
 			// Animation. If the animation is no longer known, pick the main animation instead.
 			std::string animname = fr.c_string();
@@ -1179,7 +1189,13 @@ void Bob::save(EditorGameBase& eg, MapObjectSaver& mos, FileWrite& fw) {
 	fw.unsigned_8(owner_ ? owner_->player_number() : 0);
 	write_coords_32(&fw, position_);
 
-	// linkprev_ and linknext_ are recreated automatically
+	// linkprev_ and linknext_ are recreated when loading, but the order of the bobs on a field
+	// depends on the order in which they arrived there
+	uint32_t field_position = 0;
+	for (const Bob* bob = position_.field->bobs; bob != this; bob = bob->linknext_) {
+		++field_position;
+	}
+	fw.unsigned_32(field_position);
 
 	fw.c_string(anim_ ? descr().get_animation_name(anim_) : "");
 	animstart_.save(fw);
@@ -145,6 +145,7 @@ public:
 	friend class Map;
 	friend struct MapBobdataPacket;
 	friend struct MapBobPacket;
+	friend class MapObjectLoader;
 
 	struct State;
 	using Ptr = void (Bob::*)(Game&, State&);
@@ -347,6 +348,9 @@ private:
 	void movepath_update(Game&, State&);
 	void move_update(Game&, State&);
 
+	void link_to_field();
+	void unlink_from_field();
+
 	int32_t start_walk(Game& game, WalkingDir, uint32_t anim, bool force = false);
 
 	/**
@@ -50,6 +50,7 @@ DescriptionManager::DescriptionManager(LuaInterface* lua) : lua_(lua) {
 }
 
 DescriptionManager::~DescriptionManager() {
+	snapshot_.write();
 }
 
 /// Walk given directory and register descriptions
@@ -170,10 +171,78 @@ void DescriptionManager::load_description(const std::string& description_name) {
 		return;
 	}
 	descriptions_being_loaded_.insert(object_script);
-	lua_->run_script(object_script);
+	// Scenarios can replace descriptions that others depend on, so we evaluate everything then
+	run_init_script(object_script, registered_scenario_descriptions_.empty());
 	descriptions_being_loaded_.erase(descriptions_being_loaded_.find(object_script));
 }
 
+void DescriptionManager::run_init_script(const std::string& script_path, bool use_snapshot) {
+	uint64_t content_hash = 0;
+	const std::vector<DescriptionSnapshot::Description>* descriptions = nullptr;
+	if (use_snapshot) {
+		content_hash = DescriptionSnapshot::hash_script(*g_fs, script_path);
+
+		snapshot_.read();
+		descriptions = snapshot_.find(script_path, content_hash);
+		if (descriptions != nullptr) {
+			for (const DescriptionSnapshot::Description& description : *descriptions) {
+				if (snapshot_loaders_.count(description.owner) == 0) {
+					descriptions = nullptr;
+					break;
+				}
+			}
+		}
+	}
+
+	// Descriptions that are loaded on demand in the meantime record themselves separately
+	recordings_.push_back(Recording());
+	recordings_.back().replayable = use_snapshot && descriptions == nullptr;
+	try {
+		if (descriptions != nullptr) {
+			for (const DescriptionSnapshot::Description& description : *descriptions) {
+				std::unique_ptr<LuaTable> table = lua_->deserialize_table(description.table);
+				snapshot_loaders_.at(description.owner)(*table, description.type);
+			}
+		} else {
+			lua_->run_script(script_path);
+		}
+	} catch (...) {
+		recordings_.pop_back();
+		throw;
+	}
+	Recording recording = std::move(recordings_.back());
+	recordings_.pop_back();
+	if (recording.replayable && !recording.descriptions.empty()) {
+		snapshot_.update(script_path, content_hash, std::move(recording.descriptions));
+	}
+}
+
+void DescriptionManager::set_snapshot_loader(DescriptionSnapshot::Owner owner,
+                                             const SnapshotLoader& loader) {
+	snapshot_loaders_[owner] = loader;
+}
+
+void DescriptionManager::record_for_snapshot(DescriptionSnapshot::Owner owner,
+                                             MapObjectType type,
+                                             const LuaTable& table) {
+	if (recordings_.empty() || !recordings_.back().replayable) {
+		return;
+	}
+	try {
+		recordings_.back().descriptions.push_back(
+		   DescriptionSnapshot::Description{owner, type, table.serialize()});
+	} catch (const LuaError&) {
+		// E.g. functions can't be stored
+		recordings_.back().replayable = false;
+	}
+}
+
+void DescriptionManager::prevent_snapshot() {
+	if (!recordings_.empty()) {
+		recordings_.back().replayable = false;
+	}
+}
+
 const std::vector<std::string>&
 DescriptionManager::get_attributes(const std::string& description_name) const {
 	assert(registered_scenario_descriptions_.count(description_name) == 1 ||
@@ -20,6 +20,7 @@
 #ifndef WL_LOGIC_MAP_OBJECTS_DESCRIPTION_MANAGER_H
 #define WL_LOGIC_MAP_OBJECTS_DESCRIPTION_MANAGER_H
 
+#include <functional>
 #include <map>
 #include <memory>
 #include <set>
@@ -27,6 +28,7 @@
 
 #include "base/macros.h"
 #include "io/filesystem/filesystem.h"
+#include "logic/map_objects/description_snapshot.h"
 #include "logic/map_objects/map_object_type.h"
 #include "scripting/lua_interface.h"
 
@@ -68,12 +70,26 @@ public:
 	/// Mark a description as having been loaded
 	void mark_loading_done(const std::string& description_name);
 
+	/// Adds a description table from the snapshot to the engine, like the init scripts do
+	using SnapshotLoader = std::function<void(const LuaTable&, MapObjectType)>;
+	/// Descriptions are only taken from the snapshot when their owner has a loader
+	void set_snapshot_loader(DescriptionSnapshot::Owner owner, const SnapshotLoader& loader);
+	/// Called for every description table that an init script hands to the engine
+	void record_for_snapshot(DescriptionSnapshot::Owner owner,
+	                         MapObjectType type,
+	                         const LuaTable& table);
+	/// Called when an init script does more than adding descriptions, so that it always has to be
+	/// evaluated
+	void prevent_snapshot();
+
 private:
 	/// Load a description on demand via notification
 	void load_description_on_demand(const std::string& description_name);
 	/// For loading all map object descriptions with a given attribute on demand
 	void register_attributes(const std::vector<std::string>& attributes,
 	                         const std::string& description_name);
+	/// Runs the init script, or adds its descriptions from the snapshot if it didn't change
+	void run_init_script(const std::string& script_path, bool use_snapshot);
 
 	struct RegisteredObject {
 		explicit RegisteredObject(const std::string& init_script_path,
@@ -96,6 +112,15 @@ private:
 	/// List of the map object descriptions that have already been loaded
 	std::set<std::string> loaded_descriptions_;
 
+	/// The descriptions added by the init scripts currently running, innermost last
+	struct Recording {
+		std::vector<DescriptionSnapshot::Description> descriptions;
+		bool replayable = true;
+	};
+	std::vector<Recording> recordings_;
+	DescriptionSnapshot snapshot_;
+	std::map<DescriptionSnapshot::Owner, SnapshotLoader> snapshot_loaders_;
+
 	LuaInterface* lua_;  // Not owned
 
 	/// For loading any registered map object description via Lua in scenarios.
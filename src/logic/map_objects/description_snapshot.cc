@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2020 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "logic/map_objects/description_snapshot.h"
+
+#include <cstdlib>
+
+#include "base/fast_hash.h"
+#include "base/i18n.h"
+#include "base/log.h"
+#include "build_info.h"
+#include "io/fileread.h"
+#include "io/filesystem/layered_filesystem.h"
+#include "io/filewrite.h"
+#include "logic/filesystem_constants.h"
+#include "logic/game_data_error.h"
+
+namespace Widelands {
+
+namespace {
+constexpr uint16_t kCurrentPacketVersion = 1;
+}  // namespace
+
+DescriptionSnapshot::DescriptionSnapshot() : read_(false), changed_(false) {
+}
+
+// static
+uint64_t DescriptionSnapshot::hash_script(FileSystem& fs, const std::string& script_path) {
+	FastHash hash;
+	size_t length;
+	void* input_data = fs.load(script_path, length);
+	hash.data(input_data, length);
+	free(input_data);
+	// The names are separated by '\0', so that "a" + "bc" and "ab" + "c" differ
+	for (const std::string& filename : fs.list_directory(FileSystem::fs_dirname(script_path))) {
+		hash.data(filename.c_str(), filename.size() + 1);
+	}
+	return hash.value();
+}
+
+// static
+std::string DescriptionSnapshot::key(const std::string& script_path) {
+	return i18n::get_locale() + ":" + script_path;
+}
+
+void DescriptionSnapshot::read() {
+	if (read_) {
+		return;
+	}
+	read_ = true;
+
+	FileRead fr;
+	if (g_fs == nullptr || !fr.try_open(*g_fs, kDescriptionSnapshotFile)) {
+		return;
+	}
+
+	try {
+		const uint16_t packet_version = fr.unsigned_16();
+		if (packet_version != kCurrentPacketVersion) {
+			throw UnhandledVersionError(
+			   "DescriptionSnapshot", packet_version, kCurrentPacketVersion);
+		}
+		// Another build might have different description formats
+		if (fr.string() != build_id()) {
+			return;
+		}
+		for (uint32_t i = fr.unsigned_32(); i; --i) {
+			const std::string entry_key = fr.string();
+			Entry entry;
+			const uint64_t low = fr.unsigned_32();
+			const uint64_t high = fr.unsigned_32();
+			entry.content_hash = high << 32 | low;
+			for (uint32_t descriptions = fr.unsigned_32(); descriptions; --descriptions) {
+				Description description;
+				description.owner = static_cast<Owner>(fr.unsigned_8());
+				description.type = static_cast<MapObjectType>(fr.unsigned_8());
+				// Tables are binary data, so they are not null terminated
+				const uint32_t size = fr.unsigned_32();
+				description.table.assign(fr.data(size), size);
+				entry.descriptions.push_back(description);
+			}
+			entries_.insert(std::make_pair(entry_key, entry));
+		}
+	} catch (const std::exception& e) {
+		// The snapshot is only a cache, so we simply rebuild it.
+		log_warn("Discarding description snapshot: %s\n", e.what());
+		entries_.clear();
+		changed_ = true;
+	}
+}
+
+void DescriptionSnapshot::write() {
+	if (!changed_ || g_fs == nullptr) {
+		return;
+	}
+
+	FileWrite fw;
+	fw.unsigned_16(kCurrentPacketVersion);
+	fw.string(build_id());
+	fw.unsigned_32(entries_.size());
+	for (const auto& key_and_entry : entries_) {
+		const Entry& entry = key_and_entry.second;
+		fw.string(key_and_entry.first);
+		fw.unsigned_32(entry.content_hash & 0xffffffff);
+		fw.unsigned_32(entry.content_hash >> 32);
+		fw.unsigned_32(entry.descriptions.size());
+		for (const Description& description : entry.descriptions) {
+			fw.unsigned_8(static_cast<uint8_t>(description.owner));
+			fw.unsigned_8(static_cast<uint8_t>(description.type));
+			fw.unsigned_32(description.table.size());
+			fw.data(description.table.data(), description.table.size());
+		}
+	}
+
+	try {
+		g_fs->ensure_directory_exists(kCacheDir);
+		fw.write(*g_fs, kDescriptionSnapshotFile);
+		changed_ = false;
+	} catch (const std::exception& e) {
+		log_warn("Unable to write description snapshot: %s\n", e.what());
+	}
+}
+
+const std::vector<DescriptionSnapshot::Description>*
+DescriptionSnapshot::find(const std::string& script_path, uint64_t content_hash) const {
+	auto it = entries_.find(key(script_path));
+	if (it == entries_.end() || it->second.content_hash != content_hash) {
+		return nullptr;
+	}
+	return &it->second.descriptions;
+}
+
+void DescriptionSnapshot::update(const std::string& script_path,
+                                 uint64_t content_hash,
+                                 std::vector<Description> descriptions) {
+	Entry& entry = entries_[key(script_path)];
+	entry.content_hash = content_hash;
+	entry.descriptions = std::move(descriptions);
+	changed_ = true;
+}
+
+}  // namespace Widelands
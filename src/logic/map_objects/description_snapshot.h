@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2020 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#ifndef WL_LOGIC_MAP_OBJECTS_DESCRIPTION_SNAPSHOT_H
+#define WL_LOGIC_MAP_OBJECTS_DESCRIPTION_SNAPSHOT_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "base/macros.h"
+#include "io/filesystem/filesystem.h"
+#include "logic/map_objects/map_object_type.h"
+
+namespace Widelands {
+
+/**
+ * A persistent cache of the description tables that the init scripts of the world and the tribes
+ * pass to the engine, stored in the home directory. A script whose tables are known doesn't need
+ * to be evaluated again, the tables are handed to the engine directly. Entries are keyed by the
+ * script's path and the language, and only trusted as long as the script's content, the files
+ * next to it and the Widelands build stay the same.
+ */
+class DescriptionSnapshot {
+public:
+	/// Who adds the descriptions to the engine
+	enum class Owner : uint8_t { kWorld, kTribes };
+
+	/// A description table as passed to the engine, in the format of LuaTable::serialize()
+	struct Description {
+		Owner owner;
+		MapObjectType type;
+		std::string table;
+	};
+
+	DescriptionSnapshot();
+
+	/// Reads the snapshot from the home directory if this wasn't done yet
+	void read();
+	/// Writes the snapshot to the home directory if it changed
+	void write();
+
+	/// Returns the descriptions that the script added, or nullptr if it wasn't evaluated with this
+	/// content and language before
+	const std::vector<Description>* find(const std::string& script_path,
+	                                     uint64_t content_hash) const;
+	void update(const std::string& script_path,
+	            uint64_t content_hash,
+	            std::vector<Description> descriptions);
+
+	/// Hash of a script's content and of the listing of its directory, used to validate entries.
+	/// Init scripts call path.list_files() for their animation frames, so adding or removing an
+	/// image changes their tables without changing the script.
+	static uint64_t hash_script(FileSystem& fs, const std::string& script_path);
+
+private:
+	struct Entry {
+		uint64_t content_hash = 0;
+		std::vector<Description> descriptions;
+	};
+
+	/// Translated strings are part of the tables, so the language is part of the key
+	static std::string key(const std::string& script_path);
+
+	std::map<std::string, Entry> entries_;
+	bool read_;
+	bool changed_;
+
+	DISALLOW_COPY_AND_ASSIGN(DescriptionSnapshot);
+};
+
+}  // namespace Widelands
+
+#endif  // end of include guard: WL_LOGIC_MAP_OBJECTS_DESCRIPTION_SNAPSHOT_H
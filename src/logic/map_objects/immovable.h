@@ -363,6 +363,8 @@ private:
  * also adjusted automatically.
  */
 struct PlayerImmovable : public BaseImmovable {
+	friend class MapObjectLoader;
+
 	explicit PlayerImmovable(const MapObjectDescr&);
 	~PlayerImmovable() override;
 
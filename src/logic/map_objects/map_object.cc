@@ -45,15 +45,35 @@ char const* const animation_direction_names[6] = {"_ne", "_e", "_se", "_sw", "_w
 
 namespace Widelands {
 
+namespace {
+// The part of the syncstream that the commands for an object are hashed into
+SyncCategory sync_category(const MapObject* obj) {
+	if (obj == nullptr) {
+		return SyncCategory::kCommandQueue;
+	}
+	const MapObjectType type = obj->descr().type();
+	if (type == MapObjectType::BATTLE ||
+	    (type >= MapObjectType::BOB && type < MapObjectType::IMMOVABLE)) {
+		return SyncCategory::kBobs;
+	}
+	if (type >= MapObjectType::IMMOVABLE) {
+		return SyncCategory::kImmovables;
+	}
+	return SyncCategory::kCommandQueue;
+}
+}  // namespace
+
 CmdDestroyMapObject::CmdDestroyMapObject(const Time& t, MapObject& o)
    : GameLogicCommand(t), obj_serial(o.serial()) {
 }
 
 void CmdDestroyMapObject::execute(Game& game) {
-	game.syncstream().unsigned_8(SyncEntry::kDestroyObject);
-	game.syncstream().unsigned_32(obj_serial);
+	MapObject* obj = game.objects().get_object(obj_serial);
+	StreamWrite& ss = game.syncstream(sync_category(obj));
+	ss.unsigned_8(SyncEntry::kDestroyObject);
+	ss.unsigned_32(obj_serial);
 
-	if (MapObject* obj = game.objects().get_object(obj_serial)) {
+	if (obj != nullptr) {
 		obj->destroy(game);
 	}
 }
@@ -98,14 +118,16 @@ CmdAct::CmdAct(const Time& t, MapObject& o, int32_t const a)
 }
 
 void CmdAct::execute(Game& game) {
-	game.syncstream().unsigned_8(SyncEntry::kCmdAct);
-	game.syncstream().unsigned_32(obj_serial);
+	MapObject* const obj = game.objects().get_object(obj_serial);
+	StreamWrite& ss = game.syncstream(sync_category(obj));
+	ss.unsigned_8(SyncEntry::kCmdAct);
+	ss.unsigned_32(obj_serial);
 
-	if (MapObject* const obj = game.objects().get_object(obj_serial)) {
-		game.syncstream().unsigned_8(static_cast<uint8_t>(obj->descr().type()));
+	if (obj != nullptr) {
+		ss.unsigned_8(static_cast<uint8_t>(obj->descr().type()));
 		obj->act(game, arg);
 	} else {
-		game.syncstream().unsigned_8(static_cast<uint8_t>(MapObjectType::MAPOBJECT));
+		ss.unsigned_8(static_cast<uint8_t>(MapObjectType::MAPOBJECT));
 	}
 	// the object must queue the next CMD_ACT itself if necessary
 }
@@ -190,6 +212,8 @@ void ObjectManager::cleanup(EditorGameBase& egbase) {
 	}
 
 	lastserial_ = 0;
+	keep_serials_ = false;
+	next_serial_ = 0;
 	is_cleaning_up_ = false;
 }
 
@@ -197,10 +221,33 @@ void ObjectManager::cleanup(EditorGameBase& egbase) {
  * Insert the given MapObject into the object manager
  */
 void ObjectManager::insert(MapObject* obj) {
-	++lastserial_;
-	assert(lastserial_);
-	obj->serial_ = lastserial_;
-	objects_[lastserial_] = obj;
+	Serial serial = next_serial_;
+	if (serial == 0) {
+		serial = ++lastserial_;
+		assert(lastserial_);
+	}
+	next_serial_ = 0;
+	obj->serial_ = serial;
+	objects_[serial] = obj;
+}
+
+void ObjectManager::keep_serials(Serial const last_serial) {
+	assert(objects_.empty());
+	lastserial_ = last_serial;
+	keep_serials_ = true;
+}
+
+void ObjectManager::reuse_serial(Serial const serial) {
+	if (!keep_serials_) {
+		return;
+	}
+	if (serial == 0 || serial > lastserial_) {
+		throw wexception("serial %u was never used, last serial is %u", serial, lastserial_);
+	}
+	if (objects_.count(serial)) {
+		throw wexception("serial %u is already in use", serial);
+	}
+	next_serial_ = serial;
 }
 
 /**
@@ -746,6 +793,8 @@ void MapObject::Loader::load(FileRead& fr) {
 			MapObject& obj = *get_object();
 			obj.reserved_by_worker_ = fr.unsigned_8();
 		}
+
+		egbase().objects().reuse_serial(serial);
 	} catch (const WException& e) {
 		throw wexception("map object: %s", e.what());
 	}
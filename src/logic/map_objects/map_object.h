@@ -386,7 +386,7 @@ inline int32_t get_reverse_dir(int32_t const dir) {
 struct ObjectManager {
 	using MapObjectMap = std::unordered_map<Serial, MapObject*>;
 
-	ObjectManager() : lastserial_(0), is_cleaning_up_(false) {
+	ObjectManager() : lastserial_(0), keep_serials_(false), next_serial_(0), is_cleaning_up_(false) {
 	}
 	~ObjectManager();
 
@@ -400,6 +400,16 @@ struct ObjectManager {
 	void insert(MapObject*);
 	void remove(MapObject&);
 
+	Serial last_serial() const {
+		return lastserial_;
+	}
+	/// Let the objects that are loaded next keep the serials that they were saved with, see
+	/// \ref reuse_serial. Objects that are created afterwards continue after 'last_serial'.
+	void keep_serials(Serial last_serial);
+	/// Insert the next object with the given serial instead of a new one. This has no effect
+	/// unless \ref keep_serials has been called since the last cleanup.
+	void reuse_serial(Serial serial);
+
 	/**
 	 * When saving the map object, ordere matters. Return a vector of all ids
 	 * that are currently available;
@@ -412,6 +422,8 @@ struct ObjectManager {
 
 private:
 	Serial lastserial_;
+	bool keep_serials_;
+	Serial next_serial_;
 	MapObjectMap objects_;
 
 	bool is_cleaning_up_;
@@ -62,7 +62,7 @@ Battle::Battle(Game& game, Soldier* first_soldier, Soldier* second_soldier)
      last_attack_hits_(false) {
 	assert(first_soldier->get_owner() != second_soldier->get_owner());
 	{
-		StreamWrite& ss = game.syncstream();
+		StreamWrite& ss = game.syncstream(SyncCategory::kBobs);
 		ss.unsigned_8(SyncEntry::kBattle);
 		ss.unsigned_32(first_soldier->serial());
 		ss.unsigned_32(second_soldier->serial());
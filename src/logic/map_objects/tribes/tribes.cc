@@ -239,6 +239,7 @@ void Tribes::register_scenario_tribes(FileSystem* filesystem) {
 }
 
 void Tribes::add_tribe_object_type(const LuaTable& table, World& world, MapObjectType type) {
+	description_manager_->record_for_snapshot(DescriptionSnapshot::Owner::kTribes, type, table);
 	const std::string& type_name = table.get_string("name");
 	const std::string& type_descname = table.get_string("descname").c_str();
 
@@ -304,6 +305,8 @@ void Tribes::add_tribe_object_type(const LuaTable& table, World& world, MapObjec
 }
 
 void Tribes::add_tribe(const LuaTable& table, const World& world) {
+	// Tribes are not part of the snapshot, so the script has to be evaluated every time
+	description_manager_->prevent_snapshot();
 	const std::string name = table.get_string("name");
 	// Register as in progress
 	description_manager_->mark_loading_in_progress(name);
@@ -256,6 +256,10 @@ PlayerImmovable* WarehouseSupply::get_position(Game&) {
 	return warehouse_;
 }
 
+Serial WarehouseSupply::serial() const {
+	return warehouse_->serial();
+}
+
 /// Warehouse supplies are never active.
 bool WarehouseSupply::is_active() const {
 	return false;
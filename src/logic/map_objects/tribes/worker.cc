@@ -19,6 +19,7 @@
 
 #include "logic/map_objects/tribes/worker.h"
 
+#include <algorithm>
 #include <memory>
 #include <tuple>
 
@@ -3258,7 +3259,8 @@ Load/save support
 ==============================
 */
 
-constexpr uint8_t kCurrentPacketVersion = 3;
+// Version 3 didn't store the position of the worker at its location
+constexpr uint8_t kCurrentPacketVersion = 4;
 
 Worker::Loader::Loader() : location_(0), carried_ware_(0) {
 }
@@ -3267,10 +3269,13 @@ void Worker::Loader::load(FileRead& fr) {
 	Bob::Loader::load(fr);
 	try {
 		const uint8_t packet_version = fr.unsigned_8();
-		if (packet_version == kCurrentPacketVersion) {
+		if (packet_version >= 3 && packet_version <= kCurrentPacketVersion) {
 
 			Worker& worker = get<Worker>();
 			location_ = fr.unsigned_32();
+			if (packet_version >= 4) {
+				mol().set_location_position(worker, fr.unsigned_32());
+			}
 			carried_ware_ = fr.unsigned_32();
 			worker.current_exp_ = fr.signed_32();
 
@@ -3444,7 +3449,15 @@ void Worker::do_save(EditorGameBase& egbase, MapObjectSaver& mos, FileWrite& fw)
 	Bob::save(egbase, mos, fw);
 
 	fw.unsigned_8(kCurrentPacketVersion);
-	fw.unsigned_32(mos.get_object_file_index_or_zero(location_.get(egbase)));
+	PlayerImmovable* location = location_.get(egbase);
+	fw.unsigned_32(mos.get_object_file_index_or_zero(location));
+	// Loading adds the workers to their locations in another order
+	uint32_t location_position = 0;
+	if (location != nullptr) {
+		const PlayerImmovable::Workers& workers = location->get_workers();
+		location_position = std::find(workers.begin(), workers.end(), this) - workers.begin();
+	}
+	fw.unsigned_32(location_position);
 	fw.unsigned_32(mos.get_object_file_index_or_zero(carried_ware_.get(egbase)));
 	fw.signed_32(current_exp_);
 
@@ -53,6 +53,7 @@ World::World(DescriptionManager* description_manager, bool render_only)
 }
 
 void World::add_world_object_type(const LuaTable& table, MapObjectType type) {
+	description_manager_->record_for_snapshot(DescriptionSnapshot::Owner::kWorld, type, table);
 	const std::string& type_name = table.get_string("name");
 
 	// TODO(GunChleoc): Compatibility, remove after v1.0
@@ -20,6 +20,7 @@
 #include "logic/pathfield.h"
 
 #include <memory>
+#include <thread>
 
 #include "base/wexception.h"
 
@@ -32,6 +33,7 @@ PathfieldManager::PathfieldManager() : nrfields_(0) {
 }
 
 void PathfieldManager::set_size(uint32_t const nrfields) {
+	std::lock_guard<std::mutex> lock(mutex_);
 	if (nrfields_ != nrfields) {
 		list_.clear();
 	}
@@ -40,6 +42,7 @@ void PathfieldManager::set_size(uint32_t const nrfields) {
 }
 
 std::shared_ptr<Pathfields> PathfieldManager::allocate() {
+	std::lock_guard<std::mutex> lock(mutex_);
 	for (std::shared_ptr<Pathfields>& pathfield : list_) {
 		if (pathfield.use_count() == 1) {
 			++pathfield->cycle;
@@ -50,7 +53,7 @@ std::shared_ptr<Pathfields> PathfieldManager::allocate() {
 		}
 	}
 
-	if (list_.size() >= 8) {
+	if (list_.size() >= 8 + std::thread::hardware_concurrency()) {
 		throw wexception("PathfieldManager::allocate: unbounded nesting?");
 	}
 
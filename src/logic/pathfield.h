@@ -21,6 +21,7 @@
 #define WL_LOGIC_PATHFIELD_H
 
 #include <memory>
+#include <mutex>
 
 #include "logic/cookie_priority_queue.h"
 #include "logic/map_objects/tribes/wareworker.h"
@@ -70,7 +71,8 @@ struct Pathfields {
  * Efficiently manages \ref Pathfields instances.
  *
  * This allows the use of more than one such structure at once,
- * which is required for pathfinding reentrancy.
+ * which is required for pathfinding reentrancy, and for computer players
+ * that search paths on several threads at once.
  */
 struct PathfieldManager {
 	PathfieldManager();
@@ -85,6 +87,7 @@ private:
 
 	uint32_t nrfields_;
 	List list_;
+	std::mutex mutex_;
 };
 }  // namespace Widelands
 
@@ -54,7 +54,7 @@ Serial get_object_serial_or_zero(uint32_t object_index, MapObjectLoader& mol) {
 	return mol.get<T>(object_index).serial();
 }
 
-void serialize_bill_of_materials(const BillOfMaterials& bill, StreamWrite* ser) {
+void serialize_bill_of_materials(const BillOfMaterials& bill, CommandWriter* ser) {
 	ser->unsigned_32(bill.size());
 	for (const WareAmount& amount : bill) {
 		ser->unsigned_8(amount.first);
@@ -62,7 +62,7 @@ void serialize_bill_of_materials(const BillOfMaterials& bill, StreamWrite* ser)
 	}
 }
 
-BillOfMaterials deserialize_bill_of_materials(StreamRead* des) {
+BillOfMaterials deserialize_bill_of_materials(CommandReader* des) {
 	BillOfMaterials bill;
 	const int count = des->unsigned_32();
 	for (int i = 0; i < count; ++i) {
@@ -81,12 +81,12 @@ PlayerCommand::PlayerCommand(const Time& time, const PlayerNumber s)
    : GameLogicCommand(time), sender_(s), cmdserial_(0) {
 }
 
-void PlayerCommand::write_id_and_sender(StreamWrite& ser) {
+void PlayerCommand::write_id_and_sender(CommandWriter& ser) {
 	ser.unsigned_8(static_cast<uint8_t>(id()));
 	ser.unsigned_8(sender());
 }
 
-PlayerCommand* PlayerCommand::deserialize(StreamRead& des) {
+PlayerCommand* PlayerCommand::deserialize(CommandReader& des) {
 	switch (static_cast<QueueCommandTypes>(des.unsigned_8())) {
 	case QueueCommandTypes::kBulldoze:
 		return new CmdBulldoze(des);
@@ -197,9 +197,9 @@ void PlayerCommand::read(FileRead& fr, EditorGameBase& egbase, MapObjectLoader&
 
 /*** class Cmd_Bulldoze ***/
 
-CmdBulldoze::CmdBulldoze(StreamRead& des)
+CmdBulldoze::CmdBulldoze(CommandReader& des)
    : PlayerCommand(Time(0), des.unsigned_8()),
-     serial(des.unsigned_32()),
+     serial(des.serial()),
      recurse(des.unsigned_8()) {
 }
 
@@ -209,9 +209,9 @@ void CmdBulldoze::execute(Game& game) {
 	}
 }
 
-void CmdBulldoze::serialize(StreamWrite& ser) {
+void CmdBulldoze::serialize(CommandWriter& ser) {
 	write_id_and_sender(ser);
-	ser.unsigned_32(serial);
+	ser.serial(serial);
 	ser.unsigned_8(recurse);
 }
 
@@ -244,9 +244,9 @@ void CmdBulldoze::write(FileWrite& fw, EditorGameBase& egbase, MapObjectSaver& m
 
 /*** class Cmd_Build ***/
 
-CmdBuild::CmdBuild(StreamRead& des) : PlayerCommand(Time(0), des.unsigned_8()) {
+CmdBuild::CmdBuild(CommandReader& des) : PlayerCommand(Time(0), des.unsigned_8()) {
 	bi = des.signed_16();
-	coords = read_coords_32(&des);
+	coords = des.coords();
 }
 
 void CmdBuild::execute(Game& game) {
@@ -255,10 +255,10 @@ void CmdBuild::execute(Game& game) {
 	game.get_player(sender())->build(coords, bi, true, former_buildings);
 }
 
-void CmdBuild::serialize(StreamWrite& ser) {
+void CmdBuild::serialize(CommandWriter& ser) {
 	write_id_and_sender(ser);
 	ser.signed_16(bi);
-	write_coords_32(&ser, coords);
+	ser.coords(coords);
 }
 
 constexpr uint16_t kCurrentPacketVersionCmdBuild = 1;
@@ -290,17 +290,17 @@ void CmdBuild::write(FileWrite& fw, EditorGameBase& egbase, MapObjectSaver& mos)
 
 /*** class Cmd_BuildFlag ***/
 
-CmdBuildFlag::CmdBuildFlag(StreamRead& des)
-   : PlayerCommand(Time(0), des.unsigned_8()), coords(read_coords_32(&des)) {
+CmdBuildFlag::CmdBuildFlag(CommandReader& des)
+   : PlayerCommand(Time(0), des.unsigned_8()), coords(des.coords()) {
 }
 
 void CmdBuildFlag::execute(Game& game) {
 	game.get_player(sender())->build_flag(coords);
 }
 
-void CmdBuildFlag::serialize(StreamWrite& ser) {
+void CmdBuildFlag::serialize(CommandWriter& ser) {
 	write_id_and_sender(ser);
-	write_coords_32(&ser, coords);
+	ser.coords(coords);
 }
 
 constexpr uint16_t kCurrentPacketVersionCmdBuildFlag = 1;
@@ -337,11 +337,11 @@ CmdBuildRoad::CmdBuildRoad(const Time& t, int32_t p, Path& pa)
      steps(nullptr) {
 }
 
-CmdBuildRoad::CmdBuildRoad(StreamRead& des)
+CmdBuildRoad::CmdBuildRoad(CommandReader& des)
    : PlayerCommand(Time(0), des.unsigned_8()),
      // We cannot completely deserialize the path here because we don't have a Map
      path(nullptr),
-     start(read_coords_32(&des)),
+     start(des.coords()),
      nsteps(des.unsigned_16()),
      steps(new uint8_t[nsteps]) {
 	for (Path::StepVector::size_type i = 0; i < nsteps; ++i) {
@@ -365,9 +365,9 @@ void CmdBuildRoad::execute(Game& game) {
 	game.get_player(sender())->build_road(*path);
 }
 
-void CmdBuildRoad::serialize(StreamWrite& ser) {
+void CmdBuildRoad::serialize(CommandWriter& ser) {
 	write_id_and_sender(ser);
-	write_coords_32(&ser, start);
+	ser.coords(start);
 	ser.unsigned_16(nsteps);
 
 	assert(path || steps);
@@ -421,11 +421,11 @@ CmdBuildWaterway::CmdBuildWaterway(const Time& t, int32_t p, Path& pa)
      steps(nullptr) {
 }
 
-CmdBuildWaterway::CmdBuildWaterway(StreamRead& des)
+CmdBuildWaterway::CmdBuildWaterway(CommandReader& des)
    : PlayerCommand(Time(0), des.unsigned_8()),
      // We cannot completely deserialize the path here because we don't have a Map
      path(nullptr),
-     start(read_coords_32(&des)),
+     start(des.coords()),
      nsteps(des.unsigned_16()),
      steps(new uint8_t[nsteps]) {
 	for (Path::StepVector::size_type i = 0; i < nsteps; ++i) {
@@ -449,9 +449,9 @@ void CmdBuildWaterway::execute(Game& game) {
 	game.get_player(sender())->build_waterway(*path);
 }
 
-void CmdBuildWaterway::serialize(StreamWrite& ser) {
+void CmdBuildWaterway::serialize(CommandWriter& ser) {
 	write_id_and_sender(ser);
-	write_coords_32(&ser, start);
+	ser.coords(start);
 	ser.unsigned_16(nsteps);
 
 	assert(path || steps);
@@ -496,9 +496,9 @@ void CmdBuildWaterway::write(FileWrite& fw, EditorGameBase& egbase, MapObjectSav
 }
 
 /*** Cmd_FlagAction ***/
-CmdFlagAction::CmdFlagAction(StreamRead& des) : PlayerCommand(Time(0), des.unsigned_8()) {
+CmdFlagAction::CmdFlagAction(CommandReader& des) : PlayerCommand(Time(0), des.unsigned_8()) {
 	des.unsigned_8();
-	serial = des.unsigned_32();
+	serial = des.serial();
 }
 
 void CmdFlagAction::execute(Game& game) {
@@ -510,10 +510,10 @@ void CmdFlagAction::execute(Game& game) {
 	}
 }
 
-void CmdFlagAction::serialize(StreamWrite& ser) {
+void CmdFlagAction::serialize(CommandWriter& ser) {
 	write_id_and_sender(ser);
 	ser.unsigned_8(0);
-	ser.unsigned_32(serial);
+	ser.serial(serial);
 }
 
 constexpr uint16_t kCurrentPacketVersionCmdFlagAction = 2;
@@ -543,9 +543,9 @@ void CmdFlagAction::write(FileWrite& fw, EditorGameBase& egbase, MapObjectSaver&
 
 /*** Cmd_StartStopBuilding ***/
 
-CmdStartStopBuilding::CmdStartStopBuilding(StreamRead& des)
+CmdStartStopBuilding::CmdStartStopBuilding(CommandReader& des)
    : PlayerCommand(Time(0), des.unsigned_8()) {
-	serial = des.unsigned_32();
+	serial = des.serial();
 }
 
 void CmdStartStopBuilding::execute(Game& game) {
@@ -559,9 +559,9 @@ void CmdStartStopBuilding::execute(Game& game) {
 	}
 }
 
-void CmdStartStopBuilding::serialize(StreamWrite& ser) {
+void CmdStartStopBuilding::serialize(CommandWriter& ser) {
 	write_id_and_sender(ser);
-	ser.unsigned_32(serial);
+	ser.serial(serial);
 }
 
 constexpr uint16_t kCurrentPacketVersionCmdStartStopBuilding = 1;
@@ -590,15 +590,15 @@ void CmdStartStopBuilding::write(FileWrite& fw, EditorGameBase& egbase, MapObjec
 	fw.unsigned_32(mos.get_object_file_index_or_zero(egbase.objects().get_object(serial)));
 }
 
-CmdMilitarySiteSetSoldierPreference::CmdMilitarySiteSetSoldierPreference(StreamRead& des)
+CmdMilitarySiteSetSoldierPreference::CmdMilitarySiteSetSoldierPreference(CommandReader& des)
    : PlayerCommand(Time(0), des.unsigned_8()) {
-	serial = des.unsigned_32();
+	serial = des.serial();
 	preference = static_cast<Widelands::SoldierPreference>(des.unsigned_8());
 }
 
-void CmdMilitarySiteSetSoldierPreference::serialize(StreamWrite& ser) {
+void CmdMilitarySiteSetSoldierPreference::serialize(CommandWriter& ser) {
 	write_id_and_sender(ser);
-	ser.unsigned_32(serial);
+	ser.serial(serial);
 	ser.unsigned_8(static_cast<uint8_t>(preference));
 }
 
@@ -649,9 +649,9 @@ void CmdMilitarySiteSetSoldierPreference::read(FileRead& fr,
 
 /*** Cmd_StartOrCancelExpedition ***/
 
-CmdStartOrCancelExpedition::CmdStartOrCancelExpedition(StreamRead& des)
+CmdStartOrCancelExpedition::CmdStartOrCancelExpedition(CommandReader& des)
    : PlayerCommand(Time(0), des.unsigned_8()) {
-	serial = des.unsigned_32();
+	serial = des.serial();
 }
 
 void CmdStartOrCancelExpedition::execute(Game& game) {
@@ -665,9 +665,9 @@ void CmdStartOrCancelExpedition::execute(Game& game) {
 	}
 }
 
-void CmdStartOrCancelExpedition::serialize(StreamWrite& ser) {
+void CmdStartOrCancelExpedition::serialize(CommandWriter& ser) {
 	write_id_and_sender(ser);
-	ser.unsigned_32(serial);
+	ser.serial(serial);
 }
 
 constexpr uint16_t kCurrentPacketVersionExpedition = 1;
@@ -698,9 +698,9 @@ void CmdStartOrCancelExpedition::write(FileWrite& fw, EditorGameBase& egbase, Ma
 
 /*** Cmd_ExpeditionConfig ***/
 
-CmdExpeditionConfig::CmdExpeditionConfig(StreamRead& des)
+CmdExpeditionConfig::CmdExpeditionConfig(CommandReader& des)
    : PlayerCommand(Time(0), des.unsigned_8()) {
-	serial = des.unsigned_32();
+	serial = des.serial();
 	type = des.unsigned_8() == 0 ? wwWARE : wwWORKER;
 	index = des.unsigned_32();
 	add = des.unsigned_8();
@@ -714,9 +714,9 @@ void CmdExpeditionConfig::execute(Game& game) {
 	}
 }
 
-void CmdExpeditionConfig::serialize(StreamWrite& ser) {
+void CmdExpeditionConfig::serialize(CommandWriter& ser) {
 	write_id_and_sender(ser);
-	ser.unsigned_32(serial);
+	ser.serial(serial);
 	ser.unsigned_8(type == wwWARE ? 0 : 1);
 	ser.unsigned_32(index);
 	ser.unsigned_8(add ? 1 : 0);
@@ -753,8 +753,9 @@ void CmdExpeditionConfig::write(FileWrite& fw, EditorGameBase& egbase, MapObject
 
 /*** Cmd_EnhanceBuilding ***/
 
-CmdEnhanceBuilding::CmdEnhanceBuilding(StreamRead& des) : PlayerCommand(Time(0), des.unsigned_8()) {
-	serial_ = des.unsigned_32();
+CmdEnhanceBuilding::CmdEnhanceBuilding(CommandReader& des)
+   : PlayerCommand(Time(0), des.unsigned_8()) {
+	serial_ = des.serial();
 	bi_ = des.unsigned_16();
 	keep_wares_ = des.unsigned_8();
 }
@@ -770,9 +771,9 @@ void CmdEnhanceBuilding::execute(Game& game) {
 	}
 }
 
-void CmdEnhanceBuilding::serialize(StreamWrite& ser) {
+void CmdEnhanceBuilding::serialize(CommandWriter& ser) {
 	write_id_and_sender(ser);
-	ser.unsigned_32(serial_);
+	ser.serial(serial_);
 	ser.unsigned_16(bi_);
 	ser.unsigned_8(keep_wares_ ? 1 : 0);
 }
@@ -804,9 +805,9 @@ void CmdEnhanceBuilding::write(FileWrite& fw, EditorGameBase& egbase, MapObjectS
 }
 
 /*** Cmd_DismantleBuilding ***/
-CmdDismantleBuilding::CmdDismantleBuilding(StreamRead& des)
+CmdDismantleBuilding::CmdDismantleBuilding(CommandReader& des)
    : PlayerCommand(Time(0), des.unsigned_8()) {
-	serial_ = des.unsigned_32();
+	serial_ = des.serial();
 	keep_wares_ = des.unsigned_8();
 }
 
@@ -816,9 +817,9 @@ void CmdDismantleBuilding::execute(Game& game) {
 	}
 }
 
-void CmdDismantleBuilding::serialize(StreamWrite& ser) {
+void CmdDismantleBuilding::serialize(CommandWriter& ser) {
 	write_id_and_sender(ser);
-	ser.unsigned_32(serial_);
+	ser.serial(serial_);
 	ser.unsigned_8(keep_wares_ ? 1 : 0);
 }
 
@@ -851,8 +852,8 @@ void CmdDismantleBuilding::write(FileWrite& fw, EditorGameBase& egbase, MapObjec
 }
 
 /*** Cmd_EvictWorker ***/
-CmdEvictWorker::CmdEvictWorker(StreamRead& des) : PlayerCommand(Time(0), des.unsigned_8()) {
-	serial = des.unsigned_32();
+CmdEvictWorker::CmdEvictWorker(CommandReader& des) : PlayerCommand(Time(0), des.unsigned_8()) {
+	serial = des.serial();
 }
 
 void CmdEvictWorker::execute(Game& game) {
@@ -862,9 +863,9 @@ void CmdEvictWorker::execute(Game& game) {
 	}
 }
 
-void CmdEvictWorker::serialize(StreamWrite& ser) {
+void CmdEvictWorker::serialize(CommandWriter& ser) {
 	write_id_and_sender(ser);
-	ser.unsigned_32(serial);
+	ser.serial(serial);
 }
 
 constexpr uint16_t kCurrentPacketVersionCmdEvictWorker = 1;
@@ -894,9 +895,9 @@ void CmdEvictWorker::write(FileWrite& fw, EditorGameBase& egbase, MapObjectSaver
 }
 
 /*** Cmd_ShipScoutDirection ***/
-CmdShipScoutDirection::CmdShipScoutDirection(StreamRead& des)
+CmdShipScoutDirection::CmdShipScoutDirection(CommandReader& des)
    : PlayerCommand(Time(0), des.unsigned_8()) {
-	serial = des.unsigned_32();
+	serial = des.serial();
 	dir = static_cast<WalkingDir>(des.unsigned_8());
 }
 
@@ -919,9 +920,9 @@ void CmdShipScoutDirection::execute(Game& game) {
 	}
 }
 
-void CmdShipScoutDirection::serialize(StreamWrite& ser) {
+void CmdShipScoutDirection::serialize(CommandWriter& ser) {
 	write_id_and_sender(ser);
-	ser.unsigned_32(serial);
+	ser.serial(serial);
 	ser.unsigned_8(static_cast<uint8_t>(dir));
 }
 
@@ -957,10 +958,10 @@ void CmdShipScoutDirection::write(FileWrite& fw, EditorGameBase& egbase, MapObje
 }
 
 /*** Cmd_ShipConstructPort ***/
-CmdShipConstructPort::CmdShipConstructPort(StreamRead& des)
+CmdShipConstructPort::CmdShipConstructPort(CommandReader& des)
    : PlayerCommand(Time(0), des.unsigned_8()) {
-	serial = des.unsigned_32();
-	coords = read_coords_32(&des);
+	serial = des.serial();
+	coords = des.coords();
 }
 
 void CmdShipConstructPort::execute(Game& game) {
@@ -978,10 +979,10 @@ void CmdShipConstructPort::execute(Game& game) {
 	}
 }
 
-void CmdShipConstructPort::serialize(StreamWrite& ser) {
+void CmdShipConstructPort::serialize(CommandWriter& ser) {
 	write_id_and_sender(ser);
-	ser.unsigned_32(serial);
-	write_coords_32(&ser, coords);
+	ser.serial(serial);
+	ser.coords(coords);
 }
 
 constexpr uint16_t kCurrentPacketVersionShipConstructPort = 1;
@@ -1016,9 +1017,9 @@ void CmdShipConstructPort::write(FileWrite& fw, EditorGameBase& egbase, MapObjec
 }
 
 /*** Cmd_ShipExploreIsland ***/
-CmdShipExploreIsland::CmdShipExploreIsland(StreamRead& des)
+CmdShipExploreIsland::CmdShipExploreIsland(CommandReader& des)
    : PlayerCommand(Time(0), des.unsigned_8()) {
-	serial = des.unsigned_32();
+	serial = des.serial();
 	island_explore_direction = static_cast<IslandExploreDirection>(des.unsigned_8());
 }
 
@@ -1041,9 +1042,9 @@ void CmdShipExploreIsland::execute(Game& game) {
 	}
 }
 
-void CmdShipExploreIsland::serialize(StreamWrite& ser) {
+void CmdShipExploreIsland::serialize(CommandWriter& ser) {
 	write_id_and_sender(ser);
-	ser.unsigned_32(serial);
+	ser.serial(serial);
 	ser.unsigned_8(static_cast<uint8_t>(island_explore_direction));
 }
 
@@ -1078,8 +1079,8 @@ void CmdShipExploreIsland::write(FileWrite& fw, EditorGameBase& egbase, MapObjec
 }
 
 /*** Cmd_ShipSink ***/
-CmdShipSink::CmdShipSink(StreamRead& des) : PlayerCommand(Time(0), des.unsigned_8()) {
-	serial = des.unsigned_32();
+CmdShipSink::CmdShipSink(CommandReader& des) : PlayerCommand(Time(0), des.unsigned_8()) {
+	serial = des.serial();
 }
 
 void CmdShipSink::execute(Game& game) {
@@ -1089,9 +1090,9 @@ void CmdShipSink::execute(Game& game) {
 	}
 }
 
-void CmdShipSink::serialize(StreamWrite& ser) {
+void CmdShipSink::serialize(CommandWriter& ser) {
 	write_id_and_sender(ser);
-	ser.unsigned_32(serial);
+	ser.serial(serial);
 }
 
 constexpr uint16_t kCurrentPacketVersionCmdShipSink = 1;
@@ -1121,9 +1122,9 @@ void CmdShipSink::write(FileWrite& fw, EditorGameBase& egbase, MapObjectSaver& m
 }
 
 /*** Cmd_ShipCancelExpedition ***/
-CmdShipCancelExpedition::CmdShipCancelExpedition(StreamRead& des)
+CmdShipCancelExpedition::CmdShipCancelExpedition(CommandReader& des)
    : PlayerCommand(Time(0), des.unsigned_8()) {
-	serial = des.unsigned_32();
+	serial = des.serial();
 }
 
 void CmdShipCancelExpedition::execute(Game& game) {
@@ -1133,9 +1134,9 @@ void CmdShipCancelExpedition::execute(Game& game) {
 	}
 }
 
-void CmdShipCancelExpedition::serialize(StreamWrite& ser) {
+void CmdShipCancelExpedition::serialize(CommandWriter& ser) {
 	write_id_and_sender(ser);
-	ser.unsigned_32(serial);
+	ser.serial(serial);
 }
 
 constexpr uint16_t kCurrentPacketVersionShipCancelExpedition = 1;
@@ -1235,18 +1236,18 @@ void CmdSetWarePriority::read(FileRead& fr, EditorGameBase& egbase, MapObjectLoa
 	}
 }
 
-CmdSetWarePriority::CmdSetWarePriority(StreamRead& des)
+CmdSetWarePriority::CmdSetWarePriority(CommandReader& des)
    : PlayerCommand(Time(0), des.unsigned_8()),
-     serial_(des.unsigned_32()),
+     serial_(des.serial()),
      type_(des.unsigned_8()),
      index_(des.signed_32()),
      priority_(des.signed_32()),
      is_constructionsite_setting_(des.unsigned_8()) {
 }
 
-void CmdSetWarePriority::serialize(StreamWrite& ser) {
+void CmdSetWarePriority::serialize(CommandWriter& ser) {
 	write_id_and_sender(ser);
-	ser.unsigned_32(serial_);
+	ser.serial(serial_);
 	ser.unsigned_8(type_);
 	ser.signed_32(index_);
 	ser.signed_32(priority_);
@@ -1341,8 +1342,9 @@ void CmdSetInputMaxFill::read(FileRead& fr, EditorGameBase& egbase, MapObjectLoa
 	}
 }
 
-CmdSetInputMaxFill::CmdSetInputMaxFill(StreamRead& des) : PlayerCommand(Time(0), des.unsigned_8()) {
-	serial_ = des.unsigned_32();
+CmdSetInputMaxFill::CmdSetInputMaxFill(CommandReader& des)
+   : PlayerCommand(Time(0), des.unsigned_8()) {
+	serial_ = des.serial();
 	index_ = des.signed_32();
 	if (des.unsigned_8() == 0) {
 		type_ = wwWARE;
@@ -1353,9 +1355,9 @@ CmdSetInputMaxFill::CmdSetInputMaxFill(StreamRead& des) : PlayerCommand(Time(0),
 	is_constructionsite_setting_ = des.unsigned_8();
 }
 
-void CmdSetInputMaxFill::serialize(StreamWrite& ser) {
+void CmdSetInputMaxFill::serialize(CommandWriter& ser) {
 	write_id_and_sender(ser);
-	ser.unsigned_32(serial_);
+	ser.serial(serial_);
 	ser.signed_32(index_);
 	ser.unsigned_8(type_ == wwWARE ? 0 : 1);
 	ser.unsigned_32(max_fill_);
@@ -1385,15 +1387,15 @@ void CmdChangeTargetQuantity::read(FileRead& fr, EditorGameBase& egbase, MapObje
 	}
 }
 
-CmdChangeTargetQuantity::CmdChangeTargetQuantity(StreamRead& des)
+CmdChangeTargetQuantity::CmdChangeTargetQuantity(CommandReader& des)
    : PlayerCommand(Time(0), des.unsigned_8()),
-     economy_(des.unsigned_32()),
+     economy_(des.serial()),
      ware_type_(des.unsigned_8()) {
 }
 
-void CmdChangeTargetQuantity::serialize(StreamWrite& ser) {
+void CmdChangeTargetQuantity::serialize(CommandWriter& ser) {
 	// Subclasses take care of writing their id() and sender()
-	ser.unsigned_32(economy());
+	ser.serial(economy());
 	ser.unsigned_8(ware_type());
 }
 
@@ -1437,14 +1439,14 @@ void CmdSetWareTargetQuantity::read(FileRead& fr, EditorGameBase& egbase, MapObj
 	}
 }
 
-CmdSetWareTargetQuantity::CmdSetWareTargetQuantity(StreamRead& des)
+CmdSetWareTargetQuantity::CmdSetWareTargetQuantity(CommandReader& des)
    : CmdChangeTargetQuantity(des), permanent_(des.unsigned_32()) {
 	if (cmdserial() == 1) {
 		des.unsigned_32();
 	}
 }
 
-void CmdSetWareTargetQuantity::serialize(StreamWrite& ser) {
+void CmdSetWareTargetQuantity::serialize(CommandWriter& ser) {
 	write_id_and_sender(ser);
 	CmdChangeTargetQuantity::serialize(ser);
 	ser.unsigned_32(permanent_);
@@ -1490,23 +1492,23 @@ void CmdSetWorkerTargetQuantity::read(FileRead& fr, EditorGameBase& egbase, MapO
 	}
 }
 
-CmdSetWorkerTargetQuantity::CmdSetWorkerTargetQuantity(StreamRead& des)
+CmdSetWorkerTargetQuantity::CmdSetWorkerTargetQuantity(CommandReader& des)
    : CmdChangeTargetQuantity(des), permanent_(des.unsigned_32()) {
 	if (cmdserial() == 1) {
 		des.unsigned_32();
 	}
 }
 
-void CmdSetWorkerTargetQuantity::serialize(StreamWrite& ser) {
+void CmdSetWorkerTargetQuantity::serialize(CommandWriter& ser) {
 	write_id_and_sender(ser);
 	CmdChangeTargetQuantity::serialize(ser);
 	ser.unsigned_32(permanent_);
 }
 
 /*** class Cmd_ChangeTrainingOptions ***/
-CmdChangeTrainingOptions::CmdChangeTrainingOptions(StreamRead& des)
+CmdChangeTrainingOptions::CmdChangeTrainingOptions(CommandReader& des)
    : PlayerCommand(Time(0), des.unsigned_8()) {
-	serial = des.unsigned_32();                                    //  Serial of the building
+	serial = des.serial();                                    //  Serial of the building
 	attribute = static_cast<TrainingAttribute>(des.unsigned_8());  //  Attribute to modify
 	value = des.unsigned_16();                                     //  New vale
 }
@@ -1517,9 +1519,9 @@ void CmdChangeTrainingOptions::execute(Game& game) {
 	}
 }
 
-void CmdChangeTrainingOptions::serialize(StreamWrite& ser) {
+void CmdChangeTrainingOptions::serialize(CommandWriter& ser) {
 	write_id_and_sender(ser);
-	ser.unsigned_32(serial);
+	ser.serial(serial);
 	ser.unsigned_8(static_cast<uint8_t>(attribute));
 	ser.unsigned_16(value);
 }
@@ -1558,9 +1560,9 @@ void CmdChangeTrainingOptions::write(FileWrite& fw, EditorGameBase& egbase, MapO
 
 /*** class Cmd_DropSoldier ***/
 
-CmdDropSoldier::CmdDropSoldier(StreamRead& des) : PlayerCommand(Time(0), des.unsigned_8()) {
-	serial = des.unsigned_32();   //  Serial of the building
-	soldier = des.unsigned_32();  //  Serial of soldier
+CmdDropSoldier::CmdDropSoldier(CommandReader& des) : PlayerCommand(Time(0), des.unsigned_8()) {
+	serial = des.serial();   //  Serial of the building
+	soldier = des.serial();  //  Serial of soldier
 }
 
 void CmdDropSoldier::execute(Game& game) {
@@ -1571,10 +1573,10 @@ void CmdDropSoldier::execute(Game& game) {
 	}
 }
 
-void CmdDropSoldier::serialize(StreamWrite& ser) {
+void CmdDropSoldier::serialize(CommandWriter& ser) {
 	write_id_and_sender(ser);
-	ser.unsigned_32(serial);
-	ser.unsigned_32(soldier);
+	ser.serial(serial);
+	ser.serial(soldier);
 }
 
 constexpr uint16_t kCurrentPacketVersionCmdDropSoldier = 1;
@@ -1610,9 +1612,9 @@ void CmdDropSoldier::write(FileWrite& fw, EditorGameBase& egbase, MapObjectSaver
 
 /*** Cmd_ChangeSoldierCapacity ***/
 
-CmdChangeSoldierCapacity::CmdChangeSoldierCapacity(StreamRead& des)
+CmdChangeSoldierCapacity::CmdChangeSoldierCapacity(CommandReader& des)
    : PlayerCommand(Time(0), des.unsigned_8()) {
-	serial = des.unsigned_32();
+	serial = des.serial();
 	val = des.signed_16();
 }
 
@@ -1645,9 +1647,9 @@ void CmdChangeSoldierCapacity::execute(Game& game) {
 	}
 }
 
-void CmdChangeSoldierCapacity::serialize(StreamWrite& ser) {
+void CmdChangeSoldierCapacity::serialize(CommandWriter& ser) {
 	write_id_and_sender(ser);
-	ser.unsigned_32(serial);
+	ser.serial(serial);
 	ser.signed_16(val);
 }
 
@@ -1684,14 +1686,15 @@ void CmdChangeSoldierCapacity::write(FileWrite& fw, EditorGameBase& egbase, MapO
 
 /*** Cmd_EnemyFlagAction ***/
 
-CmdEnemyFlagAction::CmdEnemyFlagAction(StreamRead& des) : PlayerCommand(Time(0), des.unsigned_8()) {
+CmdEnemyFlagAction::CmdEnemyFlagAction(CommandReader& des)
+   : PlayerCommand(Time(0), des.unsigned_8()) {
 	des.unsigned_8();
-	serial = des.unsigned_32();
+	serial = des.serial();
 	des.unsigned_8();
 	const uint32_t number = des.unsigned_32();
 	soldiers.clear();
 	for (uint32_t i = 0; i < number; ++i) {
-		soldiers.push_back(des.unsigned_32());
+		soldiers.push_back(des.serial());
 	}
 }
 
@@ -1726,14 +1729,14 @@ void CmdEnemyFlagAction::execute(Game& game) {
 	}
 }
 
-void CmdEnemyFlagAction::serialize(StreamWrite& ser) {
+void CmdEnemyFlagAction::serialize(CommandWriter& ser) {
 	write_id_and_sender(ser);
 	ser.unsigned_8(1);
-	ser.unsigned_32(serial);
+	ser.serial(serial);
 	ser.unsigned_8(sender());
 	ser.unsigned_32(soldiers.size());
 	for (Serial s : soldiers) {
-		ser.unsigned_32(s);
+		ser.serial(s);
 	}
 }
 
@@ -1795,7 +1798,7 @@ void CmdEnemyFlagAction::write(FileWrite& fw, EditorGameBase& egbase, MapObjectS
 
 /*** struct PlayerMessageCommand ***/
 
-PlayerMessageCommand::PlayerMessageCommand(StreamRead& des)
+PlayerMessageCommand::PlayerMessageCommand(CommandReader& des)
    : PlayerCommand(Time(0), des.unsigned_8()), message_id_(des.unsigned_32()) {
 }
 
@@ -1832,7 +1835,7 @@ void CmdMessageSetStatusRead::execute(Game& game) {
 	   message_id(), Message::Status::kRead);
 }
 
-void CmdMessageSetStatusRead::serialize(StreamWrite& ser) {
+void CmdMessageSetStatusRead::serialize(CommandWriter& ser) {
 	write_id_and_sender(ser);
 	ser.unsigned_32(message_id().value());
 }
@@ -1844,7 +1847,7 @@ void CmdMessageSetStatusArchived::execute(Game& game) {
 	   message_id(), Message::Status::kArchived);
 }
 
-void CmdMessageSetStatusArchived::serialize(StreamWrite& ser) {
+void CmdMessageSetStatusArchived::serialize(CommandWriter& ser) {
 	write_id_and_sender(ser);
 	ser.unsigned_32(message_id().value());
 }
@@ -1908,16 +1911,17 @@ void CmdSetStockPolicy::execute(Game& game) {
 	}
 }
 
-CmdSetStockPolicy::CmdSetStockPolicy(StreamRead& des) : PlayerCommand(Time(0), des.unsigned_8()) {
-	warehouse_ = des.unsigned_32();
+CmdSetStockPolicy::CmdSetStockPolicy(CommandReader& des)
+   : PlayerCommand(Time(0), des.unsigned_8()) {
+	warehouse_ = des.serial();
 	isworker_ = des.unsigned_8();
 	ware_ = DescriptionIndex(des.unsigned_8());
 	policy_ = static_cast<StockPolicy>(des.unsigned_8());
 }
 
-void CmdSetStockPolicy::serialize(StreamWrite& ser) {
+void CmdSetStockPolicy::serialize(CommandWriter& ser) {
 	write_id_and_sender(ser);
-	ser.unsigned_32(warehouse_);
+	ser.serial(warehouse_);
 	ser.unsigned_8(isworker_);
 	ser.unsigned_8(ware_);
 	ser.unsigned_8(static_cast<uint8_t>(policy_));
@@ -1993,18 +1997,18 @@ void CmdProposeTrade::execute(Game& game) {
 	game.propose_trade(trade_);
 }
 
-CmdProposeTrade::CmdProposeTrade(StreamRead& des) : PlayerCommand(Time(0), des.unsigned_8()) {
-	trade_.initiator = des.unsigned_32();
-	trade_.receiver = des.unsigned_32();
+CmdProposeTrade::CmdProposeTrade(CommandReader& des) : PlayerCommand(Time(0), des.unsigned_8()) {
+	trade_.initiator = des.serial();
+	trade_.receiver = des.serial();
 	trade_.items_to_send = deserialize_bill_of_materials(&des);
 	trade_.items_to_receive = deserialize_bill_of_materials(&des);
 	trade_.num_batches = des.signed_32();
 }
 
-void CmdProposeTrade::serialize(StreamWrite& ser) {
+void CmdProposeTrade::serialize(CommandWriter& ser) {
 	write_id_and_sender(ser);
-	ser.unsigned_32(trade_.initiator);
-	ser.unsigned_32(trade_.receiver);
+	ser.serial(trade_.initiator);
+	ser.serial(trade_.receiver);
 	serialize_bill_of_materials(trade_.items_to_send, &ser);
 	serialize_bill_of_materials(trade_.items_to_receive, &ser);
 	ser.signed_32(trade_.num_batches);
@@ -2036,15 +2040,15 @@ void CmdToggleMuteMessages::execute(Game& game) {
 	}
 }
 
-CmdToggleMuteMessages::CmdToggleMuteMessages(StreamRead& des)
+CmdToggleMuteMessages::CmdToggleMuteMessages(CommandReader& des)
    : PlayerCommand(Time(0), des.unsigned_8()) {
-	building_ = des.unsigned_32();
+	building_ = des.serial();
 	all_ = des.unsigned_8();
 }
 
-void CmdToggleMuteMessages::serialize(StreamWrite& ser) {
+void CmdToggleMuteMessages::serialize(CommandWriter& ser) {
 	write_id_and_sender(ser);
-	ser.unsigned_32(building_);
+	ser.serial(building_);
 	ser.unsigned_8(all_ ? 1 : 0);
 }
 
@@ -2080,15 +2084,15 @@ void CmdMarkMapObjectForRemoval::execute(Game& game) {
 	}
 }
 
-CmdMarkMapObjectForRemoval::CmdMarkMapObjectForRemoval(StreamRead& des)
+CmdMarkMapObjectForRemoval::CmdMarkMapObjectForRemoval(CommandReader& des)
    : PlayerCommand(Time(0), des.unsigned_8()) {
-	object_ = des.unsigned_32();
+	object_ = des.serial();
 	mark_ = des.unsigned_8();
 }
 
-void CmdMarkMapObjectForRemoval::serialize(StreamWrite& ser) {
+void CmdMarkMapObjectForRemoval::serialize(CommandWriter& ser) {
 	write_id_and_sender(ser);
-	ser.unsigned_32(object_);
+	ser.serial(object_);
 	ser.unsigned_8(mark_ ? 1 : 0);
 }
 
@@ -2122,16 +2126,14 @@ void CmdPickCustomStartingPosition::execute(Game& game) {
 	game.get_player(sender())->do_pick_custom_starting_position(coords_);
 }
 
-CmdPickCustomStartingPosition::CmdPickCustomStartingPosition(StreamRead& des)
+CmdPickCustomStartingPosition::CmdPickCustomStartingPosition(CommandReader& des)
    : PlayerCommand(Time(0), des.unsigned_8()) {
-	coords_.x = des.unsigned_16();
-	coords_.y = des.unsigned_16();
+	coords_ = des.coords();
 }
 
-void CmdPickCustomStartingPosition::serialize(StreamWrite& ser) {
+void CmdPickCustomStartingPosition::serialize(CommandWriter& ser) {
 	write_id_and_sender(ser);
-	ser.unsigned_16(coords_.x);
-	ser.unsigned_16(coords_.y);
+	ser.coords(coords_);
 }
 
 constexpr uint8_t kCurrentPacketVersionCmdPickCustomStartingPosition = 1;
@@ -24,6 +24,7 @@
 
 #include "economy/flag.h"
 #include "logic/cmd_queue.h"
+#include "logic/command_stream.h"
 #include "logic/map_objects/tribes/militarysite.h"
 #include "logic/map_objects/tribes/ship.h"
 #include "logic/map_objects/tribes/trainingsite.h"
@@ -51,7 +52,7 @@ public:
 	PlayerCommand() : GameLogicCommand(Time(0)), sender_(0), cmdserial_(0) {
 	}
 
-	void write_id_and_sender(StreamWrite& ser);
+	void write_id_and_sender(CommandWriter& ser);
 
 	PlayerNumber sender() const {
 		return sender_;
@@ -64,8 +65,8 @@ public:
 	}
 
 	// For networking and replays
-	virtual void serialize(StreamWrite&) = 0;
-	static Widelands::PlayerCommand* deserialize(StreamRead&);
+	virtual void serialize(CommandWriter&) = 0;
+	static Widelands::PlayerCommand* deserialize(CommandReader&);
 
 	// Call these from child classes
 	void write(FileWrite&, EditorGameBase&, MapObjectSaver&) override;
@@ -83,7 +84,7 @@ struct CmdBulldoze : public PlayerCommand {
 	   : PlayerCommand(t, p), serial(pi.serial()), recurse(init_recurse) {
 	}
 
-	explicit CmdBulldoze(StreamRead&);
+	explicit CmdBulldoze(CommandReader&);
 
 	void write(FileWrite&, EditorGameBase&, MapObjectSaver&) override;
 	void read(FileRead&, EditorGameBase&, MapObjectLoader&) override;
@@ -93,7 +94,7 @@ struct CmdBulldoze : public PlayerCommand {
 	}
 
 	void execute(Game&) override;
-	void serialize(StreamWrite&) override;
+	void serialize(CommandWriter&) override;
 
 private:
 	Serial serial;
@@ -107,7 +108,7 @@ struct CmdBuild : public PlayerCommand {
 	   : PlayerCommand(init_duetime, p), coords(c), bi(i) {
 	}
 
-	explicit CmdBuild(StreamRead&);
+	explicit CmdBuild(CommandReader&);
 
 	void write(FileWrite&, EditorGameBase&, MapObjectSaver&) override;
 	void read(FileRead&, EditorGameBase&, MapObjectLoader&) override;
@@ -117,7 +118,7 @@ struct CmdBuild : public PlayerCommand {
 	}
 
 	void execute(Game&) override;
-	void serialize(StreamWrite&) override;
+	void serialize(CommandWriter&) override;
 
 private:
 	Coords coords;
@@ -130,7 +131,7 @@ struct CmdBuildFlag : public PlayerCommand {
 	CmdBuildFlag(const Time& t, const int32_t p, const Coords& c) : PlayerCommand(t, p), coords(c) {
 	}
 
-	explicit CmdBuildFlag(StreamRead&);
+	explicit CmdBuildFlag(CommandReader&);
 
 	void write(FileWrite&, EditorGameBase&, MapObjectSaver&) override;
 	void read(FileRead&, EditorGameBase&, MapObjectLoader&) override;
@@ -140,7 +141,7 @@ struct CmdBuildFlag : public PlayerCommand {
 	}
 
 	void execute(Game&) override;
-	void serialize(StreamWrite&) override;
+	void serialize(CommandWriter&) override;
 
 private:
 	Coords coords;
@@ -150,7 +151,7 @@ struct CmdBuildRoad : public PlayerCommand {
 	CmdBuildRoad() : PlayerCommand(), path(nullptr), start(), nsteps(0), steps(nullptr) {
 	}  // For savegame loading
 	CmdBuildRoad(const Time&, int32_t, Path&);
-	explicit CmdBuildRoad(StreamRead&);
+	explicit CmdBuildRoad(CommandReader&);
 
 	~CmdBuildRoad() override;
 
@@ -162,7 +163,7 @@ struct CmdBuildRoad : public PlayerCommand {
 	}
 
 	void execute(Game&) override;
-	void serialize(StreamWrite&) override;
+	void serialize(CommandWriter&) override;
 
 private:
 	std::unique_ptr<Path> path;
@@ -175,7 +176,7 @@ struct CmdBuildWaterway : public PlayerCommand {
 	CmdBuildWaterway() : PlayerCommand(), path(nullptr), start(), nsteps(0), steps(nullptr) {
 	}  // For savegame loading
 	CmdBuildWaterway(const Time&, int32_t, Path&);
-	explicit CmdBuildWaterway(StreamRead&);
+	explicit CmdBuildWaterway(CommandReader&);
 
 	~CmdBuildWaterway() override;
 
@@ -187,7 +188,7 @@ struct CmdBuildWaterway : public PlayerCommand {
 	}
 
 	void execute(Game&) override;
-	void serialize(StreamWrite&) override;
+	void serialize(CommandWriter&) override;
 
 private:
 	std::unique_ptr<Path> path;
@@ -210,10 +211,10 @@ struct CmdFlagAction : public PlayerCommand {
 		return QueueCommandTypes::kFlagAction;
 	}
 
-	explicit CmdFlagAction(StreamRead&);
+	explicit CmdFlagAction(CommandReader&);
 
 	void execute(Game&) override;
-	void serialize(StreamWrite&) override;
+	void serialize(CommandWriter&) override;
 
 private:
 	Serial serial;
@@ -233,10 +234,10 @@ struct CmdStartStopBuilding : public PlayerCommand {
 		return QueueCommandTypes::kStartStopBuilding;
 	}
 
-	explicit CmdStartStopBuilding(StreamRead&);
+	explicit CmdStartStopBuilding(CommandReader&);
 
 	void execute(Game&) override;
-	void serialize(StreamWrite&) override;
+	void serialize(CommandWriter&) override;
 
 private:
 	Serial serial;
@@ -260,10 +261,10 @@ struct CmdMilitarySiteSetSoldierPreference : public PlayerCommand {
 		return QueueCommandTypes::kMilitarysiteSetSoldierPreference;
 	}
 
-	explicit CmdMilitarySiteSetSoldierPreference(StreamRead&);
+	explicit CmdMilitarySiteSetSoldierPreference(CommandReader&);
 
 	void execute(Game&) override;
-	void serialize(StreamWrite&) override;
+	void serialize(CommandWriter&) override;
 
 private:
 	Serial serial;
@@ -283,10 +284,10 @@ struct CmdStartOrCancelExpedition : public PlayerCommand {
 		return QueueCommandTypes::kStartOrCancelExpedition;
 	}
 
-	explicit CmdStartOrCancelExpedition(StreamRead&);
+	explicit CmdStartOrCancelExpedition(CommandReader&);
 
 	void execute(Game&) override;
-	void serialize(StreamWrite&) override;
+	void serialize(CommandWriter&) override;
 
 private:
 	Serial serial;
@@ -308,10 +309,10 @@ struct CmdExpeditionConfig : public PlayerCommand {
 		return QueueCommandTypes::kExpeditionConfig;
 	}
 
-	explicit CmdExpeditionConfig(StreamRead&);
+	explicit CmdExpeditionConfig(CommandReader&);
 
 	void execute(Game&) override;
-	void serialize(StreamWrite&) override;
+	void serialize(CommandWriter&) override;
 
 private:
 	Serial serial;
@@ -336,10 +337,10 @@ struct CmdEnhanceBuilding : public PlayerCommand {
 		return QueueCommandTypes::kEnhanceBuilding;
 	}
 
-	explicit CmdEnhanceBuilding(StreamRead&);
+	explicit CmdEnhanceBuilding(CommandReader&);
 
 	void execute(Game&) override;
-	void serialize(StreamWrite&) override;
+	void serialize(CommandWriter&) override;
 
 private:
 	Serial serial_;
@@ -362,10 +363,10 @@ struct CmdDismantleBuilding : public PlayerCommand {
 		return QueueCommandTypes::kDismantleBuilding;
 	}
 
-	explicit CmdDismantleBuilding(StreamRead&);
+	explicit CmdDismantleBuilding(CommandReader&);
 
 	void execute(Game&) override;
-	void serialize(StreamWrite&) override;
+	void serialize(CommandWriter&) override;
 
 private:
 	Serial serial_;
@@ -387,10 +388,10 @@ struct CmdEvictWorker : public PlayerCommand {
 		return QueueCommandTypes::kEvictWorker;
 	}
 
-	explicit CmdEvictWorker(StreamRead&);
+	explicit CmdEvictWorker(CommandReader&);
 
 	void execute(Game&) override;
-	void serialize(StreamWrite&) override;
+	void serialize(CommandWriter&) override;
 
 private:
 	Serial serial;
@@ -410,10 +411,10 @@ struct CmdShipScoutDirection : public PlayerCommand {
 		return QueueCommandTypes::kShipScoutDirection;
 	}
 
-	explicit CmdShipScoutDirection(StreamRead&);
+	explicit CmdShipScoutDirection(CommandReader&);
 
 	void execute(Game&) override;
-	void serialize(StreamWrite&) override;
+	void serialize(CommandWriter&) override;
 
 private:
 	Serial serial;
@@ -434,10 +435,10 @@ struct CmdShipConstructPort : public PlayerCommand {
 		return QueueCommandTypes::kShipConstructPort;
 	}
 
-	explicit CmdShipConstructPort(StreamRead&);
+	explicit CmdShipConstructPort(CommandReader&);
 
 	void execute(Game&) override;
-	void serialize(StreamWrite&) override;
+	void serialize(CommandWriter&) override;
 
 private:
 	Serial serial;
@@ -462,10 +463,10 @@ struct CmdShipExploreIsland : public PlayerCommand {
 		return QueueCommandTypes::kShipExploreIsland;
 	}
 
-	explicit CmdShipExploreIsland(StreamRead&);
+	explicit CmdShipExploreIsland(CommandReader&);
 
 	void execute(Game&) override;
-	void serialize(StreamWrite&) override;
+	void serialize(CommandWriter&) override;
 
 private:
 	Serial serial;
@@ -485,10 +486,10 @@ struct CmdShipSink : public PlayerCommand {
 		return QueueCommandTypes::kShipSink;
 	}
 
-	explicit CmdShipSink(StreamRead&);
+	explicit CmdShipSink(CommandReader&);
 
 	void execute(Game&) override;
-	void serialize(StreamWrite&) override;
+	void serialize(CommandWriter&) override;
 
 private:
 	Serial serial;
@@ -508,10 +509,10 @@ struct CmdShipCancelExpedition : public PlayerCommand {
 		return QueueCommandTypes::kShipCancelExpedition;
 	}
 
-	explicit CmdShipCancelExpedition(StreamRead&);
+	explicit CmdShipCancelExpedition(CommandReader&);
 
 	void execute(Game&) override;
-	void serialize(StreamWrite&) override;
+	void serialize(CommandWriter&) override;
 
 private:
 	Serial serial;
@@ -543,10 +544,10 @@ struct CmdSetWarePriority : public PlayerCommand {
 		return QueueCommandTypes::kSetWarePriority;
 	}
 
-	explicit CmdSetWarePriority(StreamRead&);
+	explicit CmdSetWarePriority(CommandReader&);
 
 	void execute(Game&) override;
-	void serialize(StreamWrite&) override;
+	void serialize(CommandWriter&) override;
 
 private:
 	Serial serial_;
@@ -581,10 +582,10 @@ struct CmdSetInputMaxFill : public PlayerCommand {
 		return QueueCommandTypes::kSetInputMaxFill;
 	}
 
-	explicit CmdSetInputMaxFill(StreamRead&);
+	explicit CmdSetInputMaxFill(CommandReader&);
 
 	void execute(Game&) override;
-	void serialize(StreamWrite&) override;
+	void serialize(CommandWriter&) override;
 
 private:
 	Serial serial_;
@@ -606,9 +607,9 @@ struct CmdChangeTargetQuantity : public PlayerCommand {
 	void write(FileWrite&, EditorGameBase&, MapObjectSaver&) override;
 	void read(FileRead&, EditorGameBase&, MapObjectLoader&) override;
 
-	explicit CmdChangeTargetQuantity(StreamRead&);
+	explicit CmdChangeTargetQuantity(CommandReader&);
 
-	void serialize(StreamWrite&) override;
+	void serialize(CommandWriter&) override;
 
 protected:
 	Serial economy() const {
@@ -640,10 +641,10 @@ struct CmdSetWareTargetQuantity : public CmdChangeTargetQuantity {
 		return QueueCommandTypes::kSetWareTargetQuantity;
 	}
 
-	explicit CmdSetWareTargetQuantity(StreamRead&);
+	explicit CmdSetWareTargetQuantity(CommandReader&);
 
 	void execute(Game&) override;
-	void serialize(StreamWrite&) override;
+	void serialize(CommandWriter&) override;
 
 private:
 	uint32_t permanent_;
@@ -666,10 +667,10 @@ struct CmdSetWorkerTargetQuantity : public CmdChangeTargetQuantity {
 		return QueueCommandTypes::kSetWorkerTargetQuantity;
 	}
 
-	explicit CmdSetWorkerTargetQuantity(StreamRead&);
+	explicit CmdSetWorkerTargetQuantity(CommandReader&);
 
 	void execute(Game&) override;
-	void serialize(StreamWrite&) override;
+	void serialize(CommandWriter&) override;
 
 private:
 	uint32_t permanent_;
@@ -695,10 +696,10 @@ struct CmdChangeTrainingOptions : public PlayerCommand {
 		return QueueCommandTypes::kChangeTrainingOptions;
 	}
 
-	explicit CmdChangeTrainingOptions(StreamRead&);
+	explicit CmdChangeTrainingOptions(CommandReader&);
 
 	void execute(Game&) override;
-	void serialize(StreamWrite&) override;
+	void serialize(CommandWriter&) override;
 
 private:
 	Serial serial;
@@ -721,10 +722,10 @@ struct CmdDropSoldier : public PlayerCommand {
 		return QueueCommandTypes::kDropSoldier;
 	}
 
-	explicit CmdDropSoldier(StreamRead&);
+	explicit CmdDropSoldier(CommandReader&);
 
 	void execute(Game&) override;
-	void serialize(StreamWrite&) override;
+	void serialize(CommandWriter&) override;
 
 private:
 	Serial serial;
@@ -746,10 +747,10 @@ struct CmdChangeSoldierCapacity : public PlayerCommand {
 		return QueueCommandTypes::kChangeSoldierCapacity;
 	}
 
-	explicit CmdChangeSoldierCapacity(StreamRead&);
+	explicit CmdChangeSoldierCapacity(CommandReader&);
 
 	void execute(Game&) override;
-	void serialize(StreamWrite&) override;
+	void serialize(CommandWriter&) override;
 
 private:
 	Serial serial;
@@ -771,10 +772,10 @@ struct CmdEnemyFlagAction : public PlayerCommand {
 		return QueueCommandTypes::kEnemyFlagAction;
 	}
 
-	explicit CmdEnemyFlagAction(StreamRead&);
+	explicit CmdEnemyFlagAction(CommandReader&);
 
 	void execute(Game&) override;
-	void serialize(StreamWrite&) override;
+	void serialize(CommandWriter&) override;
 
 private:
 	Serial serial;
@@ -792,7 +793,7 @@ struct PlayerMessageCommand : public PlayerCommand {
 	void write(FileWrite&, EditorGameBase&, MapObjectSaver&) override;
 	void read(FileRead&, EditorGameBase&, MapObjectLoader&) override;
 
-	explicit PlayerMessageCommand(StreamRead&);
+	explicit PlayerMessageCommand(CommandReader&);
 
 	MessageId message_id() const {
 		return message_id_;
@@ -813,11 +814,11 @@ struct CmdMessageSetStatusRead : public PlayerMessageCommand {
 		return QueueCommandTypes::kMessageSetStatusRead;
 	}
 
-	explicit CmdMessageSetStatusRead(StreamRead& des) : PlayerMessageCommand(des) {
+	explicit CmdMessageSetStatusRead(CommandReader& des) : PlayerMessageCommand(des) {
 	}
 
 	void execute(Game&) override;
-	void serialize(StreamWrite&) override;
+	void serialize(CommandWriter&) override;
 };
 
 struct CmdMessageSetStatusArchived : public PlayerMessageCommand {
@@ -831,11 +832,11 @@ struct CmdMessageSetStatusArchived : public PlayerMessageCommand {
 		return QueueCommandTypes::kMessageSetStatusArchived;
 	}
 
-	explicit CmdMessageSetStatusArchived(StreamRead& des) : PlayerMessageCommand(des) {
+	explicit CmdMessageSetStatusArchived(CommandReader& des) : PlayerMessageCommand(des) {
 	}
 
 	void execute(Game&) override;
-	void serialize(StreamWrite&) override;
+	void serialize(CommandWriter&) override;
 };
 
 /**
@@ -856,8 +857,8 @@ struct CmdSetStockPolicy : PlayerCommand {
 	void execute(Game& game) override;
 
 	// Network (de-)serialization
-	explicit CmdSetStockPolicy(StreamRead& des);
-	void serialize(StreamWrite& ser) override;
+	explicit CmdSetStockPolicy(CommandReader& des);
+	void serialize(CommandWriter& ser) override;
 
 	// Savegame functions
 	CmdSetStockPolicy();
@@ -881,8 +882,8 @@ struct CmdProposeTrade : PlayerCommand {
 	void execute(Game& game) override;
 
 	// Network (de-)serialization
-	explicit CmdProposeTrade(StreamRead& des);
-	void serialize(StreamWrite& ser) override;
+	explicit CmdProposeTrade(CommandReader& des);
+	void serialize(CommandWriter& ser) override;
 
 	// Savegame functions
 	CmdProposeTrade();
@@ -904,8 +905,8 @@ struct CmdToggleMuteMessages : PlayerCommand {
 
 	void execute(Game& game) override;
 
-	explicit CmdToggleMuteMessages(StreamRead& des);
-	void serialize(StreamWrite& ser) override;
+	explicit CmdToggleMuteMessages(CommandReader& des);
+	void serialize(CommandWriter& ser) override;
 
 	CmdToggleMuteMessages() : PlayerCommand(), building_(kInvalidSerial), all_(false) {
 	}
@@ -928,8 +929,8 @@ struct CmdMarkMapObjectForRemoval : PlayerCommand {
 
 	void execute(Game& game) override;
 
-	explicit CmdMarkMapObjectForRemoval(StreamRead& des);
-	void serialize(StreamWrite& ser) override;
+	explicit CmdMarkMapObjectForRemoval(CommandReader& des);
+	void serialize(CommandWriter& ser) override;
 
 	CmdMarkMapObjectForRemoval() : PlayerCommand(), object_(kInvalidSerial), mark_(false) {
 	}
@@ -952,8 +953,8 @@ struct CmdPickCustomStartingPosition : PlayerCommand {
 
 	void execute(Game& game) override;
 
-	explicit CmdPickCustomStartingPosition(StreamRead& des);
-	void serialize(StreamWrite& ser) override;
+	explicit CmdPickCustomStartingPosition(CommandReader& des);
+	void serialize(CommandWriter& ser) override;
 
 	CmdPickCustomStartingPosition() : PlayerCommand() {
 	}
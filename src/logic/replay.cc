@@ -19,14 +19,16 @@
 
 #include "logic/replay.h"
 
+#include <memory>
+
 #include "base/log.h"
-#include "base/md5.h"
 #include "base/random.h"
 #include "base/wexception.h"
 #include "game_io/game_loader.h"
 #include "game_io/game_preload_packet.h"
+#include "io/fileread.h"
 #include "io/filesystem/layered_filesystem.h"
-#include "io/streamread.h"
+#include "io/filewrite.h"
 #include "io/streamwrite.h"
 #include "logic/filesystem_constants.h"
 #include "logic/game.h"
@@ -34,20 +36,26 @@
 #include "logic/game_data_error.h"
 #include "logic/playercommand.h"
 #include "logic/save_handler.h"
+#include "logic/sync_digest.h"
 
 namespace Widelands {
 
 // File format definitions
 constexpr uint32_t kReplayKnownToDesync = 0x2E21A100;
 constexpr uint32_t kReplayMagic = 0x2E21A101;
-constexpr uint8_t kCurrentPacketVersion = 3;
+constexpr uint8_t kCurrentPacketVersion = 6;
+// The last version that was part of a release. It has no keyframes, stores player commands
+// with fixed width fields and uses MD5 checksums, so we can't check it for desyncs.
+constexpr uint8_t kReleasedPacketVersion = 3;
+constexpr size_t kMd5ChecksumSize = 16;
 constexpr Duration kSyncInterval = Duration(200);
+constexpr uint16_t kCurrentKeyframeIndexPacketVersion = 1;
 
-enum { pkt_end = 2, pkt_playercommand = 3, pkt_syncreport = 4 };
+enum { pkt_end = 2, pkt_playercommand = 3, pkt_syncreport = 4, pkt_keyframe = 5 };
 
 class CmdReplaySyncRead : public Command {
 public:
-	CmdReplaySyncRead(const Time& init_duetime, const Md5Checksum& hash)
+	CmdReplaySyncRead(const Time& init_duetime, const SyncDigest& hash)
 	   : Command(init_duetime), hash_(hash) {
 	}
 
@@ -56,14 +64,16 @@ public:
 	}
 
 	void execute(Game& game) override {
-		const Md5Checksum myhash = game.get_sync_hash();
+		const SyncDigest myhash = game.get_sync_digest();
 
 		if (hash_ != myhash) {
 			log_err_time(game.get_gametime(),
 			             "REPLAY: Lost synchronization at time %u\n"
 			             "I have:     %s\n"
-			             "Replay has: %s\n",
-			             duetime().get(), myhash.str().c_str(), hash_.str().c_str());
+			             "Replay has: %s\n"
+			             "Differences in: %s\n",
+			             duetime().get(), myhash.str().c_str(), hash_.str().c_str(),
+			             myhash.describe_difference(hash_).c_str());
 
 			// In case syncstream logging is on, save it for analysis
 			game.save_syncstream(true);
@@ -74,13 +84,98 @@ public:
 	}
 
 private:
-	Md5Checksum hash_;
+	SyncDigest hash_;
 };
 
+ReplayKeyframeIndex::ReplayKeyframeIndex(const std::string& replay_filename)
+   : replay_filename_(replay_filename) {
+	read();
+}
+
+void ReplayKeyframeIndex::read() {
+	FileRead fr;
+	if (!fr.try_open(*g_fs, replay_filename_ + kReplayKeyframeIndexExtension)) {
+		return;
+	}
+
+	try {
+		const uint16_t packet_version = fr.unsigned_16();
+		if (packet_version != kCurrentKeyframeIndexPacketVersion) {
+			throw UnhandledVersionError(
+			   "ReplayKeyframeIndex", packet_version, kCurrentKeyframeIndexPacketVersion);
+		}
+		for (uint32_t i = fr.unsigned_32(); i; --i) {
+			Keyframe keyframe;
+			keyframe.number = fr.unsigned_32();
+			keyframe.gametime = Time(fr.unsigned_32());
+			keyframe.offset = fr.unsigned_32();
+			keyframes_.push_back(keyframe);
+		}
+	} catch (const std::exception& e) {
+		// The replay can still be watched, we just can't seek quickly
+		log_warn("Discarding keyframes of %s: %s\n", replay_filename_.c_str(), e.what());
+		keyframes_.clear();
+	}
+}
+
+void ReplayKeyframeIndex::write() {
+	FileWrite fw;
+	fw.unsigned_16(kCurrentKeyframeIndexPacketVersion);
+	fw.unsigned_32(keyframes_.size());
+	for (const Keyframe& keyframe : keyframes_) {
+		fw.unsigned_32(keyframe.number);
+		fw.unsigned_32(keyframe.gametime.get());
+		fw.unsigned_32(keyframe.offset);
+	}
+	fw.write(*g_fs, replay_filename_ + kReplayKeyframeIndexExtension);
+}
+
+void ReplayKeyframeIndex::add(const Keyframe& keyframe) {
+	assert(keyframes_.empty() || keyframes_.back().gametime < keyframe.gametime);
+	keyframes_.push_back(keyframe);
+	write();
+}
+
+const ReplayKeyframeIndex::Keyframe* ReplayKeyframeIndex::find(const Time& time) const {
+	const Keyframe* result = nullptr;
+	for (const Keyframe& keyframe : keyframes_) {
+		if (keyframe.gametime > time) {
+			break;
+		}
+		if (g_fs->file_exists(savegame_filename(keyframe.number))) {
+			result = &keyframe;
+		}
+	}
+	return result;
+}
+
+std::string ReplayKeyframeIndex::savegame_filename(uint32_t number) const {
+	return replay_filename_ + kReplayKeyframeInfix + std::to_string(number) + kSavegameExtension;
+}
+
+// static
+void ReplayKeyframeIndex::remove(const std::string& replay_filename) {
+	const ReplayKeyframeIndex index(replay_filename);
+	for (const Keyframe& keyframe : index.keyframes_) {
+		const std::string savegame = index.savegame_filename(keyframe.number);
+		if (g_fs->file_exists(savegame)) {
+			g_fs->fs_unlink(savegame);
+		}
+	}
+	if (g_fs->file_exists(replay_filename + kReplayKeyframeIndexExtension)) {
+		g_fs->fs_unlink(replay_filename + kReplayKeyframeIndexExtension);
+	}
+}
+
 /**
  * Load the savegame part of the given replay and open the command log.
  */
-ReplayReader::ReplayReader(Game& game, const std::string& filename) {
+ReplayReader::ReplayReader(Game& game, const std::string& filename)
+   : game_(game),
+     filename_(filename),
+     cmdlog_(nullptr),
+     packet_version_(kCurrentPacketVersion),
+     keyframes_(filename) {
 	replaytime_ = Time(0);
 
 	{
@@ -91,36 +186,105 @@ ReplayReader::ReplayReader(Game& game, const std::string& filename) {
 		gl.load_game();
 	}
 
-	cmdlog_ = g_fs->open_stream_read(filename);
+	open_cmdlog();
+}
+
+/**
+ * Cleanup after replays
+ */
+ReplayReader::~ReplayReader() {
+	close_cmdlog();
+}
+
+/**
+ * Open the command log and read its header, which also sets the random number
+ * generator to its state at the start of the replay.
+ */
+void ReplayReader::open_cmdlog() {
+	close_cmdlog();
+	cmdlog_ = new FileRead();
 
 	try {
+		cmdlog_->open(*g_fs, filename_);
+
 		const uint32_t magic = cmdlog_->unsigned_32();
 		if (magic == kReplayKnownToDesync) {
 			// Note: This was never released as part of a build
 			throw wexception("%s is a replay from a version that is known to have desync "
 			                 "problems",
-			                 filename.c_str());
+			                 filename_.c_str());
 		}
 		if (magic != kReplayMagic) {
-			throw wexception("%s apparently not a valid replay file", filename.c_str());
+			throw wexception("%s apparently not a valid replay file", filename_.c_str());
 		}
 
-		const uint8_t packet_version = cmdlog_->unsigned_8();
-		if (packet_version != kCurrentPacketVersion) {
-			throw UnhandledVersionError("ReplayReader", packet_version, kCurrentPacketVersion);
+		packet_version_ = cmdlog_->unsigned_8();
+		if (packet_version_ != kReleasedPacketVersion &&
+		    packet_version_ != kCurrentPacketVersion) {
+			throw UnhandledVersionError("ReplayReader", packet_version_, kCurrentPacketVersion);
 		}
-		game.rng().read_state(*cmdlog_);
+		game_.rng().read_state(*cmdlog_);
+		commands_ = CommandStream();
 	} catch (...) {
-		delete cmdlog_;
+		close_cmdlog();
 		throw;
 	}
 }
 
+void ReplayReader::close_cmdlog() {
+	delete cmdlog_;
+	cmdlog_ = nullptr;
+}
+
 /**
- * Cleanup after replays
+ * Read a keyframe packet. If 'restore' is set, the random number generator
+ * and the synchronization hash are set to their state at the keyframe.
  */
-ReplayReader::~ReplayReader() {
-	delete cmdlog_;
+void ReplayReader::read_keyframe(bool restore) {
+	replaytime_ = Time(cmdlog_->unsigned_32());
+	RNG rng;
+	rng.read_state(*cmdlog_);
+	SyncHasher sync_state;
+	sync_state.read_state(*cmdlog_);
+
+	if (restore) {
+		game_.rng() = rng;
+		game_.set_sync_state(sync_state);
+	}
+}
+
+/**
+ * Restore the game from the last keyframe that is not after the given time,
+ * or from the replay's initial savegame if there is no such keyframe.
+ * The caller is responsible for fast-forwarding the game to the desired time.
+ *
+ * \return the gametime that the game has been restored to
+ */
+Time ReplayReader::seek(const Time& time) {
+	const ReplayKeyframeIndex::Keyframe* keyframe = keyframes_.find(time);
+	if (keyframe == nullptr) {
+		game_.restore_savegame(filename_ + kSavegameExtension);
+		open_cmdlog();
+		replaytime_ = game_.get_gametime();
+		return replaytime_;
+	}
+
+	game_.restore_savegame(keyframes_.savegame_filename(keyframe->number));
+	if (cmdlog_ == nullptr) {
+		open_cmdlog();
+	}
+	try {
+		cmdlog_->set_file_pos(keyframe->offset);
+		if (cmdlog_->unsigned_8() != pkt_keyframe) {
+			throw wexception("no keyframe packet at offset %u", keyframe->offset);
+		}
+		read_keyframe(true);
+	} catch (const WException& e) {
+		log_err_time(game_.get_gametime(), "REPLAY: Unable to seek to keyframe %u: %s\n",
+		             keyframe->number, e.what());
+		close_cmdlog();
+	}
+	return game_.get_gametime();
 }
 
 /**
@@ -144,11 +308,16 @@ Command* ReplayReader::get_next_command(const Time& time) {
 
 		switch (pkt) {
 		case pkt_playercommand: {
-			replaytime_ = Time(cmdlog_->unsigned_32());
-
-			Time duetime(cmdlog_->unsigned_32());
-			uint32_t cmdserial = cmdlog_->unsigned_32();
-			PlayerCommand& cmd = *PlayerCommand::deserialize(*cmdlog_);
+			CommandReader legacy_reader(*cmdlog_);
+			CommandReader compact_reader(*cmdlog_, commands_);
+			CommandReader& reader = packet_version_ == kReleasedPacketVersion ?
+			                           legacy_reader :
+			                           compact_reader;
+			replaytime_ = reader.time();
+
+			Time duetime = reader.time();
+			uint32_t cmdserial = reader.unsigned_32();
+			PlayerCommand& cmd = *PlayerCommand::deserialize(reader);
 			cmd.set_duetime(duetime);
 			cmd.set_cmdserial(cmdserial);
 
@@ -157,17 +326,26 @@ Command* ReplayReader::get_next_command(const Time& time) {
 
 		case pkt_syncreport: {
 			Time duetime(cmdlog_->unsigned_32());
-			Md5Checksum hash;
-			cmdlog_->data(hash.data, sizeof(hash.data));
+			if (packet_version_ == kReleasedPacketVersion) {
+				cmdlog_->data(kMd5ChecksumSize);
+				return get_next_command(time);
+			}
+			SyncDigest hash;
+			hash.read(*cmdlog_);
 
 			return new CmdReplaySyncRead(duetime, hash);
 		}
 
+		case pkt_keyframe: {
+			// We only need the keyframes' contents when seeking
+			read_keyframe(false);
+			return get_next_command(time);
+		}
+
 		case pkt_end: {
 			Time endtime(cmdlog_->unsigned_32());
 			log_err_time(time, "REPLAY: End of replay (gametime: %u)\n", endtime.get());
-			delete cmdlog_;
-			cmdlog_ = nullptr;
+			close_cmdlog();
 			return nullptr;
 		}
 
@@ -176,8 +354,7 @@ Command* ReplayReader::get_next_command(const Time& time) {
 		}
 	} catch (const WException& e) {
 		log_err_time(time, "REPLAY: Caught exception %s\n", e.what());
-		delete cmdlog_;
-		cmdlog_ = nullptr;
+		close_cmdlog();
 	}
 
 	return nullptr;
@@ -205,13 +382,41 @@ public:
 
 	void execute(Game& game) override {
 		if (ReplayWriter* const rw = game.get_replaywriter()) {
-			rw->send_sync(game.get_sync_hash());
+			rw->send_sync(game.get_sync_digest());
 
 			game.enqueue_command(new CmdReplaySyncWrite(duetime() + kSyncInterval));
 		}
 	}
 };
 
+/**
+ * Forwards everything to the command log file and keeps track of its size,
+ * so that we know the offsets of the keyframes.
+ */
+class ReplayWriter::CommandLog : public StreamWrite {
+public:
+	explicit CommandLog(const std::string& filename)
+	   : file_(g_fs->open_stream_write(filename)), size_(0) {
+	}
+
+	void data(const void* const write_data, const size_t size) override {
+		file_->data(write_data, size);
+		size_ += size;
+	}
+
+	void flush() override {
+		file_->flush();
+	}
+
+	uint32_t size() const {
+		return size_;
+	}
+
+private:
+	std::unique_ptr<StreamWrite> file_;
+	uint32_t size_;
+};
+
 /**
  * Start a replay at the given filename (the caller must add the suffix).
  *
@@ -220,27 +425,27 @@ public:
  * and the game has changed into running state.
  */
 ReplayWriter::ReplayWriter(Game& game, const std::string& filename)
-   : game_(game), filename_(filename) {
+   : game_(game), cmdlog_(nullptr), filename_(filename), keyframes_(filename) {
 	g_fs->ensure_directory_exists(kReplayDir);
 
 	SaveHandler& save_handler = game_.save_handler();
 
 	std::string error;
-	if (!save_handler.save_game(game_, filename_ + kSavegameExtension, &error)) {
+	if (!save_handler.save_game(game_, savegame_filename(), &error)) {
 		throw wexception("Failed to save game for replay: %s", error.c_str());
 	}
 
 	log_info("Reloading the game from replay\n");
 	game.cleanup_for_load();
 	{
-		GameLoader gl(filename_ + kSavegameExtension, game);
+		GameLoader gl(savegame_filename(), game);
 		gl.load_game();
 	}
 	log_info("Done reloading the game from replay\n");
 
 	game.enqueue_command(new CmdReplaySyncWrite(game.get_gametime() + kSyncInterval));
 
-	cmdlog_ = g_fs->open_stream_write(filename);
+	cmdlog_ = new CommandLog(filename);
 	cmdlog_->unsigned_32(kReplayMagic);
 	cmdlog_->unsigned_8(kCurrentPacketVersion);
 
@@ -262,13 +467,14 @@ ReplayWriter::~ReplayWriter() {
  */
 void ReplayWriter::send_player_command(PlayerCommand* cmd) {
 	cmdlog_->unsigned_8(pkt_playercommand);
+	CommandWriter writer(*cmdlog_, commands_);
 	// The semantics of the timestamp is
 	// "There will be no more player commands that are due *before* the
 	// given time".
-	cmdlog_->unsigned_32(game_.get_gametime().get());
-	cmdlog_->unsigned_32(cmd->duetime().get());
-	cmdlog_->unsigned_32(cmd->cmdserial());
-	cmd->serialize(*cmdlog_);
+	writer.time(game_.get_gametime());
+	writer.time(cmd->duetime());
+	writer.unsigned_32(cmd->cmdserial());
+	cmd->serialize(writer);
 
 	cmdlog_->flush();
 }
@@ -276,10 +482,43 @@ void ReplayWriter::send_player_command(PlayerCommand* cmd) {
 /**
  * Store a synchronization hash for the current game time in the replay.
  */
-void ReplayWriter::send_sync(const Md5Checksum& hash) {
+void ReplayWriter::send_sync(const SyncDigest& hash) {
 	cmdlog_->unsigned_8(pkt_syncreport);
 	cmdlog_->unsigned_32(game_.get_gametime().get());
-	cmdlog_->data(hash.data, sizeof(hash.data));
+	hash.write(*cmdlog_);
+	cmdlog_->flush();
+}
+
+std::string ReplayWriter::savegame_filename() const {
+	return filename_ + kSavegameExtension;
+}
+
+std::string ReplayWriter::next_keyframe_filename() const {
+	return keyframes_.savegame_filename(keyframes_.size() + 1);
+}
+
+/**
+ * Store the state that isn't part of savegames in the command log, so that
+ * readers can restore it when they seek to this keyframe.
+ */
+void ReplayWriter::write_keyframe() {
+	ReplayKeyframeIndex::Keyframe keyframe;
+	keyframe.number = keyframes_.size() + 1;
+	keyframe.gametime = game_.get_gametime();
+	keyframe.offset = cmdlog_->size();
+
+	cmdlog_->unsigned_8(pkt_keyframe);
+	cmdlog_->unsigned_32(keyframe.gametime.get());
+	game_.rng().write_state(*cmdlog_);
+	game_.get_sync_state().write_state(*cmdlog_);
 	cmdlog_->flush();
+	// Readers that seek to this keyframe don't know the commands before it
+	commands_.reset();
+
+	try {
+		keyframes_.add(keyframe);
+	} catch (const std::exception& e) {
+		log_warn_time(keyframe.gametime, "Failed to write keyframe index for replay: %s\n", e.what());
+	}
 }
 }  // namespace Widelands
@@ -25,22 +25,64 @@
  * Also useful as a debugging aid.
  *
  * A game replay consists of a savegame plus a log-file of subsequent
- * playercommands.
+ * playercommands. Additional savegames ("keyframes") are taken at regular
+ * intervals while recording, so that we can seek in the replay without having
+ * to simulate the whole game up to that point.
  */
 
 #include <string>
+#include <vector>
 
 #include "base/times.h"
+#include "logic/command_stream.h"
 
-struct Md5Checksum;
-
-class StreamRead;
+class FileRead;
 class StreamWrite;
 
 namespace Widelands {
 struct Command;
 class Game;
 class PlayerCommand;
+class SyncDigest;
+
+/**
+ * The keyframes of a replay, stored next to the replay's command log.
+ * Each keyframe is a savegame plus the offset of the matching keyframe packet
+ * in the command log.
+ */
+class ReplayKeyframeIndex {
+public:
+	struct Keyframe {
+		uint32_t number;
+		Time gametime;
+		uint32_t offset;
+	};
+
+	explicit ReplayKeyframeIndex(const std::string& replay_filename);
+
+	/// Add a keyframe and write the index to disk
+	void add(const Keyframe& keyframe);
+
+	size_t size() const {
+		return keyframes_.size();
+	}
+
+	/// \return the last keyframe that is not after 'time', or nullptr if there is none
+	const Keyframe* find(const Time& time) const;
+
+	/// \return the filename of the savegame for the given keyframe
+	std::string savegame_filename(uint32_t number) const;
+
+	/// Delete the index and the savegames of all keyframes of the given replay
+	static void remove(const std::string& replay_filename);
+
+private:
+	void read();
+	void write();
+
+	const std::string replay_filename_;
+	std::vector<Keyframe> keyframes_;
+};
 
 /**
  * Read game replays from disk.
@@ -53,8 +95,19 @@ public:
 	Command* get_next_command(const Time& time);
 	bool end_of_replay();
 
+	Time seek(const Time& time);
+
 private:
-	StreamRead* cmdlog_;
+	void open_cmdlog();
+	void close_cmdlog();
+	void read_keyframe(bool restore);
+
+	Game& game_;
+	const std::string filename_;
+	FileRead* cmdlog_;
+	uint8_t packet_version_;
+	CommandStream commands_;
+	ReplayKeyframeIndex keyframes_;
 
 	Time replaytime_;
 };
@@ -68,12 +121,23 @@ public:
 	~ReplayWriter();
 
 	void send_player_command(PlayerCommand*);
-	void send_sync(const Md5Checksum&);
+	void send_sync(const SyncDigest&);
+
+	/// \return the savegame that the replay starts from
+	std::string savegame_filename() const;
+	/// \return the filename that the game should save the next keyframe to
+	std::string next_keyframe_filename() const;
+	/// Record that the game has just been saved to the next keyframe
+	void write_keyframe();
 
 private:
+	class CommandLog;
+
 	Game& game_;
-	StreamWrite* cmdlog_;
+	CommandLog* cmdlog_;
+	CommandStream commands_;
 	std::string filename_;
+	ReplayKeyframeIndex keyframes_;
 };
 }  // namespace Widelands
 
@@ -19,6 +19,8 @@
 
 #include "logic/replay_game_controller.h"
 
+#include <algorithm>
+
 #include <SDL_timer.h>
 
 #include "logic/game.h"
@@ -26,12 +28,19 @@
 #include "ui_basic/messagebox.h"
 #include "wui/interactive_base.h"
 
+namespace {
+// How much gametime to simulate per frame while fast-forwarding after seeking
+constexpr Duration kFastForwardStep = Duration(10 * 1000);
+}  // namespace
+
 ReplayGameController::ReplayGameController(Widelands::Game& game, const std::string& filename)
    : game_(game),
      lastframe_(SDL_GetTicks()),
      time_(game_.get_gametime()),
      speed_(1000),
-     paused_(false) {
+     paused_(false),
+     end_reached_(false),
+     seek_target_(0) {
 	game_.set_game_controller(this);
 	replayreader_.reset(new Widelands::ReplayReader(game_, filename));
 }
@@ -50,15 +59,20 @@ void ReplayGameController::think() {
 
 	frametime = frametime * real_speed() / 1000;
 
-	time_ = game_.get_gametime() + Duration(frametime);
+	if (seek_target_ > game_.get_gametime()) {
+		time_ = std::min(seek_target_, game_.get_gametime() + kFastForwardStep);
+	} else {
+		time_ = game_.get_gametime() + Duration(frametime);
+	}
 
-	if (replayreader_) {
+	if (!end_reached_) {
 		while (Widelands::Command* const cmd = replayreader_->get_next_command(time_)) {
 			game_.enqueue_command(cmd);
 		}
 
 		if (replayreader_->end_of_replay()) {
-			replayreader_.reset(nullptr);
+			end_reached_ = true;
+			seek_target_ = Time(0);
 			game_.enqueue_command(new CmdReplayEnd(time_ = game_.get_gametime()));
 		}
 	}
@@ -96,6 +110,16 @@ void ReplayGameController::set_paused(bool const paused) {
 	paused_ = paused;
 }
 
+/**
+ * Restore the nearest keyframe before the given time and fast-forward from there.
+ */
+void ReplayGameController::seek(const Time& time) {
+	time_ = replayreader_->seek(time);
+	end_reached_ = false;
+	seek_target_ = time;
+	lastframe_ = SDL_GetTicks();
+}
+
 void ReplayGameController::CmdReplayEnd::execute(Widelands::Game& game) {
 	game.game_controller()->set_desired_speed(0);
 	UI::WLMessageBox mmb(game.get_ibase(), _("End of Replay"),
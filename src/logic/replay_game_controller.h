@@ -43,6 +43,7 @@ public:
 	void set_desired_speed(uint32_t const speed) override;
 	bool is_paused() override;
 	void set_paused(bool const paused) override;
+	void seek(const Time& time) override;
 
 private:
 	struct CmdReplayEnd : public Widelands::Command {
@@ -58,6 +59,9 @@ private:
 	Time time_;
 	uint32_t speed_;
 	bool paused_;
+	bool end_reached_;
+	// The gametime that we are fast-forwarding to after seeking
+	Time seek_target_;
 };
 
 #endif  // end of include guard: WL_LOGIC_REPLAY_GAME_CONTROLLER_H
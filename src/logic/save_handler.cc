@@ -27,6 +27,7 @@
 #include "base/time_string.h"
 #include "base/wexception.h"
 #include "game_io/game_saver.h"
+#include "game_io/savegame_index.h"
 #include "io/filesystem/filesystem.h"
 #include "io/filesystem/filesystem_exceptions.h"
 #include "logic/filesystem_constants.h"
@@ -127,7 +128,9 @@ bool SaveHandler::check_next_tick(Widelands::Game& game, uint32_t realtime) {
 	              "Autosave: %d ms interval elapsed, current gametime: %s, saving...\n",
 	              autosave_interval_in_ms_, gametimestring(game.get_gametime().get(), true).c_str());
 
-	game.get_ibase()->log_message(_("Saving game…"));
+	if (game.get_ibase() != nullptr) {
+		game.get_ibase()->log_message(_("Saving game…"));
+	}
 
 	return true;
 }
@@ -173,7 +176,9 @@ void SaveHandler::think(Widelands::Game& game) {
 		}
 		if (!save_success) {
 			log_err_time(game.get_gametime(), "Autosave: ERROR! - %s\n", error.c_str());
-			game.get_ibase()->log_message(_("Saving failed!"));
+			if (game.get_ibase() != nullptr) {
+				game.get_ibase()->log_message(_("Saving failed!"));
+			}
 
 			// Wait 30 seconds until next save try
 			next_save_realtime_ = SDL_GetTicks() + 30000;
@@ -186,7 +191,9 @@ void SaveHandler::think(Widelands::Game& game) {
 		next_save_realtime_ = SDL_GetTicks() + autosave_interval_in_ms_;
 
 		log_info_time(game.get_gametime(), "Autosave: save took %d ms\n", SDL_GetTicks() - realtime);
-		game.get_ibase()->log_message(_("Game saved"));
+		if (game.get_ibase() != nullptr) {
+			game.get_ibase()->log_message(_("Game saved"));
+		}
 	} else {
 		saving_next_tick_ = check_next_tick(game, realtime);
 	}
@@ -258,6 +265,7 @@ bool SaveHandler::save_game(Widelands::Game& game,
 	// but save was successfull otherwise
 	if (gsh.error() == GenericSaveHandler::Error::kSuccess ||
 	    gsh.error() == GenericSaveHandler::Error::kDeletingBackupFailed) {
+		Widelands::SavegameIndex::invalidate(complete_filename);
 		return true;
 	}
 
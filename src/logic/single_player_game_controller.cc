@@ -66,6 +66,7 @@ void SinglePlayerGameController::think() {
 
 	if (use_ai_ && game_.is_loaded()) {
 		const Widelands::PlayerNumber nr_players = game_.map().get_nrplayers();
+		std::vector<AI::ComputerPlayer*> thinking;
 		iterate_players_existing(p, nr_players, game_, plr) if (p != local_) {
 
 			if (p > computerplayers_.size()) {
@@ -75,8 +76,9 @@ void SinglePlayerGameController::think() {
 				computerplayers_[p - 1] =
 				   AI::ComputerPlayer::get_implementation(plr->get_ai())->instantiate(game_, p);
 			}
-			computerplayers_[p - 1]->think();
+			thinking.push_back(computerplayers_[p - 1]);
 		}
+		AI::ComputerPlayer::think_all(game_, thinking);
 	}
 }
 
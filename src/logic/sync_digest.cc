@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2020 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "logic/sync_digest.h"
+
+#include <boost/format.hpp>
+
+#include "io/streamread.h"
+
+namespace Widelands {
+
+namespace {
+
+const char* const kCategoryNames[SyncDigest::kNumCategories] = {
+   "command queue", "player commands", "random numbers", "bobs", "immovables", "economies"};
+
+void write_64(const uint64_t value, StreamWrite& sw) {
+	sw.unsigned_32(value >> 32);
+	sw.unsigned_32(value & 0xffffffff);
+}
+
+uint64_t read_64(StreamRead& sr) {
+	const uint64_t high = sr.unsigned_32();
+	return (high << 32) | sr.unsigned_32();
+}
+
+// Combines a range of checksums into a single one
+uint64_t combine(const uint64_t* begin, const uint64_t* end) {
+	FastHash hash;
+	for (const uint64_t* it = begin; it != end; ++it) {
+		// Hash the bytes in a fixed order, so that the result does not depend on the machine
+		uint8_t bytes[8];
+		for (size_t i = 0; i < 8; ++i) {
+			bytes[i] = (*it >> (8 * i)) & 0xff;
+		}
+		hash.data(bytes, sizeof(bytes));
+	}
+	return hash.value();
+}
+
+}  // namespace
+
+constexpr size_t SyncDigest::kNumCategories;
+constexpr size_t SyncDigest::kNumLeaves;
+
+SyncDigest::SyncDigest() {
+	leaves_.fill(0);
+}
+
+uint64_t SyncDigest::category(const SyncCategory c) const {
+	if (c == SyncCategory::kEconomy) {
+		const uint64_t* economies = leaves_.data() + static_cast<size_t>(SyncCategory::kEconomy);
+		return combine(economies, economies + kMaxPlayers);
+	}
+	return leaves_[static_cast<size_t>(c)];
+}
+
+uint64_t SyncDigest::root() const {
+	uint64_t categories[kNumCategories];
+	for (size_t i = 0; i < kNumCategories; ++i) {
+		categories[i] = category(static_cast<SyncCategory>(i));
+	}
+	return combine(categories, categories + kNumCategories);
+}
+
+std::string SyncDigest::str() const {
+	return (boost::format("%016x") % root()).str();
+}
+
+std::string SyncDigest::describe_difference(const SyncDigest& other) const {
+	std::string result;
+	for (size_t i = 0; i < kNumCategories; ++i) {
+		const SyncCategory c = static_cast<SyncCategory>(i);
+		if (category(c) == other.category(c)) {
+			continue;
+		}
+		if (!result.empty()) {
+			result += ", ";
+		}
+		result += kCategoryNames[i];
+		if (c == SyncCategory::kEconomy) {
+			std::string players;
+			for (PlayerNumber p = 1; p <= kMaxPlayers; ++p) {
+				const size_t index = leaf(SyncCategory::kEconomy, p);
+				if (leaves_[index] != other.leaves_[index]) {
+					if (!players.empty()) {
+						players += " ";
+					}
+					players += std::to_string(static_cast<unsigned>(p));
+				}
+			}
+			result += " (players " + players + ")";
+		}
+	}
+	return result;
+}
+
+void SyncDigest::read(StreamRead& sr) {
+	for (uint64_t& value : leaves_) {
+		value = read_64(sr);
+	}
+}
+
+void SyncDigest::write(StreamWrite& sw) const {
+	for (const uint64_t value : leaves_) {
+		write_64(value, sw);
+	}
+}
+
+SyncHasher::SyncHasher() : current_leaf_(0) {
+}
+
+void SyncHasher::reset() {
+	for (FastHash& hash : hashes_) {
+		hash.reset();
+	}
+	current_leaf_ = 0;
+}
+
+void SyncHasher::data(const void* const data, const size_t size) {
+	hashes_[current_leaf_].data(data, size);
+}
+
+SyncDigest SyncHasher::digest() const {
+	SyncDigest result;
+	for (size_t i = 0; i < SyncDigest::kNumLeaves; ++i) {
+		result.leaves_[i] = hashes_[i].value();
+	}
+	return result;
+}
+
+void SyncHasher::read_state(StreamRead& sr) {
+	for (FastHash& hash : hashes_) {
+		hash.read_state(sr);
+	}
+}
+
+void SyncHasher::write_state(StreamWrite& sw) const {
+	for (const FastHash& hash : hashes_) {
+		hash.write_state(sw);
+	}
+}
+
+}  // namespace Widelands
@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2020 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#ifndef WL_LOGIC_SYNC_DIGEST_H
+#define WL_LOGIC_SYNC_DIGEST_H
+
+#include <array>
+#include <cassert>
+#include <string>
+
+#include "base/fast_hash.h"
+#include "graphic/playercolor.h"
+#include "io/streamwrite.h"
+#include "logic/widelands.h"
+
+class StreamRead;
+
+namespace Widelands {
+
+/// The parts of the simulation whose contributions to the syncstream are hashed
+/// separately, so that a desync can be tracked down to the part that diverged.
+enum class SyncCategory : uint8_t {
+	kCommandQueue,    // Commands that were not sent by a player, wares and other objects
+	kPlayerCommands,  // Commands sent by players, including the AI
+	kRandom,          // The random number generator
+	kBobs,            // Workers, critters, ships and battles
+	kImmovables,      // Immovables, flags, roads and buildings
+	kEconomy          // Requests and supplies, with one checksum per player
+};
+
+/**
+ * A tree of checksums of the syncstream. The root combines one checksum per
+ * \ref SyncCategory, and the checksum of the economies combines one checksum
+ * per player.
+ */
+class SyncDigest {
+public:
+	static constexpr size_t kNumCategories = static_cast<size_t>(SyncCategory::kEconomy) + 1;
+	static constexpr size_t kNumLeaves = kNumCategories - 1 + kMaxPlayers;
+
+	SyncDigest();
+
+	/// \return the index of the leaf that the given category and player are hashed into.
+	/// The player is only used for \ref SyncCategory::kEconomy.
+	static size_t leaf(SyncCategory category, PlayerNumber player) {
+		if (category == SyncCategory::kEconomy) {
+			assert(0 < player && player <= kMaxPlayers);
+			return static_cast<size_t>(SyncCategory::kEconomy) + player - 1;
+		}
+		return static_cast<size_t>(category);
+	}
+
+	uint64_t root() const;
+	uint64_t category(SyncCategory) const;
+
+	bool operator==(const SyncDigest& other) const {
+		return leaves_ == other.leaves_;
+	}
+	bool operator!=(const SyncDigest& other) const {
+		return !(*this == other);
+	}
+
+	/// \return the root checksum as a hex string
+	std::string str() const;
+
+	/// \return the parts of the simulation in which this digest differs from 'other'
+	std::string describe_difference(const SyncDigest& other) const;
+
+	void read(StreamRead&);
+	void write(StreamWrite&) const;
+
+private:
+	friend class SyncHasher;
+
+	std::array<uint64_t, kNumLeaves> leaves_;
+};
+
+/**
+ * Consumes the syncstream and computes its \ref SyncDigest. The data is hashed
+ * into the leaf that has been selected last.
+ */
+class SyncHasher : public StreamWrite {
+public:
+	SyncHasher();
+
+	/// Reset all checksums to their initial state.
+	void reset();
+
+	void select(SyncCategory category, PlayerNumber player) {
+		current_leaf_ = SyncDigest::leaf(category, player);
+	}
+	size_t current_leaf() const {
+		return current_leaf_;
+	}
+
+	void data(const void* data, size_t size) override;
+
+	SyncDigest digest() const;
+
+	/// Store and restore the state of the computation, e.g. for replay keyframes.
+	void read_state(StreamRead&);
+	void write_state(StreamWrite&) const;
+	void set_state(const SyncHasher& other) {
+		hashes_ = other.hashes_;
+	}
+
+private:
+	std::array<FastHash, SyncDigest::kNumLeaves> hashes_;
+	size_t current_leaf_;
+};
+
+}  // namespace Widelands
+
+#endif  // end of include guard: WL_LOGIC_SYNC_DIGEST_H
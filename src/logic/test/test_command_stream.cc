@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2020 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include <string>
+
+#include <boost/test/unit_test.hpp>
+
+#include "base/macros.h"
+#include "base/wexception.h"
+#include "logic/command_stream.h"
+
+// BOOST_CHECK_EQUAL generates an old-style cast usage warning, so ignore
+#pragma GCC diagnostic ignored "-Wold-style-cast"
+
+// Triggered by BOOST_AUTO_TEST_CASE
+CLANG_DIAG_OFF("-Wdisabled-macro-expansion")
+CLANG_DIAG_OFF("-Wused-but-marked-unused")
+
+namespace {
+
+class StringWrite : public StreamWrite {
+public:
+	void data(const void* const write_data, const size_t size) override {
+		result.append(static_cast<const char*>(write_data), size);
+	}
+	std::string result;
+};
+
+class StringRead : public StreamRead {
+public:
+	explicit StringRead(const std::string& input) : input_(input), pos_(0) {
+	}
+	size_t data(void* const read_data, const size_t bufsize) override {
+		const size_t size = std::min(bufsize, input_.size() - pos_);
+		memcpy(read_data, input_.data() + pos_, size);
+		pos_ += size;
+		return size;
+	}
+	bool end_of_file() const override {
+		return pos_ == input_.size();
+	}
+
+private:
+	const std::string input_;
+	size_t pos_;
+};
+
+// A typical burst of commands: the same few buildings and places come up again and again
+void write_commands(Widelands::CommandWriter& writer, uint32_t start) {
+	for (uint32_t i = 0; i < 20; ++i) {
+		writer.time(Time(start + 37 * i));
+		writer.unsigned_8(i % 5);
+		writer.serial(100000 + i % 4);
+		writer.coords(Widelands::Coords(120 + i % 3, 80 - i % 2));
+		writer.signed_32(-1);
+		writer.unsigned_32(i);
+	}
+}
+
+void check_commands(Widelands::CommandReader& reader, uint32_t start) {
+	for (uint32_t i = 0; i < 20; ++i) {
+		BOOST_CHECK_EQUAL(reader.time().get(), start + 37 * i);
+		BOOST_CHECK_EQUAL(reader.unsigned_8(), i % 5);
+		BOOST_CHECK_EQUAL(reader.serial(), 100000 + i % 4);
+		const Widelands::Coords coords = reader.coords();
+		BOOST_CHECK_EQUAL(coords.x, 120 + i % 3);
+		BOOST_CHECK_EQUAL(coords.y, 80 - i % 2);
+		BOOST_CHECK_EQUAL(reader.signed_32(), -1);
+		BOOST_CHECK_EQUAL(reader.unsigned_32(), i);
+	}
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(CommandStreamTests)
+
+BOOST_AUTO_TEST_CASE(commands_survive_the_round_trip) {
+	Widelands::CommandStream writer_state;
+	StringWrite out;
+	Widelands::CommandWriter writer(out, writer_state);
+	write_commands(writer, 600000);
+	// Fixed width fields take 4 + 1 + 4 + 4 + 4 + 4 bytes for each of these commands
+	BOOST_TEST_MESSAGE("20 commands take " << out.result.size() << " bytes instead of 420");
+	BOOST_CHECK_LT(out.result.size(), 210u);
+
+	writer.time(Time(700000));
+	writer.unsigned_16(65535);
+	writer.signed_16(-32768);
+	writer.unsigned_32(4294967295u);
+	writer.signed_32(-2147483647 - 1);
+	writer.serial(0);
+	writer.serial(4294967295u);
+	writer.coords(Widelands::Coords(-1, 32767));
+
+	Widelands::CommandStream reader_state;
+	StringRead in(out.result);
+	Widelands::CommandReader reader(in, reader_state);
+	check_commands(reader, 600000);
+	BOOST_CHECK_EQUAL(reader.time().get(), 700000u);
+	BOOST_CHECK_EQUAL(reader.unsigned_16(), 65535);
+	BOOST_CHECK_EQUAL(reader.signed_16(), -32768);
+	BOOST_CHECK_EQUAL(reader.unsigned_32(), 4294967295u);
+	BOOST_CHECK_EQUAL(reader.signed_32(), -2147483647 - 1);
+	BOOST_CHECK_EQUAL(reader.serial(), 0u);
+	BOOST_CHECK_EQUAL(reader.serial(), 4294967295u);
+	const Widelands::Coords coords = reader.coords();
+	BOOST_CHECK_EQUAL(coords.x, -1);
+	BOOST_CHECK_EQUAL(coords.y, 32767);
+	BOOST_CHECK(in.end_of_file());
+}
+
+BOOST_AUTO_TEST_CASE(readers_can_start_after_a_reset) {
+	Widelands::CommandStream writer_state;
+	StringWrite out;
+	Widelands::CommandWriter writer(out, writer_state);
+	write_commands(writer, 1000);
+	const size_t offset = out.result.size();
+	writer_state.reset();
+	write_commands(writer, 2000);
+
+	// Somebody who has seen everything
+	Widelands::CommandStream full_state;
+	StringRead full(out.result);
+	Widelands::CommandReader full_reader(full, full_state);
+	check_commands(full_reader, 1000);
+	check_commands(full_reader, 2000);
+
+	// Somebody who joins at the reset
+	Widelands::CommandStream late_state;
+	StringRead late(out.result.substr(offset));
+	Widelands::CommandReader late_reader(late, late_state);
+	check_commands(late_reader, 2000);
+}
+
+BOOST_AUTO_TEST_CASE(legacy_reader_reads_fixed_width_fields) {
+	StringWrite out;
+	out.unsigned_32(123456);
+	out.unsigned_32(4711);
+	out.unsigned_16(3);
+	out.unsigned_16(4);
+	out.signed_16(-5);
+
+	StringRead in(out.result);
+	Widelands::CommandReader reader(in);
+	BOOST_CHECK_EQUAL(reader.time().get(), 123456u);
+	BOOST_CHECK_EQUAL(reader.serial(), 4711u);
+	const Widelands::Coords coords = reader.coords();
+	BOOST_CHECK_EQUAL(coords.x, 3);
+	BOOST_CHECK_EQUAL(coords.y, 4);
+	BOOST_CHECK_EQUAL(reader.signed_16(), -5);
+}
+
+BOOST_AUTO_TEST_CASE(malformed_streams_are_rejected) {
+	Widelands::CommandStream state;
+	// A recent serial that was never sent
+	StringRead unknown(std::string(1, '\x03'));
+	Widelands::CommandReader unknown_reader(unknown, state);
+	BOOST_CHECK_THROW(unknown_reader.serial(), WException);
+
+	// A value that doesn't fit into 16 bits
+	StringRead too_big(std::string("\xff\xff\x04", 3));
+	Widelands::CommandReader too_big_reader(too_big, state);
+	BOOST_CHECK_THROW(too_big_reader.unsigned_16(), WException);
+
+	// A variable length quantity that never ends
+	StringRead endless(std::string(11, '\x80'));
+	Widelands::CommandReader endless_reader(endless, state);
+	BOOST_CHECK_THROW(endless_reader.unsigned_32(), WException);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
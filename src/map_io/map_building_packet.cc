@@ -89,6 +89,7 @@ void MapBuildingPacket::read(FileSystem& fs,
 							//  Now, create this Building, take extra special care for
 							//  constructionsites. All data is read later.
 							Building* building;
+							egbase.objects().reuse_serial(serial);
 							if (building_type == kTypeConstructionSite) {
 								building = &egbase.warp_constructionsite(c, p, index, true);
 							} else if (building_type == kTypeDismantleSite) {
@@ -113,6 +113,7 @@ void MapFlagPacket::read(FileSystem& fs,
 					//  packet. We always create this, no matter what skip is
 					//  since we have to read the data packets. We delete this
 					//  object later again, if it is not wanted.
+					egbase.objects().reuse_serial(serial);
 					Flag* flag =
 					   new Flag(dynamic_cast<Game&>(egbase), player, fc, ware_economy, worker_economy);
 					mol.register_object<Flag>(serial, *flag);
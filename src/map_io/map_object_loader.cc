@@ -19,8 +19,13 @@
 
 #include "map_io/map_object_loader.h"
 
+#include <algorithm>
+#include <limits>
+#include <set>
+
 #include "base/wexception.h"
 #include "logic/editor_game_base.h"
+#include "logic/map_objects/tribes/worker.h"
 
 namespace Widelands {
 
@@ -72,6 +77,61 @@ void MapObjectLoader::schedule_act(Bob& bob) {
 	schedule_act_.push_back(&bob);
 }
 
+void MapObjectLoader::set_field_position(Bob& bob, uint32_t const position) {
+	field_positions_.push_back(std::make_pair(&bob, position));
+}
+
+void MapObjectLoader::set_location_position(Worker& worker, uint32_t const position) {
+	location_positions_[&worker] = position;
+}
+
+/**
+ * Loading adds the bobs to the lists of their fields and the workers to the
+ * lists of their locations in the order of their serials. But the game logic
+ * picks the first match from these lists, so we have to bring them back into
+ * the order that they had when the game was saved.
+ */
+void MapObjectLoader::restore_list_order(EditorGameBase& egbase) {
+	// Bobs are linked at the head of the list of their field, so we start with the last one
+	std::stable_sort(field_positions_.begin(), field_positions_.end(),
+	                 [](const std::pair<Bob*, uint32_t>& a, const std::pair<Bob*, uint32_t>& b) {
+		                 return a.second > b.second;
+	                 });
+	for (const std::pair<Bob*, uint32_t>& field_position : field_positions_) {
+		field_position.first->unlink_from_field();
+		field_position.first->link_to_field();
+	}
+	field_positions_.clear();
+
+	std::set<PlayerImmovable*> locations;
+	for (const auto& location_position : location_positions_) {
+		if (PlayerImmovable* location = location_position.first->get_location(egbase)) {
+			locations.insert(location);
+		}
+	}
+	const auto position = [this](const Worker* worker) {
+		const auto it = location_positions_.find(worker);
+		return it == location_positions_.end() ? std::numeric_limits<uint32_t>::max() :
+		                                         it->second;
+	};
+	for (PlayerImmovable* location : locations) {
+		std::stable_sort(location->workers_.begin(), location->workers_.end(),
+		                 [&position](const Worker* a, const Worker* b) {
+			                 return position(a) < position(b);
+		                 });
+	}
+	location_positions_.clear();
+}
+
+void MapObjectLoader::set_economy_position(const Request& request, uint32_t const position) {
+	economy_positions_[&request] = position;
+}
+
+uint32_t MapObjectLoader::economy_position(const Request& request) const {
+	const auto it = economy_positions_.find(&request);
+	return it == economy_positions_.end() ? std::numeric_limits<uint32_t>::max() : it->second;
+}
+
 /**
  * Part of compatibility hacks that need to be run after the load has finished.
  *
@@ -26,6 +26,8 @@
 
 namespace Widelands {
 class Bob;
+class Request;
+class Worker;
 
 /*
  * This class helps to
@@ -82,6 +84,18 @@ public:
 	void schedule_destroy(MapObject&);
 	void schedule_act(Bob&);
 
+	/// Remember where the bob was in the list of bobs on its field when the game was saved
+	void set_field_position(Bob&, uint32_t position);
+	/// Remember where the worker was in the list of workers at its location
+	void set_location_position(Worker&, uint32_t position);
+	void restore_list_order(EditorGameBase&);
+
+	/// Remember where the request was in the list of requests of its economy
+	void set_economy_position(const Request&, uint32_t position);
+	/// \return where the request was in the list of requests of its economy, or the largest
+	/// possible value if we don't know it
+	uint32_t economy_position(const Request&) const;
+
 	void load_finish_game(Game& g);
 
 private:
@@ -92,6 +106,10 @@ private:
 
 	std::vector<MapObject*> schedule_destroy_;
 	std::vector<Bob*> schedule_act_;
+
+	std::vector<std::pair<Bob*, uint32_t>> field_positions_;
+	std::map<const Worker*, uint32_t> location_positions_;
+	std::map<const Request*, uint32_t> economy_positions_;
 };
 }  // namespace Widelands
 
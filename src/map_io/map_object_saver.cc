@@ -41,8 +41,7 @@ MapObjectSaver::MapObjectSaver()
      nr_battles_(0),
      nr_ship_fleets_(0),
      nr_ferry_fleets_(0),
-     nr_portdocks_(0),
-     lastserial_(0) {
+     nr_portdocks_(0) {
 }
 
 /**
@@ -63,7 +62,9 @@ MapObjectSaver::MapObjectRec& MapObjectSaver::get_object_record(const MapObject&
 	rec.description += std::to_string(obj.serial());
 	rec.description += ')';
 #endif
-	rec.fileserial = ++lastserial_;
+	// Keep the serials, so that loading the game doesn't renumber the objects
+	assert(obj.serial() != 0);
+	rec.fileserial = obj.serial();
 	rec.registered = false;
 	rec.saved = false;
 	return objects_.insert(std::make_pair(&obj, rec)).first->second;
@@ -103,7 +103,6 @@ private:
 	uint32_t nr_ship_fleets_;
 	uint32_t nr_ferry_fleets_;
 	uint32_t nr_portdocks_;
-	uint32_t lastserial_;
 };
 }  // namespace Widelands
 
@@ -56,6 +56,7 @@ void MapRoadPacket::read(FileSystem& fs,
 				try {
 					//  If this is already known, get it.
 					//  Road data is read somewhere else
+					egbase.objects().reuse_serial(serial);
 					mol.register_object(serial, *new Road()).init(egbase);
 				} catch (const WException& e) {
 					throw GameDataError("%u: %s", serial, e.what());
@@ -56,6 +56,7 @@ void MapWaterwayPacket::read(FileSystem& fs,
 				try {
 					//  If this is already known, get it.
 					//  Waterway data is read somewhere else
+					egbase.objects().reuse_serial(serial);
 					mol.register_object(serial, *new Waterway()).init(egbase);
 				} catch (const WException& e) {
 					throw GameDataError("%u: %s", serial, e.what());
@@ -334,6 +334,7 @@ int32_t WidelandsMapLoader::load_map_complete(EditorGameBase& egbase,
 				}
 			}
 		}
+		mol_->restore_list_order(egbase);
 
 		//  This should be at least after loading Soldiers (Bobs).
 		//  NOTE DO NOT CHANGE THE PLACE UNLESS YOU KNOW WHAT ARE YOU DOING
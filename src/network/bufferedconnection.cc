@@ -4,25 +4,37 @@
 
 #include "base/log.h"
 
+namespace {
+
+/// Upper limit for the size of a single write of merged packets. A larger packet is written
+/// on its own. Keeping the writes small allows pings and chat messages to overtake file
+/// transfers.
+constexpr size_t kMaxSendBatchSize = 8 * kNetworkBufferSize;
+
+/// How many buffers of sent packets are kept for reuse
+constexpr size_t kMaxFreeSendBuffers = 64;
+
+/// The size of the buffer for received data. It has to hold the largest possible
+/// packet, and should hold a burst of commands without stalling the network thread.
+constexpr size_t kReceiveBufferSize = 256 * 1024;
+
+}  // namespace
+
 BufferedConnection::Peeker::Peeker(BufferedConnection* conn) : conn_(conn), peek_pointer_(0) {
 	assert(conn_);
 }
 
 bool BufferedConnection::Peeker::string() {
-
-	std::lock_guard<std::mutex> lock(conn_->mutex_receive_);
+	const ByteRingBuffer& buffer = conn_->receive_buffer_;
+	const size_t available = buffer.readable();
 
 	// Simple validity check. Should always be true as long as the caller
 	// has not used any receive() method.
-	assert(conn_->receive_buffer_.size() >= peek_pointer_);
-
-	if (conn_->receive_buffer_.size() < peek_pointer_ + 1) {
-		return false;
-	}
+	assert(available >= peek_pointer_);
 
 	// A string goes until the next \0 and might have a length of 0
-	for (size_t i = peek_pointer_; i < conn_->receive_buffer_.size(); ++i) {
-		if (conn_->receive_buffer_[i] == '\0') {
+	for (size_t i = peek_pointer_; i < available; ++i) {
+		if (buffer.peek(i) == '\0') {
 			peek_pointer_ = i + 1;
 			return true;
 		}
@@ -31,31 +43,26 @@ bool BufferedConnection::Peeker::string() {
 }
 
 bool BufferedConnection::Peeker::cmd(RelayCommand* out) {
-
-	std::lock_guard<std::mutex> lock(conn_->mutex_receive_);
-
-	assert(conn_->receive_buffer_.size() >= peek_pointer_);
-
-	if (conn_->receive_buffer_.size() > peek_pointer_) {
-		if (out != nullptr) {
-			*out = static_cast<RelayCommand>(conn_->receive_buffer_[peek_pointer_]);
-		}
-		peek_pointer_++;
-		return true;
+	::uint8_t value;
+	if (!uint8_t(&value)) {
+		return false;
 	}
-	return false;
+	if (out != nullptr) {
+		*out = static_cast<RelayCommand>(value);
+	}
+	return true;
 }
 
 bool BufferedConnection::Peeker::uint8_t(::uint8_t* out) {
+	const ByteRingBuffer& buffer = conn_->receive_buffer_;
+	const size_t available = buffer.readable();
 
-	std::lock_guard<std::mutex> lock(conn_->mutex_receive_);
-
-	assert(conn_->receive_buffer_.size() >= peek_pointer_);
+	assert(available >= peek_pointer_);
 
 	// If there is any byte available, we can read an uint8
-	if (conn_->receive_buffer_.size() > peek_pointer_) {
+	if (available > peek_pointer_) {
 		if (out != nullptr) {
-			*out = static_cast<::uint8_t>(conn_->receive_buffer_[peek_pointer_]);
+			*out = buffer.peek(peek_pointer_);
 		}
 		peek_pointer_++;
 		return true;
@@ -64,23 +71,22 @@ bool BufferedConnection::Peeker::uint8_t(::uint8_t* out) {
 }
 
 bool BufferedConnection::Peeker::recvpacket() {
+	const ByteRingBuffer& buffer = conn_->receive_buffer_;
+	const size_t available = buffer.readable();
 
-	std::lock_guard<std::mutex> lock(conn_->mutex_receive_);
-
-	assert(conn_->receive_buffer_.size() >= peek_pointer_);
+	assert(available >= peek_pointer_);
 
-	if (conn_->receive_buffer_.size() < peek_pointer_ + 2) {
+	if (available < peek_pointer_ + 2) {
 		// Not even enough space for the size of the recvpacket
 		return false;
 	}
 
 	// RecvPackets have their size coded in their first two bytes.
 	// See SendPacket in network.cc
-	const uint16_t size =
-	   conn_->receive_buffer_[peek_pointer_ + 0] << 8 | conn_->receive_buffer_[peek_pointer_ + 1];
+	const uint16_t size = buffer.peek(peek_pointer_ + 0) << 8 | buffer.peek(peek_pointer_ + 1);
 	assert(size >= 2);
 
-	if (conn_->receive_buffer_.size() >= peek_pointer_ + size) {
+	if (available >= peek_pointer_ + size) {
 		peek_pointer_ += size;
 		return true;
 	}
@@ -150,17 +156,18 @@ void BufferedConnection::receive(std::string* str) {
 	// Check if we can read a complete string
 	assert(Peeker(this).string());
 
-	std::lock_guard<std::mutex> lock(mutex_receive_);
-
-	// Read the string
-	str->clear();
 	// No range check needed, peek_string() takes care of that
-	while (receive_buffer_.front() != '\0') {
-		str->push_back(receive_buffer_.front());
-		receive_buffer_.pop_front();
+	size_t length = 0;
+	while (receive_buffer_.peek(length) != '\0') {
+		++length;
+	}
+	str->resize(length);
+	if (length > 0) {
+		receive_buffer_.read(&(*str)[0], length);
 	}
-	// Pop the \0
-	receive_buffer_.pop_front();
+	// Skip the \0
+	receive_buffer_.skip(1);
+	resume_receiving();
 }
 
 void BufferedConnection::receive(RelayCommand* out) {
@@ -170,32 +177,63 @@ void BufferedConnection::receive(RelayCommand* out) {
 }
 
 void BufferedConnection::receive(uint8_t* out) {
+	assert(receive_buffer_.readable() > 0);
 
-	std::lock_guard<std::mutex> lock(mutex_receive_);
-
-	assert(!receive_buffer_.empty());
-
-	*out = receive_buffer_.front();
-	receive_buffer_.pop_front();
+	receive_buffer_.read(out, 1);
+	resume_receiving();
 }
 
 void BufferedConnection::receive(RecvPacket* packet) {
 
 	assert(Peeker(this).recvpacket());
 
-	std::lock_guard<std::mutex> lock(mutex_receive_);
-
-	// Read the packet
-	const uint16_t size = receive_buffer_[0] << 8 | receive_buffer_[1];
+	// Read the packet straight from the receive buffer into the packet
+	const uint16_t size = receive_buffer_.peek(0) << 8 | receive_buffer_.peek(1);
 	assert(size >= 2);
-	assert(receive_buffer_.size() >= size);
+	assert(receive_buffer_.readable() >= size);
 
-	packet->buffer.clear();
-	packet->buffer.insert(
-	   packet->buffer.end(), receive_buffer_.begin() + 2, receive_buffer_.begin() + size);
+	receive_buffer_.skip(2);
+	packet->buffer.resize(size - 2);
+	if (size > 2) {
+		receive_buffer_.read(packet->buffer.data(), size - 2);
+	}
 	packet->index_ = 0;
+	resume_receiving();
+}
+
+void BufferedConnection::resume_receiving() {
+	// Pairs with the fence in start_receiving(): either the network thread sees the
+	// room that we have made, or we see that it has stopped receiving
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (receive_stalled_.exchange(false)) {
+		io_service_.post([this]() { start_receiving(); });
+	}
+}
+
+void BufferedConnection::begin_batch() {
+	std::lock_guard<std::mutex> lock(mutex_send_);
+	++batch_depth_;
+}
 
-	receive_buffer_.erase(receive_buffer_.begin(), receive_buffer_.begin() + size);
+void BufferedConnection::end_batch() {
+	std::unique_lock<std::mutex> lock(mutex_send_);
+	assert(batch_depth_ > 0);
+	--batch_depth_;
+	lock.unlock();
+	start_sending();
+}
+
+std::vector<uint8_t> BufferedConnection::take_send_buffer() {
+	std::unique_lock<std::mutex> lock(mutex_send_);
+	if (free_send_buffers_.empty()) {
+		lock.unlock();
+		std::vector<uint8_t> v;
+		v.reserve(kNetworkBufferSize);
+		return v;
+	}
+	std::vector<uint8_t> v = std::move(free_send_buffers_.back());
+	free_send_buffers_.pop_back();
+	return v;
 }
 
 // Called by send() method but will only do something if not sending yet
@@ -203,21 +241,34 @@ void BufferedConnection::start_sending() {
 
 	std::unique_lock<std::mutex> lock(mutex_send_);
 
-	if (currently_sending_) {
-		// Already sending, don't start a second write call
+	if (currently_sending_ || batch_depth_ > 0) {
+		// Already sending or collecting, don't start a second write call
 		return;
 	}
 
-	// Find something to send
-	std::queue<std::vector<uint8_t>>* nonempty_queue = nullptr;
+	// Merge the waiting packets into one write, starting with the highest priority.
+	// Packets are never split, so a packet can't be disrupted by one of another priority.
+	send_batch_.clear();
 	for (auto& entry : buffers_to_send_) {
-		if (!entry.second.empty()) {
-			nonempty_queue = &entry.second;
+		std::queue<std::vector<uint8_t>>& queue = entry.second;
+		while (!queue.empty() && (send_batch_.empty() ||
+		                          send_batch_.size() + queue.front().size() <= kMaxSendBatchSize)) {
+			std::vector<uint8_t>& packet = queue.front();
+			send_batch_.insert(send_batch_.end(), packet.begin(), packet.end());
+			if (free_send_buffers_.size() < kMaxFreeSendBuffers &&
+			    packet.capacity() <= kMaxSendBatchSize) {
+				packet.clear();
+				free_send_buffers_.push_back(std::move(packet));
+			}
+			queue.pop();
+		}
+		if (!queue.empty()) {
+			// The batch is full
 			break;
 		}
 	}
 
-	if (nonempty_queue == nullptr) {
+	if (send_batch_.empty()) {
 		// Nothing (further) to send (right now)
 		return;
 	}
@@ -229,20 +280,17 @@ void BufferedConnection::start_sending() {
 	// the operating system is currently full.
 	// When done with sending, call the lambda method defined below
 	boost::asio::async_write(
-	   socket_, boost::asio::buffer(nonempty_queue->front()),
+	   socket_, boost::asio::buffer(send_batch_),
 #ifndef NDEBUG
-	   [this, nonempty_queue](boost::system::error_code ec, std::size_t length) {
+	   [this](boost::system::error_code ec, std::size_t length) {
 #else
-	   [this, nonempty_queue](boost::system::error_code ec, std::size_t /*length*/) {
+	   [this](boost::system::error_code ec, std::size_t /*length*/) {
 #endif
 		   std::unique_lock<std::mutex> lock2(mutex_send_);
 		   currently_sending_ = false;
 		   if (!ec) {
-			   // No error: Remove the buffer from the queue
-			   assert(nonempty_queue != nullptr);
-			   assert(!nonempty_queue->empty());
-			   assert(nonempty_queue->front().size() == length);
-			   nonempty_queue->pop();
+			   // No error: The batch has been sent completely
+			   assert(send_batch_.size() == length);
 			   lock2.unlock();
 			   // Try to send some more data
 			   start_sending();
@@ -265,19 +313,27 @@ void BufferedConnection::start_receiving() {
 		return;
 	}
 
+	size_t size = 0;
+	uint8_t* area = receive_buffer_.write_area(&size);
+	if (size == 0) {
+		// The buffer is full. The game thread continues receiving via resume_receiving()
+		// once it has made room, unless it has done so already in the meantime.
+		receive_stalled_.store(true);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		area = receive_buffer_.write_area(&size);
+		if (size == 0 || !receive_stalled_.exchange(false)) {
+			return;
+		}
+	}
+
+	// The socket writes directly into the receive buffer
 	socket_.async_read_some(
-	   boost::asio::buffer(asio_receive_buffer_, kNetworkBufferSize),
-	   [this](boost::system::error_code ec, std::size_t length) {
+	   boost::asio::buffer(area, size), [this](boost::system::error_code ec, std::size_t length) {
 		   if (!ec) {
 			   assert(length > 0);
-			   assert(length <= kNetworkBufferSize);
-			   // Has read something
-			   std::unique_lock<std::mutex> lock(mutex_receive_);
-			   for (size_t i = 0; i < length; ++i) {
-				   receive_buffer_.push_back(asio_receive_buffer_[i]);
-			   }
-			   lock.unlock();
-			   // Try to send some more data
+			   // Has read something, hand it over to the game thread
+			   receive_buffer_.commit_write(length);
+			   // Try to receive some more data
 			   start_receiving();
 		   } else {
 			   if (socket_.is_open()) {
@@ -310,7 +366,12 @@ void BufferedConnection::reduce_send_buffer(boost::asio::ip::tcp::socket& socket
 }
 
 BufferedConnection::BufferedConnection(const NetAddress& host)
-   : io_service_(), socket_(io_service_), receive_buffer_(), currently_sending_(false) {
+   : batch_depth_(0),
+     io_service_(),
+     socket_(io_service_),
+     receive_buffer_(kReceiveBufferSize),
+     receive_stalled_(false),
+     currently_sending_(false) {
 
 	const boost::asio::ip::tcp::endpoint destination(host.ip, host.port);
 
@@ -340,7 +401,12 @@ BufferedConnection::BufferedConnection(const NetAddress& host)
 }
 
 BufferedConnection::BufferedConnection()
-   : io_service_(), socket_(io_service_), receive_buffer_(), currently_sending_(false) {
+   : batch_depth_(0),
+     io_service_(),
+     socket_(io_service_),
+     receive_buffer_(kReceiveBufferSize),
+     receive_stalled_(false),
+     currently_sending_(false) {
 }
 
 void BufferedConnection::notify_connected() {
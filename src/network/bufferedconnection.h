@@ -20,11 +20,13 @@
 #ifndef WL_NETWORK_BUFFEREDCONNECTION_H
 #define WL_NETWORK_BUFFEREDCONNECTION_H
 
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <thread>
 
 #include "network/network.h"
+#include "network/ring_buffer.h"
 #include "network/relay_protocol.h"
 
 /**
@@ -210,19 +212,31 @@ public:
 	 */
 	template <typename... Targs> void send(NetPriority priority, const Targs&... Fargs) {
 
-		std::vector<uint8_t> v;
-		v.reserve(kNetworkBufferSize);
+		std::vector<uint8_t> v = take_send_buffer();
 
 		send_T_(v, Fargs...);
 
 		std::unique_lock<std::mutex> lock(mutex_send_);
 		// The map will automatically create the vector for the requested priority if it does not
 		// exist
-		buffers_to_send_[priority].push(v);
+		buffers_to_send_[priority].push(std::move(v));
 		lock.unlock();
 		start_sending();
 	}
 
+	/**
+	 * Holds back all data that is sent until \ref end_batch() is called. Afterwards,
+	 * the collected data is written to the socket with as few calls as possible.
+	 * Batches can be nested, the data is sent when the outermost batch ends.
+	 */
+	void begin_batch();
+
+	/**
+	 * Ends a batch that was started with \ref begin_batch() and starts sending
+	 * the data that has been collected.
+	 */
+	void end_batch();
+
 private:
 	// I love this language... Sorry for the next functions,
 	// but you have to admit that this is cool! :-D
@@ -286,21 +300,34 @@ private:
 	 */
 	explicit BufferedConnection();
 
+	/**
+	 * Returns an empty buffer for a new packet, reusing the buffers of packets
+	 * that have been sent already.
+	 */
+	std::vector<uint8_t> take_send_buffer();
+
 	/**
 	 * Tries to send some data.
 	 * Is called by send() each time new data is given to this class but only
-	 * does something when not already sending.
-	 * Will continue sending until all buffers_to_send_ are empty.
+	 * does something when not already sending and no batch is being collected.
+	 * Merges as many of the waiting packets as possible into one write and
+	 * continues sending until all buffers_to_send_ are empty.
 	 */
 	void start_sending();
 
 	/**
 	 * Waits on the socket until data can be received.
 	 * After data has been received, directly calls itself again to start
-	 * the next wait.
+	 * the next wait. Stops while the receive buffer is full.
 	 */
 	void start_receiving();
 
+	/**
+	 * Called by the game thread after it has taken data from the receive buffer.
+	 * Restarts receiving if the network thread has stopped because the buffer was full.
+	 */
+	void resume_receiving();
+
 	/**
 	 * Reduces the send buffer of the given socket to only contain 20 packets.
 	 * @param socket The socket to modify.
@@ -311,6 +338,12 @@ private:
 	/// The map key is the priority of the packets stored in the queue.
 	/// Each packet in the queue is a vector of uint8_t.
 	std::map<uint8_t, std::queue<std::vector<uint8_t>>> buffers_to_send_;
+	/// Buffers of packets that have been sent, to be reused by take_send_buffer()
+	std::vector<std::vector<uint8_t>> free_send_buffers_;
+	/// The packets that are currently being written to the socket
+	std::vector<uint8_t> send_batch_;
+	/// How many calls of begin_batch() are waiting for their end_batch()
+	uint32_t batch_depth_;
 
 	/// An io_service needed by boost.asio. Primarily needed for asynchronous operations.
 	boost::asio::io_service io_service_;
@@ -319,17 +352,16 @@ private:
 	boost::asio::ip::tcp::socket socket_;
 
 	/// Buffer for arriving data. We need to store it until we have enough
-	/// to return the required type.
-	std::deque<uint8_t> receive_buffer_;
-	/// The buffer that is given to the asynchronous receive function
-	uint8_t asio_receive_buffer_[kNetworkBufferSize];
+	/// to return the required type. The network thread writes to it and the
+	/// game thread reads from it, without locking.
+	ByteRingBuffer receive_buffer_;
+	/// Whether the network thread has stopped receiving because the buffer is full
+	std::atomic<bool> receive_stalled_;
 
 	/// A thread used for the asynchronous send/receive methods
 	std::thread asio_thread_;
-	/// Protects buffers_to_send_
+	/// Protects buffers_to_send_, free_send_buffers_, send_batch_ and batch_depth_
 	std::mutex mutex_send_;
-	/// Protects receive_buffer_
-	std::mutex mutex_receive_;
 	/// Whether we are currently sending something, used within start_sending()
 	bool currently_sending_;
 };
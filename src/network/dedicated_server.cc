@@ -0,0 +1,198 @@
+/*
+ * Copyright (C) 2020 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "network/dedicated_server.h"
+
+#include <SDL_timer.h>
+#include <boost/format.hpp>
+
+#include "ai/defaultai.h"
+#include "base/log.h"
+#include "base/wexception.h"
+#include "logic/filesystem_constants.h"
+#include "logic/map.h"
+#include "map_io/map_loader.h"
+#include "network/constants.h"
+#include "network/gamehost.h"
+#include "network/network_gaming_messages.h"
+#include "wlapplication_options.h"
+
+namespace {
+
+/// Time in ms between two calls of GameHost::think() while waiting for players
+constexpr uint32_t kWaitFrameTime = 10;
+
+}  // namespace
+
+DedicatedServer::DedicatedServer(Profile& config)
+   : config_(config), server_(config.get_safe_section("server")) {
+	chat_subscriber_ = Notifications::subscribe<ChatMessage>([](const ChatMessage& message) {
+		log_info("[Chat]: %s: %s\n", message.sender.empty() ? "*" : message.sender.c_str(),
+		         message.msg.c_str());
+	});
+}
+
+DedicatedServer::~DedicatedServer() {
+}
+
+void DedicatedServer::run() {
+	NetworkGamingMessages::fill_map();
+
+	// The save handler reads its settings from the global config
+	set_config_int("autosave", server_.get_natural("autosave", kDefaultAutosaveInterval) * 60);
+
+	host_.reset(new GameHost(server_.get_string("name", "dedicated"),
+	                         static_cast<uint16_t>(server_.get_natural("port", kWidelandsLanPort))));
+	setup_map();
+	setup_players();
+	if (!wait_for_players()) {
+		return;
+	}
+
+	host_->set_desired_speed(server_.get_natural("speed", 1000));
+	const uint32_t end_time = server_.get_natural("end_time", 0);
+	if (end_time > 0) {
+		host_->set_headless_end_time(Time(end_time * 60 * 1000));
+	}
+
+	log_info("[Dedicated]: starting the game\n");
+	host_->run_game();
+	log_info("[Dedicated]: the game is over\n");
+	host_.reset();
+}
+
+void DedicatedServer::setup_map() {
+	const std::string filename = server_.get_safe_string("map");
+	Widelands::Map map;
+	std::unique_ptr<Widelands::MapLoader> ml = map.get_correct_loader(filename);
+	if (ml == nullptr) {
+		throw wexception("%s is not a map", filename.c_str());
+	}
+	map.set_filename(filename);
+	ml->preload_map(true);
+
+	host_->set_scenario(false);
+	host_->set_map(map.get_name(), filename, map.get_background_theme(), map.get_background(),
+	               map.get_nrplayers());
+	host_->set_win_condition_script(
+	   server_.get_string("win_condition", "scripting/win_conditions/endless_game.lua"));
+	host_->set_peaceful_mode(server_.get_bool("peaceful", false));
+	log_info("[Dedicated]: hosting %s with %u players\n", map.get_name().c_str(),
+	         static_cast<unsigned>(map.get_nrplayers()));
+}
+
+void DedicatedServer::setup_players() {
+	for (uint8_t i = 0; i < host_->settings().players.size(); ++i) {
+		Section* section = config_.get_section((boost::format("player_%u") % (i + 1)).str());
+		if (section == nullptr) {
+			continue;
+		}
+
+		const std::string state = section->get_string("state", "human");
+		if (state == "computer") {
+			host_->set_player_state(i, PlayerSettings::State::kComputer);
+			host_->set_player_ai(
+			   i, section->get_string("ai", AI::DefaultAI::normal_impl.name.c_str()));
+		} else if (state == "closed") {
+			host_->set_player_state(i, PlayerSettings::State::kClosed);
+			continue;
+		} else if (state != "human") {
+			throw wexception("player %u: unknown state '%s'", i + 1, state.c_str());
+		}
+
+		const std::string tribe = section->get_string("tribe", "");
+		host_->set_player_tribe(i, tribe, tribe.empty());
+		host_->set_player_init(i, section->get_natural("init", 0));
+		host_->set_player_team(i, section->get_natural("team", 0));
+	}
+}
+
+/**
+ * Keeps the network going until all players are ready. Human players take
+ * their slots themselves, like in a game hosted with user interface.
+ *
+ * \return \c false if the game can't be started at all
+ */
+bool DedicatedServer::wait_for_players() {
+	const uint32_t timeout = server_.get_natural("start_timeout", 0) * 1000;
+	const uint32_t start_delay = server_.get_natural("start_delay", 10) * 1000;
+	const uint32_t start_time = SDL_GetTicks();
+	bool timed_out = false;
+	uint32_t launch_time = 0;
+
+	log_info("[Dedicated]: waiting for players\n");
+	for (;;) {
+		host_->think();
+		const uint32_t now = SDL_GetTicks();
+
+		if (!timed_out && timeout > 0 && now - start_time >= timeout) {
+			timed_out = true;
+			fill_open_slots();
+		}
+
+		if (!host_->can_launch()) {
+			if (launch_time != 0) {
+				announce("Start of the game was cancelled.");
+				launch_time = 0;
+			}
+		} else if (launch_time == 0) {
+			launch_time = now + start_delay;
+			announce((boost::format("The game starts in %u seconds.") % (start_delay / 1000)).str());
+		} else if (static_cast<int32_t>(now - launch_time) >= 0) {
+			return true;
+		}
+
+		if (timed_out && launch_time == 0) {
+			bool all_closed = true;
+			for (const PlayerSettings& player : host_->settings().players) {
+				all_closed &= player.state == PlayerSettings::State::kClosed;
+			}
+			if (all_closed) {
+				log_err("[Dedicated]: no players left, giving up\n");
+				return false;
+			}
+		}
+
+		SDL_Delay(kWaitFrameTime);
+	}
+}
+
+/// Hands all slots that no human player took to the AI, or closes them.
+void DedicatedServer::fill_open_slots() {
+	const std::string ai = server_.get_string("fill_ai", AI::DefaultAI::normal_impl.name.c_str());
+	for (uint8_t i = 0; i < host_->settings().players.size(); ++i) {
+		if (host_->settings().players.at(i).state != PlayerSettings::State::kOpen) {
+			continue;
+		}
+		if (ai.empty()) {
+			log_info("[Dedicated]: closing slot %u\n", i + 1);
+			host_->set_player_state(i, PlayerSettings::State::kClosed);
+		} else {
+			log_info("[Dedicated]: slot %u is played by the %s AI\n", i + 1, ai.c_str());
+			host_->set_player_state(i, PlayerSettings::State::kComputer);
+			host_->set_player_ai(i, ai);
+		}
+	}
+}
+
+void DedicatedServer::announce(const std::string& message) {
+	ChatMessage chat(message);
+	chat.sender = host_->get_local_playername();
+	host_->send(chat);
+}
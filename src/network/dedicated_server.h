@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2020 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#ifndef WL_NETWORK_DEDICATED_SERVER_H
+#define WL_NETWORK_DEDICATED_SERVER_H
+
+#include <memory>
+#include <string>
+
+#include "chat/chat.h"
+#include "io/profile.h"
+#include "notifications/notifications.h"
+
+struct GameHost;
+
+/**
+ * Hosts a LAN game without any user interface. Everything that the host
+ * would normally choose in the game setup screen is read from a config file,
+ * and everything that happens is written to the log.
+ *
+ * The config file has a [server] section with the keys
+ *  - map: filename of the map to play (mandatory)
+ *  - name: the name of the host, default "dedicated"
+ *  - port: the port to listen on. Only games on the default port are
+ *    announced on the LAN.
+ *  - win_condition: the win condition script, default endless game
+ *  - peaceful: whether peaceful mode is active, default false
+ *  - speed: the desired game speed in milliseconds per second, default 1000
+ *  - autosave: the autosave interval in minutes, 0 disables autosaving
+ *  - start_timeout: seconds to wait for human players. Afterwards, all open
+ *    slots are filled with 'fill_ai'. 0 waits forever.
+ *  - fill_ai: AI for slots that no player took, default "normal". If this is
+ *    empty, the slots are closed instead.
+ *  - start_delay: seconds between all players being ready and the start of
+ *    the game, default 10
+ *  - end_time: minutes of gametime after which the game ends. By default, it
+ *    ends once all clients have left.
+ *
+ * Each player slot can be configured in a section [player_<n>] with the keys
+ *  - state: "human" (default), "computer" or "closed"
+ *  - ai: the AI for computer players, default "normal"
+ *  - tribe: the tribe, random if not given
+ *  - init: the index of the start condition, default 0
+ *  - team: the team number, default 0
+ */
+class DedicatedServer {
+public:
+	explicit DedicatedServer(Profile& config);
+	~DedicatedServer();
+
+	/// Waits for the players, then runs the game until it is over.
+	void run();
+
+private:
+	void setup_map();
+	void setup_players();
+	bool wait_for_players();
+	void fill_open_slots();
+	void announce(const std::string& message);
+
+	Profile& config_;
+	Section& server_;
+	std::unique_ptr<GameHost> host_;
+	std::unique_ptr<Notifications::Subscriber<ChatMessage>> chat_subscriber_;
+};
+
+#endif  // end of include guard: WL_NETWORK_DEDICATED_SERVER_H
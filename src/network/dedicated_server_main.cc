@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2020 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include <memory>
+
+#include "base/log.h"
+#include "build_info.h"
+#include "headless_environment.h"
+#include "io/filesystem/layered_filesystem.h"
+#include "io/profile.h"
+#include "network/dedicated_server.h"
+
+/**
+ * Runs a network game without any user interface, see \ref DedicatedServer
+ * for the config file format.
+ */
+int main(int argc, char** argv) {
+	if (argc != 2) {
+		log_err("Usage: %s <config file>\n", argv[0]);
+		return 1;
+	}
+	log_info("This is the Widelands dedicated server, version %s (%s)\n", build_id().c_str(),
+	         build_type().c_str());
+
+	const std::string config_path = argv[1];
+	g_fs = new LayeredFileSystem();
+	try {
+		std::string config_dir = FileSystem::fs_dirname(config_path);
+		if (config_dir.empty()) {
+			config_dir = ".";
+		}
+		std::unique_ptr<FileSystem> config_fs(&FileSystem::create(config_dir));
+		Profile config;
+		config.read(FileSystem::fs_filename(config_path.c_str()), nullptr, *config_fs);
+
+		initialize_headless_environment(config.get_safe_section("server"));
+		DedicatedServer(config).run();
+	} catch (const std::exception& e) {
+		log_err("Dedicated server: %s\n", e.what());
+		cleanup_headless_environment();
+		return 1;
+	}
+	cleanup_headless_environment();
+	return 0;
+}
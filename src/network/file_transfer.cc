@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2020 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "network/file_transfer.h"
+
+#include <cassert>
+
+#include <zlib.h>
+
+#include "base/fast_hash.h"
+#include "base/log.h"
+#include "base/md5.h"
+#include "base/time_string.h"
+#include "io/fileread.h"
+#include "io/filesystem/filesystem_exceptions.h"
+#include "io/filesystem/layered_filesystem.h"
+#include "logic/filesystem_constants.h"
+#include "logic/game.h"
+#include "network/network_protocol.h"
+
+namespace {
+
+/// Prepare a part of a file for the transfer. The part is compressed if that makes it smaller.
+FilePart compress_file_part(const char* data, uint32_t size) {
+	FilePart part;
+	part.size = size;
+
+	FastHash checksum;
+	checksum.data(data, size);
+	part.checksum = checksum.value();
+
+	uLongf compressed_size = compressBound(size);
+	part.data.resize(compressed_size);
+	part.compressed =
+	   compress2(part.data.data(), &compressed_size, reinterpret_cast<const Bytef*>(data), size,
+	             Z_DEFAULT_COMPRESSION) == Z_OK &&
+	   compressed_size < size;
+	if (part.compressed) {
+		part.data.resize(compressed_size);
+	} else {
+		part.data.assign(data, data + size);
+	}
+	return part;
+}
+
+}  // namespace
+
+std::unique_ptr<NetTransferFile> prepare_file_transfer(const std::string& filename) {
+	FileRead fr;
+	fr.open(*g_fs, filename);
+	std::unique_ptr<NetTransferFile> file(new NetTransferFile());
+	file->filename = filename;
+	file->bytes = fr.get_size();
+	SimpleMD5Checksum md5sum;
+	for (uint32_t part = 0; part < file->number_of_parts(); ++part) {
+		const uint32_t left = file->bytes - NETFILEPARTSIZE * part;
+		const uint32_t size = (left > NETFILEPARTSIZE) ? NETFILEPARTSIZE : left;
+		const char* data = fr.data(size);
+		md5sum.data(data, size);
+		file->parts.push_back(compress_file_part(data, size));
+	}
+	md5sum.finish_checksum();
+	file->md5sum = md5sum.get_checksum().str();
+	return file;
+}
+
+std::unique_ptr<NetTransferFile> prepare_snapshot_transfer(Widelands::Game& game,
+                                                           const std::string& name) {
+	g_fs->ensure_directory_exists(kTempFileDir);
+	const std::string filename = kTempFileDir + g_fs->file_separator() + timestring() + name +
+	                             std::to_string(game.get_gametime().get()) + kTempFileExtension;
+	std::string error;
+	if (!game.save_handler().save_game(game, filename, &error)) {
+		log_err_time(game.get_gametime(), "Failed to save snapshot: %s\n", error.c_str());
+		return nullptr;
+	}
+
+	std::unique_ptr<NetTransferFile> file;
+	try {
+		file = prepare_file_transfer(filename);
+	} catch (const std::exception& e) {
+		log_err_time(game.get_gametime(), "Unable to read snapshot %s: %s\n", filename.c_str(),
+		             e.what());
+	}
+	// The snapshot is kept in memory, so the file is not needed anymore
+	try {
+		g_fs->fs_unlink(filename);
+	} catch (const FileError& e) {
+		log_warn_time(game.get_gametime(), "Deleting snapshot %s failed: %s\n", filename.c_str(),
+		              e.what());
+	}
+	return file;
+}
+
+void send_file_part(NetHostInterface& net,
+                    NetHostInterface::ConnectionId id,
+                    const NetTransferFile& file,
+                    uint32_t part) {
+	assert(part < file.parts.size());
+	const FilePart& file_part = file.parts[part];
+
+	SendPacket packet;
+	packet.unsigned_8(NETCMD_FILE_PART);
+	packet.unsigned_32(part);
+	packet.unsigned_32(file_part.size);
+	packet.unsigned_8(file_part.compressed ? 1 : 0);
+	packet.unsigned_32(file_part.data.size());
+	packet.unsigned_32(file_part.checksum >> 32);
+	packet.unsigned_32(file_part.checksum & 0xffffffff);
+	packet.data(file_part.data.data(), file_part.data.size());
+	net.send(id, packet, NetPriority::kFiletransfer);
+}
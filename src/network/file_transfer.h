@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2020 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#ifndef WL_NETWORK_FILE_TRANSFER_H
+#define WL_NETWORK_FILE_TRANSFER_H
+
+#include <memory>
+#include <string>
+
+#include "network/nethost_interface.h"
+#include "network/network.h"
+
+namespace Widelands {
+class Game;
+}  // namespace Widelands
+
+/// How many file parts may be sent to a client without being confirmed
+constexpr uint32_t kFileTransferWindow = 16;
+
+/// Read in a file and prepare all of its parts for the transfer
+std::unique_ptr<NetTransferFile> prepare_file_transfer(const std::string& filename);
+
+/// Save the running \p game to a temporary file and prepare it for the transfer. The file name
+/// contains \p name and the gametime. Returns nullptr if the game could not be saved.
+std::unique_ptr<NetTransferFile> prepare_snapshot_transfer(Widelands::Game& game,
+                                                           const std::string& name);
+
+/// Send a single part of \p file to the connection \p id
+void send_file_part(NetHostInterface& net,
+                    NetHostInterface::ConnectionId id,
+                    const NetTransferFile& file,
+                    uint32_t part);
+
+#endif  // end of include guard: WL_NETWORK_FILE_TRANSFER_H
@@ -19,12 +19,20 @@
 
 #include "network/gameclient.h"
 
+#include <deque>
 #include <memory>
 
 #include <SDL_timer.h>
+#include <boost/algorithm/string/predicate.hpp>
+#include <zlib.h>
 
+#include "ai/computer_player.h"
+#include "base/fast_hash.h"
 #include "base/i18n.h"
 #include "base/log.h"
+#include "base/md5.h"
+#include "base/random.h"
+#include "base/time_string.h"
 #include "base/warning.h"
 #include "base/wexception.h"
 #include "build_info.h"
@@ -33,12 +41,14 @@
 #include "io/fileread.h"
 #include "io/filesystem/filesystem_exceptions.h"
 #include "io/filewrite.h"
+#include "logic/command_stream.h"
 #include "logic/filesystem_constants.h"
 #include "logic/game.h"
 #include "logic/map_objects/tribes/tribe_basic_info.h"
 #include "logic/player.h"
 #include "logic/playercommand.h"
 #include "logic/playersmanager.h"
+#include "logic/sync_digest.h"
 #include "map_io/widelands_map_loader.h"
 #include "network/internet_gaming.h"
 #include "network/netclient.h"
@@ -55,6 +65,35 @@
 #include "wui/interactive_player.h"
 #include "wui/interactive_spectator.h"
 
+namespace {
+
+/// Time in ms between two network checks while a client without user interface waits for the
+/// game to start
+constexpr uint32_t kHeadlessWaitTime = 10;
+
+// Interrupted file transfers are kept in the temp directory, so they can be resumed
+const std::string kPartialTransferSuffix = "_transfer_";
+
+/// \return the temp file with the parts of the file with the given checksum that have
+/// been received so far, or an empty string if there is none
+std::string find_partial_transfer(const std::string& md5sum) {
+	const std::string suffix = kPartialTransferSuffix + md5sum + kTempFileExtension;
+	const FilenameSet candidates = g_fs->filter_directory(
+	   kTempFileDir, [&suffix](const std::string& fn) { return boost::ends_with(fn, suffix); });
+	return candidates.empty() ? "" : *candidates.begin();
+}
+
+std::string md5sum_of_file(const std::string& filename) {
+	FileRead fr;
+	fr.open(*g_fs, filename);
+	SimpleMD5Checksum md5sum;
+	md5sum.data(fr.data(fr.get_size()), fr.get_size());
+	md5sum.finish_checksum();
+	return md5sum.get_checksum().str();
+}
+
+}  // namespace
+
 struct GameClientImpl {
 	bool internet_;
 
@@ -95,6 +134,38 @@ struct GameClientImpl {
 	/** File that is eventually transferred via the network if not found at the other side */
 	std::unique_ptr<NetTransferFile> file_;
 
+	/// Set while we rejoin a running game and have not caught up with it yet
+	bool rejoining;
+	/// Whether the state of the game at the time of the snapshot still has to be restored
+	bool rejoin_state_pending;
+	RNG rejoin_rng;
+	Widelands::SyncHasher rejoin_sync_state;
+	/// Player commands that arrived before the snapshot was loaded
+	std::vector<std::unique_ptr<Widelands::PlayerCommand>> rejoin_commands;
+
+	/// The player commands that we send to the host
+	Widelands::CommandStream commands_to_host;
+	/// The player commands that the host sends to us
+	Widelands::CommandStream commands_from_host;
+
+	/// Whether we run without user interface
+	bool headless;
+	/// Whether the host has launched the game
+	bool launched;
+	/// Plays for the local player if we run without user interface
+	std::unique_ptr<AI::ComputerPlayer> computer_player;
+
+	/// Gets to see the game stream if we are a spectator relay
+	GameClientObserver* observer;
+	/// How long a spectator relay holds the packets of the running game back
+	uint32_t stream_delay;
+	struct DelayedPacket {
+		uint32_t due;
+		uint8_t cmd;
+		std::unique_ptr<RecvPacket> packet;
+	};
+	std::deque<DelayedPacket> delayed_packets;
+
 	void send_hello();
 	void send_player_command(Widelands::PlayerCommand*);
 
@@ -111,13 +182,20 @@ void GameClientImpl::send_hello() {
 	s.string(localplayername);
 	s.string(build_id());
 	net->send(s);
+
+	if (observer != nullptr) {
+		s.reset();
+		s.unsigned_8(NETCMD_SPECTATOR_RELAY);
+		net->send(s);
+	}
 }
 
 void GameClientImpl::send_player_command(Widelands::PlayerCommand* pc) {
 	SendPacket s;
 	s.unsigned_8(NETCMD_PLAYERCOMMAND);
-	s.unsigned_32(game->get_gametime().get());
-	pc->serialize(s);
+	Widelands::CommandWriter writer(s, commands_to_host);
+	writer.time(game->get_gametime());
+	pc->serialize(writer);
 	net->send(s);
 }
 
@@ -150,6 +228,10 @@ InteractiveGameBase* GameClientImpl::init_game(GameClient* parent, UI::ProgressW
 	Notifications::publish(UI::NoteLoadingMessage(_("Preparing game…")));
 
 	game->set_game_controller(parent);
+	if (rejoining) {
+		// The replay would have to start from the snapshot that we load later on
+		game->set_write_replay(false);
+	}
 	uint8_t const pn = settings.playernum + 1;
 	game->save_handler().set_autosave_filename(
 	   (boost::format("%s_netclient%u") % kAutosavePrefix % static_cast<unsigned int>(pn)).str());
@@ -173,7 +255,12 @@ InteractiveGameBase* GameClientImpl::init_game(GameClient* parent, UI::ProgressW
  * Run the actual game and cleanup when done.
  */
 void GameClientImpl::run_game(InteractiveGameBase* igb) {
+	const Time networktime = time.networktime();
 	time.reset(game->get_gametime());
+	if (rejoining && networktime > game->get_gametime()) {
+		// The game went on while we received the snapshot, so we have to catch up
+		time.receive(networktime);
+	}
 	lasttimestamp = game->get_gametime();
 	lasttimestamp_realtime = SDL_GetTicks();
 
@@ -230,6 +317,12 @@ GameClient::GameClient(const std::pair<NetAddress, NetAddress>& host,
 	d->realspeed = 0;
 	d->desiredspeed = 1000;
 	d->file_ = nullptr;
+	d->rejoining = false;
+	d->rejoin_state_pending = false;
+	d->headless = false;
+	d->launched = false;
+	d->observer = nullptr;
+	d->stream_delay = 0;
 
 	// Get the default win condition script
 	d->settings.win_condition_script = d->settings.win_condition_scripts.front();
@@ -285,7 +378,72 @@ void GameClient::run() {
 	}
 }
 
+void GameClient::run_headless(const std::string& ai) {
+	d->headless = true;
+	d->send_hello();
+	d->settings.multiplayer = true;
+	NetworkGamingMessages::fill_map();
+
+	while (!d->launched) {
+		handle_network();
+		if (!d->net->is_connected()) {
+			return;
+		}
+		SDL_Delay(kHeadlessWaitTime);
+	}
+
+	d->server_is_waiting = true;
+
+	Widelands::Game game;
+	game.set_write_syncstream(get_config_bool("write_syncstreams", true));
+	if (d->rejoining) {
+		// The replay would have to start from the snapshot that we load later on
+		game.set_write_replay(false);
+	}
+
+	try {
+		d->game = &game;
+		game.set_game_controller(this);
+		const uint8_t pn = d->settings.playernum + 1;
+		game.save_handler().set_autosave_filename(
+		   (boost::format("%s_netclient%u") % kAutosavePrefix % static_cast<unsigned int>(pn))
+		      .str());
+		if (d->settings.savegame) {
+			game.init_savegame(d->settings);
+		} else {
+			game.init_newgame(d->settings);
+		}
+		if (pn > 0 && pn <= UserSettings::highest_playernum()) {
+			log_info("[Client]: player %u is played by the %s AI\n", static_cast<unsigned int>(pn),
+			         ai.c_str());
+			d->computer_player.reset(
+			   AI::ComputerPlayer::get_implementation(ai)->instantiate(game, pn));
+		}
+		d->run_game(nullptr);
+		d->computer_player.reset();
+	} catch (...) {
+		d->computer_player.reset();
+		WLApplication::emergency_save(game);
+		d->game = nullptr;
+		disconnect("CLIENT_CRASHED");
+		throw;
+	}
+}
+
+void GameClient::relay_to(GameClientObserver* observer, uint32_t delay) {
+	d->observer = observer;
+	d->stream_delay = delay;
+}
+
+bool GameClient::is_headless_game_over() {
+	return !d->net->is_connected() && d->delayed_packets.empty();
+}
+
 void GameClient::think() {
+	if (d->rejoin_state_pending && d->game && d->game->is_loaded()) {
+		restore_rejoin_state();
+	}
+
 	handle_network();
 
 	if (d->game) {
@@ -299,12 +457,25 @@ void GameClient::think() {
 		if (d->server_is_waiting && d->game->get_gametime() == d->time.networktime()) {
 			send_time();
 			d->server_is_waiting = false;
+			if (d->rejoining) {
+				log_info("[Client]: caught up with the game at time %u\n",
+				         d->game->get_gametime().get());
+				d->rejoining = false;
+			}
 		} else if (d->game->get_gametime() != d->lasttimestamp) {
 			uint32_t curtime = SDL_GetTicks();
 			if (curtime - d->lasttimestamp_realtime > CLIENT_TIMESTAMP_INTERVAL) {
 				send_time();
 			}
 		}
+
+		if (d->computer_player && !d->rejoining) {
+			d->computer_player->think();
+		}
+
+		if (d->observer && d->game->is_loaded()) {
+			d->observer->think(*d->game);
+		}
 	}
 }
 
@@ -317,7 +488,9 @@ void GameClient::send_player_command(Widelands::PlayerCommand* pc) {
 	assert(d->game);
 
 	// TODO(Klaus Halfmann): should this be an assert?
-	if (pc->sender() == d->settings.playernum + 1)  //  allow command for current player only
+	if (d->rejoining) {
+		log_warn("[Client]: Playercommand dropped, we have not caught up with the game yet\n");
+	} else if (pc->sender() == d->settings.playernum + 1)  //  allow command for current player only
 	{
 		log_info("[Client]: send playercommand at time %i\n", d->game->get_gametime().get());
 
@@ -614,7 +787,7 @@ void GameClient::sync_report_callback() {
 		SendPacket s;
 		s.unsigned_8(NETCMD_SYNCREPORT);
 		s.unsigned_32(d->game->get_gametime().get());
-		s.data(d->game->get_sync_hash().data, 16);
+		d->game->get_sync_digest().write(s);
 		d->net->send(s);
 	}
 }
@@ -719,11 +892,6 @@ void GameClient::handle_new_file(RecvPacket& packet) {
 		}
 	}
 
-	// Yes we need the file!
-	SendPacket s;
-	s.unsigned_8(NETCMD_NEW_FILE_AVAILABLE);
-	d->net->send(s);
-
 	d->file_.reset(new NetTransferFile());
 	d->file_->bytes = bytes;
 	d->file_->filename = path;
@@ -733,6 +901,38 @@ void GameClient::handle_new_file(RecvPacket& packet) {
 		path.resize(position);
 		g_fs->ensure_directory_exists(path);
 	}
+
+	// Resume an earlier transfer of the same file. We keep only complete parts, and
+	// always request the last part, so that the transfer gets completed.
+	std::vector<char> received;
+	g_fs->ensure_directory_exists(kTempFileDir);
+	d->file_->partial_filename = find_partial_transfer(md5);
+	if (!d->file_->partial_filename.empty()) {
+		try {
+			FileRead fr;
+			fr.open(*g_fs, d->file_->partial_filename);
+			const uint32_t parts = std::min<uint32_t>(fr.get_size(), bytes) / NETFILEPARTSIZE;
+			d->file_->next_part = std::min(parts, std::max(d->file_->number_of_parts(), 1U) - 1);
+			const char* data = fr.data(d->file_->next_part * NETFILEPARTSIZE);
+			received.assign(data, data + d->file_->next_part * NETFILEPARTSIZE);
+			log_info("[Client] Resuming transfer of %s at part %u\n", d->file_->filename.c_str(),
+			         d->file_->next_part);
+		} catch (const std::exception& e) {
+			log_warn("[Client] Unable to resume transfer: %s\n", e.what());
+			d->file_->next_part = 0;
+		}
+	} else {
+		d->file_->partial_filename = kTempFileDir + g_fs->file_separator() + timestring() +
+		                             kPartialTransferSuffix + md5 + kTempFileExtension;
+	}
+	d->file_->partial.reset(g_fs->open_stream_write(d->file_->partial_filename));
+	d->file_->partial->data(received.data(), received.size());
+
+	// Yes we need the file!
+	SendPacket s;
+	s.unsigned_8(NETCMD_NEW_FILE_AVAILABLE);
+	s.unsigned_32(d->file_->next_part);
+	d->net->send(s);
 }
 
 /**
@@ -747,74 +947,102 @@ void GameClient::handle_file_part(RecvPacket& packet) {
 		return;  // silently ignore
 	}
 
-	uint32_t part = packet.unsigned_32();
-	uint32_t size = packet.unsigned_32();
-
-	FilePart fp;
-
-	char buf[NETFILEPARTSIZE];
-	assert(size <= NETFILEPARTSIZE);
+	const uint32_t part = packet.unsigned_32();
+	const uint32_t size = packet.unsigned_32();
+	const bool compressed = packet.unsigned_8() == 1;
+	const uint32_t data_size = packet.unsigned_32();
+	uint64_t checksum = static_cast<uint64_t>(packet.unsigned_32()) << 32;
+	checksum |= packet.unsigned_32();
+	if (size > NETFILEPARTSIZE || data_size > compressBound(NETFILEPARTSIZE)) {
+		throw wexception("Invalid file part of %u bytes", size);
+	}
+	if (part >= d->file_->number_of_parts()) {
+		throw wexception("Invalid file part %u", part);
+	}
+	if (part < d->file_->next_part) {
+		// We already have this part
+		return;
+	}
 
-	// TODO(Klaus Halfmann): read directly into FilePart?
-	if (packet.data(buf, size) != size) {
-		log_warn("Readproblem. Will try to go on anyways\n");
+	std::vector<uint8_t> data(data_size);
+	packet.data(data.data(), data_size);
+	std::vector<uint8_t> buf(size);
+	bool valid = false;
+	if (compressed) {
+		uLongf uncompressed_size = size;
+		valid = uncompress(buf.data(), &uncompressed_size, data.data(), data_size) == Z_OK &&
+		        uncompressed_size == size;
+	} else if (data_size == size) {
+		buf.swap(data);
+		valid = true;
+	}
+	if (valid) {
+		FastHash hash;
+		hash.data(buf.data(), size);
+		valid = hash.value() == checksum;
 	}
-	memcpy(fp.part, &buf[0], size);
-	d->file_->parts.push_back(fp);
 
-	// Write file to disk as soon as all parts arrived
-	uint32_t left = (d->file_->bytes - NETFILEPARTSIZE * part);
-	if (left <= NETFILEPARTSIZE) {
+	SendPacket s;
+	if (!valid) {
+		log_warn("[Client] File part %u is corrupted, requesting it again\n", part);
+		s.unsigned_8(NETCMD_NEW_FILE_AVAILABLE);
+		s.unsigned_32(part);
+		d->net->send(s);
+		return;
+	}
+	if (part > d->file_->next_part) {
+		// An earlier part was corrupted. We keep this one until that one arrives.
+		d->file_->early_parts[part].swap(buf);
+		return;
+	}
 
-		// Send an answer. We got everything
-		SendPacket s;
+	// Write and confirm the parts in order, so that the host sends the next ones
+	for (;;) {
+		d->file_->partial->data(buf.data(), buf.size());
+		s.reset();
 		s.unsigned_8(NETCMD_FILE_PART);
-		s.unsigned_32(part);
+		s.unsigned_32(d->file_->next_part);
 		s.string(d->file_->md5sum);
 		d->net->send(s);
+		++d->file_->next_part;
 
-		FileWrite fw;
-		left = d->file_->bytes;
-		uint32_t i = 0;
-		// Put all data together
-		while (left > 0) {
-			uint32_t writeout = (left > NETFILEPARTSIZE) ? NETFILEPARTSIZE : left;
-			fw.data(d->file_->parts[i].part, writeout, FileWrite::Pos::null());
-			left -= writeout;
-			++i;
+		const auto early = d->file_->early_parts.find(d->file_->next_part);
+		if (early == d->file_->early_parts.end()) {
+			break;
 		}
-		// Now really write the file
-		fw.write(*g_fs, d->file_->filename.c_str());
-
-		// Check for consistence
-		FileRead fr;
-		fr.open(*g_fs, d->file_->filename);
+		buf.swap(early->second);
+		d->file_->early_parts.erase(early);
+	}
 
-		std::unique_ptr<char[]> complete(new char[d->file_->bytes]);
+	// Move the file to its place as soon as all parts arrived
+	if (d->file_->next_part >= d->file_->number_of_parts()) {
+		d->file_->partial.reset();
 
-		fr.data_complete(complete.get(), d->file_->bytes);
-		SimpleMD5Checksum md5sum;
-		md5sum.data(complete.get(), d->file_->bytes);
-		md5sum.finish_checksum();
-		std::string localmd5 = md5sum.get_checksum().str();
-		if (localmd5 != d->file_->md5sum) {
+		// Check for consistence
+		if (md5sum_of_file(d->file_->partial_filename) != d->file_->md5sum) {
 			// Something went wrong! We have to rerequest the file.
+			d->file_->next_part = 0;
+			d->file_->early_parts.clear();
+			d->file_->partial.reset(g_fs->open_stream_write(d->file_->partial_filename));
 			s.reset();
 			s.unsigned_8(NETCMD_NEW_FILE_AVAILABLE);
+			s.unsigned_32(0);
 			d->net->send(s);
 			// Notify the players
 			s.reset();
 			s.unsigned_8(NETCMD_CHAT);
 			s.string(_("/me 's file failed md5 checksumming."));
 			d->net->send(s);
-			try {
-				g_fs->fs_unlink(d->file_->filename);
-			} catch (const FileError& e) {
-				log_err("file error in GameClient::handle_packet: case NETCMD_FILE_PART: "
-				        "%s\n",
-				        e.what());
-			}
+			return;
 		}
+		try {
+			g_fs->fs_rename(d->file_->partial_filename, d->file_->filename);
+		} catch (const FileError& e) {
+			log_err("file error in GameClient::handle_packet: case NETCMD_FILE_PART: "
+			        "%s\n",
+			        e.what());
+		}
+
 		// Check file for validity
 		bool invalid = false;
 		if (d->settings.savegame) {
@@ -899,14 +1127,23 @@ void GameClient::handle_setting_allplayers(RecvPacket& packet) {
  *
  */
 void GameClient::handle_playercommand(RecvPacket& packet) {
-	if (!d->game) {
+	if (!d->game && !d->rejoining) {
 		throw DisconnectException("PLAYERCMD_WO_GAME");
 	}
 
-	const Time time(packet.unsigned_32());
-	Widelands::PlayerCommand& plcmd = *Widelands::PlayerCommand::deserialize(packet);
+	Widelands::CommandReader reader(packet, d->commands_from_host);
+	const Time time = reader.time();
+	Widelands::PlayerCommand& plcmd = *Widelands::PlayerCommand::deserialize(reader);
 	plcmd.set_duetime(time);
-	d->game->enqueue_command(&plcmd);
+	if (d->observer) {
+		d->observer->handled_player_command(time, plcmd);
+	}
+	if (d->rejoin_state_pending) {
+		// Keep the command until the snapshot is loaded
+		d->rejoin_commands.emplace_back(&plcmd);
+	} else {
+		d->game->enqueue_command(&plcmd);
+	}
 	d->time.receive(time);
 }
 
@@ -914,11 +1151,15 @@ void GameClient::handle_playercommand(RecvPacket& packet) {
  *
  */
 void GameClient::handle_syncrequest(RecvPacket& packet) {
-	if (!d->game) {
+	if (!d->game && !d->rejoining) {
 		throw DisconnectException("SYNCREQUEST_WO_GAME");
 	}
 	const Time time(packet.unsigned_32());
 	d->time.receive(time);
+	if (d->rejoin_state_pending) {
+		// The host does not wait for our report before we have the game
+		return;
+	}
 	d->game->enqueue_command(new CmdNetCheckSync(time, [this] { sync_report_callback(); }));
 	d->game->report_sync_request();
 }
@@ -956,9 +1197,13 @@ void GameClient::handle_system_message(RecvPacket& packet) {
 /**
  *
  */
-void GameClient::handle_desync(RecvPacket&) {
-	log_err("[Client] received NETCMD_INFO_DESYNC. Trying to salvage some "
-	        "information for debugging.\n");
+void GameClient::handle_desync(RecvPacket& packet) {
+	const uint32_t last_synced_time = packet.unsigned_32();
+	const uint32_t desync_time = packet.unsigned_32();
+	const std::string difference = packet.string();
+	log_err("[Client] received NETCMD_INFO_DESYNC for time %u to %u in: %s. Trying to salvage "
+	        "some information for debugging.\n",
+	        last_synced_time, desync_time, difference.c_str());
 	if (d->game) {
 		d->game->save_syncstream(true);
 		// We don't know our playernumber, so report as -1
@@ -966,14 +1211,44 @@ void GameClient::handle_desync(RecvPacket&) {
 	}
 }
 
+/**
+ * We reconnected to a running game. Remember its state at the time of the
+ * snapshot that the host is about to send.
+ */
+void GameClient::handle_rejoin(RecvPacket& packet) {
+	if (d->game || d->settings.usernum < 0) {
+		throw DisconnectException("UNEXPECTED_REJOIN");
+	}
+	const Time time(packet.unsigned_32());
+	d->rejoin_rng.read_state(packet);
+	d->rejoin_sync_state.read_state(packet);
+	d->rejoining = true;
+	d->rejoin_state_pending = true;
+	d->rejoin_commands.clear();
+	d->time.reset(time);
+	log_info("[Client]: rejoining the game at time %u\n", time.get());
+}
+
+/**
+ * The snapshot has been loaded. Restore the state of the game at the time of
+ * the snapshot and apply the player commands that were issued since.
+ */
+void GameClient::restore_rejoin_state() {
+	d->rejoin_state_pending = false;
+	d->game->rng() = d->rejoin_rng;
+	d->game->set_sync_state(d->rejoin_sync_state);
+	for (std::unique_ptr<Widelands::PlayerCommand>& plcmd : d->rejoin_commands) {
+		d->game->enqueue_command(plcmd.release());
+	}
+	d->rejoin_commands.clear();
+}
+
 /**
  * Handle one packet received from the host.
  *
  * \note The caller must handle exceptions by closing the connection.
  */
-void GameClient::handle_packet(RecvPacket& packet) {
-	uint8_t cmd = packet.unsigned_8();
-
+void GameClient::handle_packet(uint8_t const cmd, RecvPacket& packet) {
 	switch (cmd) {
 	case NETCMD_DISCONNECT:
 		return handle_disconnect(packet);
@@ -1020,10 +1295,13 @@ void GameClient::handle_packet(RecvPacket& packet) {
 		d->settings.custom_starting_positions = packet.unsigned_8();
 		break;
 	case NETCMD_LAUNCH:
-		if (!d->modal || d->game) {
+		if ((!d->modal && !d->headless) || d->game) {
 			throw DisconnectException("UNEXPECTED_LAUNCH");
 		}
-		d->modal->end_modal<FullscreenMenuBase::MenuTarget>(FullscreenMenuBase::MenuTarget::kOk);
+		d->launched = true;
+		if (d->modal) {
+			d->modal->end_modal<FullscreenMenuBase::MenuTarget>(FullscreenMenuBase::MenuTarget::kOk);
+		}
 		break;
 	case NETCMD_SETSPEED:
 		d->realspeed = packet.unsigned_16();
@@ -1046,6 +1324,8 @@ void GameClient::handle_packet(RecvPacket& packet) {
 		return handle_system_message(packet);
 	case NETCMD_INFO_DESYNC:
 		return handle_desync(packet);
+	case NETCMD_REJOIN:
+		return handle_rejoin(packet);
 	default:
 		throw ProtocolException(cmd);
 	}
@@ -1061,16 +1341,40 @@ void GameClient::handle_network() {
 	}
 	try {
 		assert(d->net != nullptr);
-		// Check if the connection is still open
+		// Check if the connection is still open. A spectator relay still passes
+		// on what it has held back.
 		if (!d->net->is_connected()) {
-			disconnect("CONNECTION_LOST", "", false);
-			return;
+			if (d->delayed_packets.empty()) {
+				disconnect("CONNECTION_LOST", "", false);
+				return;
+			}
+		} else {
+			// Process all available packets
+			std::unique_ptr<RecvPacket> packet = d->net->try_receive();
+			while (packet) {
+				const uint8_t cmd = packet->unsigned_8();
+				if (d->launched && d->stream_delay > 0 && cmd != NETCMD_PING) {
+					d->delayed_packets.push_back(GameClientImpl::DelayedPacket{
+					   SDL_GetTicks() + d->stream_delay, cmd, std::move(packet)});
+				} else {
+					handle_packet(cmd, *packet);
+					if (d->observer && cmd != NETCMD_PING) {
+						d->observer->handled_packet(cmd, *packet);
+					}
+				}
+				packet = d->net->try_receive();
+			}
 		}
-		// Process all available packets
-		std::unique_ptr<RecvPacket> packet = d->net->try_receive();
-		while (packet) {
-			handle_packet(*packet);
-			packet = d->net->try_receive();
+		// Process the held back packets that are due
+		const uint32_t now = SDL_GetTicks();
+		while (!d->delayed_packets.empty() &&
+		       static_cast<int32_t>(now - d->delayed_packets.front().due) >= 0) {
+			GameClientImpl::DelayedPacket delayed = std::move(d->delayed_packets.front());
+			d->delayed_packets.pop_front();
+			handle_packet(delayed.cmd, *delayed.packet);
+			if (d->observer) {
+				d->observer->handled_packet(delayed.cmd, *delayed.packet);
+			}
 		}
 	} catch (const DisconnectException& e) {
 		disconnect(e.what());
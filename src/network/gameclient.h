@@ -28,6 +28,26 @@
 
 struct GameClientImpl;
 
+/**
+ * Follows the game stream that a \ref GameClient handles, see \ref SpectatorRelay.
+ */
+class GameClientObserver {
+public:
+	virtual ~GameClientObserver() {
+	}
+
+	/// The client has handled the packet \p packet with the command \p cmd from the host.
+	/// Pings and answers to our own requests are not passed on.
+	virtual void handled_packet(uint8_t cmd, const RecvPacket& packet) = 0;
+
+	/// The client has decoded the player command \p command that is due at \p time.
+	/// The packet that contained it is passed to \ref handled_packet afterwards.
+	virtual void handled_player_command(const Time& time, Widelands::PlayerCommand& command) = 0;
+
+	/// Called once per frame while the client runs the game
+	virtual void think(Widelands::Game& game) = 0;
+};
+
 /**
  * GameClient manages the lifetime of a network game in which this computer
  * participates as a client.
@@ -47,6 +67,14 @@ struct GameClient : public GameController, public GameSettingsProvider, public C
 	~GameClient() override;
 
 	void run();
+	/// Runs the game without any user interface. The local player, if there is
+	/// one, is controlled by the given AI. This is used to test the network code.
+	void run_headless(const std::string& ai);
+
+	/// Makes the client pass the game on to \p observer, which must outlive the client.
+	/// The client announces itself as a spectator relay to the host when it says hello,
+	/// and it handles everything that the host sends during the game \p delay ms later.
+	void relay_to(GameClientObserver* observer, uint32_t delay);
 
 	// GameController interface
 	void think() override;
@@ -59,6 +87,7 @@ struct GameClient : public GameController, public GameSettingsProvider, public C
 	void set_desired_speed(uint32_t speed) override;
 	bool is_paused() override;
 	void set_paused(bool paused) override;
+	bool is_headless_game_over() override;
 	void report_result(uint8_t player,
 	                   Widelands::PlayerEndResult result,
 	                   const std::string& info) override;
@@ -133,7 +162,9 @@ private:
 	void handle_chat(RecvPacket& packet);
 	void handle_system_message(RecvPacket& packet);
 	void handle_desync(RecvPacket& packet);
-	void handle_packet(RecvPacket& packet);
+	void handle_rejoin(RecvPacket& packet);
+	void restore_rejoin_state();
+	void handle_packet(uint8_t cmd, RecvPacket& packet);
 
 	void handle_network();
 	void send_time();
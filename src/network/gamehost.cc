@@ -21,6 +21,7 @@
 
 #include <algorithm>
 #include <cstdlib>
+#include <map>
 #include <memory>
 
 #include <SDL_timer.h>
@@ -32,23 +33,27 @@
 #include "ai/defaultai.h"
 #include "base/i18n.h"
 #include "base/log.h"
-#include "base/md5.h"
+#include "base/random.h"
+#include "base/time_string.h"
 #include "base/warning.h"
 #include "base/wexception.h"
 #include "build_info.h"
 #include "chat/chat.h"
 #include "game_io/game_loader.h"
 #include "game_io/game_preload_packet.h"
-#include "io/fileread.h"
 #include "io/filesystem/layered_filesystem.h"
+#include "logic/command_stream.h"
 #include "logic/filesystem_constants.h"
 #include "logic/game.h"
 #include "logic/map_objects/tribes/tribe_basic_info.h"
 #include "logic/player.h"
 #include "logic/playercommand.h"
 #include "logic/playersmanager.h"
+#include "logic/sync_digest.h"
 #include "network/constants.h"
+#include "network/file_transfer.h"
 #include "network/internet_gaming.h"
+#include "network/lag_controller.h"
 #include "network/nethost.h"
 #include "network/nethostproxy.h"
 #include "network/network_gaming_messages.h"
@@ -62,6 +67,16 @@
 #include "wui/interactive_player.h"
 #include "wui/interactive_spectator.h"
 
+namespace {
+
+/// Part of the file names of the snapshots for rejoining clients
+const std::string kRejoinSnapshotSuffix = "_rejoin_";
+
+/// Interval in ms in which the round trip times to the clients are measured during the game
+constexpr uint32_t kRttPingInterval = 1000;
+
+}  // namespace
+
 struct HostGameSettingsProvider : public GameSettingsProvider {
 	explicit HostGameSettingsProvider(GameHost* const init_host) : host_(init_host) {
 	}
@@ -423,7 +438,7 @@ struct Client {
 	uint8_t playernum;
 	int16_t usernum;
 	std::string build_id;
-	Md5Checksum syncreport;
+	Widelands::SyncDigest syncreport;
 	bool syncreport_arrived;
 	Time time;  // last time report
 	uint32_t desiredspeed;
@@ -432,6 +447,27 @@ struct Client {
 	/// relative
 	/// to when the last answer of the client was received.
 	time_t lastdelta;
+
+	/// Whether the client wants the offered map or savegame
+	bool receiving_file;
+	/// The next file part that will be sent to the client
+	uint32_t file_next_part;
+	/// The number of file parts that the client has confirmed
+	uint32_t file_parts_acked;
+
+	/// Whether the client rejoins the running game and has not caught up yet
+	bool rejoining;
+	/// The snapshot of the running game that is transferred to a rejoining client
+	std::shared_ptr<NetTransferFile> snapshot;
+
+	/// When we sent a ping that has not been answered yet, 0 if there is none
+	uint32_t ping_sent_at;
+
+	/// Whether the client is a spectator relay, which follows the game with a delay
+	bool spectator_relay;
+
+	/// The player commands that the client sends to us
+	Widelands::CommandStream commands;
 };
 
 struct GameHostImpl {
@@ -460,6 +496,9 @@ struct GameHostImpl {
 	/// The networktime we committed to by sending it across the network.
 	Time committed_networktime;
 
+	/// The player commands that we broadcast to all clients
+	Widelands::CommandStream commands;
+
 	/// This is the time for local simulation
 	NetworkTime time;
 
@@ -472,6 +511,11 @@ struct GameHostImpl {
 	 * as we're not \ref waiting.
 	 */
 	uint32_t networkspeed;
+	/// The speed that the players agreed on, before \ref lag_controller limits it
+	uint32_t desired_networkspeed;
+	/// Adapts the speed and the patience with hung clients to the network
+	LagController lag_controller;
+	uint32_t last_rtt_ping;
 	time_t lastpauseping;
 
 	/// All currently running computer players, *NOT* in one-one correspondence
@@ -481,8 +525,14 @@ struct GameHostImpl {
 	/// \c true if a syncreport is currently in flight
 	bool syncreport_pending;
 	Time syncreport_time;
-	Md5Checksum syncreport;
+	Widelands::SyncDigest syncreport;
 	bool syncreport_arrived;
+	/// The time of the last syncreport that matched for all clients
+	Time last_synced_time;
+
+	/// Players who lost their connection to the running game and may rejoin it,
+	/// by user name
+	std::map<std::string, uint8_t> rejoinable_players;
 
 	explicit GameHostImpl(GameHost* const h)
 	   : localdesiredspeed(0),
@@ -498,16 +548,32 @@ struct GameHostImpl {
 	     waiting(false),
 	     lastframe(0),
 	     networkspeed(0),
+	     desired_networkspeed(0),
+	     last_rtt_ping(0),
 	     lastpauseping(0),
 	     syncreport_pending(false),
 	     syncreport_time(0),
 	     syncreport(),
-	     syncreport_arrived(false) {
+	     syncreport_arrived(false),
+	     last_synced_time(0) {
 	}
 };
 
 GameHost::GameHost(const std::string& playername, bool internet)
-   : d(new GameHostImpl(this)), internet_(internet), forced_pause_(false) {
+   : GameHost(playername, internet, kWidelandsLanPort, false) {
+}
+
+GameHost::GameHost(const std::string& playername, uint16_t port)
+   : GameHost(playername, false, port, true) {
+}
+
+GameHost::GameHost(const std::string& playername, bool internet, uint16_t port, bool headless)
+   : d(new GameHostImpl(this)),
+     internet_(internet),
+     port_(port),
+     headless_(headless),
+     headless_had_clients_(false),
+     forced_pause_(false) {
 	log_info("[Host]: starting up.\n");
 
 	d->localplayername = playername;
@@ -526,22 +592,27 @@ GameHost::GameHost(const std::string& playername, bool internet)
 			                  "nothing you can do about it. Please report a bug."));
 		}
 	} else {
-		d->net = NetHost::listen(kWidelandsLanPort);
+		d->net = NetHost::listen(port);
 		if (d->net == nullptr) {
 			// This might happen when the widelands socket is already in use
 			throw WLWarning(_("Failed to start the server!"),
 			                _("Widelands could not start a server.\n"
 			                  "Probably some other process is already running a server on our port."));
 		}
-		d->promoter.reset(new LanGamePromoter());
+		// Clients only look for games on the default port
+		if (port == kWidelandsLanPort) {
+			d->promoter.reset(new LanGamePromoter());
+		}
 	}
 	d->game = nullptr;
 	d->pseudo_networktime = Time(0);
 	d->waiting = true;
 	d->networkspeed = 1000;
+	d->desired_networkspeed = 1000;
 	d->localdesiredspeed = 1000;
 	d->syncreport_pending = false;
 	d->syncreport_time = Time(0);
+	d->last_synced_time = Time(0);
 
 	d->settings.tribes = Widelands::get_all_tribeinfos();
 	set_multiplayer_game_settings();
@@ -640,13 +711,16 @@ void GameHost::run() {
 		}
 		return;
 	}
+	run_game();
+}
 
+void GameHost::run_game() {
 	// if this is an internet game, tell the metaserver that the game started
 	if (internet_) {
 		InternetGaming::ref().set_game_playing();
 	} else {
-		// if it is a LAN game, no longer accept new clients
-		dynamic_cast<NetHost*>(d->net.get())->stop_listening();
+		// if it is a LAN game, no longer advertise it. We keep listening though, so that players
+		// who lost their connection can rejoin.
 		d->promoter.reset();
 	}
 
@@ -666,19 +740,27 @@ void GameHost::run() {
 	game.set_write_syncstream(get_config_bool("write_syncstreams", true));
 
 	try {
-		std::vector<std::string> tipstexts{"general_game", "multiplayer"};
-		if (d->hp.has_players_tribe()) {
-			tipstexts.push_back(d->hp.get_players_tribe());
+		if (!headless_) {
+			std::vector<std::string> tipstexts{"general_game", "multiplayer"};
+			if (d->hp.has_players_tribe()) {
+				tipstexts.push_back(d->hp.get_players_tribe());
+			}
+			game.create_loader_ui(
+			   tipstexts, false, d->settings.map_theme, d->settings.map_background);
 		}
-		game.create_loader_ui(tipstexts, false, d->settings.map_theme, d->settings.map_background);
 		Notifications::publish(UI::NoteLoadingMessage(_("Preparing game…")));
 
 		d->game = &game;
 		game.set_game_controller(this);
-		InteractiveGameBase* igb;
 		uint8_t pn = d->settings.playernum + 1;
-		game.save_handler().set_autosave_filename(
-		   (boost::format("%s_nethost") % kAutosavePrefix).str());
+		if (headless_) {
+			// Several dedicated servers might be running on the same machine
+			game.save_handler().set_autosave_filename(
+			   (boost::format("%s_dedicated_%u") % kAutosavePrefix % port_).str());
+		} else {
+			game.save_handler().set_autosave_filename(
+			   (boost::format("%s_nethost") % kAutosavePrefix).str());
+		}
 
 		if (d->settings.savegame) {
 			// Read and broadcast original win condition
@@ -689,12 +771,13 @@ void GameHost::run() {
 			set_win_condition_script(gpdp.get_win_condition());
 		}
 
-		if ((pn > 0) && (pn <= UserSettings::highest_playernum())) {
-			igb = new InteractivePlayer(game, get_config_section(), pn, true, &d->chat);
+		if (headless_) {
+			headless_had_clients_ = !d->clients.empty();
+		} else if ((pn > 0) && (pn <= UserSettings::highest_playernum())) {
+			game.set_ibase(new InteractivePlayer(game, get_config_section(), pn, true, &d->chat));
 		} else {
-			igb = new InteractiveSpectator(game, get_config_section(), true, &d->chat);
+			game.set_ibase(new InteractiveSpectator(game, get_config_section(), true, &d->chat));
 		}
-		game.set_ibase(igb);
 
 		if (!d->settings.savegame) {  // new game
 			game.init_newgame(d->settings);
@@ -721,7 +804,7 @@ void GameHost::run() {
 		            Widelands::Game::StartGameType::kSaveGame :
 		            d->settings.scenario ? Widelands::Game::StartGameType::kMultiPlayerScenario :
 		                                   Widelands::Game::StartGameType::kMap,
-		         "", false, "nethost");
+		         "", false, headless_ ? "dedicated" : "nethost");
 
 		// if this is an internet game, tell the metaserver that the game is done.
 		if (internet_) {
@@ -748,7 +831,57 @@ void GameHost::run() {
 	d->game = nullptr;
 }
 
+void GameHost::set_headless_end_time(const Time& time) {
+	assert(headless_);
+	headless_end_time_ = time;
+}
+
+bool GameHost::is_headless_game_over() {
+	if (d->game == nullptr) {
+		return true;
+	}
+	if (headless_end_time_.is_valid() && d->game->get_gametime() >= headless_end_time_) {
+		log_info("[Host]: end time reached\n");
+		return true;
+	}
+	if (headless_had_clients_ && d->clients.empty()) {
+		log_info("[Host]: all clients have left\n");
+		return true;
+	}
+	return false;
+}
+
+std::string GameHost::network_status() {
+	LagController::ClientId id = 0;
+	const LagController::Statistics* slowest = d->lag_controller.slowest_client(&id);
+	if (d->game == nullptr || slowest == nullptr) {
+		return std::string();
+	}
+	// Only bother the players when the network is slowing down the game
+	if (d->networkspeed == d->desired_networkspeed &&
+	    slowest->lag < d->lag_controller.hang_tolerance() / 2) {
+		return std::string();
+	}
+	std::string name;
+	for (const Client& client : d->clients) {
+		if (client.sock_id == id && client.usernum >= 0) {
+			name = d->settings.users.at(client.usernum).name;
+		}
+	}
+	/** TRANSLATORS: Shown in network games. The name of the player whose connection is the */
+	/** TRANSLATORS: slowest, the round trip time and how far the player is behind the game. */
+	return (boost::format(_("Slowest: %1$s (ping %2$u ms, %3$u ms behind)")) % name % slowest->rtt %
+	        slowest->lag)
+	   .str();
+}
+
 void GameHost::think() {
+	if (d->game) {
+		send_rtt_pings();
+	}
+
+	// Everything else that we send during one tick goes out to each client in one go
+	NetBatch batch(*d->net);
 	handle_network();
 
 	if (d->game) {
@@ -780,9 +913,11 @@ void GameHost::think() {
 			}
 		}
 
-		for (AI::ComputerPlayer* cp : d->computerplayers) {
-			cp->think();
+		if (d->lag_controller.think(curtime, d->desired_networkspeed)) {
+			update_network_speed();
 		}
+
+		AI::ComputerPlayer::think_all(*d->game, d->computerplayers);
 	}
 }
 
@@ -791,9 +926,11 @@ void GameHost::send_player_command(Widelands::PlayerCommand* pc) {
 
 	SendPacket packet;
 	packet.unsigned_8(NETCMD_PLAYERCOMMAND);
-	packet.unsigned_32(pc->duetime().get());
-	pc->serialize(packet);
+	Widelands::CommandWriter writer(packet, d->commands);
+	writer.time(pc->duetime());
+	pc->serialize(writer);
 	broadcast(packet);
+
 	d->game->enqueue_command(pc);
 
 	committed_network_time(d->committed_networktime + Duration(1));
@@ -1129,30 +1266,16 @@ void GameHost::set_map(const std::string& mapname,
 	// TODO(unknown): not yet able to handle directory type maps / savegames, would involve zipping
 	// in place or such ...
 	if (!g_fs->is_directory(mapfilename)) {
-		// Read in the file
-		FileRead fr;
-		fr.open(*g_fs, mapfilename);
-		file_.reset(new NetTransferFile());
-		file_->filename = mapfilename;
-		uint32_t leftparts = file_->bytes = fr.get_size();
-		while (leftparts > 0) {
-			uint32_t readout = (leftparts > NETFILEPARTSIZE) ? NETFILEPARTSIZE : leftparts;
-			FilePart fp;
-			memcpy(fp.part, fr.data(readout), readout);
-			file_->parts.push_back(fp);
-			leftparts -= readout;
-		}
-		std::vector<char> complete(file_->bytes);
-		fr.set_file_pos(0);
-		fr.data_complete(&complete[0], file_->bytes);
-		SimpleMD5Checksum md5sum;
-		md5sum.data(&complete[0], file_->bytes);
-		md5sum.finish_checksum();
-		file_->md5sum = md5sum.get_checksum().str();
+		// The parts are compressed once here and then shared by all receivers.
+		file_ = prepare_file_transfer(mapfilename);
 	} else {
 		// reset previously offered map / saved game
 		file_.reset(nullptr);
 	}
+	// Transfers of the previous file are obsolete now
+	for (Client& client : d->clients) {
+		client.receiving_file = false;
+	}
 
 	packet.reset();
 	if (write_map_transfer_info(packet, mapfilename)) {
@@ -1737,8 +1860,140 @@ void GameHost::welcome_client(uint32_t const number, std::string& playername) {
 		}
 	}
 
-	//  Send the tribe information to the new client.
+	send_game_settings(client);
+
+	// Broadcast new information about the player to everybody
+	broadcast_setting_user(client.usernum);
+
+	// Check if there is an unoccupied player left and if, assign.
+	for (uint8_t i = 0; i < d->settings.players.size(); ++i) {
+		if (d->settings.players.at(i).state == PlayerSettings::State::kOpen) {
+			switch_to_player(client.usernum, i);
+			break;
+		}
+	}
+
+	send_system_message_code("CLIENT_HAS_JOINED_GAME", effective_name);
+}
+
+/**
+ * Let a player who lost the connection to the running game take over their
+ * player again.
+ *
+ * The client receives a snapshot of our game as it is right now, together with
+ * the state of the random number generator and the sync state. The savegame
+ * contains the player commands that are already queued, and loading it gives
+ * exactly the state of the running game. The client then catches up with the
+ * game on its own, so the other players don't need to wait for it.
+ */
+void GameHost::rejoin_client(uint32_t const number, const std::string& playername) {
+	assert(d->game != nullptr);
+	assert(number < d->clients.size());
+
+	Client& client = d->clients.at(number);
+	assert(client.playernum == UserSettings::not_connected());
+	assert(client.sock_id > 0);
+
+	const auto rejoinable = d->rejoinable_players.find(playername);
+	if (rejoinable == d->rejoinable_players.end()) {
+		throw DisconnectException("GAME_ALREADY_STARTED");
+	}
+	const uint8_t playernum = rejoinable->second;
+	for (const Widelands::PlayerEndStatus& status :
+	     d->game->player_manager()->get_players_end_status()) {
+		if (status.player == playernum + 1) {
+			throw DisconnectException("GAME_ALREADY_STARTED");
+		}
+	}
+	for (uint32_t i = 1; i < d->settings.users.size(); ++i) {
+		if (d->settings.users.at(i).name == playername &&
+		    d->settings.users.at(i).position == UserSettings::not_connected()) {
+			client.usernum = i;
+			break;
+		}
+	}
+	if (client.usernum == -1) {
+		throw DisconnectException("GAME_ALREADY_STARTED");
+	}
+	std::shared_ptr<NetTransferFile> snapshot =
+	   prepare_snapshot_transfer(*d->game, kRejoinSnapshotSuffix);
+	if (!snapshot) {
+		log_err("[Host]: No snapshot for rejoining client %u\n", number);
+		throw DisconnectException("SNAPSHOT_FAILED");
+	}
+	const Time snapshot_time = d->game->get_gametime();
+	d->rejoinable_players.erase(rejoinable);
+	client.playernum = UserSettings::none();
+	client.rejoining = true;
+	client.time = snapshot_time;
+	// The client can only read the broadcast stream from its next reset on
+	d->commands.reset();
+	d->settings.users.at(client.usernum).position = UserSettings::none();
+
+	log_info("[Host]: Client %u: rejoins the game as usernum %u\n", number, client.usernum);
+
+	SendPacket packet;
+	packet.unsigned_8(NETCMD_HELLO);
+	packet.unsigned_8(NETWORK_PROTOCOL_VERSION);
+	packet.unsigned_32(client.usernum);
+	d->net->send(client.sock_id, packet);
+
+	// Take the player back from the computer player that replaced it
+	Widelands::Player* player = d->game->get_player(playernum + 1);
+	if (!player->get_ai().empty()) {
+		for (auto it = d->computerplayers.begin(); it != d->computerplayers.end(); ++it) {
+			if ((*it)->player_number() == playernum + 1) {
+				delete *it;
+				d->computerplayers.erase(it);
+				break;
+			}
+		}
+		player->set_ai("");
+		set_player_ai(playernum, "", false);
+		set_player_state(playernum, PlayerSettings::State::kOpen);
+	}
+	switch_to_player(client.usernum, playernum);
+	client.snapshot = snapshot;
+
+	// The client loads the snapshot as a savegame
 	packet.reset();
+	packet.unsigned_8(NETCMD_SETTING_MAP);
+	packet.string(d->settings.mapname);
+	packet.string(client.snapshot->filename);
+	packet.string(d->settings.map_theme);
+	packet.string(d->settings.map_background);
+	packet.unsigned_8(1);
+	packet.unsigned_8(d->settings.scenario ? 1 : 0);
+	d->net->send(client.sock_id, packet);
+
+	send_game_settings(client);
+
+	packet.reset();
+	packet.unsigned_8(NETCMD_REJOIN);
+	packet.unsigned_32(snapshot_time.get());
+	d->game->rng().write_state(packet);
+	d->game->get_sync_state().write_state(packet);
+	d->net->send(client.sock_id, packet);
+	// The game may be paused, so we can't wait for the next time that we commit to
+	packet.reset();
+	packet.unsigned_8(NETCMD_TIME);
+	packet.unsigned_32(d->committed_networktime.get());
+	d->net->send(client.sock_id, packet);
+
+	packet.reset();
+	packet.unsigned_8(NETCMD_NEW_FILE_AVAILABLE);
+	packet.string(client.snapshot->filename);
+	packet.unsigned_32(client.snapshot->bytes);
+	packet.string(client.snapshot->md5sum);
+	d->net->send(client.sock_id, packet);
+
+	send_system_message_code("CLIENT_IS_REJOINING_GAME", playername);
+}
+
+/// Send the settings of the game that are not sent with a single command to a new client
+void GameHost::send_game_settings(const Client& client) {
+	//  Send the tribe information to the new client.
+	SendPacket packet;
 	packet.unsigned_8(NETCMD_SETTING_TRIBES);
 	packet.unsigned_8(d->settings.tribes.size());
 	for (const Widelands::TribeBasicInfo& tribe : d->settings.tribes) {
@@ -1775,19 +2030,6 @@ void GameHost::welcome_client(uint32_t const number, std::string& playername) {
 	packet.unsigned_8(NETCMD_CUSTOM_STARTING_POSITIONS);
 	packet.unsigned_8(d->settings.custom_starting_positions ? 1 : 0);
 	d->net->send(client.sock_id, packet);
-
-	// Broadcast new information about the player to everybody
-	broadcast_setting_user(client.usernum);
-
-	// Check if there is an unoccupied player left and if, assign.
-	for (uint8_t i = 0; i < d->settings.players.size(); ++i) {
-		if (d->settings.players.at(i).state == PlayerSettings::State::kOpen) {
-			switch_to_player(client.usernum, i);
-			break;
-		}
-	}
-
-	send_system_message_code("CLIENT_HAS_JOINED_GAME", effective_name);
 }
 
 void GameHost::committed_network_time(const Time& time) {
@@ -1813,7 +2055,8 @@ void GameHost::receive_client_time(uint32_t const number, const Time& time) {
 	if (d->committed_networktime < time) {
 		throw DisconnectException("SIMULATING_BEYOND_TIME");
 	}
-	if (d->syncreport_pending && !client.syncreport_arrived) {
+	if (d->syncreport_pending && !client.syncreport_arrived && !client.rejoining &&
+	    !client.spectator_relay) {
 		if (time > d->syncreport_time) {
 			throw DisconnectException("CLIENT_SYNC_REP_TIMEOUT");
 		}
@@ -1821,6 +2064,21 @@ void GameHost::receive_client_time(uint32_t const number, const Time& time) {
 
 	client.time = time;
 	log_info("[Host]: Client %i: Time %i\n", number, time.get());
+	if (d->networkspeed > 0 && !client.rejoining && !client.spectator_relay) {
+		d->lag_controller.report_lag(
+		   client.sock_id, (d->committed_networktime - time).get() * 1000 / d->networkspeed);
+	}
+
+	// A rejoining client has caught up once we would no longer consider it hung. It takes part
+	// in the sync reports from the next request on.
+	const Duration hang_tolerance(d->lag_controller.hang_tolerance() * d->networkspeed / 1000);
+	if (client.rejoining && !client.snapshot && !d->syncreport_pending &&
+	    d->committed_networktime - time <= hang_tolerance) {
+		client.rejoining = false;
+		log_info("[Host]: Client %i has caught up with the game\n", number);
+		send_system_message_code(
+		   "CLIENT_HAS_REJOINED_GAME", d->settings.users.at(client.usernum).name);
+	}
 
 	if (d->waiting) {
 		log_info("[Host]: Client %i reports time %i (networktime = %i) during hang\n", number,
@@ -1829,14 +2087,39 @@ void GameHost::receive_client_time(uint32_t const number, const Time& time) {
 	}
 }
 
+/**
+ * Measure the round trip times to the clients. The pings are sent right away
+ * and not as part of a batch, which would only be sent after the computer
+ * players have thought.
+ */
+void GameHost::send_rtt_pings() {
+	const uint32_t curtime = SDL_GetTicks();
+	if (curtime - d->last_rtt_ping < kRttPingInterval) {
+		return;
+	}
+	d->last_rtt_ping = curtime;
+	SendPacket packet;
+	packet.unsigned_8(NETCMD_PING);
+	for (Client& client : d->clients) {
+		if (client.playernum != UserSettings::not_connected() && client.ping_sent_at == 0) {
+			client.ping_sent_at = curtime;
+			d->net->send(client.sock_id, packet, NetPriority::kPing);
+		}
+	}
+}
+
 void GameHost::check_hung_clients() {
 	assert(d->game != nullptr);
 
 	int nrdelayed = 0;
 	int nrhung = 0;
+	const uint32_t hang_tolerance = d->lag_controller.hang_tolerance() * d->networkspeed / 1000;
 
 	for (uint32_t i = 0; i < d->clients.size(); ++i) {
-		if (d->clients.at(i).playernum == UserSettings::not_connected()) {
+		// Rejoining clients catch up on their own, and relays lag behind on purpose,
+		// so we don't wait for them
+		if (d->clients.at(i).playernum == UserSettings::not_connected() ||
+		    d->clients.at(i).rejoining || d->clients.at(i).spectator_relay) {
 			continue;
 		}
 
@@ -1848,7 +2131,7 @@ void GameHost::check_hung_clients() {
 		} else {
 			assert(d->game != nullptr);
 			++nrdelayed;
-			if (delta > Duration(5 * CLIENT_TIMESTAMP_INTERVAL * d->networkspeed / 1000)) {
+			if (delta > Duration(hang_tolerance)) {
 				log_info("[Host]: Client %i (%s) hung\n", i,
 				         d->settings.users.at(d->clients.at(i).usernum).name.c_str());
 				++nrhung;
@@ -1921,13 +2204,16 @@ void GameHost::broadcast_real_speed(uint32_t const speed) {
  * The immediate pausing (with the Pause key) is disabled completely in the
  * network games, as sudden pauses would be distracting to other players. A
  * hard interruption of the game can be achieved with the forced pause.
+ *
+ * Finally, the \ref LagController may limit the speed, so that the slowest
+ * client doesn't fall so far behind that everybody has to wait for it.
  */
 void GameHost::update_network_speed() {
 	uint32_t const oldnetworkspeed = d->networkspeed;
 
 	// First check if a pause was forced by the host
 	if (forced_pause_) {
-		d->networkspeed = 0;
+		d->desired_networkspeed = 0;
 	}
 
 	else {
@@ -1954,15 +2240,19 @@ void GameHost::update_network_speed() {
 			}
 		}
 
-		d->networkspeed = (speeds.size() % 2) ?
-		                     speeds.at(speeds.size() / 2) :
-		                     (speeds.at(speeds.size() / 2) + speeds.at((speeds.size() / 2) - 1)) / 2;
+		d->desired_networkspeed =
+		   (speeds.size() % 2) ?
+		      speeds.at(speeds.size() / 2) :
+		      (speeds.at(speeds.size() / 2) + speeds.at((speeds.size() / 2) - 1)) / 2;
 
-		if (d->networkspeed > std::numeric_limits<uint16_t>::max()) {
-			d->networkspeed = std::numeric_limits<uint16_t>::max();
+		if (d->desired_networkspeed > std::numeric_limits<uint16_t>::max()) {
+			d->desired_networkspeed = std::numeric_limits<uint16_t>::max();
 		}
 	}
 
+	// Don't go faster than the slowest client can follow
+	d->networkspeed = d->lag_controller.limit_speed(d->desired_networkspeed);
+
 	if (d->networkspeed != oldnetworkspeed && !d->waiting) {
 		broadcast_real_speed(d->networkspeed);
 	}
@@ -2007,7 +2297,8 @@ void GameHost::check_sync_reports() {
 	}
 
 	for (const Client& client : d->clients) {
-		if (client.playernum != UserSettings::not_connected() && !client.syncreport_arrived) {
+		if (client.playernum != UserSettings::not_connected() && !client.rejoining &&
+		    !client.spectator_relay && !client.syncreport_arrived) {
 			return;
 		}
 	}
@@ -2015,17 +2306,23 @@ void GameHost::check_sync_reports() {
 	d->syncreport_pending = false;
 	log_info("[Host]: comparing syncreports for time %i\n", d->syncreport_time.get());
 
+	bool in_sync = true;
 	for (uint32_t i = 0; i < d->clients.size(); ++i) {
 		Client& client = d->clients.at(i);
-		if (client.playernum == UserSettings::not_connected()) {
+		if (client.playernum == UserSettings::not_connected() || client.rejoining ||
+		    client.spectator_relay) {
 			continue;
 		}
 
 		if (client.syncreport != d->syncreport) {
+			in_sync = false;
+			const std::string difference = d->syncreport.describe_difference(client.syncreport);
 			log_err("[Host]: lost synchronization with client %u!\n"
 			        "I have:     %s\n"
-			        "Client has: %s\n",
-			        i, d->syncreport.str().c_str(), client.syncreport.str().c_str());
+			        "Client has: %s\n"
+			        "Desync between time %u and %u in: %s\n",
+			        i, d->syncreport.str().c_str(), client.syncreport.str().c_str(),
+			        d->last_synced_time.get(), d->syncreport_time.get(), difference.c_str());
 
 			d->game->save_syncstream(true);
 			// Create syncstream excerpt and add faulting player number
@@ -2033,6 +2330,9 @@ void GameHost::check_sync_reports() {
 
 			SendPacket packet;
 			packet.unsigned_8(NETCMD_INFO_DESYNC);
+			packet.unsigned_32(d->last_synced_time.get());
+			packet.unsigned_32(d->syncreport_time.get());
+			packet.string(difference);
 			broadcast(packet);
 
 			disconnect_client(i, "CLIENT_DESYNCED");
@@ -2042,12 +2342,15 @@ void GameHost::check_sync_reports() {
 			broadcast_real_speed(d->networkspeed);
 		}
 	}
+	if (in_sync) {
+		d->last_synced_time = d->syncreport_time;
+	}
 }
 
 void GameHost::sync_report_callback() {
 	assert(d->game->get_gametime() == d->syncreport_time);
 
-	d->syncreport = d->game->get_sync_hash();
+	d->syncreport = d->game->get_sync_digest();
 	d->syncreport_arrived = true;
 
 	check_sync_reports();
@@ -2063,14 +2366,19 @@ void GameHost::handle_network() {
 	Client peer;
 	assert(d->net != nullptr);
 	while (d->net->try_accept(&peer.sock_id)) {
-		// Should only happen if the game has not been started yet
-		assert(d->game == nullptr);
+		// During the game, only players who want to rejoin are accepted by handle_hello()
 		peer.playernum = UserSettings::not_connected();
 		peer.syncreport_arrived = false;
 		peer.desiredspeed = 1000;
 		peer.usernum = -1;  // == no user assigned for now.
 		peer.hung_since = 0;
 		peer.lastdelta = 0;
+		peer.receiving_file = false;
+		peer.file_next_part = 0;
+		peer.file_parts_acked = 0;
+		peer.rejoining = false;
+		peer.ping_sent_at = 0;
+		peer.spectator_relay = false;
 		d->clients.push_back(peer);
 	}
 
@@ -2110,6 +2418,8 @@ void GameHost::handle_network() {
 		}
 	}
 
+	send_file_parts();
+
 	// If a pause was forced or if the players all pause, send a ping regularly
 	// to keep the sockets up and running
 	if ((forced_pause_ || real_speed() == 0) && (time(nullptr) > (d->lastpauseping + 20))) {
@@ -2154,12 +2464,11 @@ void GameHost::handle_hello(uint32_t const client_num,
                             uint8_t const cmd,
                             Client& client,
                             RecvPacket& r) {
-	// Now we wait for the client to say Hi in the right language,
-	// unless the game has already started
-	if (d->game) {
-		throw DisconnectException("GAME_ALREADY_STARTED");
-	}
+	// Now we wait for the client to say Hi in the right language
 	if (cmd != NETCMD_HELLO) {
+		if (d->game) {
+			throw DisconnectException("GAME_ALREADY_STARTED");
+		}
 		throw ProtocolException(cmd);
 	}
 	uint8_t version = r.unsigned_8();
@@ -2170,6 +2479,10 @@ void GameHost::handle_hello(uint32_t const client_num,
 	std::string clientname = r.string();
 	client.build_id = r.string();
 
+	// Once the game has started, only players who lost their connection may come back
+	if (d->game) {
+		return rejoin_client(client_num, clientname);
+	}
 	welcome_client(client_num, clientname);
 }
 
@@ -2224,7 +2537,7 @@ void GameHost::handle_changeinit(Client& client, RecvPacket& r) {
 }
 
 void GameHost::handle_changeposition(Client& client, RecvPacket& r) {
-	if (!d->game) {
+	if (!d->game && !client.spectator_relay) {
 		uint8_t const pos = r.unsigned_8();
 		switch_to_player(client.usernum, pos);
 	}
@@ -2241,8 +2554,9 @@ void GameHost::handle_playercommmand(uint32_t const client_num, Client& client,
 	if (!d->game) {
 		throw DisconnectException("PLAYERCMD_WO_GAME");
 	}
-	Time time(r.unsigned_32());
-	Widelands::PlayerCommand* plcmd = Widelands::PlayerCommand::deserialize(r);
+	Widelands::CommandReader reader(r, client.commands);
+	const Time time = reader.time();
+	Widelands::PlayerCommand* plcmd = Widelands::PlayerCommand::deserialize(reader);
 	log_info("[Host]: Client %u (%u) sent player command %u for %u, time = %u\n", client_num,
 	         client.playernum, static_cast<unsigned int>(plcmd->id()), plcmd->sender(), time.get());
 	receive_client_time(client_num, time);
@@ -2253,11 +2567,16 @@ void GameHost::handle_playercommmand(uint32_t const client_num, Client& client,
 }
 
 void GameHost::handle_syncreport(uint32_t const client_num, Client& client, RecvPacket& r) {
+	if (d->game && (client.rejoining || client.spectator_relay)) {
+		// The client did not have the game when the request was sent, or it
+		// answers the request too late to be taken into account
+		return;
+	}
 	if (!d->game || !d->syncreport_pending || client.syncreport_arrived) {
 		throw DisconnectException("UNEXPECTED_SYNC_REP");
 	}
 	Time time(r.unsigned_32());
-	r.data(client.syncreport.data, 16);
+	client.syncreport.read(r);
 	client.syncreport_arrived = true;
 	receive_client_time(client_num, time);
 	check_sync_reports();
@@ -2285,17 +2604,52 @@ void GameHost::handle_speed(Client& client, RecvPacket& r) {
 	update_network_speed();
 }
 
-/** a new file should be uploaded to all players */
-void GameHost::handle_new_file(Client& client) {
-	if (!file_) {  // Do we have a file for sending?
+/// The client will pass the game on to spectators of its own
+void GameHost::handle_spectator_relay(Client& client) {
+	if (d->game) {
+		throw DisconnectException("GAME_ALREADY_STARTED");
+	}
+	if (client.spectator_relay) {
+		return;
+	}
+	client.spectator_relay = true;
+	log_info("[Host]: Client %i is a spectator relay\n", client.usernum);
+	// The relay must not block a player position
+	switch_to_player(client.usernum, UserSettings::none());
+}
+
+/// The file that is offered to the client: either the snapshot for rejoining or the map / savegame
+const NetTransferFile* GameHost::file_for(const Client& client) const {
+	return client.snapshot ? client.snapshot.get() : file_.get();
+}
+
+/** a client wants to receive the offered file, or some parts of it once more */
+void GameHost::handle_new_file(Client& client, RecvPacket& r) {
+	const NetTransferFile* file = file_for(client);
+	if (!file) {  // Do we have a file for sending?
 		throw DisconnectException("REQUEST_OF_N_E_FILE");
 	}
-	send_system_message_code(
-	   "STARTED_SENDING_FILE", file_->filename, d->settings.users.at(client.usernum).name);
-	// Send all parts to the interested client
-	for (size_t part = 0; part < file_->parts.size(); ++part) {
-		send_file_part(client.sock_id, part);
+	const uint32_t first_part = r.unsigned_32();
+	if (first_part >= file->number_of_parts() && first_part != 0) {
+		throw DisconnectException("REQUEST_OF_N_E_FILE");
+	}
+	if (client.receiving_file && first_part >= client.file_parts_acked &&
+	    first_part < client.file_next_part) {
+		// The part arrived corrupted. The client keeps the parts after it, so only this one is
+		// sent once more.
+		send_file_part(*d->net, client.sock_id, *file, first_part);
+		return;
+	}
+	// The parts are sent by send_file_parts()
+	const bool was_receiving = client.receiving_file;
+	client.receiving_file = true;
+	client.file_next_part = first_part;
+	client.file_parts_acked = first_part;
+	if (client.snapshot || was_receiving) {
+		return;
 	}
+	send_system_message_code(
+	   "STARTED_SENDING_FILE", file->filename, d->settings.users.at(client.usernum).name);
 	// Remember client as "currently receiving file"
 	d->settings.users[client.usernum].ready = false;
 	broadcast_setting_user(client.usernum);
@@ -2327,7 +2681,12 @@ void GameHost::handle_packet(uint32_t const client_num, RecvPacket& r) {
 
 	switch (cmd) {
 	case NETCMD_PONG:
-		log_info("[Host]: Client %u: got pong\n", client_num);
+		if (client.ping_sent_at != 0) {
+			d->lag_controller.report_rtt(client.sock_id, SDL_GetTicks() - client.ping_sent_at);
+			client.ping_sent_at = 0;
+		} else {
+			log_info("[Host]: Client %u: got pong\n", client_num);
+		}
 		break;
 
 	case NETCMD_SETTING_CHANGETRIBE:
@@ -2351,9 +2710,11 @@ void GameHost::handle_packet(uint32_t const client_num, RecvPacket& r) {
 	case NETCMD_SETSPEED:
 		return handle_speed(client, r);
 	case NETCMD_NEW_FILE_AVAILABLE:
-		return handle_new_file(client);
+		return handle_new_file(client, r);
 	case NETCMD_FILE_PART:
 		return handle_file_part(client, r);
+	case NETCMD_SPECTATOR_RELAY:
+		return handle_spectator_relay(client);
 
 	case NETCMD_SETTING_MAP:
 	case NETCMD_SETTING_PLAYER:
@@ -2375,44 +2736,69 @@ void GameHost::handle_packet(uint32_t const client_num, RecvPacket& r) {
 
 /** Handle uploading part of a file  */
 void GameHost::handle_file_part(Client& client, RecvPacket& r) {
-	if (!file_) {  // Do we have a file for sending
+	const NetTransferFile* file = file_for(client);
+	if (!file) {  // Do we have a file for sending
 		throw DisconnectException("REQUEST_OF_N_E_FILE");
 	}
 	uint32_t part = r.unsigned_32();
 	std::string md5sum = r.string();
-	if (md5sum != file_->md5sum) {
+	if (md5sum != file->md5sum) {
 		log_err("[Host]: File transfer checksum mismatch %s != %s\n", md5sum.c_str(),
-		        file_->md5sum.c_str());
+		        file->md5sum.c_str());
 		return;  // Surely the file was changed, so we cancel here.
 	}
-	if (part >= file_->parts.size()) {
+	if (part >= file->parts.size()) {
 		log_warn(
 		   "[Host]: Warning: Client reports to have received file part %u but we only have %" PRIuS
 		   "\n",
-		   part, file_->parts.size());
+		   part, file->parts.size());
 		return;
 	}
-	if (part == file_->parts.size() - 1) {
+	if (!client.receiving_file || part != client.file_parts_acked) {
+		// Confirmation of a part that was sent before the client requested a resend
+		return;
+	}
+	++client.file_parts_acked;
+	if (part == file->parts.size() - 1) {
+		client.receiving_file = false;
+		if (client.snapshot) {
+			// The client has everything to load the game now
+			client.snapshot.reset();
+			SendPacket packet;
+			packet.unsigned_8(NETCMD_LAUNCH);
+			d->net->send(client.sock_id, packet);
+			return;
+		}
 		send_system_message_code(
-		   "COMPLETED_FILE_TRANSFER", file_->filename, d->settings.users.at(client.usernum).name);
+		   "COMPLETED_FILE_TRANSFER", file->filename, d->settings.users.at(client.usernum).name);
 		d->settings.users[client.usernum].ready = true;
 		broadcast_setting_user(client.usernum);
 	}
 }
 
-void GameHost::send_file_part(NetHostInterface::ConnectionId csock_id, uint32_t part) {
-	assert(part < file_->parts.size());
-
-	uint32_t left = file_->bytes - NETFILEPARTSIZE * part;
-	uint32_t size = (left > NETFILEPARTSIZE) ? NETFILEPARTSIZE : left;
-
-	// Send the part
-	SendPacket packet;
-	packet.unsigned_8(NETCMD_FILE_PART);
-	packet.unsigned_32(part);
-	packet.unsigned_32(size);
-	packet.data(file_->parts[part].part, size);
-	d->net->send(csock_id, packet, NetPriority::kFiletransfer);
+/**
+ * Send the next file parts to all clients that are receiving the file.
+ *
+ * The parts are interleaved between the clients, and only a limited number of
+ * parts may be unconfirmed per client. So a client with a slow connection does
+ * not delay the transfer to the other clients.
+ */
+void GameHost::send_file_parts() {
+	for (uint32_t round = 0; round < kFileTransferWindow; ++round) {
+		bool sent = false;
+		for (Client& client : d->clients) {
+			const NetTransferFile* file = file_for(client);
+			if (!file || !client.receiving_file || client.file_next_part >= file->parts.size() ||
+			    client.file_next_part - client.file_parts_acked >= kFileTransferWindow) {
+				continue;
+			}
+			send_file_part(*d->net, client.sock_id, *file, client.file_next_part++);
+			sent = true;
+		}
+		if (!sent) {
+			return;
+		}
+	}
 }
 
 void GameHost::disconnect_player_controller(uint8_t const number, const std::string& name) {
@@ -2448,12 +2834,18 @@ void GameHost::disconnect_client(uint32_t const client_number,
 
 	// If the client is linked to a player and it is the client that closes the connection
 	// and the game has already started ...
-	if (client.playernum != UserSettings::none() && reason != "SERVER_LEFT" && d->game != nullptr) {
+	if (client.playernum <= UserSettings::highest_playernum() && reason != "SERVER_LEFT" &&
+	    d->game != nullptr) {
 		// And the client hasn't lost/won yet ...
 		if (d->settings.users.at(client.usernum).result == Widelands::PlayerEndResult::kUndefined) {
-			// If not shown yet, show a window and ask the host player what to do
-			// with the tribe of the leaving client
-			if (d->game->get_igbase()->show_game_client_disconnected()) {
+			// The player may come back later
+			d->rejoinable_players[d->settings.users.at(client.usernum).name] = client.playernum;
+			if (headless_) {
+				// There is nobody to ask, so we let the AI take over
+				replace_client_with_ai(client.playernum, AI::DefaultAI::normal_impl.name);
+			} else if (d->game->get_igbase()->show_game_client_disconnected()) {
+				// If not shown yet, show a window and ask the host player what to do
+				// with the tribe of the leaving client
 				// Window has just been opened, pause game and create a save game
 				if (!forced_pause()) {
 					force_pause();
@@ -2496,6 +2888,7 @@ void GameHost::disconnect_client(uint32_t const client_number,
 	log_warn("[Host]: disconnect_client(%u, %s, %s)\n", client_number, reason.c_str(), arg.c_str());
 
 	if (client.sock_id > 0) {
+		d->lag_controller.remove_client(client.sock_id);
 		if (sendreason) {
 			SendPacket packet;
 			packet.unsigned_8(NETCMD_DISCONNECT);
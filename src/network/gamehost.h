@@ -44,9 +44,18 @@ struct GameHost : public GameController {
 	static constexpr uint8_t kSpectatorPlayerNum = 0;
 
 	GameHost(const std::string& playername, bool internet = false);
+	/// Creates a LAN host without any user interface that listens on the given
+	/// port. The host itself is only a spectator.
+	GameHost(const std::string& playername, uint16_t port);
 	~GameHost() override;
 
+	/// Runs the game setup screen, followed by the game.
 	void run();
+	/// Runs the game with the current settings.
+	void run_game();
+	/// Games without user interface are over once the given gametime is
+	/// reached, or after all clients have left.
+	void set_headless_end_time(const Time& time);
 	const std::string& get_local_playername() const;
 	int16_t get_local_playerposition();
 
@@ -61,6 +70,8 @@ struct GameHost : public GameController {
 	void set_desired_speed(uint32_t speed) override;
 	bool is_paused() override;
 	void set_paused(bool paused) override;
+	bool is_headless_game_over() override;
+	std::string network_status() override;
 	// End GameController interface
 
 	// Pregame-related stuff
@@ -123,6 +134,8 @@ struct GameHost : public GameController {
 	}
 
 private:
+	GameHost(const std::string& playername, bool internet, uint16_t port, bool headless);
+
 	void send_system_message_code(const std::string&,
 	                              const std::string& a = "",
 	                              const std::string& b = "",
@@ -148,20 +161,25 @@ private:
 	void handle_syncreport(uint32_t client_num, Client& client, RecvPacket& r);
 	void handle_chat(Client& client, RecvPacket& r);
 	void handle_speed(Client& client, RecvPacket& r);
-	void handle_new_file(Client& client);
+	void handle_new_file(Client& client, RecvPacket& r);
 	void handle_file_part(Client& client, RecvPacket& r);
+	void handle_spectator_relay(Client& client);
 
 	void handle_packet(uint32_t i, RecvPacket&);
 	void handle_network();
-	void send_file_part(NetHostInterface::ConnectionId client_sock_id, uint32_t part);
+	const NetTransferFile* file_for(const Client& client) const;
+	void send_file_parts();
 
 	void check_hung_clients();
+	void send_rtt_pings();
 	void broadcast_real_speed(uint32_t speed);
 	void update_network_speed();
 
 	std::string get_computer_player_name(uint8_t playernum);
 	bool has_user_name(const std::string& name, uint8_t ignoreplayer = UserSettings::none());
 	void welcome_client(uint32_t number, std::string& playername);
+	void rejoin_client(uint32_t number, const std::string& playername);
+	void send_game_settings(const Client& client);
 	void committed_network_time(const Time& time);
 	void receive_client_time(uint32_t number, const Time& time);
 
@@ -185,6 +203,12 @@ private:
 	std::unique_ptr<NetTransferFile> file_;
 	GameHostImpl* d;
 	bool internet_;
+	uint16_t port_;
+	// Whether there is no user interface and we are only a spectator
+	bool headless_;
+	Time headless_end_time_;
+	// Whether a headless game had any clients at all
+	bool headless_had_clients_;
 	bool forced_pause_;  // triggered by the forcePause host chat command, see HostChatProvider in
 	                     // gamehost.cc
 };
@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2020 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "network/lag_controller.h"
+
+#include <algorithm>
+
+#include "network/network_protocol.h"
+
+namespace {
+
+/// The host never waits for a client that lags behind by less than this
+constexpr uint32_t kMinimumHangTolerance = 5 * CLIENT_TIMESTAMP_INTERVAL;
+
+/// The speed is adjusted at most this often
+constexpr uint32_t kAdjustmentInterval = 1000;
+
+/// The speed limit never goes below this. Clients that can't even manage this are left to
+/// the hang detection.
+constexpr uint32_t kMinimumSpeed = 250;
+
+/// Weight of a new sample in the smoothed values, as 1 / x
+constexpr uint32_t kRttSmoothing = 8;
+constexpr uint32_t kDeviationSmoothing = 4;
+constexpr uint32_t kLagSmoothing = 4;
+
+uint32_t smooth(uint32_t value, uint32_t sample, uint32_t weight) {
+	return (value * (weight - 1) + sample) / weight;
+}
+
+}  // namespace
+
+LagController::LagController() : speed_limit_(0), last_adjustment_(0) {
+}
+
+void LagController::report_rtt(ClientId client, uint32_t rtt) {
+	Statistics& statistics = clients_[client];
+	if (!statistics.has_rtt) {
+		statistics.has_rtt = true;
+		statistics.rtt = rtt;
+		statistics.rtt_deviation = rtt / 2;
+		return;
+	}
+	const uint32_t deviation = rtt > statistics.rtt ? rtt - statistics.rtt : statistics.rtt - rtt;
+	statistics.rtt_deviation = smooth(statistics.rtt_deviation, deviation, kDeviationSmoothing);
+	statistics.rtt = smooth(statistics.rtt, rtt, kRttSmoothing);
+}
+
+void LagController::report_lag(ClientId client, uint32_t lag) {
+	Statistics& statistics = clients_[client];
+	statistics.lag = statistics.has_lag ? smooth(statistics.lag, lag, kLagSmoothing) : lag;
+	statistics.has_lag = true;
+}
+
+void LagController::remove_client(ClientId client) {
+	clients_.erase(client);
+}
+
+uint32_t LagController::hang_tolerance() const {
+	// The reported times are always at least one round trip old, and the clients send them
+	// only every CLIENT_TIMESTAMP_INTERVAL
+	uint32_t tolerance = kMinimumHangTolerance;
+	for (const auto& client : clients_) {
+		const Statistics& statistics = client.second;
+		tolerance = std::max(tolerance, statistics.rtt + 4 * statistics.rtt_deviation +
+		                                   2 * CLIENT_TIMESTAMP_INTERVAL);
+	}
+	return tolerance;
+}
+
+uint32_t LagController::excess_lag(const Statistics& statistics) const {
+	return statistics.lag > statistics.rtt ? statistics.lag - statistics.rtt : 0;
+}
+
+const LagController::Statistics* LagController::slowest_client(ClientId* id) const {
+	const Statistics* slowest = nullptr;
+	for (const auto& client : clients_) {
+		if (!client.second.has_lag) {
+			continue;
+		}
+		if (slowest == nullptr || excess_lag(client.second) > excess_lag(*slowest)) {
+			slowest = &client.second;
+			if (id != nullptr) {
+				*id = client.first;
+			}
+		}
+	}
+	return slowest;
+}
+
+bool LagController::think(uint32_t now, uint32_t desired_speed) {
+	if (now - last_adjustment_ < kAdjustmentInterval) {
+		return false;
+	}
+	last_adjustment_ = now;
+
+	const Statistics* slowest = slowest_client();
+	if (slowest == nullptr || desired_speed == 0) {
+		return false;
+	}
+
+	// The room that the slowest client has before the host has to wait for it
+	const uint32_t headroom = hang_tolerance() - std::min(slowest->rtt, hang_tolerance());
+	const uint32_t excess = excess_lag(*slowest);
+	const uint32_t old_limit = speed_limit_;
+	const uint32_t speed = limit_speed(desired_speed);
+
+	if (excess > headroom / 2) {
+		// Slow down before the client stalls and makes everybody wait
+		if (speed > kMinimumSpeed) {
+			speed_limit_ = std::max(kMinimumSpeed, speed * 3 / 4);
+		}
+	} else if (speed_limit_ != 0 && excess < headroom / 4) {
+		// The client keeps up easily, so we carefully speed up again
+		speed_limit_ += std::max<uint32_t>(speed_limit_ / 10, 100);
+		if (speed_limit_ >= desired_speed) {
+			speed_limit_ = 0;
+		}
+	}
+	return speed_limit_ != old_limit;
+}
+
+uint32_t LagController::limit_speed(uint32_t desired_speed) const {
+	return speed_limit_ != 0 ? std::min(desired_speed, speed_limit_) : desired_speed;
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2020 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#ifndef WL_NETWORK_LAG_CONTROLLER_H
+#define WL_NETWORK_LAG_CONTROLLER_H
+
+#include <map>
+
+#include <cstdint>
+
+/**
+ * Decides how the host of a network game copes with the latency of its clients.
+ *
+ * The host measures the round trip time to each client, and how far the
+ * simulation of each client trails behind the committed network time. From
+ * these, the controller derives
+ *  - how far the committed network time may lead a client before the host
+ *    considers it hung and waits for it, and
+ *  - the game speed that the slowest client can follow without falling that
+ *    far behind.
+ *
+ * Latency alone never slows the game down, it only makes the host more
+ * patient. The speed is only reduced for clients that fall behind by more
+ * than their latency explains, before they make the host wait for everybody.
+ *
+ * All durations are in milliseconds of real time.
+ */
+class LagController {
+public:
+	/// Identifies a client, e.g. by its connection id
+	using ClientId = uint8_t;
+
+	/// What is known about the connection to a client
+	struct Statistics {
+		/// Smoothed round trip time
+		uint32_t rtt = 0;
+		/// Smoothed mean deviation of the round trip time
+		uint32_t rtt_deviation = 0;
+		/// Smoothed time that the client trails behind the committed network time
+		uint32_t lag = 0;
+		bool has_rtt = false;
+		bool has_lag = false;
+	};
+
+	LagController();
+
+	/// A ping to the client was answered after \p rtt.
+	void report_rtt(ClientId client, uint32_t rtt);
+
+	/// The client reported a game time that is \p lag behind the committed network time.
+	void report_lag(ClientId client, uint32_t lag);
+
+	/// Forgets everything about the client.
+	void remove_client(ClientId client);
+
+	/**
+	 * Adjusts the speed limit to the statistics of the clients.
+	 * \param now The current time
+	 * \param desired_speed The speed that the players would like to play at
+	 * \return Whether \ref limit_speed() has changed
+	 */
+	bool think(uint32_t now, uint32_t desired_speed);
+
+	/// How far the committed network time may lead the slowest client before it counts as hung.
+	uint32_t hang_tolerance() const;
+
+	/// The speed to play at when the players desire \p desired_speed.
+	uint32_t limit_speed(uint32_t desired_speed) const;
+
+	/// The client that is closest to stalling, or \c nullptr if there is none.
+	const Statistics* slowest_client(ClientId* client = nullptr) const;
+
+private:
+	/// How far the client lags behind by more than its latency explains
+	uint32_t excess_lag(const Statistics& statistics) const;
+
+	std::map<ClientId, Statistics> clients_;
+	/// The highest speed that the clients can follow, 0 if there is no limit
+	uint32_t speed_limit_;
+	uint32_t last_adjustment_;
+};
+
+#endif  // end of include guard: WL_NETWORK_LAG_CONTROLLER_H
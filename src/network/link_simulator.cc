@@ -0,0 +1,348 @@
+/*
+ * Copyright (C) 2020 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "network/link_simulator.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "base/log.h"
+#include "network/network_protocol.h"
+
+namespace {
+
+/// TCP waits at least this long (in ms) before it sends lost data again
+constexpr uint32_t kMinimumRetransmissionDelay = 200;
+
+/// Large enough for any packet of the in-game network protocol
+constexpr size_t kReadBufferSize = 4096;
+
+uint32_t ticks() {
+	static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	return std::chrono::duration_cast<std::chrono::milliseconds>(
+	          std::chrono::steady_clock::now() - start)
+	   .count();
+}
+
+uint32_t read_u32(const uint8_t* data) {
+	return data[0] | (data[1] << 8) | (data[2] << 16) | (static_cast<uint32_t>(data[3]) << 24);
+}
+
+uint32_t average(uint64_t sum, uint32_t count) {
+	return count > 0 ? sum / count : 0;
+}
+
+}  // namespace
+
+LinkSimulator::LinkSimulator(uint16_t listen_port,
+                             uint16_t host_port,
+                             const LinkConditions& conditions,
+                             uint32_t seed)
+   : acceptor_(io_service_), host_port_(host_port), conditions_(conditions) {
+	rng_.seed(seed);
+	const boost::asio::ip::tcp::endpoint endpoint(boost::asio::ip::address_v4::loopback(),
+	                                              listen_port);
+	acceptor_.open(endpoint.protocol());
+	acceptor_.set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
+	acceptor_.bind(endpoint);
+	acceptor_.listen();
+	acceptor_.non_blocking(true);
+	log_info("[LinkSimulator] Forwarding port %u to port %u with latency %u ms, jitter %u ms, "
+	         "bandwidth %u B/s, loss %u%%\n",
+	         listen_port, host_port, conditions_.latency, conditions_.jitter,
+	         conditions_.bandwidth, conditions_.loss);
+}
+
+LinkSimulator::~LinkSimulator() {
+	const uint32_t now = ticks();
+	for (std::unique_ptr<Link>& link : links_) {
+		close(*link, now);
+	}
+}
+
+void LinkSimulator::think() {
+	const uint32_t now = ticks();
+	accept(now);
+	for (std::unique_ptr<Link>& link : links_) {
+		if (!link->open) {
+			continue;
+		}
+		if (!receive(link->client, *link, link->to_host, true, now) ||
+		    !receive(link->host, *link, link->to_client, false, now) ||
+		    !deliver(link->host, *link, link->to_host, true, now) ||
+		    !deliver(link->client, *link, link->to_client, false, now)) {
+			close(*link, now);
+		}
+	}
+}
+
+void LinkSimulator::accept(uint32_t now) {
+	for (;;) {
+		std::unique_ptr<Link> link(new Link(io_service_));
+		boost::system::error_code ec;
+		acceptor_.accept(link->client, ec);
+		if (ec) {
+			if (ec != boost::asio::error::would_block && ec != boost::asio::error::try_again) {
+				log_warn("[LinkSimulator] Error when accepting a client: %s\n", ec.message().c_str());
+			}
+			return;
+		}
+
+		link->host.connect(
+		   boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4::loopback(), host_port_), ec);
+		if (ec) {
+			log_warn("[LinkSimulator] Unable to connect to the host: %s\n", ec.message().c_str());
+			continue;
+		}
+		for (boost::asio::ip::tcp::socket* socket : {&link->client, &link->host}) {
+			socket->non_blocking(true);
+			socket->set_option(boost::asio::ip::tcp::no_delay(true), ec);
+		}
+		link->statistics.connected_at = now;
+		log_info("[LinkSimulator] Link %u connected\n", static_cast<unsigned>(links_.size() + 1));
+		links_.push_back(std::move(link));
+	}
+}
+
+bool LinkSimulator::receive(boost::asio::ip::tcp::socket& from,
+                            Link& link,
+                            Direction& direction,
+                            bool to_host,
+                            uint32_t now) {
+	uint8_t buffer[kReadBufferSize];
+	for (;;) {
+		boost::system::error_code ec;
+		const size_t size = from.read_some(boost::asio::buffer(buffer, sizeof(buffer)), ec);
+		if (ec == boost::asio::error::would_block || ec == boost::asio::error::try_again) {
+			return true;
+		}
+		if (ec || size == 0) {
+			return false;
+		}
+		direction.bytes += size;
+
+		// Time that the data occupies the simulated link
+		uint32_t start = std::max(now, direction.transmitted_until);
+		if (conditions_.bandwidth > 0) {
+			start += static_cast<uint64_t>(size) * 1000 / conditions_.bandwidth;
+		}
+		direction.transmitted_until = start;
+
+		uint32_t due = start + conditions_.latency;
+		if (conditions_.jitter > 0) {
+			due += rng_.rand() % (conditions_.jitter + 1);
+		}
+		if (conditions_.loss > 0 && rng_.rand() % 100 < conditions_.loss) {
+			due += std::max(kMinimumRetransmissionDelay, 2 * conditions_.latency);
+		}
+		// TCP delivers in order, so nothing can overtake data that has been lost
+		due = std::max(due, direction.last_due);
+		direction.last_due = due;
+
+		direction.chunks.push_back(Chunk{due, 0, std::vector<uint8_t>(buffer, buffer + size)});
+
+		// The times that the host announces are known to it as soon as it sends them
+		if (!to_host) {
+			scan(link, direction, false, buffer, size, now);
+		}
+	}
+}
+
+bool LinkSimulator::deliver(boost::asio::ip::tcp::socket& to,
+                            Link& link,
+                            Direction& direction,
+                            bool to_host,
+                            uint32_t now) {
+	while (!direction.chunks.empty() && direction.chunks.front().due <= now) {
+		Chunk& chunk = direction.chunks.front();
+		boost::system::error_code ec;
+		chunk.written += to.write_some(
+		   boost::asio::buffer(chunk.data.data() + chunk.written, chunk.data.size() - chunk.written),
+		   ec);
+		if (ec == boost::asio::error::would_block || ec == boost::asio::error::try_again) {
+			return true;
+		}
+		if (ec) {
+			return false;
+		}
+		if (chunk.written < chunk.data.size()) {
+			return true;
+		}
+		// The replies of the clients are measured when they reach the host
+		if (to_host) {
+			scan(link, direction, true, chunk.data.data(), chunk.data.size(), now);
+		}
+		direction.chunks.pop_front();
+	}
+	return true;
+}
+
+void LinkSimulator::scan(Link& link,
+                         Direction& direction,
+                         bool to_host,
+                         const uint8_t* data,
+                         size_t size,
+                         uint32_t now) {
+	std::vector<uint8_t>& packet = direction.incomplete_packet;
+	packet.insert(packet.end(), data, data + size);
+
+	// Packets start with their big endian length, which includes the length itself
+	size_t offset = 0;
+	while (packet.size() - offset >= 3) {
+		const size_t length = (packet[offset] << 8) | packet[offset + 1];
+		if (length < 3) {
+			// Not the in-game protocol, so there is nothing to learn here
+			log_warn("[LinkSimulator] Invalid packet length %u\n", static_cast<unsigned>(length));
+			packet.clear();
+			return;
+		}
+		if (packet.size() - offset < length) {
+			break;
+		}
+		observe(link, to_host, packet[offset + 2], &packet[offset + 3], length - 3, now);
+		offset += length;
+	}
+	packet.erase(packet.begin(), packet.begin() + offset);
+}
+
+void LinkSimulator::observe(
+   Link& link, bool to_host, uint8_t cmd, const uint8_t* payload, size_t size, uint32_t now) {
+	Statistics& statistics = link.statistics;
+	if (to_host) {
+		// The time in NETCMD_PLAYERCOMMAND is relative to the command stream, so
+		// we only look at the explicit time reports
+		switch (cmd) {
+		case NETCMD_TIME:
+			if (size >= 4 && statistics.launched) {
+				const uint32_t time = read_u32(payload);
+				const uint32_t lag = link.networktime > time ? link.networktime - time : 0;
+				++statistics.time_reports;
+				statistics.time_lag_sum += lag;
+				statistics.time_lag_max = std::max(statistics.time_lag_max, lag);
+			}
+			break;
+		case NETCMD_SYNCREPORT:
+			if (size >= 4) {
+				auto request = link.sync_requests.find(read_u32(payload));
+				if (request != link.sync_requests.end()) {
+					const uint32_t roundtrip = now - request->second;
+					++statistics.sync_reports;
+					statistics.sync_roundtrip_sum += roundtrip;
+					statistics.sync_roundtrip_max = std::max(statistics.sync_roundtrip_max, roundtrip);
+					link.sync_requests.erase(link.sync_requests.begin(), ++request);
+				}
+				if (!statistics.synced) {
+					statistics.synced = true;
+					statistics.first_sync_at = now;
+				}
+			}
+			break;
+		default:
+			break;
+		}
+		return;
+	}
+
+	switch (cmd) {
+	case NETCMD_LAUNCH:
+		statistics.launched = true;
+		statistics.launched_at = now;
+		break;
+	case NETCMD_TIME:
+		if (size >= 4) {
+			link.networktime = std::max(link.networktime, read_u32(payload));
+		}
+		break;
+	case NETCMD_SYNCREQUEST:
+		if (size >= 4) {
+			const uint32_t time = read_u32(payload);
+			link.networktime = std::max(link.networktime, time);
+			link.sync_requests[time] = now;
+		}
+		break;
+	case NETCMD_WAIT:
+		++statistics.waits;
+		break;
+	case NETCMD_SETSPEED:
+		if (size >= 2 && statistics.launched) {
+			const bool paused = payload[0] == 0 && payload[1] == 0;
+			if (paused && !statistics.paused) {
+				statistics.paused = true;
+				statistics.paused_since = now;
+				++statistics.pauses;
+			} else if (!paused && statistics.paused) {
+				statistics.paused = false;
+				statistics.paused_ms += now - statistics.paused_since;
+			}
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+void LinkSimulator::close(Link& link, uint32_t now) {
+	if (!link.open) {
+		return;
+	}
+	link.open = false;
+	link.statistics.closed_at = now;
+	if (link.statistics.paused) {
+		link.statistics.paused = false;
+		link.statistics.paused_ms += now - link.statistics.paused_since;
+	}
+	boost::system::error_code ec;
+	link.client.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
+	link.client.close(ec);
+	link.host.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
+	link.host.close(ec);
+}
+
+void LinkSimulator::report() const {
+	const uint32_t now = ticks();
+	log_info("[LinkSimulator] Statistics for %u links:\n", static_cast<unsigned>(links_.size()));
+	for (size_t i = 0; i < links_.size(); ++i) {
+		const Link& link = *links_[i];
+		const Statistics& statistics = link.statistics;
+		const uint32_t end = link.open ? now : statistics.closed_at;
+		const uint32_t seconds = std::max<uint32_t>(1, (end - statistics.connected_at) / 1000);
+
+		log_info("  Link %u: up %u B/s, down %u B/s\n", static_cast<unsigned>(i + 1),
+		         static_cast<unsigned>(link.to_host.bytes / seconds),
+		         static_cast<unsigned>(link.to_client.bytes / seconds));
+		if (!statistics.launched) {
+			log_info("    The game was never launched\n");
+			continue;
+		}
+		if (statistics.synced) {
+			log_info("    Time to first sync report: %u ms after launch\n",
+			         statistics.first_sync_at - statistics.launched_at);
+		} else {
+			log_info("    No sync report was received\n");
+		}
+		log_info("    Sync round trip: %u ms average, %u ms maximum (%u reports)\n",
+		         average(statistics.sync_roundtrip_sum, statistics.sync_reports),
+		         statistics.sync_roundtrip_max, statistics.sync_reports);
+		log_info("    Lag behind network time: %u ms average, %u ms maximum (%u reports)\n",
+		         average(statistics.time_lag_sum, statistics.time_reports),
+		         statistics.time_lag_max, statistics.time_reports);
+		log_info("    Host waited %u times, paused %u times for %u ms in total\n",
+		         statistics.waits, statistics.pauses, statistics.paused_ms);
+	}
+}
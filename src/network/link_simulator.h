@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2020 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#ifndef WL_NETWORK_LINK_SIMULATOR_H
+#define WL_NETWORK_LINK_SIMULATOR_H
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <boost/asio.hpp>
+
+#include "base/macros.h"
+#include "base/random.h"
+
+/// Conditions of the simulated network link between each client and the host
+struct LinkConditions {
+	/// Delay in ms in each direction
+	uint32_t latency = 0;
+	/// Maximum additional random delay in ms
+	uint32_t jitter = 0;
+	/// Bytes per second in each direction, 0 means unlimited
+	uint32_t bandwidth = 0;
+	/// Percentage of the data that is lost and has to be sent again
+	uint32_t loss = 0;
+};
+
+/**
+ * Stands in for the relay between the clients and a \ref GameHost on this
+ * computer. Every client that connects to the listening port gets its own
+ * connection to the host, and the data in both directions is delayed
+ * according to the \ref LinkConditions.
+ *
+ * As the connections use TCP, lost data is not missing, but arrives late,
+ * together with everything that was sent after it.
+ *
+ * The simulator also reads the packets of the in-game network protocol, to
+ * find out how responsive the game is for each client.
+ */
+class LinkSimulator {
+public:
+	LinkSimulator(uint16_t listen_port,
+	              uint16_t host_port,
+	              const LinkConditions& conditions,
+	              uint32_t seed);
+	~LinkSimulator();
+
+	/// Accepts new clients and forwards all data that is due. Call this often.
+	void think();
+
+	/// Writes the statistics of all links to the log.
+	void report() const;
+
+private:
+	struct Chunk {
+		uint32_t due;
+		size_t written;
+		std::vector<uint8_t> data;
+	};
+
+	struct Direction {
+		/// Data that is still on its way
+		std::deque<Chunk> chunks;
+		/// When the link has finished transmitting the last chunk
+		uint32_t transmitted_until = 0;
+		/// When the last chunk arrives. Later chunks can't overtake it.
+		uint32_t last_due = 0;
+		/// The start of a packet that has not been received completely yet
+		std::vector<uint8_t> incomplete_packet;
+		uint64_t bytes = 0;
+	};
+
+	/// What a link has seen of the in-game network protocol
+	struct Statistics {
+		uint32_t connected_at = 0;
+		uint32_t closed_at = 0;
+		bool launched = false;
+		uint32_t launched_at = 0;
+		bool synced = false;
+		uint32_t first_sync_at = 0;
+		/// Round trips from a NETCMD_SYNCREQUEST to the matching NETCMD_SYNCREPORT, in ms
+		uint32_t sync_reports = 0;
+		uint64_t sync_roundtrip_sum = 0;
+		uint32_t sync_roundtrip_max = 0;
+		/// How far behind the network time a client's NETCMD_TIME is, in ms of gametime
+		uint32_t time_reports = 0;
+		uint64_t time_lag_sum = 0;
+		uint32_t time_lag_max = 0;
+		uint32_t waits = 0;
+		uint32_t pauses = 0;
+		uint32_t paused_ms = 0;
+		bool paused = false;
+		uint32_t paused_since = 0;
+	};
+
+	struct Link {
+		explicit Link(boost::asio::io_service& io_service) : client(io_service), host(io_service) {
+		}
+
+		boost::asio::ip::tcp::socket client;
+		boost::asio::ip::tcp::socket host;
+		Direction to_host;
+		Direction to_client;
+		bool open = true;
+
+		/// The latest network time that the host sent
+		uint32_t networktime = 0;
+		/// When the sync reports for the given gametimes were requested
+		std::map<uint32_t, uint32_t> sync_requests;
+		Statistics statistics;
+	};
+
+	void accept(uint32_t now);
+	bool receive(boost::asio::ip::tcp::socket& from,
+	             Link& link,
+	             Direction& direction,
+	             bool to_host,
+	             uint32_t now);
+	bool deliver(boost::asio::ip::tcp::socket& to,
+	             Link& link,
+	             Direction& direction,
+	             bool to_host,
+	             uint32_t now);
+	void scan(Link& link,
+	          Direction& direction,
+	          bool to_host,
+	          const uint8_t* data,
+	          size_t size,
+	          uint32_t now);
+	void observe(Link& link,
+	             bool to_host,
+	             uint8_t cmd,
+	             const uint8_t* payload,
+	             size_t size,
+	             uint32_t now);
+	void close(Link& link, uint32_t now);
+
+	boost::asio::io_service io_service_;
+	boost::asio::ip::tcp::acceptor acceptor_;
+	const uint16_t host_port_;
+	const LinkConditions conditions_;
+	RNG rng_;
+	std::vector<std::unique_ptr<Link>> links_;
+
+	DISALLOW_COPY_AND_ASSIGN(LinkSimulator);
+};
+
+#endif  // end of include guard: WL_NETWORK_LINK_SIMULATOR_H
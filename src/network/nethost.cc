@@ -99,6 +99,10 @@ bool NetHost::try_accept(ConnectionId* new_id) {
 	ConnectionId id = next_id_++;
 	assert(id > 0);
 	assert(clients_.count(id) == 0);
+	// New clients join the batch that is running, so that end_batch() matches up
+	for (uint32_t i = 0; i < batch_depth_; ++i) {
+		accept_queue_.front()->begin_batch();
+	}
 	clients_.insert(std::make_pair(id, std::move(accept_queue_.front())));
 	accept_queue_.pop();
 	assert(clients_.count(id) == 1);
@@ -129,9 +133,26 @@ void NetHost::send(const ConnectionId id, const SendPacket& packet, NetPriority
 	clients_.at(id)->send(priority, packet);
 }
 
-void NetHost::send(const std::vector<ConnectionId>& ids, const SendPacket& packet, NetPriority) {
+void NetHost::send(const std::vector<ConnectionId>& ids,
+                   const SendPacket& packet,
+                   NetPriority priority) {
 	for (ConnectionId id : ids) {
-		send(id, packet);
+		send(id, packet, priority);
+	}
+}
+
+void NetHost::begin_batch() {
+	++batch_depth_;
+	for (auto& client : clients_) {
+		client.second->begin_batch();
+	}
+}
+
+void NetHost::end_batch() {
+	assert(batch_depth_ > 0);
+	--batch_depth_;
+	for (auto& client : clients_) {
+		client.second->end_batch();
 	}
 }
 
@@ -167,7 +188,12 @@ void NetHost::start_accepting(
 }
 
 NetHost::NetHost(const uint16_t port)
-   : clients_(), next_id_(1), io_service_(), acceptor_v4_(io_service_), acceptor_v6_(io_service_) {
+   : clients_(),
+     next_id_(1),
+     batch_depth_(0),
+     io_service_(),
+     acceptor_v4_(io_service_),
+     acceptor_v6_(io_service_) {
 
 	if (open_acceptor(
 	       &acceptor_v4_, boost::asio::ip::tcp::endpoint(boost::asio::ip::tcp::v4(), port))) {
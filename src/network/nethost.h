@@ -56,6 +56,8 @@ public:
 	void send(const std::vector<ConnectionId>& ids,
 	          const SendPacket& packet,
 	          NetPriority priority = NetPriority::kNormal) override;
+	void begin_batch() override;
+	void end_batch() override;
 
 	/**
 	 * Stops listening for connections.
@@ -103,6 +105,8 @@ private:
 	std::map<NetHostInterface::ConnectionId, std::unique_ptr<BufferedConnection>> clients_;
 	/// The next client id that will be used
 	NetHostInterface::ConnectionId next_id_;
+	/// How many calls of begin_batch() are waiting for their end_batch()
+	uint32_t batch_depth_;
 	/// An io_service needed by boost.asio. Primary needed for async operations.
 	boost::asio::io_service io_service_;
 	/// The acceptor we get IPv4 connection requests to.
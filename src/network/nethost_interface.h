@@ -22,6 +22,7 @@
 
 #include <memory>
 
+#include "base/macros.h"
 #include "network/network.h"
 
 /**
@@ -95,6 +96,35 @@ public:
 	virtual void send(const std::vector<ConnectionId>& ids,
 	                  const SendPacket& packet,
 	                  NetPriority priority = NetPriority::kNormal) = 0;
+
+	/**
+	 * Starts collecting the packets that are sent, until \ref end_batch() is called.
+	 * All packets for a client are then sent together, which saves system calls
+	 * and network overhead compared to sending them one by one.
+	 * Batches can be nested, the packets are sent when the outermost batch ends.
+	 */
+	virtual void begin_batch() = 0;
+
+	/**
+	 * Ends a batch that was started with \ref begin_batch() and sends the collected packets.
+	 */
+	virtual void end_batch() = 0;
+};
+
+/// Collects everything that is sent through the given host during its lifetime into one batch.
+class NetBatch {
+public:
+	explicit NetBatch(NetHostInterface& net) : net_(net) {
+		net_.begin_batch();
+	}
+	~NetBatch() {
+		net_.end_batch();
+	}
+
+private:
+	NetHostInterface& net_;
+
+	DISALLOW_COPY_AND_ASSIGN(NetBatch);
 };
 
 #endif  // end of include guard: WL_NETWORK_NETHOST_INTERFACE_H
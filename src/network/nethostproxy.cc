@@ -119,6 +119,14 @@ void NetHostProxy::send(const std::vector<ConnectionId>& ids,
 	conn_->send(priority, RelayCommand::kToClients, active_ids, packet);
 }
 
+void NetHostProxy::begin_batch() {
+	conn_->begin_batch();
+}
+
+void NetHostProxy::end_batch() {
+	conn_->end_batch();
+}
+
 NetHostProxy::NetHostProxy(const std::pair<NetAddress, NetAddress>& addresses,
                            const std::string& name,
                            const std::string& password)
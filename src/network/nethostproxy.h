@@ -57,6 +57,8 @@ public:
 	void send(const std::vector<ConnectionId>& ids,
 	          const SendPacket& packet,
 	          NetPriority priority = NetPriority::kNormal) override;
+	void begin_batch() override;
+	void end_batch() override;
 
 private:
 	/**
@@ -186,9 +186,8 @@ void SendPacket::data(const void* const packet_data, const size_t size) {
 		// So if they are removed the protocol has to be updated
 	}
 
-	for (size_t idx = 0; idx < size; ++idx) {
-		buffer.push_back(static_cast<const uint8_t*>(packet_data)[idx]);
-	}
+	const uint8_t* const bytes = static_cast<const uint8_t*>(packet_data);
+	buffer.insert(buffer.end(), bytes, bytes + size);
 }
 
 void SendPacket::reset() {
@@ -218,9 +217,8 @@ size_t RecvPacket::data(void* const packet_data, size_t const bufsize) {
 		throw wexception("Packet too short");
 	}
 
-	for (size_t read = 0; read < bufsize; ++read) {
-		static_cast<uint8_t*>(packet_data)[read] = buffer[index_++];
-	}
+	memcpy(packet_data, buffer.data() + index_, bufsize);
+	index_ += bufsize;
 
 	return bufsize;
 }
@@ -229,6 +227,10 @@ bool RecvPacket::end_of_file() const {
 	return index_ < buffer.size();
 }
 
+void RecvPacket::copy_to(SendPacket* packet) const {
+	packet->data(buffer.data(), buffer.size());
+}
+
 DisconnectException::DisconnectException(const char* fmt, ...) {
 	char buffer[kNetworkBufferSize];
 	{
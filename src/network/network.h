@@ -21,6 +21,9 @@
 #define WL_NETWORK_NETWORK_H
 
 #include <functional>
+#include <map>
+#include <memory>
+#include <vector>
 
 #include <boost/asio.hpp>
 #include <boost/lexical_cast.hpp>
@@ -163,6 +166,10 @@ public:
 	size_t data(void* data, size_t bufsize) override;
 	bool end_of_file() const override;
 
+	/// Appends the whole packet, including the parts that have already been read,
+	/// to \p packet. Used to pass received packets on unchanged.
+	void copy_to(SendPacket* packet) const;
+
 private:
 	friend class BufferedConnection;
 	std::vector<uint8_t> buffer;
@@ -170,18 +177,38 @@ private:
 };
 
 struct FilePart {
-	char part[NETFILEPARTSIZE];
+	/// The length of the part before compression
+	uint32_t size;
+	bool compressed;
+	/// The checksum of the part before compression
+	uint64_t checksum;
+	std::vector<uint8_t> data;
 };
 
 struct NetTransferFile {
-	NetTransferFile() : bytes(0), filename(""), md5sum("") {
+	NetTransferFile() : bytes(0), filename(""), md5sum(""), next_part(0) {
 	}
 	~NetTransferFile() = default;
 
+	uint32_t number_of_parts() const {
+		return (bytes + NETFILEPARTSIZE - 1) / NETFILEPARTSIZE;
+	}
+
 	uint32_t bytes;
 	std::string filename;
 	std::string md5sum;
+
+	/// Only used by the host
 	std::vector<FilePart> parts;
+
+	/// Only used by the client: the parts that have been received so far are
+	/// written to a temp file, so that an interrupted transfer can be resumed.
+	std::string partial_filename;
+	std::unique_ptr<StreamWrite> partial;
+	uint32_t next_part;
+	/// Only used by the client: the parts that arrived after a corrupted part,
+	/// until that part has been sent once more
+	std::map<uint32_t, std::vector<uint8_t>> early_parts;
 };
 
 /**
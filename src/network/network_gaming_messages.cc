@@ -162,6 +162,10 @@ void NetworkGamingMessages::fill_map() {
 	ngmessages["DIFFERENT_WL_VERSION"] =
 	   _("WARNING: %1$s uses version: %2$s, while Host uses version: %3$s");
 	ngmessages["CLIENT_HAS_JOINED_GAME"] = _("%s has joined the game");
+	ngmessages["CLIENT_IS_REJOINING_GAME"] = _("%s is rejoining the game");
+	ngmessages["CLIENT_HAS_REJOINED_GAME"] = _("%s has caught up with the game");
+	ngmessages["SNAPSHOT_FAILED"] = _("The host was unable to save the running game.");
+	ngmessages["UNEXPECTED_REJOIN"] = _("Unexpectedly received REJOIN command from server.");
 	ngmessages["STARTED_SENDING_FILE"] = _("Started to send file %1$s to %2$s!");
 	ngmessages["COMPLETED_FILE_TRANSFER"] = _("Completed transfer of file %1$s to %2$s");
 	ngmessages["PLAYER_DEFEATED"] = _("The player ‘%s’ was defeated and became a spectator.");
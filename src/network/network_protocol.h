@@ -20,15 +20,15 @@
 #ifndef WL_NETWORK_NETWORK_PROTOCOL_H
 #define WL_NETWORK_NETWORK_PROTOCOL_H
 
-/// How many bytes will (maximal) be send as file part
-#define NETFILEPARTSIZE 511
+/// How many bytes of the file will (maximal) be send as file part, before compression
+#define NETFILEPARTSIZE 16384
 
 enum {
 	/**
 	 * The current version of the in-game network protocol. Client and host
 	 * protocol versions must match.
 	 */
-	NETWORK_PROTOCOL_VERSION = 24,
+	NETWORK_PROTOCOL_VERSION = 31,
 
 	/**
 	 * The default interval (in milliseconds) in which the host issues
@@ -108,9 +108,13 @@ enum {
 
 	/**
 	 * Bidirectional command: Player command. This command has the payload:
-	 * \li signed_32: game time
+	 * \li game time
 	 * \li serialized \ref Widelands::PlayerCommand
 	 *
+	 * Both are written with a \ref Widelands::CommandWriter. Each direction of
+	 * each connection is its own \ref Widelands::CommandStream, so these packets
+	 * must be decoded in the order in which they were sent.
+	 *
 	 * If sent by the host, the client must enqueue the given \ref PlayerCommand
 	 * with the sent game time as duetime. The host can send PlayerCommands for
 	 * very player in the game.
@@ -248,13 +252,13 @@ enum {
 	NETCMD_WAIT = 14,
 
 	/**
-	 * Sent by the host to request an MD5 synchronization hash. Payload is:
+	 * Sent by the host to request the synchronization checksums. Payload is:
 	 * \li signed_32: game time at which the hash must be taken
 	 *
 	 * The client must reply with a \ref NETCMD_SYNCREPORT command as soon
 	 * as the given game time has been reached on the client.
 	 *
-	 * \see Widelands::Game::get_sync_hash
+	 * \see Widelands::Game::get_sync_digest
 	 */
 	NETCMD_SYNCREQUEST = 15,
 
@@ -300,8 +304,9 @@ enum {
 	/**
 	 * Sent by the client to reply to a \ref NETCMD_SYNCREQUEST command,
 	 * with the following payload:
-	 * \li signed_32: game time at which the hash was taken
-	 * \li 16 bytes:  MD5 hash
+	 * \li signed_32: game time at which the checksums were taken
+	 * \li SyncDigest: the checksums of the parts of the simulation,
+	 *                 see \ref Widelands::SyncDigest
 	 *
 	 * It is solely the host's responsibility to act when desyncs are
 	 * detected.
@@ -327,8 +332,10 @@ enum {
 	NETCMD_CHAT = 21,
 
 	/**
-	 * Sent by the host to indicate that a desync has been detected. This command
-	 * has no payload.
+	 * Sent by the host to indicate that a desync has been detected. Payload is:
+	 * \li unsigned_32: game time of the last sync report that matched
+	 * \li unsigned_32: game time of the sync report that didn't match
+	 * \li string:      the parts of the simulation that diverged
 	 *
 	 * The only purpose of this command is to instruct clients to store data that
 	 * may be helpful for debugging. In particular, clients should not disconnect
@@ -346,6 +353,13 @@ enum {
 	 * \li string:      md5sum
 	 *
 	 * Sent by the client as answer on the same message of the host as request.
+	 * \li unsigned_32: number of the first part that the client needs. The parts
+	 *                  before it have been received by an earlier transfer.
+	 *
+	 * The client may send this again during the transfer. If the given part has
+	 * been sent but not confirmed yet, it arrived corrupted, and only this part
+	 * is sent once more. The client keeps the parts after it and confirms all
+	 * parts in order. Otherwise, the transfer goes on from the given part.
 	 */
 	NETCMD_NEW_FILE_AVAILABLE = 23,
 
@@ -354,11 +368,14 @@ enum {
 	 *
 	 * Attached data is:
 	 * \li unsigned_32: part number
-	 * \li unsigned_32: length of data (needed because last part might be shorter)
+	 * \li unsigned_32: length of the uncompressed part (the last part might be shorter)
+	 * \li unsigned_8:  1 if the data is compressed with zlib, else 0
+	 * \li unsigned_32: length of data
+	 * \li 2 * unsigned_32: checksum of the uncompressed part, see \ref FastHash
 	 * \li void[length of data]: data
 	 *
-	 * Sent by the client when the complete file has been received.
-	 * \li unsigned_32: number of the last received part
+	 * Sent by the client for every part that it has received and checked.
+	 * \li unsigned_32: number of the received part
 	 * \li string:      md5sum - to ensure client and host are talking about the same
 	 */
 	NETCMD_FILE_PART = 24,
@@ -444,6 +461,41 @@ enum {
 	 */
 	NETCMD_CUSTOM_STARTING_POSITIONS = 34,
 
+	/**
+	 * Sent by the host to a player who lost the connection to a running game
+	 * and connected again. Payload is:
+	 * \li unsigned_32: game time of the snapshot of the game
+	 * \li RNG state:   state of the random number generator at that time
+	 * \li SyncHasher:  state of the synchronization checksums at that time
+	 *
+	 * The snapshot is a savegame of the host's game at that time. It contains
+	 * the player commands that were already queued, so the client only gets the
+	 * \ref NETCMD_PLAYERCOMMAND commands that follow this command. The snapshot
+	 * is offered with \ref NETCMD_NEW_FILE_AVAILABLE. Until it has been loaded, the
+	 * client must keep the player commands that it receives, and it may ignore
+	 * \ref NETCMD_SYNCREQUEST commands. It must not write a replay, since the
+	 * replay would have to start from the snapshot. The host sends
+	 * \ref NETCMD_LAUNCH once the transfer is complete. The client then loads
+	 * the snapshot, restores the states from this command, applies the kept
+	 * player commands and catches up with the game as if a \ref NETCMD_WAIT
+	 * command had been sent. It must not send player commands before it has
+	 * caught up.
+	 */
+	NETCMD_REJOIN = 35,
+
+	/**
+	 * Sent by a client right after \ref NETCMD_HELLO, before the game is launched,
+	 * to announce that it is a spectator relay, see \ref SpectatorRelay. There is no payload.
+	 *
+	 * The host makes the client a spectator that can't take a player position. It
+	 * does not expect time and sync reports from the client during the game, since
+	 * the relay handles the game stream with a delay.
+	 *
+	 * The relay itself talks the in-game protocol to its own spectators, as if it
+	 * was the host of a running game: they join it like rejoining players.
+	 */
+	NETCMD_SPECTATOR_RELAY = 36,
+
 	/**
 	 * Sent by the metaserver to a freshly opened game to check connectability
 	 */
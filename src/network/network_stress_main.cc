@@ -0,0 +1,272 @@
+/*
+ * Copyright (C) 2020 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#ifdef _WIN32
+#error "The network stress test needs fork() and is not available on Windows"
+#endif
+
+#include <algorithm>
+#include <csignal>
+#include <memory>
+#include <vector>
+
+#include <SDL_timer.h>
+#include <boost/asio.hpp>
+#include <boost/format.hpp>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "ai/defaultai.h"
+#include "base/log.h"
+#include "base/spawn.h"
+#include "base/warning.h"
+#include "base/wexception.h"
+#include "build_info.h"
+#include "graphic/playercolor.h"
+#include "headless_environment.h"
+#include "io/filesystem/layered_filesystem.h"
+#include "io/profile.h"
+#include "network/constants.h"
+#include "network/dedicated_server.h"
+#include "network/gameclient.h"
+#include "network/link_simulator.h"
+#include "network/network.h"
+
+/**
+ * Plays a network game between AIs on this computer, with a simulated
+ * network between the clients and the host, and reports how the game coped
+ * with it.
+ *
+ * The host and every client run in their own process, because the game logic
+ * can only run once per process. The clients connect to a \ref LinkSimulator,
+ * which passes their data on to the host.
+ *
+ * The config file has a [stress] section with the keys
+ *  - map: filename of the map to play (mandatory)
+ *  - clients: the number of clients, default 2
+ *  - ai: the AI that plays for the clients, default "normal"
+ *  - win_condition: the win condition script, default endless game
+ *  - duration: minutes of gametime to play, default 10
+ *  - speed: the game speed in milliseconds per second, default 1000
+ *  - latency: delay of the link in ms in each direction, default 0
+ *  - jitter: maximum additional random delay in ms, default 0
+ *  - bandwidth: bytes per second in each direction, default 0 for unlimited
+ *  - loss: percentage of the data that has to be sent again, default 0
+ *  - seed: seed for the randomness of the link, default 1
+ *  - host_port: the port that the host listens on, default 7397
+ *  - relay_port: the port that the clients connect to, default 7398
+ *  - homedir: directory for the home directories of host and clients, which
+ *    must not be the home directory of the user. Default is "stress_test".
+ *  - datadir: the data directory, default is the installed one
+ */
+
+namespace {
+
+constexpr uint32_t kConnectTimeout = 60 * 1000;
+constexpr uint32_t kConnectRetryTime = 100;
+
+/// Runs the host, the game is set up in the same way as by \ref DedicatedServer.
+int run_host(Section& stress, uint32_t clients) {
+	Profile config;
+	Section& server = config.create_section("server");
+	server.set_string("map", stress.get_safe_string("map"));
+	server.set_string("name", "StressHost");
+	server.set_natural("port", stress.get_natural("host_port", kWidelandsLanPort + 1));
+	server.set_string(
+	   "win_condition",
+	   stress.get_string("win_condition", "scripting/win_conditions/endless_game.lua"));
+	server.set_natural("speed", stress.get_natural("speed", 1000));
+	server.set_natural("autosave", 0);
+	server.set_natural("start_timeout", 0);
+	server.set_natural("start_delay", 1);
+	server.set_natural("end_time", stress.get_natural("duration", 10));
+	server.set_string("homedir", std::string(stress.get_string("homedir", "stress_test")) + "/host");
+	if (stress.has_val("datadir")) {
+		server.set_string("datadir", stress.get_safe_string("datadir"));
+	}
+	// Slots beyond the number of clients are not needed
+	for (uint32_t i = clients + 1; i <= kMaxPlayers; ++i) {
+		const std::string section = (boost::format("player_%u") % i).str();
+		config.create_section(section.c_str()).set_string("state", "closed");
+	}
+
+	g_fs = new LayeredFileSystem();
+	try {
+		initialize_headless_environment(server);
+		DedicatedServer(config).run();
+	} catch (const std::exception& e) {
+		log_err("Stress test host: %s\n", e.what());
+		cleanup_headless_environment();
+		return 1;
+	}
+	cleanup_headless_environment();
+	return 0;
+}
+
+/// Runs a client that is controlled by the AI.
+int run_client(Section& stress, uint32_t number) {
+	Profile config;
+	Section& client = config.create_section("client");
+	client.set_string(
+	   "homedir", (boost::format("%s/client_%u") % stress.get_string("homedir", "stress_test") %
+	               number).str());
+	if (stress.has_val("datadir")) {
+		client.set_string("datadir", stress.get_safe_string("datadir"));
+	}
+	const std::string ai = stress.get_string("ai", AI::DefaultAI::normal_impl.name.c_str());
+
+	NetAddress address;
+	if (!NetAddress::parse_ip(
+	       &address, "127.0.0.1", stress.get_natural("relay_port", kWidelandsLanPort + 2))) {
+		log_err("Stress test client %u: invalid address\n", number);
+		return 1;
+	}
+
+	g_fs = new LayeredFileSystem();
+	try {
+		initialize_headless_environment(client);
+		const std::string name = (boost::format("Stress%u") % number).str();
+		std::unique_ptr<GameClient> game_client;
+		const uint32_t start_time = SDL_GetTicks();
+		while (game_client == nullptr) {
+			try {
+				game_client.reset(new GameClient(std::make_pair(address, NetAddress()), name));
+			} catch (const WLWarning&) {
+				if (SDL_GetTicks() - start_time > kConnectTimeout) {
+					throw;
+				}
+				SDL_Delay(kConnectRetryTime);
+			}
+		}
+		game_client->run_headless(ai);
+	} catch (const std::exception& e) {
+		log_err("Stress test client %u: %s\n", number, e.what());
+		cleanup_headless_environment();
+		return 1;
+	}
+	cleanup_headless_environment();
+	return 0;
+}
+
+/// Waits until something accepts connections on the given port on this computer.
+bool wait_for_port(uint16_t port, pid_t pid) {
+	boost::asio::io_service io_service;
+	const boost::asio::ip::tcp::endpoint endpoint(boost::asio::ip::address_v4::loopback(), port);
+	const uint32_t start_time = SDL_GetTicks();
+	while (SDL_GetTicks() - start_time < kConnectTimeout) {
+		boost::asio::ip::tcp::socket socket(io_service);
+		boost::system::error_code ec;
+		socket.connect(endpoint, ec);
+		if (!ec) {
+			socket.close(ec);
+			return true;
+		}
+		int status;
+		if (waitpid(pid, &status, WNOHANG) == pid) {
+			return false;
+		}
+		SDL_Delay(kConnectRetryTime);
+	}
+	return false;
+}
+
+bool succeeded(int status) {
+	return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+	if (argc != 2) {
+		log_err("Usage: %s <config file>\n", argv[0]);
+		return 1;
+	}
+	log_info("This is the Widelands network stress test, version %s (%s)\n",
+	         build_id().c_str(), build_type().c_str());
+
+	const std::string config_path = argv[1];
+	Profile config;
+	{
+		std::string config_dir = FileSystem::fs_dirname(config_path);
+		if (config_dir.empty()) {
+			config_dir = ".";
+		}
+		try {
+			std::unique_ptr<FileSystem> config_fs(&FileSystem::create(config_dir));
+			config.read(FileSystem::fs_filename(config_path.c_str()), nullptr, *config_fs);
+		} catch (const std::exception& e) {
+			log_err("Unable to read %s: %s\n", config_path.c_str(), e.what());
+			return 1;
+		}
+	}
+
+	try {
+		Section& stress = config.get_safe_section("stress");
+		const uint32_t clients = stress.get_natural("clients", 2);
+		if (clients < 1 || clients > kMaxPlayers) {
+			throw wexception("clients must be between 1 and %u", static_cast<unsigned>(kMaxPlayers));
+		}
+		const uint16_t host_port = stress.get_natural("host_port", kWidelandsLanPort + 1);
+		const uint16_t relay_port = stress.get_natural("relay_port", kWidelandsLanPort + 2);
+
+		LinkConditions conditions;
+		conditions.latency = stress.get_natural("latency", 0);
+		conditions.jitter = stress.get_natural("jitter", 0);
+		conditions.bandwidth = stress.get_natural("bandwidth", 0);
+		conditions.loss = std::min(stress.get_natural("loss", 0), 100u);
+
+		const pid_t host = spawn([&stress, clients]() { return run_host(stress, clients); });
+		if (!wait_for_port(host_port, host)) {
+			kill(host, SIGTERM);
+			waitpid(host, nullptr, 0);
+			throw wexception("the host did not start listening on port %u", host_port);
+		}
+
+		LinkSimulator simulator(relay_port, host_port, conditions, stress.get_natural("seed", 1));
+		std::vector<pid_t> children(1, host);
+		for (uint32_t i = 1; i <= clients; ++i) {
+			children.push_back(spawn([&stress, i]() { return run_client(stress, i); }));
+		}
+
+		bool all_succeeded = true;
+		while (!children.empty()) {
+			simulator.think();
+			for (auto it = children.begin(); it != children.end();) {
+				int status;
+				if (waitpid(*it, &status, WNOHANG) == *it) {
+					all_succeeded &= succeeded(status);
+					it = children.erase(it);
+				} else {
+					++it;
+				}
+			}
+			SDL_Delay(1);
+		}
+
+		simulator.report();
+		if (!all_succeeded) {
+			log_err("Some of the processes failed, see the log above\n");
+			return 1;
+		}
+	} catch (const std::exception& e) {
+		log_err("Network stress test: %s\n", e.what());
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2020 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "network/ring_buffer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace {
+
+size_t round_up_to_power_of_two(size_t value) {
+	size_t result = 1;
+	while (result < value) {
+		result <<= 1;
+	}
+	return result;
+}
+
+}  // namespace
+
+ByteRingBuffer::ByteRingBuffer(size_t const capacity)
+   : storage_(new uint8_t[round_up_to_power_of_two(capacity)]),
+     mask_(round_up_to_power_of_two(capacity) - 1),
+     write_pos_(0),
+     read_pos_(0) {
+}
+
+uint8_t* ByteRingBuffer::write_area(size_t* size) {
+	const size_t write_pos = write_pos_.load(std::memory_order_relaxed);
+	const size_t free_space = capacity() - (write_pos - read_pos_.load(std::memory_order_acquire));
+	const size_t offset = write_pos & mask_;
+	*size = std::min(free_space, capacity() - offset);
+	return storage_.get() + offset;
+}
+
+void ByteRingBuffer::commit_write(size_t const size) {
+	const size_t write_pos = write_pos_.load(std::memory_order_relaxed);
+	assert(write_pos + size - read_pos_.load(std::memory_order_acquire) <= capacity());
+	write_pos_.store(write_pos + size, std::memory_order_release);
+}
+
+void ByteRingBuffer::read(void* out, size_t const size) {
+	assert(size <= readable());
+	const size_t offset = read_pos_.load(std::memory_order_relaxed) & mask_;
+	const size_t first = std::min(size, capacity() - offset);
+	memcpy(out, storage_.get() + offset, first);
+	memcpy(static_cast<uint8_t*>(out) + first, storage_.get(), size - first);
+	skip(size);
+}
+
+void ByteRingBuffer::skip(size_t const size) {
+	assert(size <= readable());
+	read_pos_.store(read_pos_.load(std::memory_order_relaxed) + size, std::memory_order_release);
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2020 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#ifndef WL_NETWORK_RING_BUFFER_H
+#define WL_NETWORK_RING_BUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "base/macros.h"
+
+/**
+ * A ring buffer of bytes for exactly one thread that writes and one thread that reads.
+ *
+ * Neither side takes a lock: the writer only moves the write position and the
+ * reader only moves the read position, and each publishes its position to the
+ * other thread with an atomic store. The writer writes directly into the buffer,
+ * e.g. with a read from a socket, and the reader copies the bytes out of the
+ * buffer to where they are needed.
+ *
+ * The buffer does not grow, so the writer has to wait until the reader has
+ * made room when it is full.
+ */
+class ByteRingBuffer {
+public:
+	/// The capacity is rounded up to a power of two
+	explicit ByteRingBuffer(size_t capacity);
+
+	size_t capacity() const {
+		return mask_ + 1;
+	}
+
+	// Only to be called by the writing thread
+
+	/// The largest free area that can be written at once. The area ends at the end of
+	/// the storage, so it might be smaller than the free space in total.
+	/// \param size Is set to the size of the area, which is 0 if the buffer is full
+	uint8_t* write_area(size_t* size);
+
+	/// Makes \p size bytes that have been written to \ref write_area() available to the reader
+	void commit_write(size_t size);
+
+	// Only to be called by the reading thread
+
+	/// The number of bytes that can be read
+	size_t readable() const {
+		return write_pos_.load(std::memory_order_acquire) - read_pos_.load(std::memory_order_relaxed);
+	}
+
+	/// The byte at \p offset from the read position, which must be less than \ref readable()
+	uint8_t peek(size_t offset) const {
+		return storage_[(read_pos_.load(std::memory_order_relaxed) + offset) & mask_];
+	}
+
+	/// Copies the next \p size bytes to \p out and frees them. At least \p size bytes
+	/// must be readable.
+	void read(void* out, size_t size);
+
+	/// Frees the next \p size bytes without reading them
+	void skip(size_t size);
+
+private:
+	std::unique_ptr<uint8_t[]> storage_;
+	const size_t mask_;
+	/// The number of bytes that have been written and read, ever. The positions in
+	/// the storage are these numbers modulo the capacity.
+	std::atomic<size_t> write_pos_;
+	std::atomic<size_t> read_pos_;
+
+	DISALLOW_COPY_AND_ASSIGN(ByteRingBuffer);
+};
+
+#endif  // end of include guard: WL_NETWORK_RING_BUFFER_H
@@ -0,0 +1,395 @@
+/*
+ * Copyright (C) 2020 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "network/spectator_relay.h"
+
+#include <algorithm>
+
+#include "base/log.h"
+#include "base/wexception.h"
+#include "logic/game.h"
+#include "logic/playercommand.h"
+#include "network/file_transfer.h"
+#include "network/network_protocol.h"
+
+namespace {
+
+/// Part of the file names of the snapshots for the spectators
+const std::string kSpectatorSnapshotSuffix = "_spectators";
+
+}  // namespace
+
+SpectatorRelay::SpectatorRelay(GameClient& client, uint16_t port)
+   : client_(client), net_(NetHost::listen(port)), last_command_time_(0) {
+	if (!net_) {
+		throw wexception("Unable to listen for spectators on port %u", port);
+	}
+	log_info("[Relay]: Listening for spectators on port %u\n", port);
+}
+
+SpectatorRelay::~SpectatorRelay() {
+	for (Spectator& spectator : spectators_) {
+		disconnect(spectator, "SERVER_LEFT");
+	}
+}
+
+void SpectatorRelay::handled_packet(uint8_t const cmd, const RecvPacket& packet) {
+	switch (cmd) {
+	case NETCMD_SETTING_TRIBES:
+	case NETCMD_SETTING_ALLPLAYERS:
+	case NETCMD_SETTING_PLAYER:
+	case NETCMD_SETTING_ALLUSERS:
+	case NETCMD_SETTING_USER:
+	case NETCMD_WIN_CONDITION:
+	case NETCMD_PEACEFUL_MODE:
+	case NETCMD_CUSTOM_STARTING_POSITIONS:
+		keep_setting(cmd, packet);
+		return forward(packet);
+	case NETCMD_SETSPEED:
+		speed_.reset(new SendPacket());
+		packet.copy_to(speed_.get());
+		return forward(packet);
+	case NETCMD_TIME:
+	case NETCMD_WAIT:
+	case NETCMD_CHAT:
+	case NETCMD_SYSTEM_MESSAGE_CODE:
+	case NETCMD_INFO_DESYNC:
+		return forward(packet);
+	default:
+		// Everything else only concerns the relay itself
+		break;
+	}
+}
+
+void SpectatorRelay::handled_player_command(const Time& time,
+                                            Widelands::PlayerCommand& command) {
+	SendPacket packet;
+	packet.unsigned_8(NETCMD_PLAYERCOMMAND);
+	Widelands::CommandWriter writer(packet, commands_);
+	writer.time(time);
+	command.serialize(writer);
+	send_to_followers(packet);
+	last_command_time_ = time;
+}
+
+void SpectatorRelay::keep_setting(uint8_t const cmd, const RecvPacket& packet) {
+	auto replaces = [cmd](uint8_t kept) {
+		switch (cmd) {
+		case NETCMD_SETTING_ALLPLAYERS:
+			return kept == NETCMD_SETTING_ALLPLAYERS || kept == NETCMD_SETTING_PLAYER;
+		case NETCMD_SETTING_ALLUSERS:
+			return kept == NETCMD_SETTING_ALLUSERS || kept == NETCMD_SETTING_USER;
+		case NETCMD_SETTING_PLAYER:
+		case NETCMD_SETTING_USER:
+			// We don't look into the packets, so we keep all of them
+			return false;
+		default:
+			return kept == cmd;
+		}
+	};
+	settings_.erase(std::remove_if(settings_.begin(), settings_.end(),
+	                               [&replaces](const Setting& setting) {
+		                               return replaces(setting.first);
+	                               }),
+	                settings_.end());
+	std::unique_ptr<SendPacket> copy(new SendPacket());
+	packet.copy_to(copy.get());
+	settings_.push_back(std::make_pair(cmd, std::move(copy)));
+}
+
+void SpectatorRelay::forward(const RecvPacket& packet) {
+	SendPacket copy;
+	packet.copy_to(&copy);
+	send_to_followers(copy);
+}
+
+void SpectatorRelay::send_to_followers(const SendPacket& packet) {
+	std::vector<NetHostInterface::ConnectionId> ids;
+	for (const Spectator& spectator : spectators_) {
+		// Spectators who are still waiting for their snapshot get everything after it
+		if (spectator.state == Spectator::State::kReceivingSnapshot ||
+		    spectator.state == Spectator::State::kWatching) {
+			ids.push_back(spectator.id);
+		}
+	}
+	if (!ids.empty()) {
+		net_->send(ids, packet);
+	}
+}
+
+void SpectatorRelay::think(Widelands::Game& game) {
+	NetBatch batch(*net_);
+
+	accept_spectators();
+
+	for (Spectator& spectator : spectators_) {
+		try {
+			std::unique_ptr<RecvPacket> packet = net_->try_receive(spectator.id);
+			while (packet) {
+				handle_spectator_packet(spectator, *packet);
+				packet = net_->try_receive(spectator.id);
+			}
+		} catch (const DisconnectException& e) {
+			disconnect(spectator, e.what());
+		} catch (const ProtocolException& e) {
+			disconnect(spectator, "PROTOCOL_EXCEPTION", e.what());
+		} catch (const std::exception& e) {
+			disconnect(spectator, "MALFORMED_COMMANDS", e.what());
+		}
+	}
+
+	welcome_spectators(game);
+	send_file_parts();
+
+	spectators_.erase(std::remove_if(spectators_.begin(), spectators_.end(),
+	                                 [this](const Spectator& spectator) {
+		                                 return !net_->is_connected(spectator.id);
+	                                 }),
+	                  spectators_.end());
+}
+
+void SpectatorRelay::accept_spectators() {
+	Spectator spectator;
+	while (net_->try_accept(&spectator.id)) {
+		spectator.state = Spectator::State::kConnecting;
+		spectator.receiving_file = false;
+		spectator.next_part = 0;
+		spectator.parts_acked = 0;
+		spectators_.push_back(spectator);
+	}
+}
+
+/**
+ * Handle a single packet from a spectator.
+ *
+ * The caller must catch exceptions and disconnect the spectator as appropriate.
+ */
+void SpectatorRelay::handle_spectator_packet(Spectator& spectator, RecvPacket& packet) {
+	const uint8_t cmd = packet.unsigned_8();
+
+	if (cmd == NETCMD_DISCONNECT) {
+		log_info("[Relay]: Spectator %u left\n", static_cast<unsigned int>(spectator.id));
+		return net_->close(spectator.id);
+	}
+
+	if (spectator.state == Spectator::State::kConnecting) {
+		if (cmd != NETCMD_HELLO) {
+			throw ProtocolException(cmd);
+		}
+		if (packet.unsigned_8() != NETWORK_PROTOCOL_VERSION) {
+			throw DisconnectException("DIFFERENT_PROTOCOL_VERS");
+		}
+		const std::string name = packet.string();
+		log_info("[Relay]: Spectator %u is %s\n", static_cast<unsigned int>(spectator.id),
+		         name.c_str());
+		// The snapshot is sent by welcome_spectators()
+		spectator.state = Spectator::State::kWaitingForGame;
+		return;
+	}
+
+	switch (cmd) {
+	case NETCMD_NEW_FILE_AVAILABLE: {
+		if (!spectator.snapshot) {
+			throw DisconnectException("REQUEST_OF_N_E_FILE");
+		}
+		const uint32_t first_part = packet.unsigned_32();
+		if (first_part >= spectator.snapshot->number_of_parts() && first_part != 0) {
+			throw DisconnectException("REQUEST_OF_N_E_FILE");
+		}
+		if (spectator.receiving_file && first_part >= spectator.parts_acked &&
+		    first_part < spectator.next_part) {
+			// A corrupted part, see GameHost::handle_new_file()
+			send_file_part(*net_, spectator.id, *spectator.snapshot, first_part);
+			break;
+		}
+		// The parts are sent by send_file_parts()
+		spectator.receiving_file = true;
+		spectator.next_part = first_part;
+		spectator.parts_acked = first_part;
+	} break;
+	case NETCMD_FILE_PART:
+		return handle_file_part(spectator, packet);
+
+	// Spectators can't take part in the game
+	case NETCMD_PONG:
+	case NETCMD_TIME:
+	case NETCMD_SYNCREPORT:
+	case NETCMD_CHAT:
+	case NETCMD_SETSPEED:
+	case NETCMD_PLAYERCOMMAND:
+	case NETCMD_SETTING_CHANGETRIBE:
+	case NETCMD_SETTING_CHANGESHARED:
+	case NETCMD_SETTING_CHANGETEAM:
+	case NETCMD_SETTING_CHANGEINIT:
+	case NETCMD_SETTING_CHANGEPOSITION:
+		break;
+
+	default:
+		throw ProtocolException(cmd);
+	}
+}
+
+void SpectatorRelay::handle_file_part(Spectator& spectator, RecvPacket& packet) {
+	if (!spectator.snapshot) {
+		throw DisconnectException("REQUEST_OF_N_E_FILE");
+	}
+	const uint32_t part = packet.unsigned_32();
+	const std::string md5sum = packet.string();
+	if (md5sum != spectator.snapshot->md5sum || part >= spectator.snapshot->parts.size()) {
+		throw DisconnectException("REQUEST_OF_N_E_FILE");
+	}
+	if (!spectator.receiving_file || part != spectator.parts_acked) {
+		// Confirmation of a part that was sent before the spectator requested a resend
+		return;
+	}
+	++spectator.parts_acked;
+	if (part == spectator.snapshot->parts.size() - 1) {
+		// The spectator has everything to load the game now
+		spectator.receiving_file = false;
+		spectator.snapshot.reset();
+		spectator.state = Spectator::State::kWatching;
+		SendPacket launch;
+		launch.unsigned_8(NETCMD_LAUNCH);
+		net_->send(spectator.id, launch);
+	}
+}
+
+/**
+ * Send a snapshot of our game to all spectators that have said hello since the
+ * last call. The player commands that we have received so far are already
+ * queued in our game, so they are part of the snapshot.
+ */
+void SpectatorRelay::welcome_spectators(Widelands::Game& game) {
+	std::vector<Spectator*> waiting;
+	for (Spectator& spectator : spectators_) {
+		if (spectator.state == Spectator::State::kWaitingForGame &&
+		    net_->is_connected(spectator.id)) {
+			waiting.push_back(&spectator);
+		}
+	}
+	if (waiting.empty()) {
+		return;
+	}
+
+	std::shared_ptr<NetTransferFile> snapshot =
+	   prepare_snapshot_transfer(game, kSpectatorSnapshotSuffix);
+	if (!snapshot) {
+		for (Spectator* spectator : waiting) {
+			disconnect(*spectator, "SNAPSHOT_FAILED");
+		}
+		return;
+	}
+	log_info("[Relay]: Sending snapshot at time %u to %" PRIuS " spectators\n",
+	         game.get_gametime().get(), waiting.size());
+
+	const GameSettings& settings = client_.settings();
+	std::vector<NetHostInterface::ConnectionId> ids;
+	for (Spectator* spectator : waiting) {
+		spectator->state = Spectator::State::kReceivingSnapshot;
+		spectator->snapshot = snapshot;
+		ids.push_back(spectator->id);
+	}
+	// The new spectators can't decode commands that refer to earlier ones
+	commands_.reset();
+
+	// The spectators see the game through the eyes of the relay
+	SendPacket packet;
+	packet.unsigned_8(NETCMD_HELLO);
+	packet.unsigned_8(NETWORK_PROTOCOL_VERSION);
+	packet.unsigned_32(settings.usernum);
+	net_->send(ids, packet);
+
+	// The spectators load the snapshot as a savegame
+	packet.reset();
+	packet.unsigned_8(NETCMD_SETTING_MAP);
+	packet.string(settings.mapname);
+	packet.string(snapshot->filename);
+	packet.string(settings.map_theme);
+	packet.string(settings.map_background);
+	packet.unsigned_8(1);
+	packet.unsigned_8(settings.scenario ? 1 : 0);
+	net_->send(ids, packet);
+
+	for (const auto& setting : settings_) {
+		net_->send(ids, *setting.second);
+	}
+	if (speed_) {
+		net_->send(ids, *speed_);
+	}
+
+	packet.reset();
+	packet.unsigned_8(NETCMD_REJOIN);
+	packet.unsigned_32(game.get_gametime().get());
+	game.rng().write_state(packet);
+	game.get_sync_state().write_state(packet);
+	net_->send(ids, packet);
+	// Our game can't have gone beyond the network time, and neither can the commands
+	packet.reset();
+	packet.unsigned_8(NETCMD_TIME);
+	packet.unsigned_32(std::max(game.get_gametime(), last_command_time_).get());
+	net_->send(ids, packet);
+
+	packet.reset();
+	packet.unsigned_8(NETCMD_NEW_FILE_AVAILABLE);
+	packet.string(snapshot->filename);
+	packet.unsigned_32(snapshot->bytes);
+	packet.string(snapshot->md5sum);
+	net_->send(ids, packet);
+}
+
+/**
+ * Send the next parts of the snapshots, interleaved between the spectators and
+ * with a limited number of unconfirmed parts per spectator, like the host does.
+ */
+void SpectatorRelay::send_file_parts() {
+	for (uint32_t round = 0; round < kFileTransferWindow; ++round) {
+		bool sent = false;
+		for (Spectator& spectator : spectators_) {
+			if (!spectator.snapshot || !spectator.receiving_file ||
+			    spectator.next_part >= spectator.snapshot->parts.size() ||
+			    spectator.next_part - spectator.parts_acked >= kFileTransferWindow) {
+				continue;
+			}
+			send_file_part(*net_, spectator.id, *spectator.snapshot, spectator.next_part++);
+			sent = true;
+		}
+		if (!sent) {
+			return;
+		}
+	}
+}
+
+void SpectatorRelay::disconnect(Spectator& spectator,
+                                const std::string& reason,
+                                const std::string& arg) {
+	log_info("[Relay]: Disconnecting spectator %u: %s %s\n",
+	         static_cast<unsigned int>(spectator.id), reason.c_str(), arg.c_str());
+	if (!net_->is_connected(spectator.id)) {
+		return;
+	}
+	SendPacket packet;
+	packet.unsigned_8(NETCMD_DISCONNECT);
+	packet.unsigned_8(arg.empty() ? 1 : 2);
+	packet.string(reason);
+	if (!arg.empty()) {
+		packet.string(arg);
+	}
+	net_->send(spectator.id, packet);
+	net_->close(spectator.id);
+}
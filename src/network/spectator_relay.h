@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2020 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#ifndef WL_NETWORK_SPECTATOR_RELAY_H
+#define WL_NETWORK_SPECTATOR_RELAY_H
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/macros.h"
+#include "logic/command_stream.h"
+#include "network/gameclient.h"
+#include "network/nethost.h"
+
+/**
+ * Passes a running network game on to any number of spectators, so that the
+ * host only has to send the game to the relay, no matter how many people watch.
+ *
+ * The relay is a \ref GameClient that joins the game as a spectator before it is
+ * launched, see \ref GameClient::relay_to(). It follows the game with a delay,
+ * so that spectators can't give away anything to the players in time.
+ *
+ * Spectators connect to the relay as if it was the host of a running game. At
+ * any time during the game, they receive a snapshot of the relay's game, just like
+ * players who rejoin a game, and then everything that the relay handles. The
+ * relay does not pass anything from the spectators on to the host, so they can't
+ * chat with the players.
+ *
+ * Player commands are encoded relative to the commands before them, so the relay
+ * encodes them anew for its spectators, and starts over whenever some join.
+ */
+class SpectatorRelay : public GameClientObserver {
+public:
+	/// Relays the game that \p client follows. Throws a wexception if the relay
+	/// can't listen for spectators on \p port.
+	SpectatorRelay(GameClient& client, uint16_t port);
+	~SpectatorRelay() override;
+
+	void handled_packet(uint8_t cmd, const RecvPacket& packet) override;
+	void handled_player_command(const Time& time, Widelands::PlayerCommand& command) override;
+	void think(Widelands::Game& game) override;
+
+private:
+	struct Spectator {
+		enum class State { kConnecting, kWaitingForGame, kReceivingSnapshot, kWatching };
+
+		NetHostInterface::ConnectionId id;
+		State state;
+		std::shared_ptr<NetTransferFile> snapshot;
+		/// Whether the spectator wants the snapshot
+		bool receiving_file;
+		/// The next part of the snapshot that will be sent
+		uint32_t next_part;
+		/// The number of parts of the snapshot that the spectator has confirmed
+		uint32_t parts_acked;
+	};
+
+	void accept_spectators();
+	void handle_spectator_packet(Spectator& spectator, RecvPacket& packet);
+	void handle_file_part(Spectator& spectator, RecvPacket& packet);
+	void welcome_spectators(Widelands::Game& game);
+	void send_file_parts();
+	void disconnect(Spectator& spectator, const std::string& reason, const std::string& arg = "");
+
+	/// Keeps a setting of the game for new spectators, and drops the
+	/// kept settings that it replaces
+	void keep_setting(uint8_t cmd, const RecvPacket& packet);
+	/// Sends the packet to all spectators that follow the game
+	void forward(const RecvPacket& packet);
+	void send_to_followers(const SendPacket& packet);
+
+	GameClient& client_;
+	std::unique_ptr<NetHost> net_;
+	std::vector<Spectator> spectators_;
+
+	/// The settings of the game with their commands, in the order in which they arrived
+	using Setting = std::pair<uint8_t, std::unique_ptr<SendPacket>>;
+	std::vector<Setting> settings_;
+	/// The last speed that the host has set, if any
+	std::unique_ptr<SendPacket> speed_;
+	/// The player commands that we pass on to the spectators
+	Widelands::CommandStream commands_;
+	/// When the last player command that we passed on is due
+	Time last_command_time_;
+
+	DISALLOW_COPY_AND_ASSIGN(SpectatorRelay);
+};
+
+#endif  // end of include guard: WL_NETWORK_SPECTATOR_RELAY_H
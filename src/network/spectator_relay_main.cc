@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2020 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include <memory>
+
+#include "base/log.h"
+#include "build_info.h"
+#include "headless_environment.h"
+#include "io/filesystem/layered_filesystem.h"
+#include "io/profile.h"
+#include "network/constants.h"
+#include "network/gameclient.h"
+#include "network/spectator_relay.h"
+
+/**
+ * Passes a network game on to spectators, see \ref SpectatorRelay. The relay
+ * has to join the game before it is launched.
+ *
+ * The config file has a [relay] section with the keys
+ *  - host: the IP address of the host of the game, default 127.0.0.1
+ *  - host_port: the port of the host, default 7396
+ *  - port: the port on which spectators connect to the relay, default 7397
+ *  - name: the name of the relay in the game, default "relay"
+ *  - delay: seconds that the relay lags behind the game, default 0
+ *  - homedir, datadir: as for the dedicated server
+ */
+int main(int argc, char** argv) {
+	if (argc != 2) {
+		log_err("Usage: %s <config file>\n", argv[0]);
+		return 1;
+	}
+	log_info("This is the Widelands spectator relay, version %s (%s)\n", build_id().c_str(),
+	         build_type().c_str());
+
+	const std::string config_path = argv[1];
+	g_fs = new LayeredFileSystem();
+	try {
+		std::string config_dir = FileSystem::fs_dirname(config_path);
+		if (config_dir.empty()) {
+			config_dir = ".";
+		}
+		std::unique_ptr<FileSystem> config_fs(&FileSystem::create(config_dir));
+		Profile config;
+		config.read(FileSystem::fs_filename(config_path.c_str()), nullptr, *config_fs);
+		Section& section = config.get_safe_section("relay");
+
+		NetAddress host;
+		if (!NetAddress::parse_ip(&host, section.get_string("host", "127.0.0.1"),
+		                          section.get_natural("host_port", kWidelandsLanPort))) {
+			log_err("Spectator relay: invalid host address\n");
+			return 1;
+		}
+
+		initialize_headless_environment(section);
+		GameClient client(std::make_pair(host, NetAddress()), section.get_string("name", "relay"));
+		SpectatorRelay relay(client, section.get_natural("port", kWidelandsLanPort + 1));
+		client.relay_to(&relay, section.get_natural("delay", 0) * 1000);
+		client.run_headless("");
+	} catch (const std::exception& e) {
+		log_err("Spectator relay: %s\n", e.what());
+		cleanup_headless_environment();
+		return 1;
+	}
+	cleanup_headless_environment();
+	return 0;
+}
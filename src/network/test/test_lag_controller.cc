@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2020 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include "base/macros.h"
+#include "network/lag_controller.h"
+
+// BOOST_CHECK_EQUAL generates an old-style cast usage warning, so ignore
+#pragma GCC diagnostic ignored "-Wold-style-cast"
+
+// Triggered by BOOST_AUTO_TEST_CASE
+CLANG_DIAG_OFF("-Wdisabled-macro-expansion")
+CLANG_DIAG_OFF("-Wused-but-marked-unused")
+
+BOOST_AUTO_TEST_SUITE(LagControllerTests)
+
+BOOST_AUTO_TEST_CASE(latency_makes_the_host_patient) {
+	LagController controller;
+	const uint32_t default_tolerance = controller.hang_tolerance();
+
+	for (int i = 0; i < 20; ++i) {
+		controller.report_rtt(1, 3000);
+		controller.report_lag(1, 3100);
+	}
+	BOOST_CHECK_GE(controller.hang_tolerance(), 3000u + default_tolerance / 5);
+
+	// Latency alone never slows the game down
+	for (uint32_t now = 1000; now < 10000; now += 1000) {
+		BOOST_CHECK(!controller.think(now, 2000));
+	}
+	BOOST_CHECK_EQUAL(controller.limit_speed(2000), 2000u);
+
+	controller.remove_client(1);
+	BOOST_CHECK_EQUAL(controller.hang_tolerance(), default_tolerance);
+	BOOST_CHECK(controller.slowest_client() == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(slow_client_limits_the_speed) {
+	LagController controller;
+	controller.report_rtt(1, 50);
+	controller.report_lag(1, 100);
+	controller.report_rtt(2, 50);
+	controller.report_lag(2, 2000);
+
+	LagController::ClientId slowest = 0;
+	BOOST_REQUIRE(controller.slowest_client(&slowest) != nullptr);
+	BOOST_CHECK_EQUAL(slowest, 2);
+
+	BOOST_CHECK(controller.think(1000, 4000));
+	const uint32_t limited = controller.limit_speed(4000);
+	BOOST_CHECK_LT(limited, 4000u);
+	// Nothing changes before the next adjustment is due
+	BOOST_CHECK(!controller.think(1500, 4000));
+
+	// The speed recovers once the client keeps up again
+	for (int i = 0; i < 20; ++i) {
+		controller.report_lag(2, 100);
+	}
+	uint32_t now = 2000;
+	for (; now < 60000 && controller.limit_speed(4000) < 4000; now += 1000) {
+		controller.think(now, 4000);
+		BOOST_CHECK_GE(controller.limit_speed(4000), limited);
+	}
+	BOOST_CHECK_EQUAL(controller.limit_speed(4000), 4000u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2020 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "base/macros.h"
+#include "network/ring_buffer.h"
+
+// BOOST_CHECK_EQUAL generates an old-style cast usage warning, so ignore
+#pragma GCC diagnostic ignored "-Wold-style-cast"
+
+// Triggered by BOOST_AUTO_TEST_CASE
+CLANG_DIAG_OFF("-Wdisabled-macro-expansion")
+CLANG_DIAG_OFF("-Wused-but-marked-unused")
+
+BOOST_AUTO_TEST_SUITE(RingBufferTests)
+
+BOOST_AUTO_TEST_CASE(data_wraps_around_the_end) {
+	ByteRingBuffer buffer(10);
+	BOOST_CHECK_EQUAL(buffer.capacity(), 16u);
+
+	size_t size = 0;
+	uint8_t* area = buffer.write_area(&size);
+	BOOST_REQUIRE_EQUAL(size, 16u);
+	for (uint8_t i = 0; i < 12; ++i) {
+		area[i] = i;
+	}
+	buffer.commit_write(12);
+	buffer.skip(10);
+	BOOST_CHECK_EQUAL(buffer.readable(), 2u);
+	BOOST_CHECK_EQUAL(buffer.peek(1), 11);
+
+	// Only the area up to the end of the storage can be written at once
+	area = buffer.write_area(&size);
+	BOOST_REQUIRE_EQUAL(size, 4u);
+	memset(area, 20, size);
+	buffer.commit_write(size);
+	area = buffer.write_area(&size);
+	BOOST_REQUIRE_EQUAL(size, 10u);
+	memset(area, 30, 2);
+	buffer.commit_write(2);
+
+	uint8_t out[8];
+	BOOST_REQUIRE_EQUAL(buffer.readable(), 8u);
+	buffer.read(out, 8);
+	BOOST_CHECK_EQUAL(out[0], 10);
+	BOOST_CHECK_EQUAL(out[5], 20);
+	BOOST_CHECK_EQUAL(out[6], 30);
+	BOOST_CHECK_EQUAL(buffer.readable(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(bytes_arrive_in_order_across_threads) {
+	constexpr uint32_t kTotal = 100000;
+	ByteRingBuffer buffer(64);
+
+	std::thread writer([&buffer]() {
+		uint32_t written = 0;
+		while (written < kTotal) {
+			size_t size = 0;
+			uint8_t* area = buffer.write_area(&size);
+			for (size_t i = 0; i < size && written + i < kTotal; ++i) {
+				area[i] = static_cast<uint8_t>(written + i);
+			}
+			size = std::min<size_t>(size, kTotal - written);
+			buffer.commit_write(size);
+			written += size;
+		}
+	});
+
+	uint32_t read = 0;
+	bool in_order = true;
+	std::vector<uint8_t> out(64);
+	while (read < kTotal) {
+		const size_t size = buffer.readable();
+		buffer.read(out.data(), size);
+		for (size_t i = 0; i < size; ++i) {
+			in_order = in_order && out[i] == static_cast<uint8_t>(read + i);
+		}
+		read += size;
+	}
+	writer.join();
+	BOOST_CHECK(in_order);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
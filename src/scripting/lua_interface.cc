@@ -92,3 +92,7 @@ void LuaInterface::interpret_string(const std::string& cmd) {
 std::unique_ptr<LuaTable> LuaInterface::run_script(const std::string& path) {
 	return ::run_script(lua_state_, g_fs->fix_cross_file(path), g_fs);
 }
+
+std::unique_ptr<LuaTable> LuaInterface::deserialize_table(const std::string& data) {
+	return LuaTable::deserialize(lua_state_, data);
+}
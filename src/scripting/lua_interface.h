@@ -39,6 +39,9 @@ public:
 	// Runs 'script' and returns the table it returned.
 	virtual std::unique_ptr<LuaTable> run_script(const std::string& script);
 
+	// Recreates a table from the result of LuaTable::serialize().
+	std::unique_ptr<LuaTable> deserialize_table(const std::string& data);
+
 protected:
 	lua_State* lua_state_;
 };
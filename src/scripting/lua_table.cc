@@ -19,10 +19,121 @@
 
 #include "scripting/lua_table.h"
 
+#include <cstring>
 #include <memory>
 
 #include "base/log.h"
 
+namespace {
+
+// Deeper tables are most likely cyclic
+constexpr int kMaxSerializedDepth = 64;
+
+template <typename T> void append_raw(std::string* data, const T& value) {
+	data->append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T> T read_raw(const std::string& data, size_t* position) {
+	if (*position + sizeof(T) > data.size()) {
+		throw LuaError("Serialized table is truncated");
+	}
+	T value;
+	memcpy(&value, data.data() + *position, sizeof(T));
+	*position += sizeof(T);
+	return value;
+}
+
+// Appends the value on top of the stack to 'data'
+void serialize_value(lua_State* L, std::string* data, int depth) {
+	if (depth > kMaxSerializedDepth) {
+		throw LuaError("Table is nested too deeply to be serialized");
+	}
+	switch (lua_type(L, -1)) {
+	case LUA_TBOOLEAN:
+		data->push_back('b');
+		data->push_back(lua_toboolean(L, -1) ? 1 : 0);
+		break;
+	case LUA_TNUMBER:
+		if (lua_isinteger(L, -1)) {
+			data->push_back('i');
+			append_raw<int64_t>(data, lua_tointeger(L, -1));
+		} else {
+			data->push_back('f');
+			append_raw<double>(data, lua_tonumber(L, -1));
+		}
+		break;
+	case LUA_TSTRING: {
+		size_t length;
+		const char* str = lua_tolstring(L, -1, &length);
+		data->push_back('s');
+		append_raw<uint32_t>(data, length);
+		data->append(str, length);
+	} break;
+	case LUA_TTABLE: {
+		luaL_checkstack(L, 3, "serializing table");
+		data->push_back('t');
+		const size_t count_position = data->size();
+		append_raw<uint32_t>(data, 0);
+		uint32_t count = 0;
+		lua_pushnil(L);                 // S: table nil
+		while (lua_next(L, -2) != 0) {  // S: table key value
+			// Work on a copy of the key, lua_next() must get it unchanged
+			lua_pushvalue(L, -2);  // S: table key value key
+			serialize_value(L, data, depth + 1);
+			lua_pop(L, 1);  // S: table key value
+			serialize_value(L, data, depth + 1);
+			lua_pop(L, 1);  // S: table key
+			++count;
+		}
+		memcpy(&(*data)[count_position], &count, sizeof(count));
+	} break;
+	default:
+		throw LuaError((boost::format("Values of type %s can't be serialized") %
+		                lua_typename(L, lua_type(L, -1)))
+		                  .str());
+	}
+}
+
+// Pushes the value starting at 'position' in 'data' and moves 'position' behind it
+void push_value(lua_State* L, const std::string& data, size_t* position, int depth) {
+	if (depth > kMaxSerializedDepth) {
+		throw LuaError("Serialized table is nested too deeply");
+	}
+	luaL_checkstack(L, 3, "deserializing table");
+	switch (read_raw<char>(data, position)) {
+	case 'b':
+		lua_pushboolean(L, read_raw<char>(data, position));
+		break;
+	case 'i':
+		lua_pushinteger(L, read_raw<int64_t>(data, position));
+		break;
+	case 'f':
+		lua_pushnumber(L, read_raw<double>(data, position));
+		break;
+	case 's': {
+		const uint32_t length = read_raw<uint32_t>(data, position);
+		if (*position + length > data.size()) {
+			throw LuaError("Serialized table is truncated");
+		}
+		lua_pushlstring(L, data.data() + *position, length);
+		*position += length;
+	} break;
+	case 't': {
+		const uint32_t count = read_raw<uint32_t>(data, position);
+		lua_newtable(L);  // S: table
+		for (uint32_t i = 0; i < count; ++i) {
+			push_value(L, data, position, depth + 1);  // S: table key
+			push_value(L, data, position, depth + 1);  // S: table key value
+			lua_rawset(L, -3);                         // S: table
+		}
+	} break;
+	default:
+		throw LuaError("Serialized table contains an unknown type");
+	}
+}
+
+}  // namespace
+
 LuaTable::LuaTable(lua_State* L) : L_(L), warn_about_unaccessed_keys_(true) {
 	// S: <table>
 	lua_pushlightuserdata(L_, const_cast<LuaTable*>(this));  // S: this
@@ -52,6 +163,39 @@ void LuaTable::do_not_warn_about_unaccessed_keys() {
 	warn_about_unaccessed_keys_ = false;
 }
 
+std::string LuaTable::serialize() const {
+	lua_pushlightuserdata(L_, const_cast<LuaTable*>(this));  // S: this
+	lua_rawget(L_, LUA_REGISTRYINDEX);                       // S: table
+	const int top = lua_gettop(L_);
+	std::string data;
+	try {
+		serialize_value(L_, &data, 0);
+	} catch (...) {
+		lua_settop(L_, top - 1);
+		throw;
+	}
+	lua_pop(L_, 1);  // S:
+	return data;
+}
+
+// static
+std::unique_ptr<LuaTable> LuaTable::deserialize(lua_State* L, const std::string& data) {
+	const int top = lua_gettop(L);
+	size_t position = 0;
+	try {
+		push_value(L, data, &position, 0);  // S: table
+		if (!lua_istable(L, -1) || position != data.size()) {
+			throw LuaError("Serialized data is not a table");
+		}
+	} catch (...) {
+		lua_settop(L, top);
+		throw;
+	}
+	std::unique_ptr<LuaTable> table(new LuaTable(L));
+	lua_pop(L, 1);  // S:
+	return table;
+}
+
 void LuaTable::get_existing_table_value(const std::string& key) const {
 	lua_pushstring(L_, key);
 	check_if_key_was_in_table(key);
@@ -54,6 +54,13 @@ public:
 	/// if any key was unused in the dictionary.
 	void do_not_warn_about_unaccessed_keys();
 
+	/// Returns the table with all its subtables as binary data, which is only meant to be read by
+	/// 'deserialize' on the same machine. Only booleans, numbers, strings and tables are supported,
+	/// throws LuaError for anything else.
+	std::string serialize() const;
+	/// Recreates a table from the result of 'serialize'
+	static std::unique_ptr<LuaTable> deserialize(lua_State* L, const std::string& data);
+
 	/// Returns all keys. All keys must be of the given type.
 	template <typename KeyType> std::set<KeyType> keys() const {
 		lua_pushlightuserdata(L_, const_cast<LuaTable*>(this));  // S: this
@@ -19,13 +19,121 @@
 
 #include "scripting/run_script.h"
 
+#include <atomic>
 #include <memory>
 
+#include "base/fast_hash.h"
+#include "base/log.h"
+#include "io/fileread.h"
 #include "io/filesystem/filesystem.h"
+#include "io/filesystem/layered_filesystem.h"
+#include "io/filewrite.h"
+#include "logic/filesystem_constants.h"
 #include "scripting/lua_table.h"
 
 namespace {
 
+constexpr uint16_t kCurrentPacketVersion = 2;
+
+// Set when the cache can't be written, so that we only complain once
+std::atomic<bool> bytecode_cache_disabled(false);
+
+uint64_t hash_of(const std::string& data) {
+	FastHash hash;
+	hash.data(data.data(), data.size());
+	return hash.value();
+}
+
+std::string bytecode_cache_filename(const std::string& identifier) {
+	return (boost::format("%s/%016x.luac") % kLuaCacheDir % hash_of(identifier)).str();
+}
+
+int append_to_string(lua_State*, const void* data, size_t size, void* buffer) {
+	static_cast<std::string*>(buffer)->append(static_cast<const char*>(data), size);
+	return 0;
+}
+
+// Pushes the precompiled chunk of the script from the cache in the home directory. Returns false
+// if there is none for this content of the script.
+bool load_cached_chunk(lua_State* L, const std::string& identifier, uint64_t content_hash) {
+	FileRead fr;
+	if (g_fs == nullptr || !fr.try_open(*g_fs, bytecode_cache_filename(identifier))) {
+		return false;
+	}
+	try {
+		if (fr.unsigned_16() != kCurrentPacketVersion || fr.string() != identifier) {
+			return false;
+		}
+		const uint64_t low = fr.unsigned_32();
+		const uint64_t high = fr.unsigned_32();
+		if ((high << 32 | low) != content_hash) {
+			return false;
+		}
+		const uint64_t bytecode_hash_low = fr.unsigned_32();
+		const uint64_t bytecode_hash_high = fr.unsigned_32();
+		const uint32_t size = fr.unsigned_32();
+		const char* bytecode = fr.data(size);
+		// Lua does not verify bytecode, so a truncated or corrupted file must not get to the loader
+		FastHash bytecode_hash;
+		bytecode_hash.data(bytecode, size);
+		if (bytecode_hash.value() != (bytecode_hash_high << 32 | bytecode_hash_low)) {
+			log_warn("Lua bytecode cache for %s is damaged, recompiling\n", identifier.c_str());
+			return false;
+		}
+		// Chunks of another Lua version or another architecture are refused here
+		if (luaL_loadbufferx(L, bytecode, size, identifier.c_str(), "b") != LUA_OK) {
+			lua_pop(L, 1);
+			return false;
+		}
+		return true;
+	} catch (const std::exception&) {
+		// The cache can be recreated at any time
+		return false;
+	}
+}
+
+// Writes the chunk on top of the stack to the cache in the home directory
+void store_chunk(lua_State* L, const std::string& identifier, uint64_t content_hash) {
+	if (g_fs == nullptr || bytecode_cache_disabled) {
+		return;
+	}
+	std::string bytecode;
+	// Debug information is kept, so that errors still name the lines of the script
+	if (lua_dump(L, &append_to_string, &bytecode, 0) != 0) {
+		return;
+	}
+	FileWrite fw;
+	fw.unsigned_16(kCurrentPacketVersion);
+	fw.string(identifier);
+	fw.unsigned_32(content_hash & 0xffffffff);
+	fw.unsigned_32(content_hash >> 32);
+	const uint64_t bytecode_hash = hash_of(bytecode);
+	fw.unsigned_32(bytecode_hash & 0xffffffff);
+	fw.unsigned_32(bytecode_hash >> 32);
+	fw.unsigned_32(bytecode.size());
+	fw.data(bytecode.data(), bytecode.size());
+	try {
+		g_fs->ensure_directory_exists(kLuaCacheDir);
+		fw.write(*g_fs, bytecode_cache_filename(identifier));
+	} catch (const std::exception& e) {
+		bytecode_cache_disabled = true;
+		log_warn("Unable to write Lua bytecode cache, not trying again: %s\n", e.what());
+	}
+}
+
+// Pushes the compiled 'content', from the bytecode cache if it has been compiled before
+int load_script(lua_State* L, const std::string& identifier, const std::string& content) {
+	const uint64_t content_hash = hash_of(content);
+	if (load_cached_chunk(L, identifier, content_hash)) {
+		return LUA_OK;
+	}
+	const int rv = luaL_loadbuffer(L, content.c_str(), content.size(), identifier.c_str());
+	if (rv == LUA_OK) {
+		store_chunk(L, identifier, content_hash);
+	}
+	return rv;
+}
+
 // Reads the 'filename' from the 'fs' and returns its content.
 std::string get_file_content(FileSystem* fs, const std::string& filename) {
 	if (!fs || !fs->file_exists(filename)) {
@@ -58,9 +166,7 @@ run_string_as_script(lua_State* L, const std::string& identifier, const std::str
 	lua_pushstring(L, identifier);
 	lua_setglobal(L, "__file__");
 
-	check_return_value_for_errors(
-	   L, luaL_loadbuffer(L, content.c_str(), content.size(), identifier.c_str()) ||
-	         lua_pcall(L, 0, 1, 0));
+	check_return_value_for_errors(L, load_script(L, identifier, content) || lua_pcall(L, 0, 1, 0));
 
 	if (lua_isnil(L, -1)) {
 		lua_pop(L, 1);    // No return value from script
@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2020 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include <cstring>
+#include <memory>
+
+#include <boost/test/unit_test.hpp>
+
+#include "base/macros.h"
+#include "scripting/lua.h"
+#include "scripting/lua_table.h"
+
+// Triggered by BOOST_AUTO_TEST_CASE
+CLANG_DIAG_OFF("-Wdisabled-macro-expansion")
+CLANG_DIAG_OFF("-Wused-but-marked-unused")
+
+namespace {
+
+struct LuaCloser {
+	void operator()(lua_State* L) {
+		lua_close(L);
+	}
+};
+
+struct LuaTableFixture {
+	LuaTableFixture() : L_ptr(luaL_newstate()), L(L_ptr.get()) {
+		luaL_openlibs(L);
+	}
+
+	// Runs 'script' and returns the table it returned
+	std::unique_ptr<LuaTable> table_from(const char* script) {
+		BOOST_REQUIRE_EQUAL(0, luaL_loadbuffer(L, script, strlen(script), "testscript"));
+		BOOST_REQUIRE_EQUAL(0, lua_pcall(L, 0, 1, 0));  // S: table
+		std::unique_ptr<LuaTable> table(new LuaTable(L));
+		table->do_not_warn_about_unaccessed_keys();
+		lua_pop(L, 1);  // S:
+		return table;
+	}
+
+	// Runs 'script' with the table as its argument and returns whether it returned true
+	bool check(const LuaTable& table, const char* script) {
+		BOOST_REQUIRE_EQUAL(0, luaL_loadbuffer(L, script, strlen(script), "checkscript"));
+		// LuaTable keeps its table in the registry, keyed by its address
+		lua_pushlightuserdata(L, const_cast<LuaTable*>(&table));  // S: script this
+		lua_rawget(L, LUA_REGISTRYINDEX);                         // S: script table
+		BOOST_REQUIRE_EQUAL(0, lua_pcall(L, 1, 1, 0));            // S: result
+		const bool result = lua_toboolean(L, -1);
+		lua_pop(L, 1);  // S:
+		return result;
+	}
+
+	std::unique_ptr<LuaTable> round_trip(const LuaTable& table) {
+		std::unique_ptr<LuaTable> copy = LuaTable::deserialize(L, table.serialize());
+		copy->do_not_warn_about_unaccessed_keys();
+		return copy;
+	}
+
+	std::unique_ptr<lua_State, LuaCloser> L_ptr;
+	lua_State* L;
+
+	DISALLOW_COPY_AND_ASSIGN(LuaTableFixture);
+};
+
+}  // namespace
+
+BOOST_FIXTURE_TEST_SUITE(lua_table_serialization, LuaTableFixture)
+
+BOOST_AUTO_TEST_CASE(numbers_keep_their_subtype) {
+	std::unique_ptr<LuaTable> copy =
+	   round_trip(*table_from("return { int = 3, float = 3.0, half = 0.5, big = 1 << 40 }"));
+	BOOST_CHECK(check(*copy, "local t = ...\n"
+	                         "return math.type(t.int) == 'integer' and t.int == 3 and\n"
+	                         "   math.type(t.float) == 'float' and t.float == 3.0 and\n"
+	                         "   t.half == 0.5 and math.type(t.big) == 'integer' and\n"
+	                         "   t.big == 1 << 40"));
+}
+
+BOOST_AUTO_TEST_CASE(non_string_keys) {
+	std::unique_ptr<LuaTable> copy = round_trip(
+	   *table_from("return { 'first', 'second', [10] = 'ten', [2.5] = 'half', [true] = 'yes' }"));
+	BOOST_CHECK(check(*copy, "local t = ...\n"
+	                         "return t[1] == 'first' and t[2] == 'second' and t[10] == 'ten' and\n"
+	                         "   t[2.5] == 'half' and t[true] == 'yes' and t['1'] == nil"));
+	const std::vector<std::string> entries = copy->array_entries<std::string>();
+	BOOST_REQUIRE_EQUAL(entries.size(), 2U);
+	BOOST_CHECK_EQUAL(entries[0], "first");
+	BOOST_CHECK_EQUAL(entries[1], "second");
+}
+
+BOOST_AUTO_TEST_CASE(nested_tables) {
+	std::unique_ptr<LuaTable> copy =
+	   round_trip(*table_from("return { name = 'hut', programs = { main = { 'call=work', "
+	                          "'return=skipped' } }, size = { 2, 3 }, enabled = false }"));
+	BOOST_CHECK_EQUAL(copy->get_string("name"), "hut");
+	BOOST_CHECK(!copy->get_bool("enabled"));
+	const std::vector<std::string> main_program =
+	   copy->get_table("programs")->get_table("main")->array_entries<std::string>();
+	BOOST_REQUIRE_EQUAL(main_program.size(), 2U);
+	BOOST_CHECK_EQUAL(main_program[0], "call=work");
+	BOOST_CHECK_EQUAL(main_program[1], "return=skipped");
+	BOOST_CHECK_EQUAL((copy->get_vector<std::string, int>("size").y), 3);
+}
+
+BOOST_AUTO_TEST_CASE(functions_are_rejected) {
+	std::unique_ptr<LuaTable> table =
+	   table_from("return { name = 'hut', programs = { main = function() end } }");
+	const int top = lua_gettop(L);
+	BOOST_CHECK_THROW(table->serialize(), LuaError);
+	BOOST_CHECK_EQUAL(lua_gettop(L), top);
+}
+
+BOOST_AUTO_TEST_CASE(cycles_are_rejected) {
+	std::unique_ptr<LuaTable> table =
+	   table_from("local t = { name = 'hut', inner = {} }\nt.inner.outer = t\nreturn t");
+	const int top = lua_gettop(L);
+	BOOST_CHECK_THROW(table->serialize(), LuaError);
+	BOOST_CHECK_EQUAL(lua_gettop(L), top);
+}
+
+BOOST_AUTO_TEST_CASE(damaged_data_is_rejected) {
+	const std::string data = table_from("return { name = 'hut' }")->serialize();
+	const int top = lua_gettop(L);
+	BOOST_CHECK_THROW(LuaTable::deserialize(L, data.substr(0, data.size() - 1)), LuaError);
+	BOOST_CHECK_THROW(LuaTable::deserialize(L, data + 'x'), LuaError);
+	BOOST_CHECK_EQUAL(lua_gettop(L), top);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
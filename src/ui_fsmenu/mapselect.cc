@@ -20,6 +20,8 @@
 
 #include <memory>
 
+#include <SDL_timer.h>
+
 #include "base/i18n.h"
 #include "base/log.h"
 #include "base/wexception.h"
@@ -28,13 +30,17 @@
 #include "logic/filesystem_constants.h"
 #include "logic/game_controller.h"
 #include "logic/game_settings.h"
-#include "map_io/widelands_map_loader.h"
 #include "wui/map_tags.h"
 
 // TODO(GunChleoc): Arabic: line height broken for descriptions for Arabic.
 // Fix align for table headings & entries and for wordwrap.
 
-using Widelands::WidelandsMapLoader;
+namespace {
+// Maximum time in ms that is spent per frame on preloading maps that are missing from the catalogue
+constexpr uint32_t kPreloadTimeBudget = 30;
+// Interval in ms for showing the progress of preloading in the table
+constexpr uint32_t kTableUpdateInterval = 1000;
+}  // namespace
 
 FullscreenMenuMapSelect::FullscreenMenuMapSelect(GameSettingsProvider* const settings,
                                                  GameController* const ctrl)
@@ -67,6 +73,7 @@ FullscreenMenuMapSelect::FullscreenMenuMapSelect(GameSettingsProvider* const set
      ctrl_(ctrl),
      has_translated_mapname_(false),
      unspecified_balancing_found_(false),
+     last_table_update_(0),
      update_map_details_(false) {
 	curdir_ = basedir_;
 	if (settings_->settings().multiplayer) {
@@ -150,25 +157,26 @@ FullscreenMenuMapSelect::FullscreenMenuMapSelect(GameSettingsProvider* const set
 
 	table_.focus();
 	clear_filter();
+	fill_table();
 
-	// We don't need the unlocalizing option if there is nothing to unlocalize.
-	// We know this after the list is filled.
-	cb_dont_localize_mapnames_->set_visible(has_translated_mapname_);
-
-	cb_dont_localize_mapnames_->changedto.connect([this](unsigned) { fill_table(); });
+	cb_dont_localize_mapnames_->changedto.connect([this](unsigned) { apply_filters(); });
 
 	for (size_t i = 0; i < tags_checkboxes_.size(); ++i) {
 		tags_checkboxes_.at(i)->changedto.connect([this, i](bool b) { tagbox_changed(i, b); });
 	}
 
-	balancing_tags_dropdown_->selected.connect([this] { fill_table(); });
-	official_tags_dropdown_->selected.connect([this] { fill_table(); });
-	team_tags_dropdown_->selected.connect([this] { fill_table(); });
+	balancing_tags_dropdown_->selected.connect([this] { apply_filters(); });
+	official_tags_dropdown_->selected.connect([this] { apply_filters(); });
+	team_tags_dropdown_->selected.connect([this] { apply_filters(); });
 	show_all_maps_->sigclicked.connect([this] { clear_filter(); });
 
 	layout();
 }
 
+FullscreenMenuMapSelect::~FullscreenMenuMapSelect() {
+	map_catalogue_.write();
+}
+
 void FullscreenMenuMapSelect::layout() {
 	title_.set_size(get_w(), title_.get_h());
 	FullscreenMenuLoadMapOrGame::layout();
@@ -189,6 +197,10 @@ void FullscreenMenuMapSelect::think() {
 		ctrl_->think();
 	}
 
+	if (!maps_to_preload_.empty()) {
+		preload_maps();
+	}
+
 	if (update_map_details_) {
 		// Call performance heavy draw_minimap function only during think
 		update_map_details_ = false;
@@ -269,21 +281,14 @@ void FullscreenMenuMapSelect::entry_selected() {
  * The search starts in \ref curdir_ ("..../maps") and there is no possibility
  * to move further up. If the user moves down into subdirectories, we insert an
  * entry to move back up.
+ *
+ * Maps are taken from the map catalogue. Maps that are missing from the catalogue
+ * or have changed are preloaded during think() and added to the table as they come in.
  */
 void FullscreenMenuMapSelect::fill_table() {
-	has_translated_mapname_ = false;
-	bool unspecified_balancing_found = false;
-
-	maps_data_.clear();
-
-	MapData::DisplayType display_type;
-	if (cb_dont_localize_mapnames_->get_state()) {
-		display_type = MapData::DisplayType::kMapnames;
-	} else {
-		display_type = MapData::DisplayType::kMapnamesLocalized;
-	}
-
-	// This is the normal case
+	directories_.clear();
+	catalogued_maps_.clear();
+	maps_to_preload_.clear();
 
 	//  Fill it with all files we find in all directories.
 	FilenameSet files = g_fs->list_directory(curdir_);
@@ -291,104 +296,165 @@ void FullscreenMenuMapSelect::fill_table() {
 	// If we are not at the top of the map directory hierarchy (we're not talking
 	// about the absolute filesystem top!) we manually add ".."
 	if (curdir_ != basedir_) {
-		maps_data_.push_back(MapData::create_parent_dir(curdir_));
+		directories_.push_back(MapData::create_parent_dir(curdir_));
 	}
 
-	Widelands::Map map;  //  MapLoader needs a place to put its preload data
-
 	for (const std::string& mapfilename : files) {
 		// Add map file (compressed) or map directory (uncompressed)
-		std::unique_ptr<Widelands::MapLoader> ml = map.get_correct_loader(mapfilename);
-		if (ml != nullptr) {
-			try {
-				map.set_filename(mapfilename);
-				ml->preload_map(true);
-
-				if (!map.get_width() || !map.get_height()) {
-					continue;
-				}
+		if (MapCatalogue::is_map_file(mapfilename)) {
+			const MapCatalogue::Entry* entry = map_catalogue_.find(mapfilename);
+			if (entry != nullptr) {
+				catalogued_maps_.push_back(std::make_pair(mapfilename, entry));
+			} else {
+				maps_to_preload_.push_back(mapfilename);
+			}
+		} else if (g_fs->is_directory(mapfilename) && g_fs->list_directory(mapfilename).size() > 0) {
+			// Add subdirectory to the list
+			const char* fs_filename = FileSystem::fs_filename(mapfilename.c_str());
+			if (!strcmp(fs_filename, ".") || !strcmp(fs_filename, "..")) {
+				continue;
+			}
+			directories_.push_back(MapData::create_directory(mapfilename));
+		}
+	}
 
-				MapData::MapType maptype;
-				if (map.scenario_types() & scenario_types_) {
-					maptype = MapData::MapType::kScenario;
-				} else if (dynamic_cast<WidelandsMapLoader*>(ml.get())) {
-					maptype = MapData::MapType::kNormal;
-				} else {
-					maptype = MapData::MapType::kSettlers2;
-				}
+	table_.clear_selections();
+	apply_filters();
+	table_.cancel.connect([this]() { clicked_back(); });
+}
 
-				MapData mapdata(map, mapfilename, maptype, display_type);
+/**
+ * Preloads maps that are missing from the catalogue until the time budget for
+ * this frame is used up, so that the menu stays responsive.
+ */
+void FullscreenMenuMapSelect::preload_maps() {
+	const uint32_t start_time = SDL_GetTicks();
+	while (!maps_to_preload_.empty() && SDL_GetTicks() - start_time < kPreloadTimeBudget) {
+		const std::string mapfilename = maps_to_preload_.back();
+		maps_to_preload_.pop_back();
+
+		const MapCatalogue::Entry& entry = map_catalogue_.update(mapfilename);
+		if (!entry.error.empty()) {
+			log_warn("Mapselect: Skip %s due to preload error: %s\n", mapfilename.c_str(),
+			         entry.error.c_str());
+		}
+		catalogued_maps_.push_back(std::make_pair(mapfilename, &entry));
+	}
 
-				has_translated_mapname_ =
-				   has_translated_mapname_ || (mapdata.name != mapdata.localized_name);
+	if (maps_to_preload_.empty()) {
+		map_catalogue_.write();
+		apply_filters();
+	} else if (SDL_GetTicks() - last_table_update_ > kTableUpdateInterval) {
+		apply_filters();
+	}
+}
 
-				bool has_all_tags = true;
-				if (team_tags_dropdown_->has_selection()) {
-					const std::string selected_tag = team_tags_dropdown_->get_selected();
-					if (!selected_tag.empty()) {
-						has_all_tags &= mapdata.tags.count(selected_tag);
-					}
-				}
-				if (official_tags_dropdown_->has_selection()) {
-					const std::string selected_tag = official_tags_dropdown_->get_selected();
-					if (!selected_tag.empty()) {
-						if (selected_tag == "official") {
-							has_all_tags &= mapdata.tags.count("official");
-						} else {
-							has_all_tags &= !mapdata.tags.count("official");
-						}
-					}
-				}
-				if (balancing_tags_dropdown_->has_selection()) {
-					const std::string selected_tag = balancing_tags_dropdown_->get_selected();
-					if (!selected_tag.empty()) {
-						if (selected_tag == "unspecified") {
-							has_all_tags &= !mapdata.tags.count("balanced");
-							has_all_tags &= !mapdata.tags.count("unbalanced");
-						} else {
-							has_all_tags &= mapdata.tags.count(selected_tag);
-						}
-					}
-				}
-				// Backwards compatibility
-				if (!mapdata.tags.count("balanced") && !mapdata.tags.count("unbalanced")) {
-					unspecified_balancing_found = true;
-				} else if (mapdata.tags.count("balanced") && mapdata.tags.count("unbalanced")) {
-					log_warn("Map '%s' is both balanced and unbalanced - please fix the 'elemental' "
-					         "packet\n",
-					         mapfilename.c_str());
-				}
+/**
+ * Fill the table with the maps of the current directory that match the filters.
+ * This only uses the data that we already have in memory.
+ */
+void FullscreenMenuMapSelect::apply_filters() {
+	has_translated_mapname_ = false;
+	bool unspecified_balancing_found = false;
+	last_table_update_ = SDL_GetTicks();
 
-				for (uint32_t tag : req_tags_) {
-					has_all_tags &= mapdata.tags.count(tags_ordered_[tag]);
-				}
+	const std::string selected_filename =
+	   table_.has_selection() ? maps_data_[table_.get_selected()].filename : "";
+
+	maps_data_ = directories_;
+
+	MapData::DisplayType display_type;
+	if (cb_dont_localize_mapnames_->get_state()) {
+		display_type = MapData::DisplayType::kMapnames;
+	} else {
+		display_type = MapData::DisplayType::kMapnamesLocalized;
+	}
+
+	for (const auto& filename_and_entry : catalogued_maps_) {
+		const std::string& mapfilename = filename_and_entry.first;
+		const MapCatalogue::Entry& entry = *filename_and_entry.second;
+		if (!entry.error.empty() || !entry.width || !entry.height) {
+			continue;
+		}
 
-				if (!has_all_tags) {
-					continue;
+		MapData::MapType maptype;
+		if (entry.scenario_types & scenario_types_) {
+			maptype = MapData::MapType::kScenario;
+		} else if (entry.is_widelands_map) {
+			maptype = MapData::MapType::kNormal;
+		} else {
+			maptype = MapData::MapType::kSettlers2;
+		}
+
+		MapData mapdata(entry, mapfilename, maptype, display_type);
+
+		has_translated_mapname_ =
+		   has_translated_mapname_ || (mapdata.name != mapdata.localized_name);
+
+		bool has_all_tags = true;
+		if (team_tags_dropdown_->has_selection()) {
+			const std::string selected_tag = team_tags_dropdown_->get_selected();
+			if (!selected_tag.empty()) {
+				has_all_tags &= mapdata.tags.count(selected_tag);
+			}
+		}
+		if (official_tags_dropdown_->has_selection()) {
+			const std::string selected_tag = official_tags_dropdown_->get_selected();
+			if (!selected_tag.empty()) {
+				if (selected_tag == "official") {
+					has_all_tags &= mapdata.tags.count("official");
+				} else {
+					has_all_tags &= !mapdata.tags.count("official");
 				}
-				maps_data_.push_back(mapdata);
-			} catch (const std::exception& e) {
-				log_warn(
-				   "Mapselect: Skip %s due to preload error: %s\n", mapfilename.c_str(), e.what());
-			} catch (...) {
-				log_warn("Mapselect: Skip %s due to unknown exception\n", mapfilename.c_str());
 			}
-		} else if (g_fs->is_directory(mapfilename) && g_fs->list_directory(mapfilename).size() > 0) {
-			// Add subdirectory to the list
-			const char* fs_filename = FileSystem::fs_filename(mapfilename.c_str());
-			if (!strcmp(fs_filename, ".") || !strcmp(fs_filename, "..")) {
-				continue;
+		}
+		if (balancing_tags_dropdown_->has_selection()) {
+			const std::string selected_tag = balancing_tags_dropdown_->get_selected();
+			if (!selected_tag.empty()) {
+				if (selected_tag == "unspecified") {
+					has_all_tags &= !mapdata.tags.count("balanced");
+					has_all_tags &= !mapdata.tags.count("unbalanced");
+				} else {
+					has_all_tags &= mapdata.tags.count(selected_tag);
+				}
 			}
-			maps_data_.push_back(MapData::create_directory(mapfilename));
 		}
+		// Backwards compatibility
+		if (!mapdata.tags.count("balanced") && !mapdata.tags.count("unbalanced")) {
+			unspecified_balancing_found = true;
+		} else if (mapdata.tags.count("balanced") && mapdata.tags.count("unbalanced")) {
+			log_warn("Map '%s' is both balanced and unbalanced - please fix the 'elemental' "
+			         "packet\n",
+			         mapfilename.c_str());
+		}
+
+		for (uint32_t tag : req_tags_) {
+			has_all_tags &= mapdata.tags.count(tags_ordered_[tag]);
+		}
+
+		if (!has_all_tags) {
+			continue;
+		}
+		maps_data_.push_back(mapdata);
 	}
 
 	table_.fill(maps_data_, display_type);
 	if (!table_.empty()) {
-		table_.select(0);
+		// Keep the selection while the table is being filled progressively
+		uint32_t selectme = 0;
+		for (uint32_t i = 0; i < table_.size(); ++i) {
+			if (maps_data_[table_[i]].filename == selected_filename) {
+				selectme = i;
+				break;
+			}
+		}
+		table_.select(selectme);
 	}
 	set_has_selection();
-	table_.cancel.connect([this]() { clicked_back(); });
+
+	// We don't need the unlocalizing option if there is nothing to unlocalize.
+	cb_dont_localize_mapnames_->set_visible(has_translated_mapname_ ||
+	                                        cb_dont_localize_mapnames_->get_state());
 
 	if (unspecified_balancing_found != unspecified_balancing_found_) {
 		unspecified_balancing_found_ = unspecified_balancing_found;
@@ -423,7 +489,7 @@ void FullscreenMenuMapSelect::tagbox_changed(int32_t id, bool to) {
 		req_tags_.erase(id);
 	}
 
-	fill_table();
+	apply_filters();
 }
 
 void FullscreenMenuMapSelect::clear_filter() {
@@ -435,7 +501,7 @@ void FullscreenMenuMapSelect::clear_filter() {
 	balancing_tags_dropdown_->select("");
 	official_tags_dropdown_->select("");
 	team_tags_dropdown_->select("");
-	fill_table();
+	apply_filters();
 }
 
 void FullscreenMenuMapSelect::rebuild_balancing_dropdown() {
@@ -451,6 +517,6 @@ void FullscreenMenuMapSelect::rebuild_balancing_dropdown() {
 		balancing_tags_dropdown_->select(selected);
 	} else {
 		balancing_tags_dropdown_->select(selected == "unspecified" ? "" : selected);
-		fill_table();
+		apply_filters();
 	}
 }
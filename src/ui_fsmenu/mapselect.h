@@ -25,6 +25,7 @@
 #include "ui_basic/dropdown.h"
 #include "ui_basic/textarea.h"
 #include "ui_fsmenu/load_map_or_game.h"
+#include "wui/map_catalogue.h"
 #include "wui/mapdetails.h"
 #include "wui/maptable.h"
 
@@ -38,6 +39,7 @@ struct GameSettingsProvider;
 class FullscreenMenuMapSelect : public FullscreenMenuLoadMapOrGame {
 public:
 	FullscreenMenuMapSelect(GameSettingsProvider*, GameController*);
+	~FullscreenMenuMapSelect() override;
 
 	MapData const* get_map() const;
 	void think() override;
@@ -60,6 +62,10 @@ private:
 	void tagbox_changed(int32_t, bool);
 	void clear_filter();
 	void rebuild_balancing_dropdown();
+	/// Fills the table from the maps of the current directory that we know about
+	void apply_filters();
+	/// Preloads some of the maps that are missing from the catalogue
+	void preload_maps();
 
 	int32_t const checkbox_space_;
 	const int checkbox_padding_;
@@ -97,6 +103,15 @@ private:
 
 	std::vector<MapData> maps_data_;
 
+	MapCatalogue map_catalogue_;
+	/// Parent and subdirectories of the current directory
+	std::vector<MapData> directories_;
+	/// Maps of the current directory that are in the catalogue
+	std::vector<std::pair<std::string, const MapCatalogue::Entry*>> catalogued_maps_;
+	/// Maps of the current directory that still need to be preloaded
+	std::vector<std::string> maps_to_preload_;
+	uint32_t last_table_update_;
+
 	bool update_map_details_;
 };
 
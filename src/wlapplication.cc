@@ -1638,7 +1638,7 @@ void WLApplication::emergency_save(Widelands::Game& game) {
 
 /**
  * Delete old syncstream (.wss) files in the replay directory on startup
- * Delete old replay files on startup
+ * Delete the keyframes of old replays and keyframes without a replay on startup
  */
 void WLApplication::cleanup_replays() {
 	for (const std::string& filename : g_fs->filter_directory(kReplayDir, [](const std::string& fn) {
@@ -1655,6 +1655,39 @@ void WLApplication::cleanup_replays() {
 			}
 		}
 	}
+
+	// Keyframes only speed up seeking, but they take up a lot of space
+	for (const std::string& filename : g_fs->filter_directory(kReplayDir, [](const std::string& fn) {
+		     return boost::ends_with(fn, kReplayExtension);
+	     })) {
+		if (is_autogenerated_and_expired(filename, kReplayKeepAroundTime)) {
+			log_info("Delete keyframes of replay %s\n", filename.c_str());
+			try {
+				Widelands::ReplayKeyframeIndex::remove(filename);
+			} catch (const FileError& e) {
+				log_warn("WLApplication::cleanup_replays: Keyframes of %s couldn't be deleted: %s\n",
+				         filename.c_str(), e.what());
+			}
+		}
+	}
+	for (const std::string& filename : g_fs->filter_directory(kReplayDir, [](const std::string& fn) {
+		     return boost::contains(fn, kReplayKeyframeInfix) ||
+		            boost::ends_with(fn, kReplayKeyframeIndexExtension);
+	     })) {
+		const std::string replay =
+		   boost::contains(filename, kReplayKeyframeInfix) ?
+		      filename.substr(0, filename.rfind(kReplayKeyframeInfix)) :
+		      filename.substr(0, filename.size() - kReplayKeyframeIndexExtension.size());
+		if (!g_fs->file_exists(replay)) {
+			log_info("Delete keyframe %s without replay\n", filename.c_str());
+			try {
+				g_fs->fs_unlink(filename);
+			} catch (const FileError& e) {
+				log_warn("WLApplication::cleanup_replays: File %s couldn't be deleted: %s\n",
+				         filename.c_str(), e.what());
+			}
+		}
+	}
 }
 
 /**
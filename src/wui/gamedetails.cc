@@ -198,9 +198,7 @@ void GameDetails::show_minimap(const SavegameData& gamedata) {
 	if (!minimap_path.empty()) {
 		try {
 			// Load the image
-			minimap_cache_[gamedata.filename] = load_image(
-			   minimap_path,
-			   std::unique_ptr<FileSystem>(g_fs->make_sub_file_system(gamedata.filename)).get());
+			minimap_cache_[gamedata.filename] = load_image(minimap_path);
 			minimap_icon_.set_visible(true);
 			minimap_icon_.set_icon(minimap_cache_.at(gamedata.filename).get());
 		} catch (const std::exception& e) {
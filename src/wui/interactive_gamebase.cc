@@ -32,6 +32,7 @@
 #include "logic/map_objects/tribes/ship.h"
 #include "logic/player.h"
 #include "network/gamehost.h"
+#include "ui_basic/window.h"
 #include "wlapplication_options.h"
 #include "wui/game_chat_menu.h"
 #include "wui/game_client_disconnected.h"
@@ -453,10 +454,20 @@ void InteractiveGameBase::draw_overlay(RenderTarget& dst) {
 			                .str();
 		}
 
+		int y = 5;
 		if (!game_speed.empty()) {
 			std::shared_ptr<const UI::RenderedText> rendered_text = UI::g_fh->render(
 			   as_richtext_paragraph(game_speed, UI::FontStyle::kWuiGameSpeedAndCoordinates));
-			rendered_text->draw(dst, Vector2i(get_w() - 5, 5), UI::Align::kRight);
+			rendered_text->draw(dst, Vector2i(get_w() - 5, y), UI::Align::kRight);
+			y += rendered_text->height();
+		}
+
+		// Display how well the network keeps up
+		const std::string network_status = game_controller->network_status();
+		if (!network_status.empty()) {
+			std::shared_ptr<const UI::RenderedText> rendered_text = UI::g_fh->render(
+			   as_richtext_paragraph(network_status, UI::FontStyle::kWuiGameSpeedAndCoordinates));
+			rendered_text->draw(dst, Vector2i(get_w() - 5, y), UI::Align::kRight);
 		}
 	}
 }
@@ -495,6 +506,19 @@ void InteractiveGameBase::set_sel_pos(Widelands::NodeAndTriangle<> const center)
 	set_tooltip("");
 }
 
+/**
+ * Called when the running game is about to be replaced by a savegame, e.g. when
+ * seeking in a replay.
+ */
+void InteractiveGameBase::cleanup_for_load() {
+	// Windows might refer to map objects that are about to be destroyed
+	for (UI::Panel* child = get_first_child(); child; child = child->get_next_sibling()) {
+		if (dynamic_cast<UI::Window*>(child) != nullptr) {
+			child->die();
+		}
+	}
+}
+
 /**
  * Called for every game after loading (from a savegame or just from a map
  * during single/multiplayer/scenario).
@@ -61,6 +61,7 @@ public:
 	/// For the game host. Show a window and ask the host player what to do with the tribe of the
 	/// leaving client.
 	bool show_game_client_disconnected();
+	void cleanup_for_load() override;
 	void postload() override;
 	void start() override;
 	void toggle_mainmenu();
@@ -733,6 +733,8 @@ void InteractivePlayer::set_player_number(uint32_t const n) {
  * while a game is currently playing.
  */
 void InteractivePlayer::cleanup_for_load() {
+	InteractiveGameBase::cleanup_for_load();
+	expedition_port_spaces_.clear();
 }
 
 void InteractivePlayer::postload() {
@@ -193,5 +193,21 @@ void InteractiveSpectator::node_action(const Widelands::NodeAndTriangle<>& node_
  * Global in-game keypresses:
  */
 bool InteractiveSpectator::handle_key(bool const down, SDL_Keysym const code) {
+	GameController* controller = game().game_controller();
+	if (down && controller->get_game_type() == GameController::GameType::kReplay) {
+		// Jump backwards or forwards in the replay by one minute, or by ten minutes with Shift
+		const Duration step(code.mod & KMOD_SHIFT ? 10 * 60 * 1000 : 60 * 1000);
+		const Time now = game().get_gametime();
+		switch (code.sym) {
+		case SDLK_LEFTBRACKET:
+			controller->seek(now.get() > step.get() ? now - step : Time(0));
+			return true;
+		case SDLK_RIGHTBRACKET:
+			controller->seek(now + step);
+			return true;
+		default:
+			break;
+		}
+	}
 	return InteractiveGameBase::handle_key(down, code);
 }
@@ -0,0 +1,209 @@
+/*
+ * Copyright (C) 2020 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "wui/map_catalogue.h"
+
+#include <memory>
+
+#include <boost/algorithm/string.hpp>
+
+#include "base/log.h"
+#include "io/fileread.h"
+#include "io/filesystem/layered_filesystem.h"
+#include "io/filewrite.h"
+#include "logic/filesystem_constants.h"
+#include "logic/game_data_error.h"
+#include "map_io/widelands_map_loader.h"
+
+namespace {
+constexpr uint16_t kCurrentPacketVersion = 1;
+}  // namespace
+
+MapCatalogue::Entry::Entry(const Widelands::Map& map)
+   : name(map.get_name()),
+     author(map.get_author()),
+     description(map.get_description()),
+     hint(map.get_hint()),
+     theme(map.get_background_theme()),
+     background(map.get_background()),
+     nrplayers(map.get_nrplayers()),
+     width(map.get_width()),
+     height(map.get_height()),
+     scenario_types(map.scenario_types()),
+     suggested_teams(map.get_suggested_teams()),
+     tags(map.get_tags()) {
+}
+
+MapCatalogue::MapCatalogue() : changed_(false) {
+	read();
+}
+
+void MapCatalogue::read() {
+	FileRead fr;
+	if (!fr.try_open(*g_fs, kMapCatalogueFile)) {
+		return;
+	}
+
+	try {
+		const uint16_t packet_version = fr.unsigned_16();
+		if (packet_version != kCurrentPacketVersion) {
+			throw Widelands::UnhandledVersionError(
+			   "MapCatalogue", packet_version, kCurrentPacketVersion);
+		}
+		for (uint32_t i = fr.unsigned_32(); i; --i) {
+			const std::string filename = fr.string();
+			Entry entry;
+			entry.mtime = fr.unsigned_32();
+			entry.error = fr.string();
+			entry.is_widelands_map = fr.unsigned_8();
+			entry.name = fr.string();
+			entry.author = fr.string();
+			entry.description = fr.string();
+			entry.hint = fr.string();
+			entry.theme = fr.string();
+			entry.background = fr.string();
+			entry.nrplayers = fr.unsigned_32();
+			entry.width = fr.unsigned_32();
+			entry.height = fr.unsigned_32();
+			entry.scenario_types = fr.unsigned_8();
+			for (uint8_t lineups = fr.unsigned_8(); lineups; --lineups) {
+				entry.suggested_teams.push_back(Widelands::SuggestedTeamLineup());
+				for (uint8_t teams = fr.unsigned_8(); teams; --teams) {
+					entry.suggested_teams.back().push_back(Widelands::SuggestedTeam());
+					for (uint8_t players = fr.unsigned_8(); players; --players) {
+						entry.suggested_teams.back().back().push_back(fr.unsigned_8());
+					}
+				}
+			}
+			for (uint16_t tags = fr.unsigned_16(); tags; --tags) {
+				entry.tags.insert(fr.string());
+			}
+
+			if (g_fs->file_exists(filename)) {
+				entries_.insert(std::make_pair(filename, entry));
+			} else {
+				changed_ = true;
+			}
+		}
+	} catch (const std::exception& e) {
+		// The catalogue is only a cache, so we simply rebuild it.
+		log_warn("Discarding map catalogue: %s\n", e.what());
+		entries_.clear();
+		changed_ = true;
+	}
+}
+
+void MapCatalogue::write() {
+	if (!changed_) {
+		return;
+	}
+
+	FileWrite fw;
+	fw.unsigned_16(kCurrentPacketVersion);
+	fw.unsigned_32(entries_.size());
+	for (const auto& filename_and_entry : entries_) {
+		const Entry& entry = filename_and_entry.second;
+		fw.string(filename_and_entry.first);
+		fw.unsigned_32(entry.mtime);
+		fw.string(entry.error);
+		fw.unsigned_8(entry.is_widelands_map ? 1 : 0);
+		fw.string(entry.name);
+		fw.string(entry.author);
+		fw.string(entry.description);
+		fw.string(entry.hint);
+		fw.string(entry.theme);
+		fw.string(entry.background);
+		fw.unsigned_32(entry.nrplayers);
+		fw.unsigned_32(entry.width);
+		fw.unsigned_32(entry.height);
+		fw.unsigned_8(entry.scenario_types);
+		fw.unsigned_8(entry.suggested_teams.size());
+		for (const Widelands::SuggestedTeamLineup& lineup : entry.suggested_teams) {
+			fw.unsigned_8(lineup.size());
+			for (const Widelands::SuggestedTeam& team : lineup) {
+				fw.unsigned_8(team.size());
+				for (const Widelands::PlayerNumber player : team) {
+					fw.unsigned_8(player);
+				}
+			}
+		}
+		fw.unsigned_16(entry.tags.size());
+		for (const std::string& tag : entry.tags) {
+			fw.string(tag);
+		}
+	}
+
+	try {
+		g_fs->ensure_directory_exists(kCacheDir);
+		fw.write(*g_fs, kMapCatalogueFile);
+		changed_ = false;
+	} catch (const std::exception& e) {
+		log_warn("Unable to write map catalogue: %s\n", e.what());
+	}
+}
+
+const MapCatalogue::Entry* MapCatalogue::find(const std::string& filename) const {
+	auto it = entries_.find(filename);
+	if (it == entries_.end()) {
+		return nullptr;
+	}
+	// A modification time of 0 means that it is unknown, so we can't trust the entry.
+	const uint32_t mtime = g_fs->get_modification_time(filename);
+	if (mtime == 0 || mtime != it->second.mtime) {
+		return nullptr;
+	}
+	return &it->second;
+}
+
+const MapCatalogue::Entry& MapCatalogue::update(const std::string& filename) {
+	changed_ = true;
+	Entry& entry = entries_[filename];
+	entry = Entry();
+
+	Widelands::Map map;  //  MapLoader needs a place to put its preload data
+	std::unique_ptr<Widelands::MapLoader> ml = map.get_correct_loader(filename);
+	if (ml == nullptr) {
+		entry.error = "No map loader available";
+	} else {
+		try {
+			map.set_filename(filename);
+			ml->preload_map(true);
+			entry = Entry(map);
+			entry.is_widelands_map =
+			   dynamic_cast<Widelands::WidelandsMapLoader*>(ml.get()) != nullptr;
+		} catch (const std::exception& e) {
+			entry.error = e.what();
+		} catch (...) {
+			entry.error = "Unknown exception";
+		}
+	}
+	entry.mtime = g_fs->get_modification_time(filename);
+	return entry;
+}
+
+// static
+bool MapCatalogue::is_map_file(const std::string& filename) {
+	std::string lower_filename = filename;
+	boost::algorithm::to_lower(lower_filename);
+	// Keep this in sync with Widelands::Map::get_correct_loader()
+	return boost::algorithm::ends_with(lower_filename, kWidelandsMapExtension) ||
+	       boost::algorithm::ends_with(lower_filename, kSavegameExtension) ||
+	       boost::algorithm::ends_with(lower_filename, kS2MapExtension1) ||
+	       boost::algorithm::ends_with(lower_filename, kS2MapExtension2);
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2020 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#ifndef WL_WUI_MAP_CATALOGUE_H
+#define WL_WUI_MAP_CATALOGUE_H
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "logic/map.h"
+
+/**
+ * A persistent cache of the preload data of all maps, stored in the home
+ * directory. This allows the map selection to list a directory without opening
+ * every map file. Entries are keyed by the map's path and only trusted as long
+ * as the map file's modification time stays the same.
+ */
+class MapCatalogue {
+public:
+	struct Entry {
+		Entry() = default;
+		/// Copies the preload data from 'map'
+		explicit Entry(const Widelands::Map& map);
+
+		uint32_t mtime = 0;
+		/// The error message if the map could not be preloaded, empty otherwise
+		std::string error;
+		/// Whether this is a Widelands map rather than a Settlers 2 map
+		bool is_widelands_map = false;
+
+		std::string name;
+		std::string author;
+		std::string description;
+		std::string hint;
+		std::string theme;
+		std::string background;
+		uint32_t nrplayers = 0;
+		uint32_t width = 0;
+		uint32_t height = 0;
+		Widelands::Map::ScenarioTypes scenario_types = Widelands::Map::NO_SCENARIO;
+		std::vector<Widelands::SuggestedTeamLineup> suggested_teams;
+		std::set<std::string> tags;
+	};
+
+	/// Reads the catalogue from the home directory and drops entries of maps that are gone.
+	MapCatalogue();
+
+	/// Returns the entry for 'filename' if it is up to date, nullptr otherwise.
+	/// Pointers to entries stay valid for the lifetime of the catalogue.
+	const Entry* find(const std::string& filename) const;
+
+	/// Preloads the map 'filename' and stores the result in the catalogue.
+	const Entry& update(const std::string& filename);
+
+	/// Writes the catalogue back to disk if it has changed.
+	void write();
+
+	/// Whether 'filename' looks like something that a MapLoader can handle.
+	static bool is_map_file(const std::string& filename);
+
+private:
+	void read();
+
+	std::map<std::string, Entry> entries_;
+	bool changed_;
+};
+
+#endif  // end of include guard: WL_WUI_MAP_CATALOGUE_H
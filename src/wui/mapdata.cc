@@ -43,26 +43,33 @@ MapData::MapData(const Widelands::Map& map,
                  const std::string& init_filename,
                  const MapData::MapType& init_maptype,
                  const MapData::DisplayType& init_displaytype)
+   : MapData(MapCatalogue::Entry(map), init_filename, init_maptype, init_displaytype) {
+}
+
+MapData::MapData(const MapCatalogue::Entry& entry,
+                 const std::string& init_filename,
+                 const MapData::MapType& init_maptype,
+                 const MapData::DisplayType& init_displaytype)
    : MapData(init_filename,
              _("No Name"),
-             map.get_author().empty() ? _("No Author") : map.get_author(),
+             entry.author.empty() ? _("No Author") : entry.author,
              init_maptype,
              init_displaytype) {
 
 	i18n::Textdomain td("maps");
-	if (!map.get_name().empty()) {
-		name = map.get_name();
+	if (!entry.name.empty()) {
+		name = entry.name;
 		localized_name = _(name);
 	}
-	description = map.get_description().empty() ? "" : _(map.get_description());
-	hint = map.get_hint().empty() ? "" : _(map.get_hint());
-	theme = map.get_background_theme();
-	background = map.get_background();
-	nrplayers = map.get_nrplayers();
-	width = map.get_width();
-	height = map.get_height();
-	suggested_teams = map.get_suggested_teams();
-	tags = map.get_tags();
+	description = entry.description.empty() ? "" : _(entry.description);
+	hint = entry.hint.empty() ? "" : _(entry.hint);
+	theme = entry.theme;
+	background = entry.background;
+	nrplayers = entry.nrplayers;
+	width = entry.width;
+	height = entry.height;
+	suggested_teams = entry.suggested_teams;
+	tags = entry.tags;
 
 	if (maptype == MapData::MapType::kScenario) {
 		tags.insert("scenario");
@@ -23,6 +23,7 @@
 #include "base/i18n.h"
 #include "io/filesystem/filesystem.h"
 #include "logic/map.h"
+#include "wui/map_catalogue.h"
 #include "wui/mapauthordata.h"
 
 /**
@@ -48,6 +49,12 @@ public:
 	        const MapData::MapType& init_maptype,
 	        const MapData::DisplayType& init_displaytype);
 
+	/// For normal maps and scenarios from the map catalogue
+	MapData(const MapCatalogue::Entry& entry,
+	        const std::string& init_filename,
+	        const MapData::MapType& init_maptype,
+	        const MapData::DisplayType& init_displaytype);
+
 	/// For directories
 	MapData(const std::string& init_filename, const std::string& init_localized_name);
 
@@ -19,7 +19,7 @@ public:
 	std::string mapname;
 	/// The win condition that was played
 	std::string wincondition;
-	/// Filename of the minimap or empty if none available
+	/// Filename of the cached minimap in the savegame index or empty if none available
 	std::string minimap_path;
 	/// "saved on ..."
 	std::string savedatestring;
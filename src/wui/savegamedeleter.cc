@@ -4,9 +4,11 @@
 
 #include "base/i18n.h"
 #include "base/log.h"
+#include "game_io/savegame_index.h"
 #include "io/filesystem/filesystem_exceptions.h"
 #include "io/filesystem/layered_filesystem.h"
 #include "logic/filesystem_constants.h"
+#include "logic/replay.h"
 #include "ui_basic/messagebox.h"
 
 SavegameDeleter::SavegameDeleter(UI::Panel* parent) : parent_(parent) {
@@ -65,6 +67,7 @@ uint32_t SavegameDeleter::try_to_delete(const std::vector<SavegameData>& to_be_d
 	for (const auto& delete_me : to_be_deleted) {
 		try {
 			g_fs->fs_unlink(delete_me.filename);
+			Widelands::SavegameIndex::invalidate(delete_me.filename);
 		} catch (const FileError& e) {
 			log_err("player-requested file deletion failed: %s", e.what());
 			++failed_deletions;
@@ -148,6 +151,7 @@ uint32_t ReplayDeleter::try_to_delete(const std::vector<SavegameData>& to_be_del
 
 		try {
 			g_fs->fs_unlink(file_to_be_deleted + kSavegameExtension);
+			Widelands::SavegameIndex::invalidate(file_to_be_deleted);
 			// If at least one of the two relevant files of a replay are
 			// successfully deleted then count it as success.
 			// (From the player perspective the replay is gone.)
@@ -157,6 +161,7 @@ uint32_t ReplayDeleter::try_to_delete(const std::vector<SavegameData>& to_be_del
 			if (g_fs->file_exists(file_to_be_deleted + kSyncstreamExtension)) {
 				g_fs->fs_unlink(file_to_be_deleted + kSyncstreamExtension);
 			}
+			Widelands::ReplayKeyframeIndex::remove(file_to_be_deleted);
 		} catch (const FileError& e) {
 			log_err("player-requested file deletion failed: %s", e.what());
 		}
@@ -5,7 +5,7 @@
 
 #include "base/i18n.h"
 #include "base/time_string.h"
-#include "game_io/game_loader.h"
+#include "game_io/game_preload_packet.h"
 #include "io/filesystem/layered_filesystem.h"
 #include "logic/filesystem_constants.h"
 
@@ -13,11 +13,18 @@ SavegameLoader::SavegameLoader(Widelands::Game& game) : game_(game) {
 }
 std::vector<SavegameData> SavegameLoader::load_files(const std::string& directory) {
 	std::vector<SavegameData> loaded_games;
+	Widelands::SavegameIndex index(directory);
 	FilenameSet gamefiles = g_fs->list_directory(directory);
 
 	for (const std::string& gamefilename : gamefiles) {
-		load(gamefilename, loaded_games);
+		if (Widelands::SavegameIndex::is_index_directory(gamefilename)) {
+			continue;
+		}
+		load(gamefilename, index, loaded_games);
 	}
+
+	index.remove_stale_entries();
+	index.write();
 	return loaded_games;
 }
 
@@ -26,38 +33,38 @@ std::string SavegameLoader::get_savename(const std::string& gamefilename) const
 }
 
 void SavegameLoader::load(const std::string& to_be_loaded,
+                          Widelands::SavegameIndex& index,
                           std::vector<SavegameData>& loaded_games) const {
 	if (g_fs->is_directory(to_be_loaded)) {
-		try {
-			load_savegame_from_directory(to_be_loaded, loaded_games);
-		} catch (const std::exception&) {
-			// loading failed, so this is actually a normal directory
-			add_sub_dir(to_be_loaded, loaded_games);
-		}
+		load_savegame_from_directory(to_be_loaded, index, loaded_games);
 	} else {
-		load_savegame_from_file(to_be_loaded, loaded_games);
+		load_savegame_from_file(to_be_loaded, index, loaded_games);
 	}
 }
 
 void SavegameLoader::load_savegame_from_directory(const std::string& gamefilename,
+                                                  Widelands::SavegameIndex& index,
                                                   std::vector<SavegameData>& loaded_games) const {
+	const Widelands::SavegameIndex::Entry& entry = index.get(gamefilename, gamefilename, game_);
+	if (!entry.error.empty()) {
+		// loading failed, so this is actually a normal directory
+		add_sub_dir(gamefilename, loaded_games);
+		return;
+	}
 
-	Widelands::GamePreloadPacket gpdp;
 	SavegameData gamedata(gamefilename);
-
-	Widelands::GameLoader gl(gamefilename.c_str(), game_);
-	gl.preload_game(gpdp);
-	gamedata.gametype = gpdp.get_gametype();
+	gamedata.gametype = entry.gametype;
 	if (!is_valid_gametype(gamedata)) {
 		return;
 	}
 
-	add_general_information(gamedata, gpdp);
-	add_time_info(gamedata, gpdp);
+	add_general_information(gamedata, entry, index);
+	add_time_info(gamedata, entry);
 	loaded_games.push_back(gamedata);
 }
 
 void SavegameLoader::load_savegame_from_file(const std::string& gamefilename,
+                                             Widelands::SavegameIndex& index,
                                              std::vector<SavegameData>& loaded_games) const {
 	std::string savename = get_savename(gamefilename);
 
@@ -65,34 +72,33 @@ void SavegameLoader::load_savegame_from_file(const std::string& gamefilename,
 		return;
 	}
 
-	Widelands::GamePreloadPacket gpdp;
 	SavegameData gamedata(gamefilename);
-	try {
-		Widelands::GameLoader gl(savename.c_str(), game_);
-		gl.preload_game(gpdp);
-		gamedata.gametype = gpdp.get_gametype();
+	const Widelands::SavegameIndex::Entry& entry = index.get(gamefilename, savename, game_);
+	if (entry.error.empty()) {
+		gamedata.gametype = entry.gametype;
 		if (!is_valid_gametype(gamedata)) {
 			return;
 		}
 
-		add_general_information(gamedata, gpdp);
-		add_time_info(gamedata, gpdp);
-
-	} catch (const std::exception& e) {
-		add_error_info(gamedata, e.what());
+		add_general_information(gamedata, entry, index);
+		add_time_info(gamedata, entry);
+	} else {
+		add_error_info(gamedata, entry.error);
 	}
 
 	loaded_games.push_back(gamedata);
 }
 
 void SavegameLoader::add_general_information(SavegameData& gamedata,
-                                             const Widelands::GamePreloadPacket& gpdp) const {
-	gamedata.set_mapname(gpdp.get_mapname());
-	gamedata.set_gametime(gpdp.get_gametime().get());
-	gamedata.set_nrplayers(gpdp.get_number_of_players());
-	gamedata.version = gpdp.get_version();
-	gamedata.wincondition = gpdp.get_localized_win_condition();
-	gamedata.minimap_path = gpdp.get_minimap_path();
+                                             const Widelands::SavegameIndex::Entry& entry,
+                                             const Widelands::SavegameIndex& index) const {
+	gamedata.set_mapname(entry.mapname);
+	gamedata.set_gametime(entry.gametime);
+	gamedata.set_nrplayers(entry.number_of_players);
+	gamedata.version = entry.version;
+	gamedata.wincondition =
+	   Widelands::GamePreloadPacket::localize_win_condition(entry.win_condition);
+	gamedata.minimap_path = index.minimap_path(gamedata.filename);
 }
 
 void SavegameLoader::add_error_info(SavegameData& gamedata, std::string errormessage) const {
@@ -110,8 +116,8 @@ void SavegameLoader::add_error_info(SavegameData& gamedata, std::string errormes
 }
 
 void SavegameLoader::add_time_info(SavegameData& gamedata,
-                                   const Widelands::GamePreloadPacket& gpdp) const {
-	gamedata.savetimestamp = gpdp.get_savetimestamp();
+                                   const Widelands::SavegameIndex::Entry& entry) const {
+	gamedata.savetimestamp = entry.savetimestamp;
 	time_t t;
 	time(&t);
 	struct tm* currenttime = localtime(&t);
@@ -4,7 +4,7 @@
 #include <string>
 #include <vector>
 
-#include "game_io/game_preload_packet.h"
+#include "game_io/savegame_index.h"
 #include "wui/savegamedata.h"
 
 class SavegameLoader {
@@ -19,15 +19,20 @@ private:
 	virtual std::string get_savename(const std::string& gamefilename) const;
 
 	void add_general_information(SavegameData& gamedata,
-	                             const Widelands::GamePreloadPacket& gpdp) const;
+	                             const Widelands::SavegameIndex::Entry& entry,
+	                             const Widelands::SavegameIndex& index) const;
 	void add_error_info(SavegameData& gamedata, std::string errormessage) const;
-	void add_time_info(SavegameData& gamedata, const Widelands::GamePreloadPacket& gpdp) const;
+	void add_time_info(SavegameData& gamedata, const Widelands::SavegameIndex::Entry& entry) const;
 	void add_sub_dir(const std::string& gamefilename, std::vector<SavegameData>& loaded_games) const;
 	void load_savegame_from_directory(const std::string& gamefilename,
+	                                  Widelands::SavegameIndex& index,
 	                                  std::vector<SavegameData>& loaded_games) const;
 	void load_savegame_from_file(const std::string& gamefilename,
+	                             Widelands::SavegameIndex& index,
 	                             std::vector<SavegameData>& loaded_games) const;
-	void load(const std::string& to_be_loaded, std::vector<SavegameData>& loaded_games) const;
+	void load(const std::string& to_be_loaded,
+	          Widelands::SavegameIndex& index,
+	          std::vector<SavegameData>& loaded_games) const;
 
 	Widelands::Game& game_;
 };